@@ -0,0 +1,26 @@
+#ifndef INC_4INAROW_ALLOCATIONCOUNTER_H
+#define INC_4INAROW_ALLOCATIONCOUNTER_H
+
+#include <cstdint>
+
+/**
+ * Class counting the calls to the global allocation functions, which are replaced by the ones defined
+ * together with the counter. The replacement is linked only into the benchmarks reading the counter,
+ * and counts the allocations of all their threads.
+ */
+class AllocationCounter {
+    public:
+        AllocationCounter() = delete;
+        ~AllocationCounter() = delete;
+        AllocationCounter(const AllocationCounter&) = delete;
+        AllocationCounter(AllocationCounter&&) = delete;
+        AllocationCounter& operator=(const AllocationCounter&) = delete;
+        AllocationCounter& operator=(AllocationCounter&&) = delete;
+
+        /**
+         * Returns the number of calls to the global allocation functions since the start of the program.
+         */
+        static uint64_t count();
+};
+
+#endif //INC_4INAROW_ALLOCATIONCOUNTER_H
@@ -0,0 +1,438 @@
+#include <arpa/inet.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/rand.h>
+#include <AuthenticatedEncryption.h>
+#include <CertificateStore.h>
+#include <Challenge.h>
+#include <Constants.h>
+#include <CSPRNG.h>
+#include <DelegatedCredential.h>
+#include <DiffieHellman.h>
+#include <DigitalSignature.h>
+#include <Move.h>
+#include <Player.h>
+#include <PlayerListMessage.h>
+#include <ServerHello.h>
+#include "Measurement.h"
+#include "TemporaryKeyPair.h"
+
+namespace {
+
+/*
+ * Number of calls to the allocation functions of OpenSSL, which do not go through the global ones.
+ * The benchmark is single-threaded, and the counter is read only around the measured code.
+ */
+uint64_t opensslAllocationCount = 0;
+
+void* countedOpensslMalloc(size_t size, const char*, int) {
+    opensslAllocationCount++;
+    return std::malloc(size);
+}
+
+void* countedOpensslRealloc(void *pointer, size_t size, const char*, int) {
+    opensslAllocationCount++;
+    return std::realloc(pointer, size);
+}
+
+void countedOpensslFree(void *pointer, const char*, int) {
+    std::free(pointer);
+}
+
+}
+
+/**
+ * Measurement of a primitive, with the size of the processed message and the allocations performed by OpenSSL.
+ */
+struct PrimitiveMeasurement : Measurement {
+    size_t bytes;
+    uint64_t opensslAllocations;
+
+    PrimitiveMeasurement(Measurement measurement, size_t bytes, uint64_t opensslAllocations)
+            : Measurement(std::move(measurement)), bytes(bytes), opensslAllocations(opensslAllocations) {}
+
+    double opensslAllocationsPerOperation() const {
+        return operations == 0 ? 0 : static_cast<double>(opensslAllocations)/operations;
+    }
+};
+
+/**
+ * Runs a primitive the given number of times, as <code>measureEach()</code> does,
+ * also counting the allocations performed by OpenSSL.
+ * @param name        the name of the measurement.
+ * @param bytes       the size of the processed message, or 0 if not meaningful.
+ * @param operations  the number of executions.
+ * @param prepare     the code preparing an execution, receiving its index.
+ * @param function    the primitive to measure, receiving the index of the execution.
+ * @return            the measurement.
+ */
+template<typename Prepare, typename Function>
+PrimitiveMeasurement measure(const std::string &name, size_t bytes, unsigned int operations,
+                             Prepare prepare, Function function) {
+    uint64_t opensslAllocations = 0;
+    auto measurement = measureEach(name, operations, prepare, [&](unsigned int i) {
+        auto allocations = opensslAllocationCount;
+        function(i);
+        opensslAllocations += opensslAllocationCount - allocations;
+    });
+
+    return PrimitiveMeasurement(std::move(measurement), bytes, opensslAllocations);
+}
+
+template<typename Function>
+PrimitiveMeasurement measure(const std::string &name, size_t bytes, unsigned int operations, Function function) {
+    return measure(name, bytes, operations, [](unsigned int) {}, function);
+}
+
+/**
+ * Builds the additional authenticated data of a message, as the server does, using the given sequence number.
+ */
+std::vector<unsigned char> sequenceNumberAad(uint32_t sequenceNumber) {
+    sequenceNumber = htonl(sequenceNumber);
+    std::vector<unsigned char> aad(sizeof(sequenceNumber));
+    memcpy(aad.data(), &sequenceNumber, sizeof(sequenceNumber));
+    return aad;
+}
+
+/**
+ * Prints a help message describing how to invoke the program from the command line.
+ */
+void printHelp() {
+    std::string helpMessage("Usage: crypto-benchmark [-h] [-a ASYMMETRIC] [-m MESSAGES] [-o OUTPUT]\n"
+                            "\n"
+                            "Options:\n"
+                            " -h, --help              Show this help message and exit\n"
+                            " -a, --asymmetric COUNT  The executions of each handshake primitive (default: 1000)\n"
+                            " -m, --messages   COUNT  The executions of each per-message primitive (default: 100000)\n"
+                            " -o, --output     OUTPUT The path of the JSON file that will store the results");
+    std::cout << helpMessage << std::endl;
+}
+
+/**
+ * Parses the arguments passed via command line. All the options are optional,
+ * but each given option must be followed by a value.
+ * @param argc        the number of arguments passed via command line.
+ * @param argv        the arguments passed via command line.
+ * @param asymmetric  a reference to the variable that will store the executions of the handshake primitives.
+ * @param messages    a reference to the variable that will store the executions of the per-message primitives.
+ * @param output      a reference to the variable that will store the path of the JSON file.
+ * @return            true if the arguments are valid, false otherwise.
+ */
+bool parseArguments(int argc, char *argv[], unsigned int &asymmetric, unsigned int &messages, std::string &output) {
+    if (argc % 2 != 1) {
+        printHelp();
+        return false;
+    }
+
+    try {
+        for (auto i = 1; i < argc; i += 2) {
+            std::string arg(argv[i]);
+
+            if (arg == "-a" || arg == "--asymmetric") {
+                asymmetric = std::stoul(argv[i + 1]);
+            } else if (arg == "-m" || arg == "--messages") {
+                messages = std::stoul(argv[i + 1]);
+            } else if (arg == "-o" || arg == "--output") {
+                output = argv[i + 1];
+            } else {
+                printHelp();
+                return false;
+            }
+        }
+    } catch (const std::exception &exception) {
+        printHelp();
+        return false;
+    }
+
+    if (asymmetric == 0 || messages == 0) {
+        printHelp();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Writes the measurements to a JSON file.
+ * @param path          the path of the file.
+ * @param measurements  the measurements.
+ * @return              true if the file has been written, false otherwise.
+ */
+bool writeJson(const std::string &path, const std::vector<PrimitiveMeasurement> &measurements) {
+    std::ofstream file(path);
+    file.precision(6);
+    file << std::fixed;
+    file << "{\n";
+    file << "  \"benchmark\": \"crypto\",\n";
+    file << "  \"openssl\": \"" << OpenSSL_version(OPENSSL_VERSION) << "\",\n";
+    file << "  \"results\": [\n";
+
+    for (size_t i = 0; i < measurements.size(); i++) {
+        const auto &measurement = measurements[i];
+        file << "    {\"name\": \"" << measurement.name << "\", ";
+        file << "\"bytes\": " << measurement.bytes << ", ";
+        file << "\"operations\": " << measurement.operations << ", ";
+        file << "\"operations_per_second\": " << measurement.operationsPerSecond() << ", ";
+        file << "\"mean_us\": " << measurement.meanLatency() << ", ";
+        file << "\"p50_us\": " << measurement.quantile(0.5) << ", ";
+        file << "\"p99_us\": " << measurement.quantile(0.99) << ", ";
+        file << "\"allocations_per_operation\": " << measurement.allocationsPerOperation() << ", ";
+        file << "\"openssl_allocations_per_operation\": " << measurement.opensslAllocationsPerOperation() << "}";
+        file << (i + 1 < measurements.size() ? ",\n" : "\n");
+    }
+
+    file << "  ]\n";
+    file << "}\n";
+    return static_cast<bool>(file);
+}
+
+int main(int argc, char *argv[]) {
+    // Must precede any other call to OpenSSL.
+    CRYPTO_set_mem_functions(countedOpensslMalloc, countedOpensslRealloc, countedOpensslFree);
+
+    auto asymmetricCount = 1000u;
+    auto messageCount = 100000u;
+    std::string output;
+
+    if (!parseArguments(argc, argv, asymmetricCount, messageCount, output)) {
+        return 1;
+    }
+
+    try {
+        std::vector<PrimitiveMeasurement> measurements;
+        volatile size_t sink = 0;  // Keeps the results of the measured code alive.
+
+        /*
+         * Handshake primitives. The signed message is a freshness proof, i.e. a nonce
+         * concatenated with an ECDH public key, as in the handshake.
+         */
+        TemporaryKeyPair keyPair;
+        fourinarow::DigitalSignature digitalSignature(keyPair.getPrivateKeyPath());
+        fourinarow::DiffieHellman serverKeys;
+
+        std::vector<unsigned char> freshnessProof(fourinarow::NONCE_SIZE);
+        fourinarow::CSPRNG::nextBytes(freshnessProof, fourinarow::NONCE_SIZE);
+        auto serverPublicKey = serverKeys.getSerializedPublicKey();
+        freshnessProof.insert(freshnessProof.end(), serverPublicKey.begin(), serverPublicKey.end());
+
+        std::vector<unsigned char> signature;
+        measurements.push_back(measure("rsa_sign", freshnessProof.size(), asymmetricCount, [&](unsigned int) {
+            signature = digitalSignature.sign(freshnessProof);
+        }));
+
+        auto publicKeyFile = fopen(keyPair.getPublicKeyPath().c_str(), "r");
+        auto publicKey = publicKeyFile ? PEM_read_PUBKEY(publicKeyFile, nullptr, nullptr, nullptr) : nullptr;
+        if (publicKeyFile) {
+            fclose(publicKeyFile);
+        }
+        if (publicKey == nullptr) {
+            throw std::runtime_error("Impossible to load the RSA public key");
+        }
+
+        measurements.push_back(measure("rsa_verify", freshnessProof.size(), asymmetricCount, [&](unsigned int) {
+            sink = sink + fourinarow::DigitalSignature::verify(freshnessProof, signature, publicKey);
+        }));
+
+        // The server verifies the signature of a client loading its public key from the players folder.
+        measurements.push_back(measure("rsa_verify_from_file", freshnessProof.size(), asymmetricCount, [&](unsigned int) {
+            sink = sink + fourinarow::DigitalSignature::verify(freshnessProof, signature, keyPair.getPublicKeyPath());
+        }));
+
+        /*
+         * Delegated signature schemes. The client verifies the signature with the serialized public key
+         * carried by the delegated credential, whose parsing is measured too.
+         */
+        const std::pair<const char*, uint8_t> delegatedSchemes[] = {
+                {"ecdsa_p256", fourinarow::SIGNATURE_ECDSA_P256_SHA256},
+                {"ed25519",    fourinarow::SIGNATURE_ED25519}
+        };
+
+        for (const auto &scheme : delegatedSchemes) {
+            auto delegatedKey = fourinarow::DigitalSignature::generate(scheme.second);
+            auto delegatedPublicKey = delegatedKey.getSerializedPublicKey();
+            std::vector<unsigned char> delegatedSignature;
+
+            measurements.push_back(measure(std::string(scheme.first) + "_sign", freshnessProof.size(), asymmetricCount, [&](unsigned int) {
+                delegatedSignature = delegatedKey.sign(freshnessProof);
+            }));
+
+            measurements.push_back(measure(std::string(scheme.first) + "_verify", freshnessProof.size(), asymmetricCount, [&](unsigned int) {
+                sink = sink + fourinarow::DigitalSignature::verify(freshnessProof, delegatedSignature, delegatedPublicKey);
+            }));
+        }
+
+        // The credential is signed with RSA by the key of the certificate: the client verifies it at every handshake.
+        auto credentialKey = fourinarow::DigitalSignature::generate(fourinarow::SIGNATURE_ED25519);
+        auto credential = fourinarow::DelegatedCredential::issue(digitalSignature, credentialKey,
+                                                                 fourinarow::SERVER_DELEGATED_CREDENTIAL_LIFETIME);
+        measurements.push_back(measure("delegated_credential_verify", credential.serialize().size(), asymmetricCount, [&](unsigned int) {
+            sink = sink + credential.verify(publicKey);
+        }));
+        EVP_PKEY_free(publicKey);
+
+        fourinarow::CertificateStore certificateStore;
+        certificateStore.addCertificate(fourinarow::CLIENT_CERTIFICATES_FOLDER + "UnipiCA_cert.pem");
+        certificateStore.addCertificateRevocationList(fourinarow::CLIENT_CERTIFICATES_FOLDER + "UnipiCA_crl.pem");
+        auto serializedCertificate = fourinarow::CertificateStore::serializeCertificate(
+                fourinarow::CLIENT_CERTIFICATES_FOLDER + "4InARow_cert.pem");
+
+        measurements.push_back(measure("certificate_verify", serializedCertificate.size(), asymmetricCount, [&](unsigned int) {
+            auto certificate = fourinarow::CertificateStore::deserializeCertificate(serializedCertificate);
+            sink = sink + certificateStore.verifyCertificate(certificate);
+        }));
+
+        measurements.push_back(measure("ecdh_key_generation", 0, asymmetricCount, [&](unsigned int) {
+            fourinarow::DiffieHellman keys;
+            sink = sink + keys.getSerializedPublicKey().size();
+        }));
+
+        fourinarow::DiffieHellman clientKeys;
+        measurements.push_back(measure("ecdh_derive_shared_secret", serverPublicKey.size(), asymmetricCount, [&](unsigned int) {
+            sink = sink + clientKeys.deriveSharedSecret(serverPublicKey).size();
+        }));
+
+        measurements.push_back(measure("x25519_key_generation", 0, asymmetricCount, [&](unsigned int) {
+            fourinarow::DiffieHellman keys(fourinarow::KEY_EXCHANGE_X25519);
+            sink = sink + keys.getSerializedPublicKey().size();
+        }));
+
+        fourinarow::DiffieHellman x25519ServerKeys(fourinarow::KEY_EXCHANGE_X25519);
+        fourinarow::DiffieHellman x25519ClientKeys(fourinarow::KEY_EXCHANGE_X25519);
+        auto x25519ServerPublicKey = x25519ServerKeys.getSerializedPublicKey();
+        measurements.push_back(measure("x25519_derive_shared_secret", x25519ServerPublicKey.size(), asymmetricCount, [&](unsigned int) {
+            sink = sink + x25519ClientKeys.deriveSharedSecret(x25519ServerPublicKey).size();
+        }));
+
+        // The players are prepared as a client at the end of the handshake, right before deriving the key.
+        std::vector<unsigned char> serverNonce(fourinarow::NONCE_SIZE);
+        fourinarow::CSPRNG::nextBytes(serverNonce, fourinarow::NONCE_SIZE);
+        std::unique_ptr<fourinarow::Player> player;
+
+        measurements.push_back(measure("player_init_cipher", 0, asymmetricCount, [&](unsigned int) {
+            player = std::make_unique<fourinarow::Player>();
+            player->generateClientNonce();
+            player->generateClientKeys();
+            player->setServerNonce(serverNonce);
+            player->setServerPublicKey(serverPublicKey);
+        }, [&](unsigned int) {
+            player->initCipher();
+        }));
+
+        // Random bytes, drawn directly from OpenSSL and from the block buffered by the CSPRNG.
+        std::vector<unsigned char> randomBytes(fourinarow::IV_SIZE);
+        measurements.push_back(measure("rand_bytes_iv", randomBytes.size(), messageCount, [&](unsigned int) {
+            if (1 != RAND_bytes(randomBytes.data(), randomBytes.size())) {
+                throw std::runtime_error("Impossible to generate the random bytes");
+            }
+        }));
+
+        measurements.push_back(measure("csprng_iv", randomBytes.size(), messageCount, [&](unsigned int) {
+            fourinarow::CSPRNG::nextBytes(randomBytes, randomBytes.size());
+        }));
+
+        measurements.push_back(measure("csprng_nonce", fourinarow::NONCE_SIZE, messageCount, [&](unsigned int) {
+            fourinarow::CSPRNG::nextBytes(randomBytes, fourinarow::NONCE_SIZE);
+        }));
+
+        measurements.push_back(measure("csprng_bool", sizeof(uint8_t), messageCount, [&](unsigned int) {
+            sink = sink + fourinarow::CSPRNG::nextBool();
+        }));
+
+        /*
+         * Per-message primitives, on the messages exchanged after the handshake. The player list
+         * holds 100 players with usernames of typical length.
+         */
+        std::string playerList;
+        for (auto i = 0; i < 100; i++) {
+            playerList += "player" + std::to_string(1000 + i) + ';';
+        }
+
+        const std::pair<const char*, std::vector<unsigned char>> messages[] = {
+                {"move",        fourinarow::Move(3).serialize()},
+                {"challenge",   fourinarow::Challenge(std::string(fourinarow::MAX_USERNAME_SIZE, 'a')).serialize()},
+                {"player_list", fourinarow::PlayerListMessage(playerList).serialize()}
+        };
+
+        // Both cipher suites are measured, whatever the preference of the host.
+        const std::pair<const char*, uint8_t> cipherSuites[] = {
+                {"aes_128_gcm",       fourinarow::CIPHER_AES_128_GCM},
+                {"chacha20_poly1305", fourinarow::CIPHER_CHACHA20_POLY1305}
+        };
+
+        for (const auto &cipherSuite : cipherSuites) {
+            std::vector<unsigned char> key(fourinarow::AuthenticatedEncryption::getKeySize(cipherSuite.second));
+            fourinarow::CSPRNG::nextBytes(key, key.size());
+            fourinarow::AuthenticatedEncryption cipher(key, cipherSuite.second);
+
+            for (const auto &message : messages) {
+                auto name = std::string(cipherSuite.first) + '_';
+                std::vector<unsigned char> ciphertext;
+                measurements.push_back(measure(name + "encrypt_" + message.first, message.second.size(), messageCount, [&](unsigned int i) {
+                    ciphertext = cipher.encrypt(message.second, sequenceNumberAad(i));
+                }));
+
+                // The same ciphertext is decrypted every time, with the sequence number used by the last encryption.
+                auto aad = sequenceNumberAad(messageCount - 1);
+                measurements.push_back(measure(name + "decrypt_" + message.first, message.second.size(), messageCount, [&](unsigned int) {
+                    sink = sink + cipher.decrypt(ciphertext, aad).size();
+                }));
+            }
+        }
+
+        // The SERVER_HELLO is sent in cleartext: only its serialization is measured, besides the signature.
+        std::vector<unsigned char> serverHelloNonce(fourinarow::NONCE_SIZE);
+        fourinarow::CSPRNG::nextBytes(serverHelloNonce, fourinarow::NONCE_SIZE);
+        fourinarow::ServerHello serverHello(serializedCertificate, serverHelloNonce, serverPublicKey,
+                                            fourinarow::CIPHER_AES_128_GCM, {}, signature);
+        auto serializedServerHello = serverHello.serialize();
+
+        measurements.push_back(measure("server_hello_serialize", serializedServerHello.size(), messageCount, [&](unsigned int) {
+            sink = sink + serverHello.serialize().size();
+        }));
+
+        measurements.push_back(measure("server_hello_deserialize", serializedServerHello.size(), messageCount, [&](unsigned int) {
+            fourinarow::ServerHello deserialized;
+            deserialized.deserialize(serializedServerHello);
+            sink = sink + deserialized.getCertificate().size();
+        }));
+
+        std::cout << "OpenSSL: " << OpenSSL_version(OPENSSL_VERSION) << std::endl;
+        std::cout << "AES hardware support: "
+                  << (fourinarow::AuthenticatedEncryption::hasAesHardwareSupport() ? "yes" : "no") << std::endl;
+        for (const auto &measurement : measurements) {
+            std::cout << measurement.name;
+            if (measurement.bytes > 0) {
+                std::cout << " (" << measurement.bytes << " bytes)";
+            }
+            std::cout << ": " << measurement.operationsPerSecond() << " op/s, mean "
+                      << measurement.meanLatency() << " us, p50 " << measurement.quantile(0.5) << " us, p99 "
+                      << measurement.quantile(0.99) << " us, " << measurement.allocationsPerOperation()
+                      << " allocations/op, " << measurement.opensslAllocationsPerOperation()
+                      << " OpenSSL allocations/op" << std::endl;
+        }
+
+        if (!output.empty()) {
+            if (!writeJson(output, measurements)) {
+                std::cerr << "Impossible to write the results to " << output << std::endl;
+                return 1;
+            }
+            std::cout << "Results written to " << output << std::endl;
+        }
+    } catch (const std::exception &exception) {
+        std::cerr << "The benchmark failed. " << exception.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include <BatchEvaluator.h>
+#include <Position.h>
+#include "PositionGenerator.h"
+
+/**
+ * Prints a help message describing how to invoke the program from the command line.
+ */
+void printHelp() {
+    std::string helpMessage("Usage: evaluator-benchmark [-h] [-p POSITIONS] [-m MOVES] [-r ROUNDS] [-s SEED]\n"
+                            "\n"
+                            "Options:\n"
+                            " -h, --help                Show this help message and exit\n"
+                            " -p, --positions POSITIONS The number of positions of a batch (default: 4096)\n"
+                            " -m, --moves     MOVES     The number of discs on the board of each position (default: 16)\n"
+                            " -r, --rounds    ROUNDS    The number of times the batch is evaluated (default: 1000)\n"
+                            " -s, --seed      SEED      The seed used to generate the positions (default: 1)");
+    std::cout << helpMessage << std::endl;
+}
+
+/**
+ * Parses the arguments passed via command line. All the options are optional,
+ * but each given option must be followed by a numeric value.
+ * @param argc       the number of arguments passed via command line.
+ * @param argv       the arguments passed via command line.
+ * @param positions  a reference to the variable that will store the number of positions of a batch.
+ * @param moves      a reference to the variable that will store the number of discs of each position.
+ * @param rounds     a reference to the variable that will store the number of rounds.
+ * @param seed       a reference to the variable that will store the seed.
+ * @return           true if the arguments are valid, false otherwise.
+ */
+bool parseArguments(int argc, char *argv[], unsigned int &positions, unsigned int &moves, unsigned int &rounds,
+                    unsigned long &seed) {
+    if (argc % 2 != 1) {
+        printHelp();
+        return false;
+    }
+
+    try {
+        for (auto i = 1; i < argc; i += 2) {
+            std::string arg(argv[i]);
+
+            if (arg == "-p" || arg == "--positions") {
+                positions = std::stoul(argv[i + 1]);
+            } else if (arg == "-m" || arg == "--moves") {
+                moves = std::stoul(argv[i + 1]);
+            } else if (arg == "-r" || arg == "--rounds") {
+                rounds = std::stoul(argv[i + 1]);
+            } else if (arg == "-s" || arg == "--seed") {
+                seed = std::stoul(argv[i + 1]);
+            } else {
+                printHelp();
+                return false;
+            }
+        }
+    } catch (const std::exception &exception) {
+        printHelp();
+        return false;
+    }
+
+    if (moves >= fourinarow::Position::Geometry::SPACES) {
+        std::cerr << "The number of discs must be lower than " << fourinarow::Position::Geometry::SPACES << std::endl;
+        return false;
+    }
+
+    if (positions == 0 || rounds == 0) {
+        printHelp();
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    auto positionCount = 4096u;
+    auto moves = 16u;
+    auto rounds = 1000u;
+    auto seed = 1ul;
+
+    if (!parseArguments(argc, argv, positionCount, moves, rounds, seed)) {
+        return 1;
+    }
+
+    std::mt19937_64 generator(seed);
+    auto positions = generatePositions(positionCount, moves, generator);
+
+    std::vector<uint64_t> current;
+    std::vector<uint64_t> mask;
+    for (const auto &position : positions) {
+        current.push_back(position.getCurrentPlayerDiscs());
+        mask.push_back(position.getMask());
+    }
+
+    const std::pair<fourinarow::BatchEvaluator::Kernel, std::string> kernels[] = {
+            {fourinarow::BatchEvaluator::Kernel::SCALAR, "scalar"},
+            {fourinarow::BatchEvaluator::Kernel::AVX2,   "AVX2"}
+    };
+
+    std::vector<int> referenceScores;
+    std::cout << "Evaluating " << positions.size() << " positions with " << moves << " discs, "
+              << rounds << " times" << std::endl;
+
+    for (const auto &kernel : kernels) {
+        if (!fourinarow::BatchEvaluator::isSupported(kernel.first)) {
+            std::cout << kernel.second << ": not supported" << std::endl;
+            continue;
+        }
+
+        fourinarow::BatchEvaluator evaluator(kernel.first);
+        std::vector<int> scores(positions.size());
+        long checksum = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (auto i = 0u; i < rounds; i++) {
+            evaluator.evaluate(current.data(), mask.data(), positions.size(), scores.data());
+            checksum += scores[i % scores.size()];
+        }
+        auto end = std::chrono::steady_clock::now();
+        auto seconds = std::chrono::duration<double>(end - start).count();
+
+        if (referenceScores.empty()) {
+            referenceScores = scores;
+        } else if (scores != referenceScores) {
+            std::cerr << "The scores of the " << kernel.second << " kernel differ from the scalar ones" << std::endl;
+            return 1;
+        }
+
+        std::cout << kernel.second << ": " << (seconds > 0 ? positions.size()*double(rounds)/seconds : 0)
+                  << " positions/s (checksum " << checksum << ")" << std::endl;
+    }
+
+    return 0;
+}
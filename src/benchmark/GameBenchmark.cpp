@@ -0,0 +1,247 @@
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <FourInARow.h>
+#include "Measurement.h"
+
+using Board = fourinarow::FourInARow;
+using Geometry = Board::Geometry;
+
+/**
+ * Prints a help message describing how to invoke the program from the command line.
+ */
+void printHelp() {
+    std::string helpMessage("Usage: game-benchmark [-h] [-g GAMES] [-s SEED] [-o OUTPUT]\n"
+                            "\n"
+                            "Options:\n"
+                            " -h, --help            Show this help message and exit\n"
+                            " -g, --games  GAMES    The number of random games played (default: 100000)\n"
+                            " -s, --seed   SEED     The seed used to generate the games (default: 1)\n"
+                            " -o, --output OUTPUT   The path of the JSON file that will store the results");
+    std::cout << helpMessage << std::endl;
+}
+
+/**
+ * Parses the arguments passed via command line. All the options are optional,
+ * but each given option must be followed by a value.
+ * @param argc    the number of arguments passed via command line.
+ * @param argv    the arguments passed via command line.
+ * @param games   a reference to the variable that will store the number of games.
+ * @param seed    a reference to the variable that will store the seed.
+ * @param output  a reference to the variable that will store the path of the JSON file.
+ * @return        true if the arguments are valid, false otherwise.
+ */
+bool parseArguments(int argc, char *argv[], unsigned int &games, unsigned long &seed, std::string &output) {
+    if (argc % 2 != 1) {
+        printHelp();
+        return false;
+    }
+
+    try {
+        for (auto i = 1; i < argc; i += 2) {
+            std::string arg(argv[i]);
+
+            if (arg == "-g" || arg == "--games") {
+                games = std::stoul(argv[i + 1]);
+            } else if (arg == "-s" || arg == "--seed") {
+                seed = std::stoul(argv[i + 1]);
+            } else if (arg == "-o" || arg == "--output") {
+                output = argv[i + 1];
+            } else {
+                printHelp();
+                return false;
+            }
+        }
+    } catch (const std::exception &exception) {
+        printHelp();
+        return false;
+    }
+
+    if (games == 0) {
+        printHelp();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Writes the measurements to a JSON file.
+ * @param path          the path of the file.
+ * @param games         the number of games played.
+ * @param seed          the seed used to generate the games.
+ * @param moves         the number of moves of the games.
+ * @param measurements  the measurements.
+ * @return              true if the file has been written, false otherwise.
+ */
+bool writeJson(const std::string &path, unsigned int games, unsigned long seed, uint64_t moves,
+               const std::vector<Measurement> &measurements) {
+    std::ofstream file(path);
+    file.precision(6);
+    file << std::fixed;
+    file << "{\n";
+    file << "  \"benchmark\": \"game\",\n";
+    file << "  \"games\": " << games << ",\n";
+    file << "  \"seed\": " << seed << ",\n";
+    file << "  \"moves\": " << moves << ",\n";
+    file << "  \"results\": [\n";
+
+    for (size_t i = 0; i < measurements.size(); i++) {
+        const auto &measurement = measurements[i];
+        file << "    {\"name\": \"" << measurement.name << "\", ";
+        file << "\"operations\": " << measurement.operations << ", ";
+        file << "\"seconds\": " << measurement.seconds << ", ";
+        file << "\"ns_per_operation\": " << measurement.nanosecondsPerOperation() << ", ";
+        file << "\"operations_per_second\": " << measurement.operationsPerSecond() << ", ";
+        file << "\"allocations_per_operation\": " << measurement.allocationsPerOperation() << "}";
+        file << (i + 1 < measurements.size() ? ",\n" : "\n");
+    }
+
+    file << "  ]\n";
+    file << "}\n";
+    return static_cast<bool>(file);
+}
+
+int main(int argc, char *argv[]) {
+    auto gameCount = 100000u;
+    auto seed = 1ul;
+    std::string output;
+
+    if (!parseArguments(argc, argv, gameCount, seed, output)) {
+        return 1;
+    }
+
+    std::mt19937_64 generator(seed);
+    std::vector<Measurement> measurements;
+    volatile uint64_t sink = 0;  // Keeps the results of the measured code alive.
+
+    /*
+     * Random playouts: each move is a random column, retried while the engine rejects it.
+     * The moves are recorded, and replayed by the other measurements.
+     */
+    std::vector<uint8_t> moves;
+    std::vector<uint32_t> gameEnds;
+    moves.reserve(static_cast<size_t>(gameCount)*Geometry::SPACES);
+    gameEnds.reserve(gameCount);
+
+    measurements.push_back(measure("random_playout", gameCount, [&]() {
+        for (auto i = 0u; i < gameCount; i++) {
+            Board board("opponent");
+            auto opponentMove = false;
+
+            while (!board.isMatchFinished()) {
+                auto column = static_cast<uint8_t>(generator() % fourinarow::COLUMNS);
+                if (board.registerMove(column, opponentMove)) {
+                    moves.push_back(column);
+                    opponentMove = !opponentMove;
+                }
+            }
+
+            gameEnds.push_back(static_cast<uint32_t>(moves.size()));
+            sink = sink + static_cast<uint64_t>(board.getResult());
+        }
+    }));
+
+    // The discs of the player who made each move, right after the move.
+    std::vector<Geometry::Bitboard> discs;
+    discs.reserve(moves.size());
+    for (size_t game = 0, move = 0; game < gameEnds.size(); game++) {
+        Geometry::Bitboard players[2] = {0, 0};
+        uint8_t heights[fourinarow::COLUMNS] = {};
+
+        for (auto player = 0u; move < gameEnds[game]; move++, player ^= 1) {
+            auto column = moves[move];
+            players[player] |= Geometry::spaceMask(heights[column]++, column);
+            discs.push_back(players[player]);
+        }
+    }
+
+    std::vector<Board> boards(gameCount, Board("opponent"));
+    measurements.push_back(measure("register_move", moves.size(), [&]() {
+        for (size_t game = 0, move = 0; game < gameEnds.size(); game++) {
+            auto &board = boards[game];
+            for (auto opponentMove = false; move < gameEnds[game]; move++, opponentMove = !opponentMove) {
+                sink = sink + board.registerMove(moves[move], opponentMove);
+            }
+        }
+    }));
+
+    // The checkWinOn*Line() routines are private, and consist of a line check in one direction.
+    const std::pair<const char*, unsigned int> directions[] = {
+            {"check_win_vertical",       Geometry::VERTICAL},
+            {"check_win_horizontal",     Geometry::HORIZONTAL},
+            {"check_win_left_diagonal",  Geometry::LEFT_DIAGONAL},
+            {"check_win_right_diagonal", Geometry::RIGHT_DIAGONAL}
+    };
+
+    for (const auto &direction : directions) {
+        measurements.push_back(measure(direction.first, discs.size(), [&]() {
+            uint64_t lines = 0;
+            for (auto playerDiscs : discs) {
+                lines += Geometry::hasLine(playerDiscs, direction.second);
+            }
+            sink = sink + lines;
+        }));
+    }
+
+    measurements.push_back(measure("check_win_per_move", discs.size(), [&]() {
+        uint64_t lines = 0;
+        for (auto playerDiscs : discs) {
+            lines += Geometry::hasLine(playerDiscs);
+        }
+        sink = sink + lines;
+    }));
+
+    /*
+     * isValidMove() is private: a rejected move executes only the validity check.
+     * The board has a full first column, and the moves alternate between it and a missing column.
+     */
+    Board fullColumnBoard("opponent");
+    for (auto i = 0u; i < fourinarow::ROWS; i++) {
+        fullColumnBoard.registerMove(0, i % 2 == 1);
+    }
+
+    const uint64_t validityChecks = static_cast<uint64_t>(gameCount)*fourinarow::COLUMNS;
+    measurements.push_back(measure("is_valid_move", validityChecks, [&]() {
+        uint64_t accepted = 0;
+        for (uint64_t i = 0; i < validityChecks; i++) {
+            accepted += fullColumnBoard.registerMove(i % 2 == 0 ? 0 : fourinarow::COLUMNS, false);
+        }
+        sink = sink + accepted;
+    }));
+
+    measurements.push_back(measure("full_game", gameCount, [&]() {
+        for (size_t game = 0, move = 0; game < gameEnds.size(); game++) {
+            Board board("opponent");
+            for (auto opponentMove = false; move < gameEnds[game]; move++, opponentMove = !opponentMove) {
+                board.registerMove(moves[move], opponentMove);
+            }
+            sink = sink + static_cast<uint64_t>(board.getResult());
+        }
+    }));
+
+    measurements.push_back(measure("to_string", gameCount, [&]() {
+        for (const auto &board : boards) {
+            sink = sink + board.toString().size();
+        }
+    }));
+
+    std::cout << "Played " << gameCount << " random games, " << moves.size() << " moves" << std::endl;
+    for (const auto &measurement : measurements) {
+        std::cout << measurement.name << ": " << measurement.nanosecondsPerOperation() << " ns/op, "
+                  << measurement.operationsPerSecond() << " op/s, "
+                  << measurement.allocationsPerOperation() << " allocations/op" << std::endl;
+    }
+
+    if (!output.empty()) {
+        if (!writeJson(output, gameCount, seed, moves.size(), measurements)) {
+            std::cerr << "Impossible to write the results to " << output << std::endl;
+            return 1;
+        }
+        std::cout << "Results written to " << output << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,595 @@
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <future>
+#include <mutex>
+#include <streambuf>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <CertificateStore.h>
+#include <Constants.h>
+#include <DelegatedKey.h>
+#include <DigitalSignature.h>
+#include <Player.h>
+#include <ClientSession.h>
+#include <SessionListener.h>
+#include <SessionLoop.h>
+#include <SessionTicketKey.h>
+#include <TcpSocket.h>
+#include <TcpSocketHasher.h>
+#include <Utils.h>
+#include <AvailableClientHandler.h>
+#include <ConnectedClientHandler.h>
+#include <HandshakeClientHandler.h>
+#include "Measurement.h"
+#include "TemporaryKeyPair.h"
+
+using Clock = std::chrono::steady_clock;
+using PlayerList = std::unordered_map<fourinarow::TcpSocket, fourinarow::Player, fourinarow::TcpSocketHasher>;
+using PlayerRemovalList = std::unordered_set<std::string>;
+
+/**
+ * CPU times of a handshake, in microseconds. Each party measures its own thread; the server also samples
+ * the CPU clock of the client thread whenever a client message becomes readable. At that moment the client
+ * is blocked waiting for the response, so that the samples split the CPU time of the client into phases
+ * regardless of how the threads are scheduled. In a resumed handshake, the CLIENT_HELLO and the END_HANDSHAKE
+ * are replaced by the RESUME_HELLO and the END_RESUME.
+ */
+struct HandshakeSample {
+    double clientStart = 0;             // Client clock, before the CLIENT_HELLO.
+    double clientAtClientHello = 0;     // Client clock, when the server can read the CLIENT_HELLO.
+    double clientAtEndHandshake = 0;    // Client clock, when the server can read the END_HANDSHAKE.
+    double clientEnd = 0;               // Client clock, after the PLAYER_LIST has been decrypted.
+    double serverHello = 0;             // Server CPU time spent handling the CLIENT_HELLO.
+    double serverFinish = 0;            // Server CPU time spent handling the END_HANDSHAKE.
+    double latency = 0;                 // Wall-clock duration of the handshake, as seen by the client.
+    bool failed = false;
+};
+
+/**
+ * Durations of a phase of the handshake, or of the whole handshake. The durations are kept sorted.
+ */
+struct Phase {
+    std::string name;
+    std::string description;
+    std::vector<double> durations;  // In microseconds.
+
+    double mean() const {
+        double total = 0;
+        for (auto duration : durations) {
+            total += duration;
+        }
+        return durations.empty() ? 0 : total/durations.size();
+    }
+
+    double quantile(double q) const {
+        return ::quantile(durations, q);
+    }
+};
+
+/**
+ * Queue handing the client sockets from the server thread to the client thread.
+ * A null socket signals a socket pair that could not be created.
+ */
+class SocketQueue {
+    private:
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::deque<std::unique_ptr<fourinarow::TcpSocket>> sockets;
+    public:
+        void push(std::unique_ptr<fourinarow::TcpSocket> socket) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                sockets.push_back(std::move(socket));
+            }
+            condition.notify_one();
+        }
+
+        std::unique_ptr<fourinarow::TcpSocket> pop() {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this]() { return !sockets.empty(); });
+            auto socket = std::move(sockets.front());
+            sockets.pop_front();
+            return socket;
+        }
+};
+
+/**
+ * Stream buffer discarding everything written to it.
+ */
+class NullBuffer : public std::streambuf {
+    protected:
+        int overflow(int character) override {
+            return character;
+        }
+};
+
+double cpuMicroseconds(clockid_t clock) {
+    timespec time{};
+    clock_gettime(clock, &time);
+    return time.tv_sec*1e6 + time.tv_nsec/1e3;
+}
+
+double processCpuSeconds() {
+    timespec time{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+    return time.tv_sec + time.tv_nsec/1e9;
+}
+
+/**
+ * Waits until the given descriptor can be read, as the server does before choosing a handler.
+ */
+void waitReadable(int descriptor) {
+    pollfd request{descriptor, POLLIN, 0};
+    while (poll(&request, 1, -1) == -1 && errno == EINTR);
+}
+
+/**
+ * Server side of a pair: creates a socket pair for each handshake, hands the client socket to the
+ * client thread and runs the handlers of the server on its end, as the server does for a new client.
+ * When resuming, a first handshake, not measured, is performed to obtain the first ticket,
+ * and a ticket is issued at the end of each handshake for the following one.
+ * With a certificate cache, a first handshake, not measured, lets the client cache the certificate.
+ * @param handshakes        the number of handshakes.
+ * @param resume            true if the handshakes resume the previous session, false otherwise.
+ * @param cached            true if the client caches the certificate of the server, false otherwise.
+ * @param username          the username of the client.
+ * @param playerCount       the number of available players listed in the <code>PLAYER_LIST</code>.
+ * @param certificate       the certificate of the server.
+ * @param digitalSignature  the digital signature tool of the server.
+ * @param delegatedKeys     the delegated keys of the server, empty to sign with the key of the certificate.
+ * @param ticketKey         the key used to issue and redeem the session tickets.
+ * @param clientClock       the CPU clock of the client thread, available once the client thread has started.
+ * @param queue             the queue of the client sockets.
+ * @param samples           the samples of the handshakes, filled with the measurements of the server.
+ */
+void runServer(unsigned int handshakes, bool resume, bool cached, const std::string &username, unsigned int playerCount,
+               const std::vector<unsigned char> &certificate, const fourinarow::DigitalSignature &digitalSignature,
+               const std::vector<fourinarow::DelegatedKey> &delegatedKeys, const fourinarow::SessionTicketKey &ticketKey,
+               std::shared_future<clockid_t> clientClock,
+               SocketQueue &queue, std::vector<HandshakeSample> &samples) {
+    PlayerList playerList; // Used only by the challenges: it can be left empty.
+    fourinarow::PlayerStatusList statusList;
+    std::vector<std::unique_ptr<fourinarow::PeerLink>> peers; // A single server process.
+    fourinarow::RatingTable ratingTable; // Used only by the quick matches, like the queue.
+    fourinarow::QuickMatchQueue matchQueue(fourinarow::QUICK_MATCH_BUCKET_WIDTH,
+                                           fourinarow::QUICK_MATCH_WIDENING_PERIOD*1000);
+    for (auto i = 0u; i < playerCount; i++) {
+        statusList.add("player" + std::to_string(1000 + i), "127.0.0.1", fourinarow::Player::Status::AVAILABLE);
+    }
+
+    HandshakeSample warmUp;
+    auto warmUpCount = resume || cached ? 1u : 0u;
+    for (auto i = 0u; i < handshakes + warmUpCount; i++) {
+        auto &sample = i < warmUpCount ? warmUp : samples[i - warmUpCount];
+        std::unique_ptr<std::pair<fourinarow::TcpSocket, fourinarow::TcpSocket>> sockets;
+        try {
+            sockets = std::make_unique<std::pair<fourinarow::TcpSocket, fourinarow::TcpSocket>>(
+                    fourinarow::TcpSocket::createPair());
+        } catch (const std::exception &exception) {
+            // The client is told to skip the handshake.
+            sample.failed = true;
+            queue.push(nullptr);
+            continue;
+        }
+
+        auto &socket = sockets->first;
+        fourinarow::Player player;
+        PlayerRemovalList removalList;
+        queue.push(std::make_unique<fourinarow::TcpSocket>(std::move(sockets->second)));
+
+        waitReadable(socket.getDescriptor());
+        sample.clientAtClientHello = cpuMicroseconds(clientClock.get());
+        auto start = cpuMicroseconds(CLOCK_THREAD_CPUTIME_ID);
+        fourinarow::ConnectedClientHandler::handle(socket, player, statusList, removalList, certificate, digitalSignature,
+                                                   delegatedKeys, ticketKey);
+        sample.serverHello = cpuMicroseconds(CLOCK_THREAD_CPUTIME_ID) - start;
+
+        if (removalList.empty()) {
+            waitReadable(socket.getDescriptor());
+            sample.clientAtEndHandshake = cpuMicroseconds(clientClock.get());
+            start = cpuMicroseconds(CLOCK_THREAD_CPUTIME_ID);
+            fourinarow::HandshakeClientHandler::handle(socket, player, statusList, removalList);
+            sample.serverFinish = cpuMicroseconds(CLOCK_THREAD_CPUTIME_ID) - start;
+        }
+
+        // The REQ_TICKET is not part of the handshake: it is not measured.
+        if (resume && removalList.empty()) {
+            waitReadable(socket.getDescriptor());
+            fourinarow::AvailableClientHandler::handle(socket, player, playerList, statusList, peers, removalList, ticketKey,
+                                                       matchQueue, ratingTable);
+        }
+
+        if (!removalList.empty()) {
+            sample.failed = true;
+        }
+
+        // The client disconnects: its username can be used again.
+        statusList.erase(username);
+    }
+}
+
+/**
+ * Client side of a pair: performs a handshake with the client handler on each client socket received.
+ * When resuming, each handshake but the first, not measured, resumes the previous session.
+ * With a certificate cache, each handshake but the first, not measured, reuses the certificate of the server
+ * verified by the previous one.
+ * @param handshakes        the number of handshakes.
+ * @param resume            true if the handshakes resume the previous session, false otherwise.
+ * @param cached            true if the client caches the certificate of the server, false otherwise.
+ * @param username          the username of the client.
+ * @param certificateStore  the store verifying the certificate of the server.
+ * @param digitalSignature  the digital signature tool of the client.
+ * @param clock             the promise of the CPU clock of the thread, fulfilled before the first handshake.
+ * @param queue             the queue of the client sockets.
+ * @param samples           the samples of the handshakes, filled with the measurements of the client.
+ */
+void runClient(unsigned int handshakes, bool resume, bool cached, const std::string &username,
+               const fourinarow::CertificateStore &certificateStore, const fourinarow::DigitalSignature &digitalSignature,
+               std::promise<clockid_t> &clock, SocketQueue &queue, std::vector<HandshakeSample> &samples) {
+    clockid_t threadClock;
+    pthread_getcpuclockid(pthread_self(), &threadClock);
+    clock.set_value(threadClock);
+
+    HandshakeSample warmUp;
+    auto warmUpCount = resume || cached ? 1u : 0u;
+    fourinarow::SessionListener listener; // The steps are waited for by polling the state of the session.
+    fourinarow::SessionLoop loop;
+    std::unique_ptr<fourinarow::ClientSession> session;
+
+    for (auto i = 0u; i < handshakes + warmUpCount; i++) {
+        auto socket = queue.pop();
+        if (!socket) {
+            continue;
+        }
+
+        // The session keeps the ticket and the certificate of the server: a full handshake without cache uses a new one.
+        if (!session || (!cached && !session->hasSessionTicket())) {
+            session = std::make_unique<fourinarow::ClientSession>(username, digitalSignature, certificateStore, listener);
+        }
+
+        auto &sample = i < warmUpCount ? warmUp : samples[i - warmUpCount];
+        auto start = Clock::now();
+        sample.clientStart = cpuMicroseconds(CLOCK_THREAD_CPUTIME_ID);
+
+        try {
+            session->connect(std::move(socket));
+            loop.add(*session);
+            while (session->getState() == fourinarow::ClientSession::State::HANDSHAKE) {
+                loop.runOnce(fourinarow::CLIENT_PROTOCOL_TIMEOUT);
+            }
+        } catch (const std::exception &exception) {
+            session->close();
+        }
+
+        sample.clientEnd = cpuMicroseconds(CLOCK_THREAD_CPUTIME_ID);
+        sample.latency = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        sample.failed = session->getState() != fourinarow::ClientSession::State::AVAILABLE;
+
+        // Without a ticket, the next handshake is a full one.
+        if (resume && !sample.failed) {
+            session->requestSessionTicket();
+            while (session->getState() == fourinarow::ClientSession::State::AVAILABLE && !session->hasSessionTicket()) {
+                loop.runOnce(fourinarow::CLIENT_PROTOCOL_TIMEOUT);
+            }
+        }
+
+        session->close();
+    }
+}
+
+/**
+ * Prints a help message describing how to invoke the program from the command line.
+ */
+void printHelp() {
+    std::string helpMessage("Usage: handshake-benchmark [-h] [-n HANDSHAKES] [-p PAIRS] [-l PLAYERS] [-m MODE] [-s SCHEME]\n"
+                            "                           [-o OUTPUT]\n"
+                            "\n"
+                            "Options:\n"
+                            " -h, --help              Show this help message and exit\n"
+                            " -n, --handshakes COUNT  The number of handshakes of each pair (default: 200)\n"
+                            " -p, --pairs      PAIRS  The number of client-server pairs running concurrently (default: 1)\n"
+                            " -l, --players    COUNT  The number of available players in the PLAYER_LIST (default: 100)\n"
+                            " -m, --mode       MODE   Either 'full', 'cached' or 'resume'. In cached mode, the full handshakes\n"
+                            "                         reuse the certificate of the server cached by the previous one. In resume\n"
+                            "                         mode, the handshakes resume the previous session with a session ticket\n"
+                            "                         (default: full)\n"
+                            " -s, --scheme     SCHEME Either 'rsa', 'ecdsa' or 'ed25519': the signature scheme of the server,\n"
+                            "                         using a delegated credential if not 'rsa', and of the client (default: rsa)\n"
+                            " -o, --output     OUTPUT The path of the JSON file that will store the results\n"
+                            "\n"
+                            "The private key of the server is read from ./certificate and its password is asked at runtime.");
+    std::cout << helpMessage << std::endl;
+}
+
+/**
+ * Parses the arguments passed via command line. All the options are optional,
+ * but each given option must be followed by a value.
+ * @param argc        the number of arguments passed via command line.
+ * @param argv        the arguments passed via command line.
+ * @param handshakes  a reference to the variable that will store the number of handshakes of each pair.
+ * @param pairs       a reference to the variable that will store the number of pairs.
+ * @param players     a reference to the variable that will store the number of listed players.
+ * @param mode        a reference to the variable that will store the mode of the handshakes.
+ * @param scheme      a reference to the variable that will store the signature scheme.
+ * @param output      a reference to the variable that will store the path of the JSON file.
+ * @return            true if the arguments are valid, false otherwise.
+ */
+bool parseArguments(int argc, char *argv[], unsigned int &handshakes, unsigned int &pairs,
+                    unsigned int &players, std::string &mode, uint8_t &scheme, std::string &output) {
+    if (argc % 2 != 1) {
+        printHelp();
+        return false;
+    }
+
+    try {
+        for (auto i = 1; i < argc; i += 2) {
+            std::string arg(argv[i]);
+
+            if (arg == "-n" || arg == "--handshakes") {
+                handshakes = std::stoul(argv[i + 1]);
+            } else if (arg == "-p" || arg == "--pairs") {
+                pairs = std::stoul(argv[i + 1]);
+            } else if (arg == "-l" || arg == "--players") {
+                players = std::stoul(argv[i + 1]);
+            } else if (arg == "-m" || arg == "--mode") {
+                mode = argv[i + 1];
+                if (mode != "full" && mode != "cached" && mode != "resume") {
+                    printHelp();
+                    return false;
+                }
+            } else if (arg == "-s" || arg == "--scheme") {
+                std::string name(argv[i + 1]);
+                if (name == "rsa") {
+                    scheme = fourinarow::SIGNATURE_RSA_PKCS1_SHA256;
+                } else if (name == "ecdsa") {
+                    scheme = fourinarow::SIGNATURE_ECDSA_P256_SHA256;
+                } else if (name == "ed25519") {
+                    scheme = fourinarow::SIGNATURE_ED25519;
+                } else {
+                    printHelp();
+                    return false;
+                }
+            } else if (arg == "-o" || arg == "--output") {
+                output = argv[i + 1];
+            } else {
+                printHelp();
+                return false;
+            }
+        }
+    } catch (const std::exception &exception) {
+        printHelp();
+        return false;
+    }
+
+    if (handshakes == 0 || pairs == 0) {
+        printHelp();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Writes the results to a JSON file.
+ * @param path                    the path of the file.
+ * @param handshakes              the number of successful handshakes.
+ * @param pairs                   the number of pairs.
+ * @param mode                    the mode of the handshakes.
+ * @param scheme                  the signature scheme.
+ * @param handshakesPerSecond     the measured throughput.
+ * @param handshakesPerCpuSecond  the handshakes per second of CPU time, client and server together.
+ * @param serverPerCpuSecond      the handshakes per second of CPU time of the server alone.
+ * @param phases                  the phases of the handshake.
+ * @return                        true if the file has been written, false otherwise.
+ */
+bool writeJson(const std::string &path, unsigned int handshakes, unsigned int pairs, const std::string &mode, uint8_t scheme,
+               double handshakesPerSecond,
+               double handshakesPerCpuSecond, double serverPerCpuSecond, const std::vector<Phase> &phases) {
+    std::ofstream file(path);
+    file.precision(6);
+    file << std::fixed;
+    file << "{\n";
+    file << "  \"benchmark\": \"handshake\",\n";
+    file << "  \"handshakes\": " << handshakes << ",\n";
+    file << "  \"pairs\": " << pairs << ",\n";
+    file << "  \"mode\": \"" << mode << "\",\n";
+    file << "  \"scheme\": \"" << fourinarow::convertSignatureScheme(scheme) << "\",\n";
+    file << "  \"handshakes_per_second\": " << handshakesPerSecond << ",\n";
+    file << "  \"handshakes_per_cpu_second\": " << handshakesPerCpuSecond << ",\n";
+    file << "  \"server_handshakes_per_cpu_second\": " << serverPerCpuSecond << ",\n";
+    file << "  \"phases\": [\n";
+
+    for (size_t i = 0; i < phases.size(); i++) {
+        const auto &phase = phases[i];
+        file << "    {\"name\": \"" << phase.name << "\", ";
+        file << "\"mean_us\": " << phase.mean() << ", ";
+        file << "\"p50_us\": " << phase.quantile(0.5) << ", ";
+        file << "\"p99_us\": " << phase.quantile(0.99) << "}";
+        file << (i + 1 < phases.size() ? ",\n" : "\n");
+    }
+
+    file << "  ]\n";
+    file << "}\n";
+    return static_cast<bool>(file);
+}
+
+int main(int argc, char *argv[]) {
+    auto handshakeCount = 200u;
+    auto pairCount = 1u;
+    auto playerCount = 100u;
+    std::string mode("full");
+    auto scheme = fourinarow::SIGNATURE_RSA_PKCS1_SHA256;
+    std::string output;
+
+    if (!parseArguments(argc, argv, handshakeCount, pairCount, playerCount, mode, scheme, output)) {
+        return 1;
+    }
+
+    auto resume = (mode == "resume");
+    auto cached = (mode == "cached");
+
+    try {
+        auto certificate = fourinarow::CertificateStore::serializeCertificate(
+                fourinarow::SERVER_CERTIFICATE_FOLDER + "4InARow_cert.pem");
+        fourinarow::DigitalSignature serverSignature(fourinarow::SERVER_CERTIFICATE_FOLDER + "4InARow_privkey.pem");
+        fourinarow::SessionTicketKey ticketKey;
+
+        // The client offers all the delegated schemes: the server holds only the key of the chosen one, if any.
+        std::vector<fourinarow::DelegatedKey> delegatedKeys;
+        if (scheme != fourinarow::SIGNATURE_RSA_PKCS1_SHA256) {
+            delegatedKeys.emplace_back(serverSignature, scheme, fourinarow::SERVER_DELEGATED_CREDENTIAL_LIFETIME);
+        }
+
+        fourinarow::CertificateStore certificateStore;
+        certificateStore.addCertificate(fourinarow::CLIENT_CERTIFICATES_FOLDER + "UnipiCA_cert.pem");
+        certificateStore.addCertificateRevocationList(fourinarow::CLIENT_CERTIFICATES_FOLDER + "UnipiCA_crl.pem");
+
+        // The clients share a key pair, registered in the players folder under the username of each pair.
+        mkdir(fourinarow::SERVER_PLAYERS_FOLDER.c_str(), 0755);
+        std::vector<std::string> usernames;
+        for (auto i = 0u; i < pairCount; i++) {
+            usernames.push_back("benchmark" + std::to_string(i));
+        }
+
+        TemporaryKeyPair keyPair(fourinarow::SERVER_PLAYERS_FOLDER + usernames[0] + fourinarow::SERVER_PLAYER_KEY_SUFFIX,
+                                 scheme);
+        fourinarow::DigitalSignature clientSignature(keyPair.getPrivateKeyPath());
+
+        for (auto i = 1u; i < pairCount; i++) {
+            std::ifstream source(keyPair.getPublicKeyPath());
+            std::ofstream destination(fourinarow::SERVER_PLAYERS_FOLDER + usernames[i] + fourinarow::SERVER_PLAYER_KEY_SUFFIX);
+            destination << source.rdbuf();
+        }
+
+        // The handlers log every message: the output is discarded while running.
+        NullBuffer discarded;
+        auto coutBuffer = std::cout.rdbuf(&discarded);
+        auto cerrBuffer = std::cerr.rdbuf(&discarded);
+
+        std::vector<std::vector<HandshakeSample>> samples(pairCount, std::vector<HandshakeSample>(handshakeCount));
+        std::vector<std::promise<clockid_t>> clientClocks(pairCount);
+        std::vector<SocketQueue> queues(pairCount);
+        std::vector<std::thread> threads;
+
+        auto cpuStart = processCpuSeconds();
+        auto start = Clock::now();
+        for (auto i = 0u; i < pairCount; i++) {
+            threads.emplace_back(runServer, handshakeCount, resume, cached, std::cref(usernames[i]), playerCount,
+                                 std::cref(certificate), std::cref(serverSignature), std::cref(delegatedKeys),
+                                 std::cref(ticketKey),
+                                 clientClocks[i].get_future().share(), std::ref(queues[i]), std::ref(samples[i]));
+            threads.emplace_back(runClient, handshakeCount, resume, cached, std::cref(usernames[i]), std::cref(certificateStore),
+                                 std::cref(clientSignature), std::ref(clientClocks[i]),
+                                 std::ref(queues[i]), std::ref(samples[i]));
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        auto cpuSeconds = processCpuSeconds() - cpuStart;
+
+        std::cout.rdbuf(coutBuffer);
+        std::cerr.rdbuf(cerrBuffer);
+
+        for (auto i = 1u; i < pairCount; i++) {
+            std::remove((fourinarow::SERVER_PLAYERS_FOLDER + usernames[i] + fourinarow::SERVER_PLAYER_KEY_SUFFIX).c_str());
+        }
+
+        // All the phases are measured in CPU time, except the latency.
+        std::vector<Phase> phases = resume ? std::vector<Phase>{
+                {"client_hello", "client: RESUME_HELLO", {}},
+                {"server_hello", "server: ticket redemption, key derivation, RESUME_ACCEPTED", {}},
+                {"client_end_handshake", "client: key derivation, END_RESUME", {}},
+                {"server_finish", "server: END_RESUME decryption, PLAYER_LIST", {}},
+                {"client_finish", "client: PLAYER_LIST decryption", {}},
+                {"server_total", "server: whole handshake", {}},
+                {"client_total", "client: whole handshake", {}},
+                {"latency", "wall-clock duration of the handshake", {}}
+        } : std::vector<Phase>{
+                {"client_hello", "client: CLIENT_HELLO", {}},
+                {"server_hello", "server: ECDH key pair, signature, SERVER_HELLO", {}},
+                {"client_end_handshake", "client: certificate, credential and signature verification, ECDH key pair, signature", {}},
+                {"server_finish", "server: signature verification, key derivation, PLAYER_LIST", {}},
+                {"client_finish", "client: key derivation, PLAYER_LIST decryption", {}},
+                {"server_total", "server: whole handshake", {}},
+                {"client_total", "client: whole handshake", {}},
+                {"latency", "wall-clock duration of the handshake", {}}
+        };
+
+        unsigned int failures = 0;
+        for (const auto &pairSamples : samples) {
+            for (const auto &sample : pairSamples) {
+                if (sample.failed) {
+                    failures++;
+                    continue;
+                }
+
+                phases[0].durations.push_back(sample.clientAtClientHello - sample.clientStart);
+                phases[1].durations.push_back(sample.serverHello);
+                phases[2].durations.push_back(sample.clientAtEndHandshake - sample.clientAtClientHello);
+                phases[3].durations.push_back(sample.serverFinish);
+                phases[4].durations.push_back(sample.clientEnd - sample.clientAtEndHandshake);
+                phases[5].durations.push_back(sample.serverHello + sample.serverFinish);
+                phases[6].durations.push_back(sample.clientEnd - sample.clientStart);
+                phases[7].durations.push_back(sample.latency);
+            }
+        }
+
+        for (auto &phase : phases) {
+            std::sort(phase.durations.begin(), phase.durations.end());
+        }
+
+        if (failures != 0) {
+            std::cerr << failures << " handshakes failed, and are excluded from the results" << std::endl;
+            if (failures == pairCount*handshakeCount) {
+                return 1;
+            }
+        }
+
+        auto successful = pairCount*handshakeCount - failures;
+        auto handshakesPerSecond = successful/seconds;
+        auto handshakesPerCpuSecond = cpuSeconds > 0 ? successful/cpuSeconds : 0;
+        auto serverCpu = phases[5].mean();
+        auto serverPerCpuSecond = serverCpu > 0 ? 1e6/serverCpu : 0;
+
+        std::cout << "Performed " << successful << (resume ? " resumed" : cached ? " cached-certificate" : "") << " handshakes with " << pairCount << " pairs in " << seconds
+                  << " s: " << handshakesPerSecond << " handshakes/s, signed with "
+                  << fourinarow::convertSignatureScheme(scheme) << std::endl;
+        std::cout << "Per core: " << handshakesPerCpuSecond << " handshakes/s (client and server), "
+                  << serverPerCpuSecond << " handshakes/s (server only)" << std::endl;
+        for (const auto &phase : phases) {
+            std::cout << phase.name << " (" << phase.description << "): mean " << phase.mean() << " us, p50 "
+                      << phase.quantile(0.5) << " us, p99 " << phase.quantile(0.99) << " us" << std::endl;
+        }
+
+        if (!output.empty()) {
+            if (!writeJson(output, successful, pairCount, mode, scheme, handshakesPerSecond, handshakesPerCpuSecond,
+                           serverPerCpuSecond, phases)) {
+                std::cerr << "Impossible to write the results to " << output << std::endl;
+                return 1;
+            }
+            std::cout << "Results written to " << output << std::endl;
+        }
+    } catch (const std::exception &exception) {
+        std::cerr << "The benchmark failed. " << exception.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
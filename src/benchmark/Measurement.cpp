@@ -0,0 +1,21 @@
+#include "Measurement.h"
+
+double Measurement::nanosecondsPerOperation() const {
+    return operations == 0 ? 0 : seconds*1e9/operations;
+}
+
+double Measurement::operationsPerSecond() const {
+    return seconds > 0 ? operations/seconds : 0;
+}
+
+double Measurement::allocationsPerOperation() const {
+    return operations == 0 ? 0 : static_cast<double>(allocations)/operations;
+}
+
+double Measurement::meanLatency() const {
+    return operations == 0 ? 0 : seconds*1e6/operations;
+}
+
+double Measurement::quantile(double q) const {
+    return ::quantile(latencies, q);
+}
@@ -0,0 +1,99 @@
+#ifndef INC_4INAROW_MEASUREMENT_H
+#define INC_4INAROW_MEASUREMENT_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "AllocationCounter.h"
+
+/**
+ * Returns the sample at the given quantile.
+ * @param samples  the samples, sorted in ascending order.
+ * @param q        the quantile, between 0 and 1.
+ * @return         the sample at the quantile, or zero if there are no samples.
+ */
+template<typename Sample>
+Sample quantile(const std::vector<Sample> &samples, double q) {
+    return samples.empty() ? Sample() : samples[static_cast<size_t>(q*(samples.size() - 1))];
+}
+
+/**
+ * Result of a measured piece of code, executing a number of identical operations.
+ */
+struct Measurement {
+    std::string name;
+    uint64_t operations;
+    double seconds;
+    uint64_t allocations;
+    std::vector<double> latencies;  // In microseconds, sorted. Empty if the operations are timed together.
+
+    double nanosecondsPerOperation() const;
+    double operationsPerSecond() const;
+    double allocationsPerOperation() const;
+
+    /**
+     * Returns the mean latency of an operation, in microseconds.
+     */
+    double meanLatency() const;
+
+    /**
+     * Returns the latency at the given quantile, in microseconds, or zero if the operations are timed together.
+     */
+    double quantile(double q) const;
+};
+
+/**
+ * Runs a piece of code once, measuring its duration and the allocations it performs.
+ * @param name        the name of the measurement.
+ * @param operations  the number of operations executed by the code.
+ * @param function    the code to measure.
+ * @return            the measurement.
+ */
+template<typename Function>
+Measurement measure(const std::string &name, uint64_t operations, Function function) {
+    auto allocations = AllocationCounter::count();
+    auto start = std::chrono::steady_clock::now();
+    function();
+    auto end = std::chrono::steady_clock::now();
+    allocations = AllocationCounter::count() - allocations;
+    return Measurement{name, operations, std::chrono::duration<double>(end - start).count(), allocations, {}};
+}
+
+/**
+ * Runs a piece of code the given number of times, measuring the latency of each execution and
+ * the allocations performed. The preparation of each execution is neither timed nor counted.
+ * @param name        the name of the measurement.
+ * @param operations  the number of executions.
+ * @param prepare     the code preparing an execution, receiving its index.
+ * @param function    the code to measure, receiving the index of the execution.
+ * @return            the measurement.
+ */
+template<typename Prepare, typename Function>
+Measurement measureEach(const std::string &name, unsigned int operations, Prepare prepare, Function function) {
+    Measurement measurement{name, operations, 0, 0, {}};
+    measurement.latencies.reserve(operations);
+
+    for (auto i = 0u; i < operations; i++) {
+        prepare(i);
+
+        auto allocations = AllocationCounter::count();
+        auto start = std::chrono::steady_clock::now();
+        function(i);
+        auto end = std::chrono::steady_clock::now();
+        measurement.allocations += AllocationCounter::count() - allocations;
+        measurement.latencies.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+        measurement.seconds += std::chrono::duration<double>(end - start).count();
+    }
+
+    std::sort(measurement.latencies.begin(), measurement.latencies.end());
+    return measurement;
+}
+
+template<typename Function>
+Measurement measureEach(const std::string &name, unsigned int operations, Function function) {
+    return measureEach(name, operations, [](unsigned int) {}, function);
+}
+
+#endif //INC_4INAROW_MEASUREMENT_H
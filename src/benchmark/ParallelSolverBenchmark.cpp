@@ -0,0 +1,127 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <ParallelSolver.h>
+#include <Position.h>
+#include "PositionGenerator.h"
+
+/**
+ * Prints a help message describing how to invoke the program from the command line.
+ */
+void printHelp() {
+    std::string helpMessage("Usage: parallel-solver-benchmark [-h] [-p POSITIONS] [-m MOVES] [-s SEED] [-t THREADS]\n"
+                            "\n"
+                            "Options:\n"
+                            " -h, --help                Show this help message and exit\n"
+                            " -p, --positions POSITIONS The number of positions to solve (default: 20)\n"
+                            " -m, --moves     MOVES     The number of discs on the board of each position (default: 12)\n"
+                            " -s, --seed      SEED      The seed used to generate the positions (default: 1)\n"
+                            " -t, --threads   THREADS   The maximum number of threads (default: 8)");
+    std::cout << helpMessage << std::endl;
+}
+
+/**
+ * Parses the arguments passed via command line. All the options are optional,
+ * but each given option must be followed by a numeric value.
+ * @param argc        the number of arguments passed via command line.
+ * @param argv        the arguments passed via command line.
+ * @param positions   a reference to the variable that will store the number of positions.
+ * @param moves       a reference to the variable that will store the number of discs of each position.
+ * @param seed        a reference to the variable that will store the seed.
+ * @param maxThreads  a reference to the variable that will store the maximum number of threads.
+ * @return            true if the arguments are valid, false otherwise.
+ */
+bool parseArguments(int argc, char *argv[], unsigned int &positions, unsigned int &moves, unsigned long &seed,
+                    unsigned int &maxThreads) {
+    if (argc % 2 != 1) {
+        printHelp();
+        return false;
+    }
+
+    try {
+        for (auto i = 1; i < argc; i += 2) {
+            std::string arg(argv[i]);
+
+            if (arg == "-p" || arg == "--positions") {
+                positions = std::stoul(argv[i + 1]);
+            } else if (arg == "-m" || arg == "--moves") {
+                moves = std::stoul(argv[i + 1]);
+            } else if (arg == "-s" || arg == "--seed") {
+                seed = std::stoul(argv[i + 1]);
+            } else if (arg == "-t" || arg == "--threads") {
+                maxThreads = std::stoul(argv[i + 1]);
+            } else {
+                printHelp();
+                return false;
+            }
+        }
+    } catch (const std::exception &exception) {
+        printHelp();
+        return false;
+    }
+
+    if (moves >= fourinarow::Position::Geometry::SPACES) {
+        std::cerr << "The number of discs must be lower than " << fourinarow::Position::Geometry::SPACES << std::endl;
+        return false;
+    }
+
+    if (maxThreads == 0) {
+        printHelp();
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    auto positionCount = 20u;
+    auto moves = 12u;
+    auto seed = 1ul;
+    auto maxThreads = 8u;
+
+    if (!parseArguments(argc, argv, positionCount, moves, seed, maxThreads)) {
+        return 1;
+    }
+
+    std::mt19937_64 generator(seed);
+    auto positions = generatePositions(positionCount, moves, generator);
+    std::vector<int> referenceScores;
+    auto referenceTime = 0.0;
+
+    std::cout << "Solving " << positions.size() << " positions with " << moves << " discs" << std::endl;
+    std::cout << "Threads    Time (ms)     Speedup    Nodes/s" << std::endl;
+
+    // Each run uses a new solver, so that it does not reuse the transposition table filled by the previous ones.
+    for (auto threads = 1u; threads <= maxThreads; threads *= 2) {
+        fourinarow::ParallelSolver solver(threads);
+        std::vector<int> scores;
+        uint64_t nodes = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (const auto &position : positions) {
+            auto evaluation = solver.solve(position);
+            scores.push_back(evaluation.lowerBound);
+            nodes += evaluation.nodes;
+        }
+        auto end = std::chrono::steady_clock::now();
+        auto time = std::chrono::duration<double, std::milli>(end - start).count();
+
+        if (threads == 1) {
+            referenceScores = scores;
+            referenceTime = time;
+        } else if (scores != referenceScores) {
+            std::cerr << "The scores found with " << threads << " threads differ from the sequential ones" << std::endl;
+            return 1;
+        }
+
+        std::cout << std::left << std::setw(11) << threads
+                  << std::setw(14) << std::fixed << std::setprecision(1) << time
+                  << std::setw(11) << std::setprecision(2) << (time > 0 ? referenceTime/time : 0)
+                  << std::setprecision(0) << (time > 0 ? nodes/(time/1000) : 0) << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,31 @@
+#include "PositionGenerator.h"
+
+std::vector<fourinarow::Position> generatePositions(unsigned int count, unsigned int moves, std::mt19937_64 &generator) {
+    std::vector<fourinarow::Position> positions;
+
+    while (positions.size() < count) {
+        fourinarow::Position position;
+
+        while (position.getMoves() < moves && !position.canWinNext()) {
+            auto next = position.possibleNonLosingMoves();
+            if (next == 0) {
+                break;
+            }
+
+            std::vector<fourinarow::Position::Bitboard> candidates;
+            for (auto i = 0; i < fourinarow::COLUMNS; i++) {
+                auto move = next & fourinarow::Position::Geometry::columnMask(i);
+                if (move) {
+                    candidates.push_back(move);
+                }
+            }
+            position.play(candidates[generator() % candidates.size()]);
+        }
+
+        if (position.getMoves() == moves && !position.canWinNext() && position.possibleNonLosingMoves() != 0) {
+            positions.push_back(position);
+        }
+    }
+
+    return positions;
+}
@@ -0,0 +1,19 @@
+#ifndef INC_4INAROW_POSITIONGENERATOR_H
+#define INC_4INAROW_POSITIONGENERATOR_H
+
+#include <random>
+#include <vector>
+#include <Position.h>
+
+/**
+ * Generates random positions with the given number of discs. The positions are reached
+ * playing random non-losing moves, and are discarded if the player to move can win immediately
+ * or has already lost, so that every position requires a real search.
+ * @param count      the number of positions to generate.
+ * @param moves      the number of discs of each position.
+ * @param generator  the random number generator.
+ * @return           the generated positions.
+ */
+std::vector<fourinarow::Position> generatePositions(unsigned int count, unsigned int moves, std::mt19937_64 &generator);
+
+#endif //INC_4INAROW_POSITIONGENERATOR_H
@@ -0,0 +1,212 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <Constants.h>
+#include <QuickMatchQueue.h>
+#include "Measurement.h"
+
+using Queue = fourinarow::QuickMatchQueue;
+
+/**
+ * Prints a help message describing how to invoke the program from the command line.
+ */
+void printHelp() {
+    std::string helpMessage("Usage: quick-match-benchmark [-h] [-d DEPTH] [-r RATE] [-t TIME] [-s SEED]\n"
+                            "\n"
+                            "Options:\n"
+                            " -h, --help          Show this help message and exit\n"
+                            " -d, --depth  DEPTH  The number of players queued at the same time (default: 100000)\n"
+                            " -r, --rate   RATE   The number of players joining the queue per second (default: 1000)\n"
+                            " -t, --time   TIME   The simulated time of the steady queue, in seconds (default: 600)\n"
+                            " -s, --seed   SEED   The seed used to generate the players (default: 1)");
+    std::cout << helpMessage << std::endl;
+}
+
+/**
+ * Parses the arguments passed via command line. All the options are optional,
+ * but each given option must be followed by a numeric value.
+ * @param argc   the number of arguments passed via command line.
+ * @param argv   the arguments passed via command line.
+ * @param depth  a reference to the variable that will store the number of players queued at the same time.
+ * @param rate   a reference to the variable that will store the number of players joining the queue per second.
+ * @param time   a reference to the variable that will store the simulated time, in seconds.
+ * @param seed   a reference to the variable that will store the seed.
+ * @return       true if the arguments are valid, false otherwise.
+ */
+bool parseArguments(int argc, char *argv[], unsigned int &depth, unsigned int &rate, unsigned int &time,
+                    unsigned long &seed) {
+    if (argc % 2 != 1) {
+        printHelp();
+        return false;
+    }
+
+    try {
+        for (auto i = 1; i < argc; i += 2) {
+            std::string arg(argv[i]);
+
+            if (arg == "-d" || arg == "--depth") {
+                depth = std::stoul(argv[i + 1]);
+            } else if (arg == "-r" || arg == "--rate") {
+                rate = std::stoul(argv[i + 1]);
+            } else if (arg == "-t" || arg == "--time") {
+                time = std::stoul(argv[i + 1]);
+            } else if (arg == "-s" || arg == "--seed") {
+                seed = std::stoul(argv[i + 1]);
+            } else {
+                printHelp();
+                return false;
+            }
+        }
+    } catch (const std::exception &exception) {
+        printHelp();
+        return false;
+    }
+
+    if (depth < 2 || rate == 0 || time == 0) {
+        printHelp();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Returns the elapsed time since the given instant, in nanoseconds.
+ * @param start  the instant.
+ * @return       the elapsed time.
+ */
+double elapsedNanoseconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[]) {
+    auto depth = 100000u;
+    auto rate = 1000u;
+    auto time = 600u;
+    auto seed = 1ul;
+
+    if (!parseArguments(argc, argv, depth, rate, time, seed)) {
+        return 1;
+    }
+
+    // The ratings of the players follow a normal distribution, as in a population rated by Elo.
+    std::mt19937_64 generator(seed);
+    std::normal_distribution<double> ratingDistribution(fourinarow::INITIAL_RATING, 300);
+    auto nextRating = [&]() {
+        return static_cast<unsigned int>(std::max(0.0, ratingDistribution(generator)));
+    };
+
+    const uint64_t wideningPeriod = fourinarow::QUICK_MATCH_WIDENING_PERIOD*1000;
+    std::vector<Queue::Pairing> pairings;
+
+    /*
+     * Burst: all the players join the queue at the same time. The first sweep pairs the players
+     * of the same bucket, and the following ones, one widening period apart, drain the sparse buckets.
+     */
+    std::vector<Queue::Entry> players;
+    players.reserve(depth);
+    for (auto i = 0u; i < depth; i++) {
+        players.push_back({"player" + std::to_string(i), i, nextRating(), 0});
+    }
+
+    Queue burstQueue(fourinarow::QUICK_MATCH_BUCKET_WIDTH, wideningPeriod);
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &player : players) {
+        burstQueue.push(player);
+    }
+    auto pushNanoseconds = elapsedNanoseconds(start)/depth;
+
+    start = std::chrono::steady_clock::now();
+    for (auto i = 0u; i < depth; i += 2) {
+        burstQueue.erase(players[i].username);
+    }
+    auto eraseNanoseconds = elapsedNanoseconds(start)/((depth + 1)/2);
+
+    for (auto i = 0u; i < depth; i += 2) {
+        burstQueue.push(players[i]);
+    }
+
+    start = std::chrono::steady_clock::now();
+    burstQueue.match(0, pairings);
+    auto sweepNanoseconds = elapsedNanoseconds(start);
+    auto firstSweepPairings = pairings.size();
+
+    auto sweeps = 1u;
+    for (uint64_t now = wideningPeriod; burstQueue.size() > 1; now += wideningPeriod, sweeps++) {
+        burstQueue.match(now, pairings);
+    }
+
+    std::cout << "Burst of " << depth << " players" << std::endl;
+    std::cout << "push: " << pushNanoseconds << " ns/op" << std::endl;
+    std::cout << "erase: " << eraseNanoseconds << " ns/op" << std::endl;
+    std::cout << "first sweep: " << firstSweepPairings << " pairings, ";
+    std::cout << (firstSweepPairings == 0 ? 0 : sweepNanoseconds/firstSweepPairings) << " ns/pairing" << std::endl;
+    std::cout << "queue drained after " << sweeps << " sweeps, " << (sweeps - 1)*wideningPeriod << " ms" << std::endl;
+
+    /*
+     * Steady queue: the players join at exponentially distributed intervals. The server sweeps the queue
+     * after every arrival, since the QUICK_MATCH message wakes up its loop, and once per widening period
+     * when no message arrives.
+     */
+    std::exponential_distribution<double> intervalDistribution(rate/1000.0);
+    Queue steadyQueue(fourinarow::QUICK_MATCH_BUCKET_WIDTH, wideningPeriod);
+    std::vector<uint64_t> waits;
+    uint64_t depthSum = 0;
+    size_t maxDepth = 0;
+    uint64_t arrivals = 0;
+    double sweepTime = 0;
+    const uint64_t end = static_cast<uint64_t>(time)*1000;
+
+    auto sweep = [&](uint64_t now) {
+        pairings.clear();
+        auto sweepStart = std::chrono::steady_clock::now();
+        steadyQueue.match(now, pairings);
+        sweepTime += elapsedNanoseconds(sweepStart);
+
+        for (const auto &pairing : pairings) {
+            waits.push_back(now - pairing.first.arrivalTime);
+            waits.push_back(now - pairing.second.arrivalTime);
+        }
+    };
+
+    double clock = 0;
+    uint64_t lastSweep = 0;
+    while (true) {
+        clock += intervalDistribution(generator);
+        auto now = static_cast<uint64_t>(clock);
+        if (now >= end) {
+            break;
+        }
+
+        for (; now - lastSweep >= wideningPeriod; lastSweep += wideningPeriod) {
+            sweep(lastSweep + wideningPeriod);
+        }
+
+        steadyQueue.push({"player" + std::to_string(arrivals), static_cast<uint32_t>(arrivals), nextRating(), now});
+        arrivals++;
+        depthSum += steadyQueue.size();
+        maxDepth = std::max(maxDepth, steadyQueue.size());
+
+        sweep(now);
+        lastSweep = now;
+    }
+
+    std::cout << "\nSteady queue, " << rate << " players/s for " << time << " s" << std::endl;
+    std::cout << "arrivals: " << arrivals << ", matched: " << waits.size() << std::endl;
+    std::cout << "queue depth: " << (arrivals == 0 ? 0 : static_cast<double>(depthSum)/arrivals) << " mean, ";
+    std::cout << maxDepth << " max" << std::endl;
+    std::cout << "sweep: " << (waits.empty() ? 0 : sweepTime*2/waits.size()) << " ns/pairing" << std::endl;
+
+    if (!waits.empty()) {
+        std::sort(waits.begin(), waits.end());
+        auto p50 = quantile(waits, 0.5);
+        auto p99 = quantile(waits, 0.99);
+        std::cout << "time to match: p50 " << p50 << " ms, p99 " << p99 << " ms, max " << waits.back() << " ms";
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
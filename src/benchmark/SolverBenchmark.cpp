@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <OpeningBook.h>
+#include <Position.h>
+#include <SerializationException.h>
+#include <Solver.h>
+#include "PositionGenerator.h"
+
+/**
+ * Prints a help message describing how to invoke the program from the command line.
+ */
+void printHelp() {
+    std::string helpMessage("Usage: solver-benchmark [-h] [-p POSITIONS] [-m MOVES] [-s SEED] [-b BOOK]\n"
+                            "\n"
+                            "Options:\n"
+                            " -h, --help                Show this help message and exit\n"
+                            " -p, --positions POSITIONS The number of positions to solve (default: 100)\n"
+                            " -m, --moves     MOVES     The number of discs on the board of each position (default: 16)\n"
+                            " -s, --seed      SEED      The seed used to generate the positions (default: 1)\n"
+                            " -b, --book      BOOK      The path of the opening book used by the solver (default: none)");
+    std::cout << helpMessage << std::endl;
+}
+
+/**
+ * Parses the arguments passed via command line. All the options are optional,
+ * but each given option must be followed by a value.
+ * @param argc       the number of arguments passed via command line.
+ * @param argv       the arguments passed via command line.
+ * @param positions  a reference to the variable that will store the number of positions.
+ * @param moves      a reference to the variable that will store the number of discs of each position.
+ * @param seed       a reference to the variable that will store the seed.
+ * @param book       a reference to the variable that will store the path of the opening book.
+ * @return           true if the arguments are valid, false otherwise.
+ */
+bool parseArguments(int argc, char *argv[], unsigned int &positions, unsigned int &moves, unsigned long &seed,
+                    std::string &book) {
+    if (argc % 2 != 1) {
+        printHelp();
+        return false;
+    }
+
+    try {
+        for (auto i = 1; i < argc; i += 2) {
+            std::string arg(argv[i]);
+
+            if (arg == "-p" || arg == "--positions") {
+                positions = std::stoul(argv[i + 1]);
+            } else if (arg == "-m" || arg == "--moves") {
+                moves = std::stoul(argv[i + 1]);
+            } else if (arg == "-s" || arg == "--seed") {
+                seed = std::stoul(argv[i + 1]);
+            } else if (arg == "-b" || arg == "--book") {
+                book = argv[i + 1];
+            } else {
+                printHelp();
+                return false;
+            }
+        }
+    } catch (const std::exception &exception) {
+        printHelp();
+        return false;
+    }
+
+    if (positions == 0) {
+        printHelp();
+        return false;
+    }
+
+    if (moves >= fourinarow::Position::Geometry::SPACES) {
+        std::cerr << "The number of discs must be lower than " << fourinarow::Position::Geometry::SPACES << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    auto positionCount = 100u;
+    auto moves = 16u;
+    auto seed = 1ul;
+    std::string bookPath;
+
+    if (!parseArguments(argc, argv, positionCount, moves, seed, bookPath)) {
+        return 1;
+    }
+
+    std::mt19937_64 generator(seed);
+    auto positions = generatePositions(positionCount, moves, generator);
+
+    fourinarow::Solver solver;
+
+    if (!bookPath.empty()) {
+        try {
+            solver.setOpeningBook(std::make_shared<const fourinarow::OpeningBook>(bookPath));
+        } catch (const fourinarow::SerializationException &exception) {
+            std::cerr << exception.what() << std::endl;
+            return 1;
+        }
+    }
+    std::vector<double> times;
+    uint64_t nodes = 0;
+
+    for (const auto &position : positions) {
+        auto start = std::chrono::steady_clock::now();
+        auto evaluation = solver.solve(position);
+        auto end = std::chrono::steady_clock::now();
+
+        times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        nodes += evaluation.nodes;
+    }
+
+    auto total = 0.0;
+    for (auto time : times) {
+        total += time;
+    }
+    std::sort(times.begin(), times.end());
+
+    std::cout << "Solved " << positions.size() << " positions with " << moves << " discs" << std::endl;
+    std::cout << "Mean time:   " << total/times.size() << " ms" << std::endl;
+    std::cout << "Median time: " << times[times.size()/2] << " ms" << std::endl;
+    std::cout << "Max time:    " << times.back() << " ms" << std::endl;
+    std::cout << "Mean nodes:  " << nodes/positions.size() << std::endl;
+    std::cout << "Nodes/s:     " << (total > 0 ? nodes/(total/1000) : 0) << std::endl;
+    return 0;
+}
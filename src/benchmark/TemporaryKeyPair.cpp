@@ -0,0 +1,105 @@
+#include <cstdio>
+#include <stdexcept>
+#include <unistd.h>
+#include <utility>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/ec.h>
+#include <openssl/rsa.h>
+#include "TemporaryKeyPair.h"
+
+namespace {
+
+EVP_PKEY* generateKeyPair(uint8_t scheme) {
+    EVP_PKEY_CTX *context = nullptr;
+
+    if (scheme == fourinarow::SIGNATURE_RSA_PKCS1_SHA256) {
+        context = EVP_PKEY_CTX_new_id(EVP_PKEY_RSA, nullptr);
+    } else if (scheme == fourinarow::SIGNATURE_ECDSA_P256_SHA256) {
+        context = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+    } else if (scheme == fourinarow::SIGNATURE_ED25519) {
+        context = EVP_PKEY_CTX_new_id(EVP_PKEY_ED25519, nullptr);
+    } else {
+        throw std::runtime_error("Unsupported signature scheme");
+    }
+
+    EVP_PKEY *keyPair = nullptr;
+
+    if (context == nullptr
+        || EVP_PKEY_keygen_init(context) != 1
+        || (scheme == fourinarow::SIGNATURE_RSA_PKCS1_SHA256 && EVP_PKEY_CTX_set_rsa_keygen_bits(context, 2048) != 1)
+        || (scheme == fourinarow::SIGNATURE_ECDSA_P256_SHA256 &&
+            EVP_PKEY_CTX_set_ec_paramgen_curve_nid(context, NID_X9_62_prime256v1) != 1)
+        || EVP_PKEY_keygen(context, &keyPair) != 1) {
+        EVP_PKEY_CTX_free(context);
+        throw std::runtime_error("Impossible to generate the key pair");
+    }
+
+    EVP_PKEY_CTX_free(context);
+    return keyPair;
+}
+
+FILE* createTemporaryFile(std::string &path) {
+    char pathTemplate[] = "/tmp/benchmark-key-XXXXXX";
+    FILE *file = nullptr;
+    auto descriptor = mkstemp(pathTemplate);
+
+    if (descriptor == -1 || (file = fdopen(descriptor, "w")) == nullptr) {
+        throw std::runtime_error("Impossible to create a temporary file");
+    }
+
+    path = pathTemplate;
+    return file;
+}
+
+}
+
+TemporaryKeyPair::TemporaryKeyPair(uint8_t scheme) : TemporaryKeyPair("", scheme) {}
+
+TemporaryKeyPair::TemporaryKeyPair(std::string publicKeyPath, uint8_t scheme) : publicKeyPath(std::move(publicKeyPath)) {
+    auto keyPair = generateKeyPair(scheme);
+
+    FILE *privateKeyFile = nullptr;
+    FILE *publicKeyFile = nullptr;
+
+    try {
+        privateKeyFile = createTemporaryFile(privateKeyPath);
+        if (this->publicKeyPath.empty()) {
+            publicKeyFile = createTemporaryFile(this->publicKeyPath);
+        } else if ((publicKeyFile = fopen(this->publicKeyPath.c_str(), "w")) == nullptr) {
+            throw std::runtime_error("Impossible to create the public key file " + this->publicKeyPath);
+        }
+    } catch (...) {
+        if (privateKeyFile != nullptr) {
+            fclose(privateKeyFile);
+            std::remove(privateKeyPath.c_str());
+        }
+        EVP_PKEY_free(keyPair);
+        throw;
+    }
+
+    auto written = PEM_write_PrivateKey(privateKeyFile, keyPair, nullptr, nullptr, 0, nullptr, nullptr) == 1
+                   && PEM_write_PUBKEY(publicKeyFile, keyPair) == 1;
+    written = (fclose(privateKeyFile) == 0) && written;
+    written = (fclose(publicKeyFile) == 0) && written;
+    EVP_PKEY_free(keyPair);
+
+    if (!written) {
+        std::remove(privateKeyPath.c_str());
+        std::remove(this->publicKeyPath.c_str());
+        throw std::runtime_error("Impossible to write the key pair");
+    }
+}
+
+TemporaryKeyPair::~TemporaryKeyPair() {
+    std::remove(privateKeyPath.c_str());
+    std::remove(publicKeyPath.c_str());
+}
+
+const std::string& TemporaryKeyPair::getPrivateKeyPath() const {
+    return privateKeyPath;
+}
+
+const std::string& TemporaryKeyPair::getPublicKeyPath() const {
+    return publicKeyPath;
+}
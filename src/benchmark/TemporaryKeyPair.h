@@ -0,0 +1,45 @@
+#ifndef INC_4INAROW_TEMPORARYKEYPAIR_H
+#define INC_4INAROW_TEMPORARYKEYPAIR_H
+
+#include <cstdint>
+#include <string>
+#include <Constants.h>
+
+/**
+ * Class representing a key pair of a signature scheme, RSA-2048 by default, generated for a benchmark and stored in unencrypted PEM files,
+ * which are removed on destruction. It replaces the key pairs of the players, whose private keys are
+ * protected by a password asked at runtime.
+ */
+class TemporaryKeyPair {
+    private:
+        std::string privateKeyPath;
+        std::string publicKeyPath;
+    public:
+        /**
+         * Generates a key pair, storing both the keys in new temporary files.
+         * @param scheme  the signature scheme of the key pair.
+         * @throws runtime_error  if the scheme is not supported, or an error occurs while generating or writing the keys.
+         */
+        explicit TemporaryKeyPair(uint8_t scheme = fourinarow::SIGNATURE_RSA_PKCS1_SHA256);
+
+        /**
+         * Generates a key pair, storing the private key in a new temporary file and
+         * the public key in the given file, e.g. in the players folder of the server.
+         * @param publicKeyPath  the path of the public key file. An existing file is overwritten.
+         * @param scheme         the signature scheme of the key pair.
+         * @throws runtime_error  if the scheme is not supported, or an error occurs while generating or writing the keys.
+         */
+        explicit TemporaryKeyPair(std::string publicKeyPath, uint8_t scheme = fourinarow::SIGNATURE_RSA_PKCS1_SHA256);
+
+        ~TemporaryKeyPair();
+
+        TemporaryKeyPair(const TemporaryKeyPair&) = delete;
+        TemporaryKeyPair& operator=(const TemporaryKeyPair&) = delete;
+        TemporaryKeyPair(TemporaryKeyPair&&) = delete;
+        TemporaryKeyPair& operator=(TemporaryKeyPair&&) = delete;
+
+        const std::string& getPrivateKeyPath() const;
+        const std::string& getPublicKeyPath() const;
+};
+
+#endif //INC_4INAROW_TEMPORARYKEYPAIR_H
@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include <OpeningBook.h>
+#include <Position.h>
+#include <SerializationException.h>
+#include <Solver.h>
+
+/**
+ * Prints a help message describing how to invoke the program from the command line.
+ */
+void printHelp() {
+    std::string helpMessage("Usage: book-generator [-h] [-p PLY] [-t THREADS] [-m MEMORY] -o OUTPUT\n"
+                            "\n"
+                            "Options:\n"
+                            " -h, --help             Show this help message and exit\n"
+                            " -p, --ply     PLY      The maximum number of discs of the positions in the book (default: 8)\n"
+                            " -t, --threads THREADS  The number of solving threads (default: the number of cores)\n"
+                            " -m, --memory  MEMORY   The size of the shared transposition table, in MiB (default: 64)\n"
+                            " -o, --output  OUTPUT   The path of the book file");
+    std::cout << helpMessage << std::endl;
+}
+
+/**
+ * Parses the arguments passed via command line. All the options except the output are optional,
+ * but each given option must be followed by a value.
+ * @param argc     the number of arguments passed via command line.
+ * @param argv     the arguments passed via command line.
+ * @param ply      a reference to the variable that will store the maximum number of discs.
+ * @param threads  a reference to the variable that will store the number of threads.
+ * @param memory   a reference to the variable that will store the size of the transposition table.
+ * @param output   a reference to the variable that will store the path of the book file.
+ * @return         true if the arguments are valid, false otherwise.
+ */
+bool parseArguments(int argc, char *argv[], unsigned int &ply, unsigned int &threads, size_t &memory, std::string &output) {
+    if (argc % 2 != 1) {
+        printHelp();
+        return false;
+    }
+
+    try {
+        for (auto i = 1; i < argc; i += 2) {
+            std::string arg(argv[i]);
+
+            if (arg == "-p" || arg == "--ply") {
+                ply = std::stoul(argv[i + 1]);
+            } else if (arg == "-t" || arg == "--threads") {
+                threads = std::stoul(argv[i + 1]);
+            } else if (arg == "-m" || arg == "--memory") {
+                memory = std::stoul(argv[i + 1])*1024*1024;
+            } else if (arg == "-o" || arg == "--output") {
+                output = argv[i + 1];
+            } else {
+                printHelp();
+                return false;
+            }
+        }
+    } catch (const std::exception &exception) {
+        printHelp();
+        return false;
+    }
+
+    if (output.empty() || threads == 0) {
+        printHelp();
+        return false;
+    }
+
+    if (ply >= fourinarow::Position::Geometry::SPACES) {
+        std::cerr << "The number of discs must be lower than " << fourinarow::Position::Geometry::SPACES << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Enumerates the positions reachable with non-losing moves, grouped by number of discs.
+ * A position and its mirror image are enumerated once. The player to move in an enumerated
+ * position can never win immediately, since the previous move was non-losing.
+ * @param ply  the maximum number of discs.
+ * @return     the positions, indexed by number of discs.
+ */
+std::vector<std::vector<fourinarow::Position>> enumeratePositions(unsigned int ply) {
+    std::vector<std::vector<fourinarow::Position>> levels(ply + 1);
+    levels[0].emplace_back();
+
+    for (auto moves = 0u; moves < ply; moves++) {
+        std::unordered_set<fourinarow::Position::Bitboard> seen;
+
+        for (const auto &position : levels[moves]) {
+            auto next = position.possibleNonLosingMoves();
+
+            for (auto i = 0; i < fourinarow::COLUMNS; i++) {
+                auto move = next & fourinarow::Position::Geometry::columnMask(i);
+                if (!move) {
+                    continue;
+                }
+
+                auto child = position;
+                child.play(move);
+
+                auto mirrored = false;
+                if (seen.insert(child.getCanonicalKey(mirrored)).second) {
+                    levels[moves + 1].push_back(child);
+                }
+            }
+        }
+
+        std::cout << "Level " << moves + 1 << ": " << levels[moves + 1].size() << " positions" << std::endl;
+    }
+
+    return levels;
+}
+
+/**
+ * Solves a set of positions in parallel. Each thread owns a solver, while the transposition table
+ * and the book of the positions with more discs are shared. The threads take the positions
+ * from a shared counter, so that a slow position does not stall the others.
+ * @param positions  the positions to solve.
+ * @param threads    the number of threads.
+ * @param table      the shared transposition table.
+ * @param book       the book of the positions already solved, possibly null.
+ * @param solved     the vector that will receive the solved positions.
+ */
+void solveLevel(const std::vector<fourinarow::Position> &positions,
+                unsigned int threads,
+                const std::shared_ptr<fourinarow::TranspositionTable> &table,
+                const std::shared_ptr<const fourinarow::OpeningBook> &book,
+                std::vector<fourinarow::OpeningBook::Entry> &solved) {
+    std::vector<int> scores(positions.size());
+    std::atomic<size_t> nextIndex(0);
+    std::vector<std::thread> workers;
+
+    for (auto i = 0u; i < threads; i++) {
+        workers.emplace_back([&positions, &table, &book, &scores, &nextIndex]() {
+            fourinarow::Solver solver(table);
+            solver.setOpeningBook(book);
+
+            for (auto index = nextIndex++; index < positions.size(); index = nextIndex++) {
+                scores[index] = solver.solve(positions[index]).lowerBound;
+            }
+        });
+    }
+
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    for (size_t i = 0; i < positions.size(); i++) {
+        solved.push_back(fourinarow::OpeningBook::Entry{positions[i], scores[i]});
+    }
+}
+
+int main(int argc, char *argv[]) {
+    auto ply = 8u;
+    auto threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t memory = 64*1024*1024;
+    std::string output;
+
+    if (!parseArguments(argc, argv, ply, threads, memory, output)) {
+        return 1;
+    }
+
+    auto levels = enumeratePositions(ply);
+    auto table = std::make_shared<fourinarow::TranspositionTable>(memory);
+    std::vector<fourinarow::OpeningBook::Entry> solved;
+    std::shared_ptr<const fourinarow::OpeningBook> book;
+
+    /*
+     * The levels are solved from the deepest one, so that the search of a position
+     * stops at the children already stored in the book, instead of exploring them again.
+     */
+    for (auto moves = ply + 1; moves > 0; moves--) {
+        auto start = std::chrono::steady_clock::now();
+        solveLevel(levels[moves - 1], threads, table, book, solved);
+        auto end = std::chrono::steady_clock::now();
+
+        book = std::make_shared<const fourinarow::OpeningBook>(solved, ply);
+        std::cout << "Solved level " << moves - 1 << " in "
+                  << std::chrono::duration<double>(end - start).count() << " s" << std::endl;
+    }
+
+    try {
+        book->save(output);
+    } catch (const fourinarow::SerializationException &exception) {
+        std::cerr << exception.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Saved " << book->getEntryCount() << " positions to " << output << std::endl;
+    return 0;
+}
@@ -18,6 +18,11 @@ void GameHandler::clearScreen() {
     std::cout << "\033[2J\033[1;1H" << std::flush;
 }
 
+void GameHandler::printBoard(const FourInARow &gameBoard) {
+    clearScreen();
+    std::cout << gameBoard.toString() << std::endl;
+}
+
 void GameHandler::printAvailableCommands() {
     std::cout << "It's your turn! What do you want to do?\n";
     std::cout << " 1) Make a move\n 2) Leave the match\n";
@@ -72,19 +77,34 @@ Move GameHandler::parseMove(FourInARow &gameBoard) {
     return Move(column);
 }
 
-bool GameHandler::handleUserTurn(const TcpSocket &socket, Player &opponent, FourInARow &gameBoard) {
+void GameHandler::parseRelayedMove(ClientSession &session) {
+    std::cout << "Insert a column number between 0 and " << std::to_string(COLUMNS - 1) << ": " << std::flush;
+    auto column = 0u;
+    std::cin >> column;
+
+    // The session checks the move against its board.
+    while (std::cin.fail() || column >= COLUMNS || !session.makeMove(column)) {
+        std::cout << "Invalid input. Please enter a valid column index: " << std::flush;
+        clearStdin();
+        std::cin >> column;
+    }
+
+    clearStdin();
+}
+
+bool GameHandler::handleUserTurn(const TcpSocket &socket, Player &channel, FourInARow &gameBoard) {
     printAvailableCommands();
     auto command = parseCommand();
 
     if (isExitCommand(command)) {
         InfoMessage goodbyeMessage(GOODBYE);
-        socket.send(encryptAndAuthenticate(&goodbyeMessage, opponent));
+        socket.send(encryptAndAuthenticate(&goodbyeMessage, channel));
         std::cout << "Returning to the main menu...\n" << std::endl;
         return false;
     }
 
     auto moveMessage = parseMove(gameBoard);
-    socket.send(encryptAndAuthenticate(&moveMessage, opponent));
+    socket.send(encryptAndAuthenticate(&moveMessage, channel));
     clearScreen();
     std::cout << gameBoard.toString() << std::endl;
 
@@ -97,11 +117,11 @@ bool GameHandler::handleUserTurn(const TcpSocket &socket, Player &opponent, Four
     return true;
 }
 
-bool GameHandler::receiveOpponentMove(const TcpSocket &socket, Player &opponent, FourInARow &gameBoard) {
+bool GameHandler::receiveOpponentMove(const TcpSocket &socket, Player &channel, FourInARow &gameBoard) {
     std::cout << "Waiting for " << gameBoard.getOpponent() << "'s move..." << std::endl;
     auto encryptedMessage = socket.receiveWithTimeout(MAX_TURN_DURATION);
 
-    auto message = authenticateAndDecrypt(encryptedMessage, opponent);
+    auto message = authenticateAndDecrypt(encryptedMessage, channel);
     auto type = getMessageType<SerializationException>(message);
 
     if (type == GOODBYE) {
@@ -131,25 +151,25 @@ bool GameHandler::receiveOpponentMove(const TcpSocket &socket, Player &opponent,
     return true;
 }
 
-void GameHandler::handle(const TcpSocket &socket, Player &opponent, bool firstToPlay) {
+void GameHandler::handle(const TcpSocket &socket, Player &channel, const std::string &opponentUsername, bool firstToPlay) {
     try {
-        FourInARow gameBoard(opponent.getUsername());
+        FourInARow gameBoard(opponentUsername);
         clearScreen();
         std::cout << gameBoard.toString() << std::endl;
 
         while (true) {
             if (firstToPlay) {
-                if (!handleUserTurn(socket, opponent, gameBoard)) {
+                if (!handleUserTurn(socket, channel, gameBoard)) {
                     return;
                 }
-                if (!receiveOpponentMove(socket, opponent, gameBoard)) {
+                if (!receiveOpponentMove(socket, channel, gameBoard)) {
                     return;
                 }
             } else {
-                if (!receiveOpponentMove(socket, opponent, gameBoard)) {
+                if (!receiveOpponentMove(socket, channel, gameBoard)) {
                     return;
                 }
-                if (!handleUserTurn(socket, opponent, gameBoard)) {
+                if (!handleUserTurn(socket, channel, gameBoard)) {
                     return;
                 }
             }
@@ -160,15 +180,50 @@ void GameHandler::handle(const TcpSocket &socket, Player &opponent, bool firstTo
     }
 }
 
-void GameHandler::sendEndGame(const TcpSocket &serverSocket, Player &myselfForServer) {
-    try {
-        InfoMessage endGame(END_GAME);
-        serverSocket.send(encryptAndAuthenticate(&endGame, myselfForServer));
-    } catch (const std::exception &exception) {
-        std::cerr << "Cannot notify the server about the end of the match. " << exception.what() << std::endl;
-        throw std::runtime_error("Cannot notify end game");
+void GameHandler::startRelayedMatch(const ClientSession &session) {
+    printBoard(session.getBoard());
+
+    if (session.isMyTurn()) {
+        printAvailableCommands();
+    } else {
+        std::cout << "Waiting for " << session.getOpponent() << "'s move..." << std::endl;
+    }
+}
+
+void GameHandler::handleOpponentMove(const ClientSession &session) {
+    printBoard(session.getBoard());
+    printAvailableCommands();
+}
+
+void GameHandler::handleUserTurn(ClientSession &session) {
+    auto command = parseCommand();
+
+    if (isExitCommand(command)) {
+        session.leaveMatch();
+        return;
+    }
+
+    // A move ending the match is notified by the session before makeMove() returns.
+    parseRelayedMove(session);
+    if (session.getState() == ClientSession::State::PLAYING) {
+        printBoard(session.getBoard());
+        std::cout << "Waiting for " << session.getOpponent() << "'s move..." << std::endl;
+    }
+}
+
+void GameHandler::printMatchEnd(const ClientSession &session, MatchEnd end) {
+    if (end == MatchEnd::WIN || end == MatchEnd::DRAW || end == MatchEnd::LOSS) {
+        printBoard(session.getBoard());
+        printMatchResult(session.getBoard().getResult());
+    } else if (end == MatchEnd::OPPONENT_LEFT) {
+        std::cout << session.getOpponent() << " has left the match.\n";
+    } else if (end == MatchEnd::OPPONENT_CHEATED) {
+        std::cout << session.getOpponent() << " is trying to cheat. What a loser!\n";
+    } else if (end == MatchEnd::TIMEOUT) {
+        std::cout << "\n" << session.getOpponent() << " did not move in time.\n";
     }
 
+    std::cout << "Returning to the main menu...\n" << std::endl;
 }
 
 }
@@ -2,12 +2,15 @@
 #define INC_4INAROW_GAMEHANDLER_H
 
 #include <Move.h>
+#include <ClientSession.h>
 #include "Handler.h"
 
 namespace fourinarow {
 
 /**
- * Class representing a handler for P2P matches between players.
+ * Class representing a handler for matches between players. The moves of a P2P match are exchanged
+ * directly with the opponent, while the ones of a relayed match are exchanged through the session
+ * with the server, which validates and forwards them.
  */
 class GameHandler : public Handler {
     private:
@@ -22,6 +25,12 @@ class GameHandler : public Handler {
          */
         static void clearScreen();
 
+        /**
+         * Clears the screen and prints the game board.
+         * @param gameBoard  the game board.
+         */
+        static void printBoard(const FourInARow &gameBoard);
+
         /**
          * Prints the result of the match in a human readable way.
          * @param result  the result of the match.
@@ -62,10 +71,17 @@ class GameHandler : public Handler {
          */
         static Move parseMove(FourInARow &gameBoard);
 
+        /**
+         * Parses a move of the user and makes it in the relayed match of the session.
+         * The method does not return until a valid column has been supplied.
+         * @param session  the session playing the relayed match.
+         */
+        static void parseRelayedMove(ClientSession &session);
+
         /**
          * Handles the turn of the user, parsing and managing the commands.
-         * @param socket     the socket used to communicate with the opponent.
-         * @param opponent   the object storing the quantities derived in the handshake with the player.
+         * @param socket     the socket used to send the moves.
+         * @param channel    the object storing the quantities derived in the handshake with the opponent.
          * @param gameBoard  the game board.
          * @return           true if the match is finished or the user wants to leave the match,
          *                   false otherwise.
@@ -74,12 +90,12 @@ class GameHandler : public Handler {
          * @throws CryptoException         if an error occurs while encrypting the move, or the maximum
          *                                 sequence number has been reached.
          */
-        static bool handleUserTurn(const TcpSocket &socket, Player &opponent, FourInARow &gameBoard);
+        static bool handleUserTurn(const TcpSocket &socket, Player &channel, FourInARow &gameBoard);
 
         /**
          * Handles the turn of the opponent, waiting for the reception of a <code>MOVE/</code> message.
-         * @param socket     the socket used to communicate with the opponent.
-         * @param opponent   the object storing the quantities derived in the handshake with the player.
+         * @param socket     the socket used to receive the moves.
+         * @param channel    the object storing the quantities derived in the handshake with the opponent.
          * @param gameBoard  the game board.
          * @return           true if the move is valid and does not end the match, false otherwise.
          * @throws SocketException         if an error occurs while receiving the move from the opponent.
@@ -87,7 +103,7 @@ class GameHandler : public Handler {
          * @throws CryptoException         if an error occurs while decrypting the message, or the maximum
          *                                 sequence number has been reached.
          */
-        static bool receiveOpponentMove(const TcpSocket &socket, Player &opponent, FourInARow &gameBoard);
+        static bool receiveOpponentMove(const TcpSocket &socket, Player &channel, FourInARow &gameBoard);
     public:
         GameHandler() = delete;
         ~GameHandler() = delete;
@@ -97,21 +113,40 @@ class GameHandler : public Handler {
         GameHandler& operator=(GameHandler&&) = delete;
 
         /**
-         * Handles a P2P game with another player.
-         * @param socket            the socket used to communicate with the opponent.
-         * @param opponent          the object storing the quantities derived in the handshake with the player.
+         * Handles a P2P game with another player, exchanging the moves directly with the opponent.
+         * @param socket            the socket used to exchange the moves.
+         * @param channel           the object storing the quantities derived in the handshake with the opponent.
+         * @param opponentUsername  the username of the opponent.
          * @param firstToPlay       true if the user has the first turn, false otherwise.
          */
-        static void handle(const TcpSocket &socket, Player &opponent, bool firstToPlay);
+        static void handle(const TcpSocket &socket, Player &channel, const std::string &opponentUsername, bool firstToPlay);
+
+        /**
+         * Prints the game board of a relayed match just started, followed by the available commands
+         * if the user has the first turn.
+         * @param session  the session playing the relayed match.
+         */
+        static void startRelayedMatch(const ClientSession &session);
+
+        /**
+         * Prints the game board after a move of the opponent in a relayed match, followed by the available commands.
+         * @param session  the session playing the relayed match.
+         */
+        static void handleOpponentMove(const ClientSession &session);
+
+        /**
+         * Handles the turn of the user in a relayed match, parsing the command inserted and
+         * issuing it to the session.
+         * @param session  the session playing the relayed match.
+         */
+        static void handleUserTurn(ClientSession &session);
 
         /**
-         * Sends a <code>END_GAME</code> message to the server to notify
-         * that the P2P match has ended and the player is available.
-         * @param serverSocket     the socket used to communicate with the server.
-         * @param myselfForServer  the object storing the quantities derived in the handshake with the server.
-         * @throws runtime_error  if an error occurs while sending the message to the server.
+         * Prints the end of a relayed match, with the final game board if the match has been played until the end.
+         * @param session  the session that played the relayed match.
+         * @param end      the reason of the end of the match.
          */
-        static void sendEndGame(const TcpSocket &serverSocket, Player &myselfForServer);
+        static void printMatchEnd(const ClientSession &session, MatchEnd end);
 };
 
 }
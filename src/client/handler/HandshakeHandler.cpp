@@ -5,118 +5,16 @@
 #include <SerializationException.h>
 #include <CryptoException.h>
 #include <SocketException.h>
-#include <ClientHello.h>
-#include <ServerHello.h>
 #include <EndHandshake.h>
 #include <Player1Hello.h>
 #include <Player2Hello.h>
 #include <InfoMessage.h>
-#include <PlayerListMessage.h>
 #include <DigitalSignature.h>
 #include <InputMultiplexer.h>
 #include "HandshakeHandler.h"
 
 namespace fourinarow {
 
-void HandshakeHandler::sendClientHello(const TcpSocket &socket, Player &myselfForServer, const std::string &username) {
-    std::cout << "Handshake: sending a CLIENT_HELLO message" << std::endl;
-
-    try {
-        myselfForServer.setUsername(username);
-        myselfForServer.generateClientNonce();
-        socket.send(ClientHello(username, myselfForServer.getClientNonce()).serialize());
-    }  catch (const std::exception &exception) {
-        std::cerr << "Impossible to send the CLIENT_HELLO message. " << exception.what() << std::endl;
-        throw std::runtime_error("Handshake with the server failed");
-    }
-}
-
-bool HandshakeHandler::isValidCertificate(const CertificateStore &certificateStore,
-                                          const Certificate &serverCertificate) {
-    return certificateStore.verifyCertificate(serverCertificate)
-           && (serverCertificate.getDistinguishedName() == SERVER_DISTINGUISHED_NAME);
-}
-
-void HandshakeHandler::receiveServerHello(const TcpSocket &socket,
-                                          Player &myselfForServer,
-                                          const CertificateStore &certificateStore) {
-    std::cout << "Handshake: waiting for a SERVER_HELLO message" << std::endl;
-
-    try {
-        auto message = socket.receiveWithTimeout(CLIENT_PROTOCOL_TIMEOUT);
-        auto type = getMessageType<SerializationException>(message);
-
-        if (type != SERVER_HELLO) {
-            throw SerializationException(convertMessageType(type));
-        }
-
-        ServerHello serverHello;
-        serverHello.deserialize(message);
-        auto serverCertificate = CertificateStore::deserializeCertificate(serverHello.getCertificate());
-
-        if (!isValidCertificate(certificateStore, serverCertificate)) {
-            throw CryptoException("Invalid server certificate");
-        }
-
-        myselfForServer.setServerNonce(serverHello.getNonce());
-        myselfForServer.setServerPublicKey(serverHello.getPublicKey());
-        myselfForServer.generateServerFreshnessProof();
-
-        if (!DigitalSignature::verify(myselfForServer.getServerFreshnessProof(),
-                                      serverHello.getDigitalSignature(),
-                                      serverCertificate.getPublicKey())) {
-            throw CryptoException("Invalid signature of the freshness proof");
-        }
-    } catch (const std::exception &exception) {
-        std::cerr << "Impossible to continue the handshake. " << exception.what() << std::endl;
-        throw std::runtime_error("Handshake with the server failed");
-    }
-}
-
-std::string HandshakeHandler::endHandshake(const TcpSocket &socket,
-                                           Player &myselfForServer,
-                                           const DigitalSignature &digitalSignature) {
-    std::cout << "Handshake: sending an END_HANDSHAKE message" << std::endl;
-
-    try {
-        myselfForServer.generateClientKeys();
-        myselfForServer.generateClientFreshnessProof();
-
-        auto signature = digitalSignature.sign(myselfForServer.getClientFreshnessProof());
-        EndHandshake endHandshake(myselfForServer.getClientPublicKey(), signature);
-        socket.send(endHandshake.serialize());
-
-        // The handshake could fail or succeed: depending on the case, the response of the server is encrypted or not.
-        auto serverResponse = socket.receiveWithTimeout(CLIENT_PROTOCOL_TIMEOUT);
-        auto type = getMessageType<SerializationException>(serverResponse);
-
-        if (type == PROTOCOL_VIOLATION || type == MALFORMED_MESSAGE || type == INTERNAL_ERROR) {
-            // Handshake failed.
-            throw std::runtime_error(convertMessageType(type));
-        }
-
-        myselfForServer.initCipher();
-
-        // The handshake should have succeeded and the response should be encrypted.
-        auto message = authenticateAndDecrypt(serverResponse, myselfForServer);
-        type = getMessageType<SerializationException>(message);
-
-        if (type != PLAYER_LIST) {
-            throw SerializationException(convertMessageType(type));
-        }
-
-        PlayerListMessage playerListMessage;
-        playerListMessage.deserialize(message);
-        cleanse(message);
-        cleanse(type);
-
-        return playerListMessage.getPlayerList();
-    } catch (const std::exception &exception) {
-        std::cerr << "Impossible to finalize the handshake. " << exception.what() << std::endl;
-        throw std::runtime_error("Handshake with the server failed");
-    }
-}
-
 void HandshakeHandler::connectToPlayer(TcpSocket &socket, const std::string &otherPlayerAddress) {
     auto attempts = 0u;
 
@@ -164,7 +62,7 @@ void HandshakeHandler::sendPlayer1Hello(const TcpSocket &socket, Player &myselfF
 
     try {
         myselfForOpponent.generateClientNonce();
-        socket.send(Player1Hello(myselfForOpponent.getClientNonce()).serialize());
+        socket.send(Player1Hello(myselfForOpponent.getClientNonce(), KEY_EXCHANGE_GROUPS).serialize());
     }  catch (const std::exception &exception) {
         std::cerr << "Impossible to start the handshake. " << exception.what() << std::endl;
         throw std::runtime_error("Handshake with the player failed");
@@ -190,7 +88,7 @@ void HandshakeHandler::handlePlayer1Hello(const TcpSocket &socket,
         player1Hello.deserialize(message);
 
         opponent.generateServerNonce();
-        opponent.generateServerKeys();
+        opponent.generateServerKeys(DiffieHellman::negotiateGroup(player1Hello.getKeyExchangeGroups()));
         opponent.setClientNonce(player1Hello.getNonce());
         opponent.generateServerFreshnessProof();
 
@@ -308,16 +206,6 @@ void HandshakeHandler::endHandshakeP2P(const TcpSocket &socket,
     }
 }
 
-std::string HandshakeHandler::doHandshakeWithServer(const TcpSocket &socket,
-                                                    Player &myselfForServer,
-                                                    const std::string &username,
-                                                    const CertificateStore &certificateStore,
-                                                    const DigitalSignature &digitalSignature) {
-    sendClientHello(socket, myselfForServer, username);
-    receiveServerHello(socket, myselfForServer, certificateStore);
-    return endHandshake(socket, myselfForServer, digitalSignature);
-}
-
 HandshakeHandler::P2PHandshakeResult HandshakeHandler::doHandshakeWithPlayer(const std::string &myAddress,
                                                                              const PlayerMessage &playerMessage,
                                                                              const DigitalSignature &digitalSignature) {
@@ -0,0 +1,120 @@
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include "HandshakeHandler.h"
+#include "PreGameHandler.h"
+#include "GameHandler.h"
+#include "SessionHandler.h"
+
+namespace fourinarow {
+
+SessionHandler::SessionHandler(std::string clientAddress, const DigitalSignature &digitalSignature)
+        : clientAddress(std::move(clientAddress)), digitalSignature(digitalSignature) {}
+
+void SessionHandler::returnToMainMenu() {
+    playerList.clear();
+    PreGameHandler::printPlayerList(playerList);
+    PreGameHandler::printAvailableCommands(playerList);
+}
+
+void SessionHandler::onConnected(ClientSession&) {
+    std::cout << "Handshake: completed" << std::endl;
+}
+
+void SessionHandler::onPlayerList(ClientSession &session, const std::vector<std::string> &players) {
+    playerList = players;
+
+    // A list requested before a challenge or a quick match is kept for the return to the main menu.
+    if (session.getState() == ClientSession::State::AVAILABLE) {
+        PreGameHandler::printPlayerList(playerList);
+        PreGameHandler::printAvailableCommands(playerList);
+    }
+}
+
+void SessionHandler::onChallenge(ClientSession&, const std::string &username) {
+    PreGameHandler::printChallengeRequest(username);
+}
+
+void SessionHandler::onChallengeAccepted(ClientSession&) {
+    std::cout << "The user has accepted the challenge!" << std::endl;
+    std::cout << "Receiving the player profile..." << std::endl;
+}
+
+void SessionHandler::onOpponentFound(ClientSession &session) {
+    std::cout << "Opponent found: '" << session.getOpponent() << "'" << std::endl;
+    std::cout << "Receiving the player profile..." << std::endl;
+}
+
+void SessionHandler::onMatchmakingFailed(ClientSession &session, MatchmakingFailure failure) {
+    PreGameHandler::printMatchmakingFailure(session, failure, playerList);
+}
+
+void SessionHandler::onMatchStarted(ClientSession &session, const std::string&, const PlayerMessage &player) {
+    if (player.isRelayed()) { // The server relays the match: no handshake with the opponent.
+        GameHandler::startRelayedMatch(session);
+        return;
+    }
+
+    pendingMatch = player;
+    matchPending = true;
+}
+
+void SessionHandler::onOpponentMove(ClientSession &session, uint8_t) {
+    GameHandler::handleOpponentMove(session);
+}
+
+void SessionHandler::onMatchEnded(ClientSession &session, MatchEnd end) {
+    GameHandler::printMatchEnd(session, end);
+    returnToMainMenu();
+}
+
+void SessionHandler::onClosed(ClientSession&, const std::string &reason) {
+    std::cerr << "\nThe connection with the server has been closed. " << reason << std::endl;
+}
+
+bool SessionHandler::hasPendingMatch() const {
+    return matchPending;
+}
+
+void SessionHandler::playPendingMatch(ClientSession &session) {
+    matchPending = false;
+
+    auto handshakeResult = HandshakeHandler::doHandshakeWithPlayer(clientAddress, pendingMatch, digitalSignature);
+    if (std::get<2>(handshakeResult)) { // Handshake succeeded.
+        std::get<1>(handshakeResult)->setUsername(session.getOpponent());
+        GameHandler::handle(*(std::get<0>(handshakeResult)),
+                            *(std::get<1>(handshakeResult)),
+                            session.getOpponent(),
+                            pendingMatch.isFirstToPlay());
+    }
+
+    session.leaveMatch();
+    if (session.getState() == ClientSession::State::AVAILABLE) {
+        returnToMainMenu();
+    }
+}
+
+bool SessionHandler::handleInput(ClientSession &session) {
+    if (std::cin.peek() == std::char_traits<char>::eof()) {
+        return false;
+    }
+
+    auto state = session.getState();
+    if (state == ClientSession::State::AVAILABLE) {
+        return PreGameHandler::handleCommand(session, playerList);
+    }
+
+    if (state == ClientSession::State::CHALLENGED) {
+        PreGameHandler::handleChallengeAnswer(session, playerList);
+    } else if (session.isMyTurn()) {
+        GameHandler::handleUserTurn(session);
+    } else {
+        std::string line;
+        std::getline(std::cin, line);
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,75 @@
+#ifndef INC_4INAROW_SESSIONHANDLER_H
+#define INC_4INAROW_SESSIONHANDLER_H
+
+#include <string>
+#include <vector>
+#include <DigitalSignature.h>
+#include <PlayerMessage.h>
+#include <ClientSession.h>
+#include <SessionListener.h>
+
+namespace fourinarow {
+
+/**
+ * Class representing the handler of the session with the server. It shows the events of the session to the user
+ * and dispatches the inputs of the user to the handler of the current phase: the pre-game commands,
+ * the answer to a challenge or the turn of a relayed match.
+ * A P2P match is not played inside an event, but kept pending until <code>playPendingMatch()</code> is called,
+ * since it blocks until its end.
+ */
+class SessionHandler : public SessionListener {
+    private:
+        std::string clientAddress;
+        const DigitalSignature &digitalSignature;
+        std::vector<std::string> playerList;
+        PlayerMessage pendingMatch;
+        bool matchPending = false;
+
+        /**
+         * Clears the player list, which is refreshed by the user, and prints the available commands.
+         */
+        void returnToMainMenu();
+    public:
+        /**
+         * Creates the handler of a session.
+         * @param clientAddress     the IPv4 address of the client, used for the P2P matches.
+         * @param digitalSignature  the digital signature tool, used for the handshake with the opponent of a P2P match.
+         */
+        SessionHandler(std::string clientAddress, const DigitalSignature &digitalSignature);
+
+        void onConnected(ClientSession &session) override;
+        void onPlayerList(ClientSession &session, const std::vector<std::string> &players) override;
+        void onChallenge(ClientSession &session, const std::string &username) override;
+        void onChallengeAccepted(ClientSession &session) override;
+        void onOpponentFound(ClientSession &session) override;
+        void onMatchmakingFailed(ClientSession &session, MatchmakingFailure failure) override;
+        void onMatchStarted(ClientSession &session, const std::string &opponent, const PlayerMessage &player) override;
+        void onOpponentMove(ClientSession &session, uint8_t column) override;
+        void onMatchEnded(ClientSession &session, MatchEnd end) override;
+        void onClosed(ClientSession &session, const std::string &reason) override;
+
+        /**
+         * Checks if a P2P match has started and has to be played.
+         */
+        bool hasPendingMatch() const;
+
+        /**
+         * Plays the pending P2P match, from the handshake with the opponent to its end,
+         * telling the server that the match has ended.
+         * @param session  the session with the server.
+         */
+        void playPendingMatch(ClientSession &session);
+
+        /**
+         * Handles a line inserted by the user, according to the state of the session.
+         * The lines inserted while the session is not waiting for an input are discarded.
+         * @param session  the session with the server.
+         * @return         false if the user wants to exit the application or <code>stdin</code> has been closed,
+         *                 true otherwise.
+         */
+        bool handleInput(ClientSession &session);
+};
+
+}
+
+#endif //INC_4INAROW_SESSIONHANDLER_H
@@ -1,14 +1,14 @@
 #include <iostream>
+#include <unistd.h>
 #include <string>
 #include <vector>
 #include <Constants.h>
 #include <Utils.h>
 #include <DigitalSignature.h>
 #include <CertificateStore.h>
-#include <FourInARow.h>
-#include "handler/HandshakeHandler.h"
-#include "handler/PreGameHandler.h"
-#include "handler/GameHandler.h"
+#include <ClientSession.h>
+#include <SessionLoop.h>
+#include "handler/SessionHandler.h"
 
 /**
  * Prints a help message describing how to invoke the program from the command line.
@@ -119,19 +119,18 @@ fourinarow::CertificateStore createCertificateStore(const std::string &pathCerti
 }
 
 /**
- * Creates a socket bound to a given address and connects to a remote server address.
+ * Connects the session to a remote server, binding the socket to a given address.
+ * @param session        the session.
  * @param clientAddress  the address to which the socket will bind.
  * @param serverAddress  the address to which the socket will connect.
- * @return               the new socket.
  * @throws runtime_error  if an error occurs while creating, binding or connecting the socket.
  */
-fourinarow::TcpSocket connectToRemoteServer(const std::string &clientAddress, const std::string &serverAddress) {
+void connectToRemoteServer(fourinarow::ClientSession &session, const std::string &clientAddress,
+                           const std::string &serverAddress) {
     std::cout << "Connecting to the remote server " << serverAddress << ':' << fourinarow::SERVER_PORT;
     std::cout << " binding to the address " << clientAddress << ':' << fourinarow::SERVER_PORT << std::endl;
 
     try {
-        fourinarow::TcpSocket serverSocket;
-
         /*
          * The bind is necessary to let the server know exactly which IP address
          * the client will use for P2P communications. In principle, binding to a specific port
@@ -139,10 +138,7 @@ fourinarow::TcpSocket connectToRemoteServer(const std::string &clientAddress, co
          * by selecting a random number, the port is chosen to be the same one that is
          * used by the server to listen for incoming requests.
          */
-        serverSocket.bind(clientAddress, fourinarow::SERVER_PORT);
-
-        serverSocket.connect(serverAddress, fourinarow::SERVER_PORT);
-        return serverSocket;
+        session.connect(serverAddress, clientAddress);
     } catch (const std::exception &exception) {
         std::cerr << "Impossible to connect to the remote server. " << exception.what() << std::endl;
         throw std::runtime_error("Cannot connect to the server");
@@ -162,38 +158,33 @@ int main(int argc, char *argv[]) {
         auto digitalSignature = createDigitalSignature(fourinarow::CLIENT_KEYS_FOLDER + username + fourinarow::CLIENT_PRIVATE_KEY_SUFFIX);
         auto certificateStore = createCertificateStore(fourinarow::CLIENT_CERTIFICATES_FOLDER + "UnipiCA_cert.pem",
                                                        fourinarow::CLIENT_CERTIFICATES_FOLDER + "UnipiCA_crl.pem");
-        auto serverSocket = connectToRemoteServer(clientAddress, serverAddress);
-
-        // Object representing this client when communicating with the server.
-        fourinarow::Player myselfForServer;
-
-        // Perform the handshake.
-        auto firstPlayerList = fourinarow::HandshakeHandler::doHandshakeWithServer(serverSocket,
-                                                                                   myselfForServer,
-                                                                                   username,
-                                                                                   certificateStore,
-                                                                                   digitalSignature);
-        while (true) {
-            // Handle the pre-game phase.
-            fourinarow::PlayerMessage opponent;
-            std::string opponentUsername;
-            auto playGame = fourinarow::PreGameHandler::handle(serverSocket,myselfForServer, firstPlayerList,opponent,opponentUsername);
-
-            if (!playGame) {
-                std::cout << "Goodbye!" << std::endl;
-                return 0;
+
+        fourinarow::SessionHandler sessionHandler(clientAddress, digitalSignature);
+        fourinarow::ClientSession session(username, digitalSignature, certificateStore, sessionHandler);
+        connectToRemoteServer(session, clientAddress, serverAddress);
+
+        // The loop waits for both the messages of the server and the commands of the user.
+        fourinarow::SessionLoop loop;
+        loop.add(session);
+        loop.watch(STDIN_FILENO);
+
+        while (session.getState() != fourinarow::ClientSession::State::CLOSED) {
+            loop.runOnce(1);
+
+            // A P2P match blocks until its end, so it is played outside of the events of the session.
+            if (sessionHandler.hasPendingMatch()) {
+                sessionHandler.playPendingMatch(session);
+                continue;
             }
 
-            auto handshakeResult = fourinarow::HandshakeHandler::doHandshakeWithPlayer(clientAddress, opponent, digitalSignature);
-            if (std::get<2>(handshakeResult)) { // Handshake succeeded.
-                std::get<1>(handshakeResult)->setUsername(opponentUsername);
-                fourinarow::GameHandler::handle(*(std::get<0>(handshakeResult)),
-                                                *(std::get<1>(handshakeResult)),
-                                                opponent.isFirstToPlay());
+            if (loop.isReady(STDIN_FILENO) && !sessionHandler.handleInput(session)) {
+                session.close();
+                std::cout << "Goodbye!" << std::endl;
+                return 0;
             }
-            fourinarow::GameHandler::sendEndGame(serverSocket, myselfForServer);
-            firstPlayerList = "";
         }
+
+        return 1;
     } catch (const std::exception &exception) {
         std::cerr << "Fatal error. " << exception.what() << std::endl;
         return 1;
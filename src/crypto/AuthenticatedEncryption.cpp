@@ -1,3 +1,8 @@
+#include <algorithm>
+#if defined(__aarch64__) && defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
 #include <Utils.h>
 #include <CryptoException.h>
 #include <Constants.h>
@@ -6,8 +11,9 @@
 
 namespace fourinarow {
 
-AuthenticatedEncryption::AuthenticatedEncryption(std::vector<unsigned char> key) : key(std::move(key)) {
-    checkKeySize<CryptoException>(this->key);
+AuthenticatedEncryption::AuthenticatedEncryption(std::vector<unsigned char> key, uint8_t cipherSuite)
+: cipherSuite(cipherSuite), cipher(getEvpCipher(cipherSuite)), key(std::move(key)) {
+    checkKeySize<CryptoException>(this->key, getKeySize(cipherSuite));
 }
 
 AuthenticatedEncryption::~AuthenticatedEncryption() {
@@ -17,7 +23,7 @@ AuthenticatedEncryption::~AuthenticatedEncryption() {
 }
 
 AuthenticatedEncryption::AuthenticatedEncryption(AuthenticatedEncryption &&that) noexcept
-: cipher(that.cipher), key(std::move(that.key)) {
+: cipherSuite(that.cipherSuite), cipher(that.cipher), key(std::move(that.key)) {
     that.cipher = nullptr;
     that.key = std::vector<unsigned char>();
 }
@@ -27,6 +33,7 @@ AuthenticatedEncryption& AuthenticatedEncryption::operator=(AuthenticatedEncrypt
         cleanse(key);
     }
 
+    cipherSuite = that.cipherSuite;
     cipher = that.cipher;
     key = std::move(that.key);
     that.cipher = nullptr;
@@ -35,6 +42,68 @@ AuthenticatedEncryption& AuthenticatedEncryption::operator=(AuthenticatedEncrypt
     return *this;
 }
 
+const EVP_CIPHER* AuthenticatedEncryption::getEvpCipher(uint8_t cipherSuite) {
+    if (cipherSuite == CIPHER_AES_128_GCM) {
+        return EVP_aes_128_gcm();
+    }
+
+    if (cipherSuite == CIPHER_CHACHA20_POLY1305) {
+        return EVP_chacha20_poly1305();
+    }
+
+    throw CryptoException("Unsupported cipher suite");
+}
+
+uint8_t AuthenticatedEncryption::getCipherSuite() const {
+    return cipherSuite;
+}
+
+size_t AuthenticatedEncryption::getKeySize(uint8_t cipherSuite) {
+    if (cipherSuite == CIPHER_AES_128_GCM) {
+        return AES_128_GCM_KEY_SIZE;
+    }
+
+    if (cipherSuite == CIPHER_CHACHA20_POLY1305) {
+        return CHACHA20_POLY1305_KEY_SIZE;
+    }
+
+    throw CryptoException("Unsupported cipher suite");
+}
+
+bool AuthenticatedEncryption::hasAesHardwareSupport() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_cpu_supports("aes") && __builtin_cpu_supports("pclmul");
+#elif defined(__aarch64__) && defined(__linux__)
+    auto capabilities = getauxval(AT_HWCAP);
+    return (capabilities & HWCAP_AES) && (capabilities & HWCAP_PMULL);
+#else
+    return false;
+#endif
+}
+
+const std::vector<uint8_t>& AuthenticatedEncryption::getPreferredCipherSuites() {
+    // The CPU does not change while running, so the preference is computed once.
+    static const std::vector<uint8_t> preferredCipherSuites = hasAesHardwareSupport() ?
+            std::vector<uint8_t>{CIPHER_AES_128_GCM, CIPHER_CHACHA20_POLY1305} :
+            std::vector<uint8_t>{CIPHER_CHACHA20_POLY1305, CIPHER_AES_128_GCM};
+    return preferredCipherSuites;
+}
+
+uint8_t AuthenticatedEncryption::negotiateCipherSuite(const std::vector<uint8_t> &offeredCipherSuites) {
+    if (!offeredCipherSuites.empty() && offeredCipherSuites.front() == CIPHER_CHACHA20_POLY1305) {
+        return CIPHER_CHACHA20_POLY1305;
+    }
+
+    for (auto cipherSuite : getPreferredCipherSuites()) {
+        if (std::find(offeredCipherSuites.begin(), offeredCipherSuites.end(), cipherSuite) !=
+            offeredCipherSuites.end()) {
+            return cipherSuite;
+        }
+    }
+
+    return CIPHER_AES_128_GCM;
+}
+
 std::vector<unsigned char> AuthenticatedEncryption::encrypt(const std::vector<unsigned char> &plaintext,
                                                             const std::vector<unsigned char> &aad) const {
     if (plaintext.empty()) {
@@ -1,31 +1,45 @@
 #ifndef INC_4INAROW_AUTHENTICATEDENCRYPTION_H
 #define INC_4INAROW_AUTHENTICATEDENCRYPTION_H
 
+#include <cstdint>
 #include <vector>
 #include <openssl/evp.h>
+#include <Constants.h>
 
 namespace fourinarow {
 
 /**
- * Class used to perform authenticated encryption using AES-128 in Galois Counter Mode (GCM).
+ * Class used to perform authenticated encryption using either AES-128 in Galois Counter Mode (GCM)
+ * or ChaCha20-Poly1305. The two cipher suites share the size of the initialization vector and of the tag.
+ * AES-128 GCM is faster on the CPUs implementing AES in hardware, ChaCha20-Poly1305 on the others.
  * The private key is held in memory for the entire lifetime of an object,
  * and securely destroyed when the destructor is called.
  * The initialization vector is randomly generated at each encryption.
  */
 class AuthenticatedEncryption {
     private:
-        const EVP_CIPHER *cipher = EVP_aes_128_gcm();
+        uint8_t cipherSuite;
+        const EVP_CIPHER *cipher;
         std::vector<unsigned char> key;
+
+        /**
+         * Returns the OpenSSL cipher implementing the given cipher suite.
+         * @param cipherSuite  the cipher suite.
+         * @return             the cipher.
+         * @throws CryptoException  if the cipher suite is not supported.
+         */
+        static const EVP_CIPHER* getEvpCipher(uint8_t cipherSuite);
     public:
         /**
-         * Creates an object able to encrypt and decrypt messages using AES-128 GCM.
-         * The given key must be on 16 bytes.
+         * Creates an object able to encrypt and decrypt messages using the given cipher suite.
+         * The given key must be on 16 bytes for AES-128 GCM, on 32 bytes for ChaCha20-Poly1305.
          * Note that the method makes a copy of the key, so it is responsibility
          * of the caller to securely destroy the original one.
-         * @param key  the key.
-         * @throws CryptoException  if the key is wrongly sized.
+         * @param key          the key.
+         * @param cipherSuite  the cipher suite, by default AES-128 GCM.
+         * @throws CryptoException  if the cipher suite is not supported, or the key is wrongly sized.
          */
-        explicit AuthenticatedEncryption(std::vector<unsigned char> key);
+        explicit AuthenticatedEncryption(std::vector<unsigned char> key, uint8_t cipherSuite = CIPHER_AES_128_GCM);
 
         /**
          * Destroys the object and securely wipes the private key from memory.
@@ -53,8 +67,42 @@ class AuthenticatedEncryption {
         AuthenticatedEncryption(const AuthenticatedEncryption&) = delete;
         AuthenticatedEncryption& operator=(const AuthenticatedEncryption&) = delete;
 
+        uint8_t getCipherSuite() const;
+
+        /**
+         * Returns the key size required by the given cipher suite.
+         * @param cipherSuite  the cipher suite.
+         * @return             the key size, in bytes.
+         * @throws CryptoException  if the cipher suite is not supported.
+         */
+        static size_t getKeySize(uint8_t cipherSuite);
+
+        /**
+         * Checks if the CPU implements AES and the carry-less multiplication used by GCM in hardware.
+         * The check is done on x86 and on ARMv8 under Linux: on the other platforms, the method returns false.
+         * @return  true if AES-128 GCM is accelerated by the CPU, false otherwise.
+         */
+        static bool hasAesHardwareSupport();
+
+        /**
+         * Returns the supported cipher suites, ordered by preference of the running host:
+         * AES-128 GCM comes first if the CPU accelerates it, ChaCha20-Poly1305 otherwise.
+         * @return  the cipher suites, by preference.
+         */
+        static const std::vector<uint8_t>& getPreferredCipherSuites();
+
+        /**
+         * Chooses the cipher suite of a session among the ones offered by the other party, ordered by its preference.
+         * If the other party prefers ChaCha20-Poly1305, it lacks hardware support for AES and its choice
+         * is honoured, since ChaCha20-Poly1305 is fast on every CPU. Otherwise, the first suite
+         * of <code>getPreferredCipherSuites()</code> that was offered is chosen.
+         * @param offeredCipherSuites  the cipher suites offered by the other party, possibly empty.
+         * @return                     the chosen cipher suite, AES-128 GCM if no supported suite was offered.
+         */
+        static uint8_t negotiateCipherSuite(const std::vector<uint8_t> &offeredCipherSuites);
+
         /**
-         * Encrypts a plaintext using AES-128 GCM.
+         * Encrypts a plaintext using the cipher suite of the object.
          * The method extracts a random initialization vector of 12 bytes at each encryption and
          * generates a tag of 128 bits that depends on the given additional authenticated data.
          * The returned result is a concatenation of the IV, the ciphertext and the tag, where
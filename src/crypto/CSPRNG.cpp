@@ -1,10 +1,87 @@
+#include <algorithm>
+#include <string.h>
+#include <pthread.h>
+#include <openssl/crypto.h>
 #include <openssl/rand.h>
+#include <Constants.h>
 #include "CryptoException.h"
 #include "Utils.h"
 #include "CSPRNG.h"
 
 namespace fourinarow {
 
+namespace {
+
+/**
+ * Block of random bytes drawn from the OpenSSL DRBG and owned by a single thread, so that
+ * the bytes can be handed out without taking any lock. Every byte is wiped as soon as it is consumed.
+ */
+class RandomBlock {
+    private:
+        std::vector<unsigned char> bytes;
+        size_t position;  // The first byte not consumed yet.
+
+        void refill() {
+            if (1 != RAND_bytes(bytes.data(), bytes.size())) {
+                throw CryptoException(getOpenSslError());
+            }
+            position = 0;
+        }
+    public:
+        RandomBlock() : bytes(CSPRNG_BLOCK_SIZE), position(CSPRNG_BLOCK_SIZE) {}
+
+        ~RandomBlock() {
+            discard();
+        }
+
+        RandomBlock(const RandomBlock&) = delete;
+        RandomBlock(RandomBlock&&) = delete;
+        RandomBlock& operator=(const RandomBlock&) = delete;
+        RandomBlock& operator=(RandomBlock&&) = delete;
+
+        void take(unsigned char *destination, size_t numberOfBytes) {
+            while (numberOfBytes > 0) {
+                if (position == bytes.size()) {
+                    refill();
+                }
+
+                auto chunk = std::min(numberOfBytes, bytes.size() - position);
+                memcpy(destination, bytes.data() + position, chunk);
+                OPENSSL_cleanse(bytes.data() + position, chunk);
+
+                position += chunk;
+                destination += chunk;
+                numberOfBytes -= chunk;
+            }
+        }
+
+        void discard() {
+            OPENSSL_cleanse(bytes.data(), bytes.size());
+            position = bytes.size();
+        }
+};
+
+thread_local RandomBlock randomBlock;
+
+/*
+ * After a fork, the child must not hand out the bytes drawn by the parent. Only the thread
+ * calling fork() survives in the child, so its block is the only one that could be reused.
+ */
+void discardAfterFork() {
+    randomBlock.discard();
+}
+
+const int forkHandlerRegistration = pthread_atfork(nullptr, nullptr, discardAfterFork);
+
+RandomBlock& getRandomBlock() {
+    if (forkHandlerRegistration != 0) {
+        throw CryptoException("Impossible to protect the random bytes across forks");
+    }
+    return randomBlock;
+}
+
+}
+
 void fourinarow::CSPRNG::nextBytes(std::vector<unsigned char> &destination, unsigned int numberOfBytes) {
     if (destination.size() < numberOfBytes) {
         throw CryptoException("The destination vector is too small");
@@ -13,18 +90,21 @@ void fourinarow::CSPRNG::nextBytes(std::vector<unsigned char> &destination, unsi
     /*
      * OpenSSL manages automatically the (re-)seeding of the RNG
      * (at least in OpenSSL 1.1.1+), so there is no need to call RAND_poll().
+     * Requests bigger than a block are not worth buffering.
      */
-    if (1 != RAND_bytes(destination.data(), numberOfBytes)) {
-        throw CryptoException(getOpenSslError());
+    if (numberOfBytes >= CSPRNG_BLOCK_SIZE) {
+        if (1 != RAND_bytes(destination.data(), numberOfBytes)) {
+            throw CryptoException(getOpenSslError());
+        }
+        return;
     }
+
+    getRandomBlock().take(destination.data(), numberOfBytes);
 }
 
 bool fourinarow::CSPRNG::nextBool() {
     uint8_t randomInt;
-
-    if (1 != RAND_bytes(&randomInt, sizeof(uint8_t))) {
-        throw CryptoException(getOpenSslError());
-    }
+    getRandomBlock().take(&randomInt, sizeof(uint8_t));
 
     if (randomInt <= 127) {
         return false;
@@ -7,6 +7,9 @@ namespace fourinarow {
 
 /**
  * Class representing a cryptographically-secure pseudorandom number generator.
+ * Every thread draws blocks of <code>CSPRNG_BLOCK_SIZE</code> bytes from the generator of OpenSSL
+ * and hands them out without taking any lock, wiping each byte as soon as it is consumed.
+ * The bytes still buffered by a thread calling <code>fork()</code> are discarded in the child.
  */
 class CSPRNG {
     public:
@@ -19,7 +22,8 @@ class CSPRNG {
 
         /**
          * Generates a given number of random bytes and saves them inside the destination vector.
-         * The bytes are generated exploiting <code>RAND_bytes()</code> offered by OpenSSL.
+         * The bytes are taken from the block of the calling thread, or generated directly exploiting
+         * <code>RAND_bytes()</code> offered by OpenSSL if they are at least as many as a block.
          * @param destination    the destination vector.
          * @param numberOfBytes  the number of bytes to generate.
          * @throws CryptoException  if the destination vector is not big enough to hold the bytes,
@@ -0,0 +1,50 @@
+#include <CryptoException.h>
+#include "SHA256.h"
+#include "CertificateCache.h"
+
+namespace fourinarow {
+
+CertificateCache::CertificateCache() : certificate(nullptr), storeRevision(0) {}
+
+const std::vector<unsigned char>& CertificateCache::getFingerprint() const {
+    return fingerprint;
+}
+
+const Certificate& CertificateCache::put(const std::vector<unsigned char> &serializedCertificate,
+                                         Certificate verifiedCertificate,
+                                         const CertificateStore &certificateStore) {
+    fingerprint = SHA256::hash(serializedCertificate);
+    certificate = std::make_unique<Certificate>(std::move(verifiedCertificate));
+    storeRevision = certificateStore.getRevision();
+    return *certificate;
+}
+
+const Certificate& CertificateCache::get(const CertificateStore &certificateStore) {
+    if (certificate == nullptr) {
+        throw CryptoException("No cached certificate");
+    }
+
+    // The expiration is checked on every use, since it does not depend on the store.
+    if (X509_cmp_current_time(X509_get0_notAfter(certificate->getRawCertificate())) <= 0) {
+        clear();
+        throw CryptoException("The cached certificate is expired");
+    }
+
+    if (storeRevision != certificateStore.getRevision()) {
+        if (!certificateStore.verifyCertificate(*certificate)) {
+            clear();
+            throw CryptoException("The cached certificate is no longer valid");
+        }
+        storeRevision = certificateStore.getRevision();
+    }
+
+    return *certificate;
+}
+
+void CertificateCache::clear() {
+    fingerprint.clear();
+    certificate.reset();
+    storeRevision = 0;
+}
+
+}
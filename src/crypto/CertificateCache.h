@@ -0,0 +1,74 @@
+#ifndef INC_4INAROW_CERTIFICATECACHE_H
+#define INC_4INAROW_CERTIFICATECACHE_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Certificate.h"
+#include "CertificateStore.h"
+
+namespace fourinarow {
+
+/**
+ * Class representing the cache of a certificate verified by a client during a previous handshake.
+ * The client sends the fingerprint of the cached certificate in its <code>CLIENT_HELLO</code>:
+ * if the certificate of the server did not change, the server omits it from the <code>SERVER_HELLO</code>,
+ * and the client reuses the cached one without deserializing and verifying it again.
+ * The cached certificate is verified again only if the certificate store changed since the last
+ * verification, e.g. because a certificate revocation list was added, and is dropped once expired.
+ */
+class CertificateCache {
+    private:
+        std::vector<unsigned char> fingerprint;
+        std::unique_ptr<Certificate> certificate;
+        uint64_t storeRevision;
+    public:
+        /**
+         * Creates an empty cache.
+         */
+        CertificateCache();
+        ~CertificateCache() = default;
+
+        CertificateCache(CertificateCache&&) = default;
+        CertificateCache& operator=(CertificateCache&&) = default;
+        CertificateCache(const CertificateCache&) = delete;
+        CertificateCache& operator=(const CertificateCache&) = delete;
+
+        /**
+         * Returns the SHA-256 fingerprint of the cached certificate, in DER format.
+         * @return  the fingerprint, or an empty vector if the cache is empty.
+         */
+        const std::vector<unsigned char>& getFingerprint() const;
+
+        /**
+         * Caches a certificate, replacing the previous one. The certificate must have been
+         * verified against the given store by the caller.
+         * @param serializedCertificate  the certificate in DER format, as received from the server.
+         * @param verifiedCertificate    the deserialized certificate.
+         * @param certificateStore       the store the certificate was verified against.
+         * @return                       the cached certificate.
+         * @throws CryptoException  if an error occurs while computing the fingerprint.
+         */
+        const Certificate& put(const std::vector<unsigned char> &serializedCertificate,
+                               Certificate verifiedCertificate,
+                               const CertificateStore &certificateStore);
+
+        /**
+         * Returns the cached certificate. If the given store changed since the certificate
+         * was verified, the certificate is verified again.
+         * @param certificateStore  the store verifying the certificate.
+         * @return                  the cached certificate.
+         * @throws CryptoException  if the cache is empty, or the certificate expired or is no longer
+         *                          valid for the store. In the last two cases, the cache is emptied.
+         */
+        const Certificate& get(const CertificateStore &certificateStore);
+
+        /**
+         * Empties the cache.
+         */
+        void clear();
+};
+
+}
+
+#endif //INC_4INAROW_CERTIFICATECACHE_H
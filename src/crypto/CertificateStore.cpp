@@ -15,6 +15,7 @@ CertificateStore::CertificateStore() {
     }
 
     empty = true;
+    revision = 0;
 }
 
 CertificateStore::~CertificateStore() {
@@ -23,7 +24,8 @@ CertificateStore::~CertificateStore() {
     }
 }
 
-CertificateStore::CertificateStore(CertificateStore &&that) noexcept : store(that.store), empty(that.empty) {
+CertificateStore::CertificateStore(CertificateStore &&that) noexcept
+: store(that.store), empty(that.empty), revision(that.revision) {
     that.store = nullptr; // Avoid a call to X509_STORE_free() when destructing "that".
     that.empty = true;
 }
@@ -35,6 +37,7 @@ CertificateStore& CertificateStore::operator=(CertificateStore &&that) noexcept
 
     store = that.store;
     empty = that.empty;
+    revision = that.revision;
     that.store = nullptr; // Avoid a call to X509_STORE_free() when destructing "that".
     that.empty = true;
     return *this;
@@ -67,6 +70,7 @@ void CertificateStore::addCertificate(const std::string &path) {
 
     X509_free(certificate);
     empty = false;
+    revision++;
 }
 
 X509_CRL* CertificateStore::loadCertificateRevocationList(const std::string &path) {
@@ -99,6 +103,11 @@ void CertificateStore::addCertificateRevocationList(const std::string &path) {
     if (1 != X509_STORE_set_flags(store, X509_V_FLAG_CRL_CHECK)) {
         throw CryptoException(getOpenSslError());
     }
+    revision++;
+}
+
+uint64_t CertificateStore::getRevision() const {
+    return revision;
 }
 
 bool CertificateStore::verifyCertificate(const Certificate &certificate) const {
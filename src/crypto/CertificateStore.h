@@ -1,6 +1,7 @@
 #ifndef INC_4INAROW_CERTIFICATESTORE_H
 #define INC_4INAROW_CERTIFICATESTORE_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <openssl/x509.h>
@@ -19,6 +20,7 @@ class CertificateStore {
     private:
         X509_STORE *store;
         bool empty;
+        uint64_t revision;
 
         /**
          * Loads a certificate from a file. The certificate must be saved in PEM format.
@@ -87,6 +89,14 @@ class CertificateStore {
          */
         void addCertificateRevocationList(const std::string &path);
 
+        /**
+         * Returns the revision of the store, incremented every time a certificate
+         * or a certificate revocation list is added. A certificate verified at a given revision
+         * does not need to be verified again until the revision changes, unless it expires.
+         * @return  the revision.
+         */
+        uint64_t getRevision() const;
+
         /**
          * Verifies an untrusted certificate against the trusted ones saved in the store.
          * @param certificate  the untrusted certificate.
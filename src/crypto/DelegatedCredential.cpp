@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <ctime>
+#include <string.h>
+#include <arpa/inet.h>
+#include <openssl/err.h>
+#include <Constants.h>
+#include <CryptoException.h>
+#include <SerializationException.h>
+#include <Utils.h>
+#include "DelegatedCredential.h"
+
+namespace fourinarow {
+
+namespace {
+
+/**
+ * Context string prepended to the signed content, so that the signature of a credential
+ * cannot be mistaken for the signature of any other message.
+ */
+const std::string CONTEXT = "4InARow delegated credential";
+
+void checkEnoughSpace(const std::vector<unsigned char> &credential, size_t processedBytes, size_t fieldSize) {
+    if (credential.size() < processedBytes + fieldSize) {
+        throw SerializationException("Malformed delegated credential");
+    }
+}
+
+}
+
+DelegatedCredential DelegatedCredential::issue(const DigitalSignature &certificateKey,
+                                               const DigitalSignature &delegatedKey,
+                                               unsigned long lifetime) {
+    auto scheme = delegatedKey.getScheme();
+
+    if (std::find(DELEGATED_SIGNATURE_SCHEMES.begin(), DELEGATED_SIGNATURE_SCHEMES.end(), scheme) ==
+        DELEGATED_SIGNATURE_SCHEMES.end()) {
+        throw CryptoException("Unsupported delegated signature scheme");
+    }
+
+    DelegatedCredential credential;
+    credential.scheme = scheme;
+    credential.expirationTime = static_cast<uint64_t>(std::time(nullptr)) + lifetime;
+    credential.publicKey = delegatedKey.getSerializedPublicKey();
+    credential.signature = certificateKey.sign(credential.getSignedContent());
+
+    return credential;
+}
+
+std::vector<unsigned char> DelegatedCredential::getSignedContent() const {
+    std::vector<unsigned char> content(CONTEXT.begin(), CONTEXT.end());
+    content.push_back(scheme);
+
+    for (size_t i = 0; i < sizeof(expirationTime); i++) {
+        content.push_back(static_cast<unsigned char>(expirationTime >> (8 * (sizeof(expirationTime) - 1 - i))));
+    }
+
+    content.insert(content.end(), publicKey.begin(), publicKey.end());
+    return content;
+}
+
+bool DelegatedCredential::verify(const EVP_PKEY *certificateKey) const {
+    auto now = static_cast<uint64_t>(std::time(nullptr));
+
+    if (now >= expirationTime || expirationTime - now > SERVER_DELEGATED_CREDENTIAL_LIFETIME) {
+        return false;
+    }
+
+    if (!DigitalSignature::verify(getSignedContent(), signature, certificateKey)) {
+        return false;
+    }
+
+    // The scheme is signed, but the key must be of the declared type too.
+    const unsigned char *buffer = publicKey.data();
+    EVP_PKEY *delegatedKey = d2i_PUBKEY(nullptr, &buffer, publicKey.size());
+
+    if (!delegatedKey) {
+        ERR_clear_error();
+        return false;
+    }
+
+    try {
+        auto result = DigitalSignature::getScheme(delegatedKey) == scheme;
+        EVP_PKEY_free(delegatedKey);
+        return result;
+    } catch (const CryptoException &exception) {
+        EVP_PKEY_free(delegatedKey);
+        return false;
+    }
+}
+
+bool DelegatedCredential::verifySignature(const std::vector<unsigned char> &message,
+                                          const std::vector<unsigned char> &signature,
+                                          const std::vector<unsigned char> &serializedCredential,
+                                          const EVP_PKEY *certificateKey) {
+    if (serializedCredential.empty()) {
+        return DigitalSignature::verify(message, signature, certificateKey);
+    }
+
+    DelegatedCredential credential;
+    credential.deserialize(serializedCredential);
+
+    return credential.verify(certificateKey) &&
+           DigitalSignature::verify(message, signature, credential.getPublicKey());
+}
+
+std::vector<unsigned char> DelegatedCredential::serialize() const {
+    checkSignaturePublicKeySize<SerializationException>(publicKey);
+    checkDigitalSignatureSize<SerializationException>(signature);
+
+    size_t processedBytes = 0;
+    size_t outputSize = sizeof(scheme) + sizeof(expirationTime) + sizeof(uint16_t) + publicKey.size() +
+                        sizeof(uint16_t) + signature.size();
+    std::vector<unsigned char> credential(outputSize);
+
+    // Serialize the scheme.
+    memcpy(credential.data(), &scheme, sizeof(scheme));
+    processedBytes += sizeof(scheme);
+
+    // Serialize the expiration time.
+    for (size_t i = 0; i < sizeof(expirationTime); i++) {
+        credential[processedBytes + i] =
+                static_cast<unsigned char>(expirationTime >> (8 * (sizeof(expirationTime) - 1 - i)));
+    }
+    processedBytes += sizeof(expirationTime);
+
+    // Serialize the public key and its length.
+    uint16_t publicKeyLength = htons(publicKey.size());
+    memcpy(credential.data() + processedBytes, &publicKeyLength, sizeof(publicKeyLength));
+    processedBytes += sizeof(publicKeyLength);
+
+    memcpy(credential.data() + processedBytes, publicKey.data(), publicKey.size());
+    processedBytes += publicKey.size();
+
+    // Serialize the signature and its length.
+    uint16_t signatureLength = htons(signature.size());
+    memcpy(credential.data() + processedBytes, &signatureLength, sizeof(signatureLength));
+    processedBytes += sizeof(signatureLength);
+
+    memcpy(credential.data() + processedBytes, signature.data(), signature.size());
+
+    return credential;
+}
+
+void DelegatedCredential::deserialize(const std::vector<unsigned char> &credential) {
+    size_t processedBytes = 0;
+
+    // Deserialize the scheme.
+    checkEnoughSpace(credential, processedBytes, sizeof(scheme));
+    memcpy(&scheme, credential.data(), sizeof(scheme));
+    processedBytes += sizeof(scheme);
+
+    // Deserialize the expiration time.
+    checkEnoughSpace(credential, processedBytes, sizeof(expirationTime));
+    expirationTime = 0;
+    for (size_t i = 0; i < sizeof(expirationTime); i++) {
+        expirationTime = (expirationTime << 8) | credential[processedBytes + i];
+    }
+    processedBytes += sizeof(expirationTime);
+
+    // Deserialize the public key and its length.
+    uint16_t publicKeyLength;
+    checkEnoughSpace(credential, processedBytes, sizeof(publicKeyLength));
+    memcpy(&publicKeyLength, credential.data() + processedBytes, sizeof(publicKeyLength));
+    publicKeyLength = ntohs(publicKeyLength);
+    processedBytes += sizeof(publicKeyLength);
+
+    checkEnoughSpace(credential, processedBytes, publicKeyLength);
+    publicKey.assign(credential.begin() + processedBytes, credential.begin() + processedBytes + publicKeyLength);
+    checkSignaturePublicKeySize<SerializationException>(publicKey);
+    processedBytes += publicKeyLength;
+
+    // Deserialize the signature and its length.
+    uint16_t signatureLength;
+    checkEnoughSpace(credential, processedBytes, sizeof(signatureLength));
+    memcpy(&signatureLength, credential.data() + processedBytes, sizeof(signatureLength));
+    signatureLength = ntohs(signatureLength);
+    processedBytes += sizeof(signatureLength);
+
+    checkEnoughSpace(credential, processedBytes, signatureLength);
+    signature.assign(credential.begin() + processedBytes, credential.begin() + processedBytes + signatureLength);
+    checkDigitalSignatureSize<SerializationException>(signature);
+    processedBytes += signatureLength;
+
+    if (processedBytes != credential.size()) {
+        throw SerializationException("Malformed delegated credential");
+    }
+}
+
+uint8_t DelegatedCredential::getScheme() const {
+    return scheme;
+}
+
+uint64_t DelegatedCredential::getExpirationTime() const {
+    return expirationTime;
+}
+
+const std::vector<unsigned char>& DelegatedCredential::getPublicKey() const {
+    return publicKey;
+}
+
+const std::vector<unsigned char>& DelegatedCredential::getSignature() const {
+    return signature;
+}
+
+}
@@ -0,0 +1,93 @@
+#ifndef INC_4INAROW_DELEGATEDCREDENTIAL_H
+#define INC_4INAROW_DELEGATEDCREDENTIAL_H
+
+#include <cstdint>
+#include <vector>
+#include <openssl/evp.h>
+#include "DigitalSignature.h"
+
+namespace fourinarow {
+
+/**
+ * Class representing a delegated credential. The credential binds a short-lived public key and its
+ * signature scheme to an expiration time, and is signed by the long-term key of the server certificate.
+ * A client trusting the certificate can then accept the signatures made by the delegated key, which can be
+ * much cheaper to compute than the RSA signatures made by the certificate key.
+ * The serialized credential is made of the scheme, the expiration time in network byte order,
+ * and the public key and the signature, each preceded by its length.
+ */
+class DelegatedCredential {
+    private:
+        uint8_t scheme = 0;
+        uint64_t expirationTime = 0;
+        std::vector<unsigned char> publicKey;
+        std::vector<unsigned char> signature;
+
+        /**
+         * Returns the content signed by the certificate key: a context string followed
+         * by the scheme, the expiration time and the public key.
+         */
+        std::vector<unsigned char> getSignedContent() const;
+    public:
+        DelegatedCredential() = default;
+        ~DelegatedCredential() = default;
+
+        DelegatedCredential(DelegatedCredential&&) = default;
+        DelegatedCredential(const DelegatedCredential&) = default;
+        DelegatedCredential& operator=(const DelegatedCredential&) = default;
+        DelegatedCredential& operator=(DelegatedCredential&&) = default;
+
+        /**
+         * Issues a credential for a delegated key.
+         * @param certificateKey  the key of the certificate, signing the credential.
+         * @param delegatedKey    the delegated key.
+         * @param lifetime        the validity of the credential, in seconds.
+         * @return                the credential.
+         * @throws CryptoException         if the scheme of the delegated key is not supported,
+         *                                 or an error occurs while signing.
+         * @throws SerializationException  if the public key of the delegated key cannot be serialized.
+         */
+        static DelegatedCredential issue(const DigitalSignature &certificateKey,
+                                         const DigitalSignature &delegatedKey,
+                                         unsigned long lifetime);
+
+        /**
+         * Verifies the credential: the signature must be made by the given certificate key,
+         * the credential must be neither expired nor valid for more than
+         * <code>SERVER_DELEGATED_CREDENTIAL_LIFETIME</code> seconds, and the type of
+         * the public key must match the scheme.
+         * @param certificateKey  the public key of the certificate.
+         * @return                true if the credential is valid, false otherwise.
+         * @throws CryptoException  if an error occurs while verifying the signature.
+         */
+        bool verify(const EVP_PKEY *certificateKey) const;
+
+        /**
+         * Verifies a signature made by a server, either with the key of its certificate
+         * if the serialized credential is empty, or with the delegated key of the credential.
+         * In the latter case, the credential is verified first.
+         * @param message               the signed message.
+         * @param signature             the signature.
+         * @param serializedCredential  the serialized credential, possibly empty.
+         * @param certificateKey        the public key of the certificate.
+         * @return                      true if the credential and the signature are valid, false otherwise.
+         * @throws CryptoException         if an error occurs while verifying the signatures.
+         * @throws SerializationException  if the credential is malformed.
+         */
+        static bool verifySignature(const std::vector<unsigned char> &message,
+                                    const std::vector<unsigned char> &signature,
+                                    const std::vector<unsigned char> &serializedCredential,
+                                    const EVP_PKEY *certificateKey);
+
+        uint8_t getScheme() const;
+        uint64_t getExpirationTime() const;
+        const std::vector<unsigned char>& getPublicKey() const;
+        const std::vector<unsigned char>& getSignature() const;
+
+        std::vector<unsigned char> serialize() const;
+        void deserialize(const std::vector<unsigned char> &credential);
+};
+
+}
+
+#endif //INC_4INAROW_DELEGATEDCREDENTIAL_H
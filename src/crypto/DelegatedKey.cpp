@@ -0,0 +1,32 @@
+#include <ctime>
+#include "DelegatedKey.h"
+
+namespace fourinarow {
+
+DelegatedKey::DelegatedKey(const DigitalSignature &certificateKey, uint8_t scheme, unsigned long lifetime)
+    : key(DigitalSignature::generate(scheme)),
+      credential(DelegatedCredential::issue(certificateKey, key, lifetime)),
+      serializedCredential(credential.serialize()),
+      lifetime(lifetime) {}
+
+bool DelegatedKey::needsRenewal() const {
+    return static_cast<uint64_t>(std::time(nullptr)) + lifetime / 2 >= credential.getExpirationTime();
+}
+
+uint8_t DelegatedKey::getScheme() const {
+    return credential.getScheme();
+}
+
+const DigitalSignature& DelegatedKey::getKey() const {
+    return key;
+}
+
+const DelegatedCredential& DelegatedKey::getCredential() const {
+    return credential;
+}
+
+const std::vector<unsigned char>& DelegatedKey::getSerializedCredential() const {
+    return serializedCredential;
+}
+
+}
@@ -0,0 +1,54 @@
+#ifndef INC_4INAROW_DELEGATEDKEY_H
+#define INC_4INAROW_DELEGATEDKEY_H
+
+#include <cstdint>
+#include <vector>
+#include "DelegatedCredential.h"
+#include "DigitalSignature.h"
+
+namespace fourinarow {
+
+/**
+ * Class representing a short-lived signing key of the server, together with the delegated credential
+ * issued for it by the certificate key. The key is generated when the object is created, and must be
+ * renewed before the credential expires.
+ */
+class DelegatedKey {
+    private:
+        DigitalSignature key;
+        DelegatedCredential credential;
+        std::vector<unsigned char> serializedCredential;
+        unsigned long lifetime;
+    public:
+        /**
+         * Generates a delegated key of the given scheme and issues its credential.
+         * @param certificateKey  the key of the certificate, signing the credential.
+         * @param scheme          the signature scheme, one of <code>DELEGATED_SIGNATURE_SCHEMES</code>.
+         * @param lifetime        the validity of the credential, in seconds.
+         * @throws CryptoException         if the scheme is not supported, or an error occurs
+         *                                 while generating the key or issuing the credential.
+         * @throws SerializationException  if the credential cannot be serialized.
+         */
+        DelegatedKey(const DigitalSignature &certificateKey, uint8_t scheme, unsigned long lifetime);
+        ~DelegatedKey() = default;
+
+        DelegatedKey(DelegatedKey&&) = default;
+        DelegatedKey& operator=(DelegatedKey&&) = default;
+        DelegatedKey(const DelegatedKey&) = delete;
+        DelegatedKey& operator=(const DelegatedKey&) = delete;
+
+        /**
+         * Checks if the key should be renewed, that is if less than half of its lifetime is left.
+         * @return  true if the key should be renewed, false otherwise.
+         */
+        bool needsRenewal() const;
+
+        uint8_t getScheme() const;
+        const DigitalSignature& getKey() const;
+        const DelegatedCredential& getCredential() const;
+        const std::vector<unsigned char>& getSerializedCredential() const;
+};
+
+}
+
+#endif //INC_4INAROW_DELEGATEDKEY_H
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <CryptoException.h>
 #include <SerializationException.h>
 #include <Utils.h>
@@ -50,11 +51,40 @@ void DiffieHellman::generateKeyPair(EVP_PKEY *parameters) {
     EVP_PKEY_CTX_free(context);
 }
 
-DiffieHellman::DiffieHellman() {
+void DiffieHellman::generateX25519KeyPair() {
+    EVP_PKEY_CTX *context = EVP_PKEY_CTX_new_id(EVP_PKEY_X25519, nullptr);
+
+    if (!context) {
+        throw CryptoException(getOpenSslError());
+    }
+
+    if (1 != EVP_PKEY_keygen_init(context)) {
+        EVP_PKEY_CTX_free(context);
+        throw CryptoException(getOpenSslError());
+    }
+
+    if (1 != EVP_PKEY_keygen(context, &(this->privateKey))) {
+        EVP_PKEY_CTX_free(context);
+        throw CryptoException(getOpenSslError());
+    }
+
+    EVP_PKEY_CTX_free(context);
+}
+
+DiffieHellman::DiffieHellman(uint8_t group) : group(group) {
     // Initializations are necessary to avoid problems using the OpenSSL API.
     EVP_PKEY *parameters = nullptr;
     privateKey = nullptr;
 
+    if (group == KEY_EXCHANGE_X25519) {
+        generateX25519KeyPair();
+        return;
+    }
+
+    if (group != KEY_EXCHANGE_ECDH_P256) {
+        throw CryptoException("Unsupported key exchange group");
+    }
+
     generateParameters(&parameters);
 
     try {
@@ -72,7 +102,8 @@ DiffieHellman::~DiffieHellman() {
     }
 }
 
-DiffieHellman::DiffieHellman(DiffieHellman &&that) noexcept : curve(that.curve), privateKey(that.privateKey) {
+DiffieHellman::DiffieHellman(DiffieHellman &&that) noexcept
+    : curve(that.curve), group(that.group), privateKey(that.privateKey) {
     that.privateKey = nullptr; // Avoid a call to EVP_PKEY_free() when destructing "that".
 }
 
@@ -81,12 +112,50 @@ DiffieHellman& DiffieHellman::operator=(DiffieHellman &&that) noexcept {
         EVP_PKEY_free(privateKey);
     }
 
+    group = that.group;
     privateKey = that.privateKey;
     that.privateKey = nullptr; // Avoid a call to EVP_PKEY_free() when destructing "that".
     return *this;
 }
 
+uint8_t DiffieHellman::getGroup() const {
+    return group;
+}
+
+uint8_t DiffieHellman::getGroup(const std::vector<unsigned char> &serializedPublicKey) {
+    if (serializedPublicKey.size() == X25519_PUBLIC_KEY_SIZE) {
+        return KEY_EXCHANGE_X25519;
+    }
+
+    if (serializedPublicKey.size() == ECDH_P256_PUBLIC_KEY_SIZE) {
+        return KEY_EXCHANGE_ECDH_P256;
+    }
+
+    throw SerializationException("The public key does not belong to a supported group");
+}
+
+uint8_t DiffieHellman::negotiateGroup(const std::vector<uint8_t> &offeredGroups) {
+    for (auto group : KEY_EXCHANGE_GROUPS) {
+        if (std::find(offeredGroups.begin(), offeredGroups.end(), group) != offeredGroups.end()) {
+            return group;
+        }
+    }
+
+    return KEY_EXCHANGE_ECDH_P256;
+}
+
 std::vector<unsigned char> DiffieHellman::getSerializedPublicKey() const {
+    if (group == KEY_EXCHANGE_X25519) {
+        std::vector<unsigned char> publicKey(X25519_PUBLIC_KEY_SIZE);
+        size_t outputSize = publicKey.size();
+
+        if (1 != EVP_PKEY_get_raw_public_key(privateKey, publicKey.data(), &outputSize)) {
+            throw SerializationException(getOpenSslError());
+        }
+
+        return publicKey;
+    }
+
     unsigned char *publicKeyBuffer = nullptr;
     auto outputSize = i2d_PUBKEY(privateKey, &publicKeyBuffer);
 
@@ -102,6 +171,21 @@ std::vector<unsigned char> DiffieHellman::getSerializedPublicKey() const {
 }
 
 EVP_PKEY* DiffieHellman::deserializePublicKey(const std::vector<unsigned char> &serializedPeerPublicKey) const {
+    if (getGroup(serializedPeerPublicKey) != group) {
+        throw SerializationException("The public key of the peer belongs to a different group");
+    }
+
+    if (group == KEY_EXCHANGE_X25519) {
+        EVP_PKEY *peerPublicKey = EVP_PKEY_new_raw_public_key(EVP_PKEY_X25519, nullptr,
+                                                              serializedPeerPublicKey.data(),
+                                                              serializedPeerPublicKey.size());
+        if (!peerPublicKey) {
+            throw CryptoException(getOpenSslError());
+        }
+
+        return peerPublicKey;
+    }
+
     const unsigned char *buffer = serializedPeerPublicKey.data();
     EVP_PKEY *peerPublicKey = d2i_PUBKEY(nullptr, &buffer, serializedPeerPublicKey.size());
 
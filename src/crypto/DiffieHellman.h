@@ -3,21 +3,26 @@
 
 #include <openssl/evp.h>
 #include <openssl/pem.h>
+#include <cstdint>
 #include <vector>
 #include <ostream>
+#include <Constants.h>
 
 namespace fourinarow {
 
 /**
  * Class used to perform a key exchange exploiting Elliptic-curve Diffie-Hellman.
- * It allows to generate a private-public key pair using the standardized prime256v1 curve
- * and to generate a shared secret using the public key of another party.
+ * It allows to generate a private-public key pair of a key exchange group, either the standardized
+ * prime256v1 curve or X25519, and to generate a shared secret using the public key of another party.
+ * The public keys of prime256v1 are serialized in DER format, while the ones of X25519 are serialized
+ * in raw format: the group of a serialized key is given by its size.
  * The private key is held in memory for the entire lifetime of an object,
  * and securely destroyed when the destructor is called.
  */
 class DiffieHellman {
     private:
         const int curve = NID_X9_62_prime256v1;
+        uint8_t group;
         EVP_PKEY *privateKey;
 
         /**
@@ -35,6 +40,12 @@ class DiffieHellman {
          */
         void generateKeyPair(EVP_PKEY *parameters);
 
+        /**
+         * Generates an X25519 private-public key pair, which needs no parameters.
+         * @throws CryptoException  if an error occurs while generating the pair.
+         */
+        void generateX25519KeyPair();
+
         /**
          * Parses a public key in binary format, returning a representation
          * usable by the OpenSSL API. It is responsibility of the caller
@@ -48,10 +59,11 @@ class DiffieHellman {
     public:
         /**
          * Creates a private-public key pair using Elliptic-curve Diffie-Hellman
-         * and the standardized prime256v1 curve.
-         * @throws CryptoException  if an error occurs while generating the pair.
+         * and the given group, by default the standardized prime256v1 curve.
+         * @param group  the key exchange group.
+         * @throws CryptoException  if the group is not supported, or an error occurs while generating the pair.
          */
-        DiffieHellman();
+        explicit DiffieHellman(uint8_t group = KEY_EXCHANGE_ECDH_P256);
 
         /**
          * Destroys the object and securely wipes the private key from memory.
@@ -79,6 +91,27 @@ class DiffieHellman {
         DiffieHellman(const DiffieHellman&) = delete;
         DiffieHellman& operator=(const DiffieHellman&) = delete;
 
+        /**
+         * Returns the key exchange group of the key pair.
+         */
+        uint8_t getGroup() const;
+
+        /**
+         * Returns the key exchange group of a serialized public key, given by its size.
+         * @param serializedPublicKey  the public key, in binary format.
+         * @return                     the key exchange group.
+         * @throws SerializationException  if the size does not match any supported group.
+         */
+        static uint8_t getGroup(const std::vector<unsigned char> &serializedPublicKey);
+
+        /**
+         * Chooses the key exchange group of a handshake, namely the first group in <code>KEY_EXCHANGE_GROUPS</code>
+         * offered by the other party, falling back to prime256v1 if none is offered.
+         * @param offeredGroups  the groups offered by the other party.
+         * @return               the key exchange group.
+         */
+        static uint8_t negotiateGroup(const std::vector<uint8_t> &offeredGroups);
+
         /**
          * Returns the public key in binary format, ready to be sent through a socket.
          * @return  the public key, in binary format.
@@ -87,7 +120,8 @@ class DiffieHellman {
         std::vector<unsigned char> getSerializedPublicKey() const;
 
         /**
-         * Derives a shared secret using the private key held by the object and the given public key.
+         * Derives a shared secret using the private key held by the object and the given public key,
+         * which must belong to the same group.
          * @param serializedPeerPublicKey  the public key of the peer, in binary format.
          * @return                         the shared secret, in binary format.
          * @throws CryptoException         if the given public key is empty, or an error occurs
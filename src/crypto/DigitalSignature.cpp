@@ -1,16 +1,84 @@
+#include <openssl/ec.h>
+#include <openssl/err.h>
 #include <CryptoException.h>
 #include <SerializationException.h>
+#include <Constants.h>
 #include <Utils.h>
 #include "DigitalSignature.h"
 
 namespace fourinarow {
 
-const EVP_MD* DigitalSignature::hashFunction = EVP_sha256();
-
 DigitalSignature::DigitalSignature(const std::string &path) {
     loadPrivateKey(path);
 }
 
+DigitalSignature::DigitalSignature(EVP_PKEY *privateKey) : privateKey(privateKey) {}
+
+DigitalSignature DigitalSignature::generate(uint8_t scheme) {
+    EVP_PKEY_CTX *context;
+
+    if (scheme == SIGNATURE_ECDSA_P256_SHA256) {
+        context = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+    } else if (scheme == SIGNATURE_ED25519) {
+        context = EVP_PKEY_CTX_new_id(EVP_PKEY_ED25519, nullptr);
+    } else {
+        throw CryptoException("Unsupported signature scheme");
+    }
+
+    if (!context) {
+        throw CryptoException(getOpenSslError());
+    }
+
+    if (1 != EVP_PKEY_keygen_init(context)) {
+        EVP_PKEY_CTX_free(context);
+        throw CryptoException(getOpenSslError());
+    }
+
+    if (scheme == SIGNATURE_ECDSA_P256_SHA256 &&
+        1 != EVP_PKEY_CTX_set_ec_paramgen_curve_nid(context, NID_X9_62_prime256v1)) {
+        EVP_PKEY_CTX_free(context);
+        throw CryptoException(getOpenSslError());
+    }
+
+    EVP_PKEY *privateKey = nullptr;
+
+    if (1 != EVP_PKEY_keygen(context, &privateKey)) {
+        EVP_PKEY_CTX_free(context);
+        throw CryptoException(getOpenSslError());
+    }
+
+    EVP_PKEY_CTX_free(context);
+    return DigitalSignature(privateKey);
+}
+
+uint8_t DigitalSignature::getScheme() const {
+    return getScheme(privateKey);
+}
+
+uint8_t DigitalSignature::getScheme(const EVP_PKEY *publicKey) {
+    if (publicKey == nullptr) {
+        throw CryptoException("Empty public key");
+    }
+
+    switch (EVP_PKEY_base_id(publicKey)) {
+        case EVP_PKEY_RSA:
+            return SIGNATURE_RSA_PKCS1_SHA256;
+        case EVP_PKEY_EC:
+            if (EVP_PKEY_bits(publicKey) == 256) {
+                return SIGNATURE_ECDSA_P256_SHA256;
+            }
+            throw CryptoException("Unsupported elliptic curve");
+        case EVP_PKEY_ED25519:
+            return SIGNATURE_ED25519;
+        default:
+            throw CryptoException("Unsupported key type");
+    }
+}
+
+const EVP_MD* DigitalSignature::getHashFunction(uint8_t scheme) {
+    return scheme == SIGNATURE_ED25519 ? nullptr : EVP_sha256();
+}
+
 DigitalSignature::~DigitalSignature() {
     if (privateKey != nullptr) {
         EVP_PKEY_free(privateKey);
@@ -68,26 +136,23 @@ std::vector<unsigned char> DigitalSignature::sign(const std::vector<unsigned cha
         throw CryptoException("Empty message");
     }
 
+    auto hashFunction = getHashFunction(getScheme());
     EVP_MD_CTX *context = EVP_MD_CTX_new();
 
     if (!context) {
         throw CryptoException(getOpenSslError());
     }
 
-    if (1 != EVP_SignInit(context, hashFunction)) {
-        EVP_MD_CTX_free(context);
-        throw CryptoException(getOpenSslError());
-    }
-
-    if (1 != EVP_SignUpdate(context, message.data(), message.size())) {
+    if (1 != EVP_DigestSignInit(context, nullptr, hashFunction, nullptr, privateKey)) {
         EVP_MD_CTX_free(context);
         throw CryptoException(getOpenSslError());
     }
 
-    std::vector<unsigned char> signature(EVP_PKEY_size(privateKey));
-    auto length = 0u;
+    // One-shot signing, the only mode supported by Ed25519.
+    auto length = (size_t) EVP_PKEY_size(privateKey);
+    std::vector<unsigned char> signature(length);
 
-    if (1 != EVP_SignFinal(context, signature.data(), &length, privateKey)) {
+    if (1 != EVP_DigestSign(context, signature.data(), &length, message.data(), message.size())) {
         EVP_MD_CTX_free(context);
         throw CryptoException(getOpenSslError());
     }
@@ -108,34 +173,25 @@ bool DigitalSignature::verify(const std::vector<unsigned char> &message,
         throw CryptoException("Empty signature");
     }
 
-    if (publicKey == nullptr) {
-        throw CryptoException("Empty public key");
-    }
-
+    auto hashFunction = getHashFunction(getScheme(publicKey));
     EVP_MD_CTX *context = EVP_MD_CTX_new();
 
     if (!context) {
         throw CryptoException(getOpenSslError());
     }
 
-    if (1 != EVP_VerifyInit(context, hashFunction)) {
+    if (1 != EVP_DigestVerifyInit(context, nullptr, hashFunction, nullptr, (EVP_PKEY*) publicKey)) {
         EVP_MD_CTX_free(context);
         throw CryptoException(getOpenSslError());
     }
 
-    if (1 != EVP_VerifyUpdate(context, message.data(), message.size())) {
-        EVP_MD_CTX_free(context);
-        throw CryptoException(getOpenSslError());
-    }
-
-    auto result = EVP_VerifyFinal(context, signature.data(), signature.size(), (EVP_PKEY*) publicKey);
+    auto result = EVP_DigestVerify(context, signature.data(), signature.size(), message.data(), message.size());
     EVP_MD_CTX_free(context);
 
-    if (result == -1) {
-        throw CryptoException(getOpenSslError());
-    }
-
-    if (result == 0) {
+    // Any value different from 1 means that the signature is not valid. Values lower than 0
+    // can also come from a malformed signature, which is not an error of the verification itself.
+    if (result != 1) {
+        ERR_clear_error();
         return false;
     }
     return true;
@@ -173,18 +229,31 @@ bool DigitalSignature::verify(const std::vector<unsigned char> &message,
 
 std::vector<unsigned char> DigitalSignature::serializePublicKey(const std::string &path) {
     EVP_PKEY *publicKey = loadPublicKey(path);
+
+    try {
+        auto serializedPublicKey = serializePublicKey(publicKey);
+        EVP_PKEY_free(publicKey);
+        return serializedPublicKey;
+    } catch (const SerializationException &exception) {
+        EVP_PKEY_free(publicKey);
+        throw;
+    }
+}
+
+std::vector<unsigned char> DigitalSignature::getSerializedPublicKey() const {
+    return serializePublicKey(privateKey);
+}
+
+std::vector<unsigned char> DigitalSignature::serializePublicKey(const EVP_PKEY *publicKey) {
     unsigned char *buffer = nullptr;
-    auto outputSize = i2d_PUBKEY(publicKey, &buffer);
+    auto outputSize = i2d_PUBKEY((EVP_PKEY*) publicKey, &buffer);
 
     if (outputSize < 0) {
-        EVP_PKEY_free(publicKey);
         throw SerializationException(getOpenSslError());
     }
 
     std::vector<unsigned char> serializedPublicKey(outputSize);
     memcpy(serializedPublicKey.data(), buffer, outputSize);
-
-    EVP_PKEY_free(publicKey);
     OPENSSL_free(buffer);
     return serializedPublicKey;
 }
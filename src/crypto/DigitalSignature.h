@@ -1,6 +1,7 @@
 #ifndef INC_4INAROW_DIGITALSIGNATURE_H
 #define INC_4INAROW_DIGITALSIGNATURE_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <openssl/pem.h>
@@ -9,17 +10,30 @@ namespace fourinarow {
 
 /**
  * Class used to digitally sign binary data. It allows to create signatures using
- * a private key loaded at construction time from a file, and to verify a signature
- * using a public key passed at run-time. The signing and verification procedures
- * are performed on the SHA256 digest of the given data.
+ * a private key loaded at construction time from a file or freshly generated, and to verify
+ * a signature using a public key passed at run-time. The signature scheme is given by the type
+ * of the key: RSA and ECDSA P-256 keys sign the SHA256 digest of the given data, while
+ * Ed25519 keys sign the data directly.
  * The private key is held in memory for the entire lifetime of an object,
  * and securely destroyed when the destructor is called.
  */
 class DigitalSignature {
     private:
-        static const EVP_MD *hashFunction;
         EVP_PKEY *privateKey;
 
+        /**
+         * Creates a digital signature object taking the ownership of the given private key.
+         * @param privateKey  the private key.
+         */
+        explicit DigitalSignature(EVP_PKEY *privateKey);
+
+        /**
+         * Returns the digest used by a signature scheme, or <code>nullptr</code>
+         * if the scheme signs the data directly.
+         * @param scheme  the signature scheme.
+         */
+        static const EVP_MD* getHashFunction(uint8_t scheme);
+
         /**
          * Loads a private key in PEM format from a file. If the file is password protected,
          * the user will be prompted to insert the password.
@@ -46,6 +60,14 @@ class DigitalSignature {
          * @throws SerializationException  if the public key is not represented in a correct binary format.
          */
         static EVP_PKEY* deserializePublicKey(const std::vector<unsigned char> &serializedPublicKey);
+
+        /**
+         * Serializes a public key in binary format.
+         * @param publicKey  the public key, in OpenSSL format.
+         * @return           the serialized key.
+         * @throws SerializationException  if an error occurs while serializing the key.
+         */
+        static std::vector<unsigned char> serializePublicKey(const EVP_PKEY *publicKey);
     public:
         /**
          * Creates a digital signature object that will use the private key saved in the
@@ -56,6 +78,15 @@ class DigitalSignature {
          */
         explicit DigitalSignature(const std::string &path);
 
+        /**
+         * Creates a digital signature object using a fresh private key of the given scheme.
+         * @param scheme  the signature scheme, either <code>SIGNATURE_ECDSA_P256_SHA256</code>
+         *                or <code>SIGNATURE_ED25519</code>.
+         * @return        the digital signature object.
+         * @throws CryptoException  if the scheme is not supported, or an error occurs while generating the key.
+         */
+        static DigitalSignature generate(uint8_t scheme);
+
         /**
          * Destroys the object and securely wipes the private key from memory.
          */
@@ -81,7 +112,27 @@ class DigitalSignature {
         DigitalSignature& operator=(const DigitalSignature&) = delete;
 
         /**
-         * Signs the SHA256 digest of a message.
+         * Returns the signature scheme of the private key.
+         * @throws CryptoException  if the key type is not supported.
+         */
+        uint8_t getScheme() const;
+
+        /**
+         * Returns the serialized public key matching the private key.
+         * @throws SerializationException  if an error occurs while serializing the key.
+         */
+        std::vector<unsigned char> getSerializedPublicKey() const;
+
+        /**
+         * Returns the signature scheme of a public key, given by its type.
+         * @param publicKey  the public key.
+         * @return           the signature scheme.
+         * @throws CryptoException  if the public key is empty, or its type is not supported.
+         */
+        static uint8_t getScheme(const EVP_PKEY *publicKey);
+
+        /**
+         * Signs a message, hashing it first if the scheme of the private key requires it.
          * @param message  the message to sign.
          * @return         the digital signature of the message.
          * @throws CryptoException  if the message is empty, or an error occurs
@@ -91,7 +142,7 @@ class DigitalSignature {
 
         /**
          * Verifies a digital signature of a message using a public key.
-         * The verification is done using the SHA256 digest of the message.
+         * The scheme is given by the type of the public key.
          * @param message    the message.
          * @param signature  the digital signature to verify.
          * @param publicKey  the public key used to verify the signature.
@@ -105,8 +156,7 @@ class DigitalSignature {
 
         /**
          * Verifies a digital signature of a message using a public key stored
-         * in PEM format in a file. The verification is done using
-         * the SHA256 digest of the message.
+         * in PEM format in a file. The scheme is given by the type of the public key.
          * @param message    the message.
          * @param signature  the digital signature to verify.
          * @param path       the path of the file containing the public key.
@@ -121,7 +171,7 @@ class DigitalSignature {
 
         /**
          * Verifies a digital signature of a message using a serialized public key.
-         * The verification is done using the SHA256 digest of the message.
+         * The scheme is given by the type of the public key.
          * @param message    the message.
          * @param signature  the digital signature to verify.
          * @param publicKey  the public key used to verify the signature.
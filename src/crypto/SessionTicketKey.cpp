@@ -0,0 +1,68 @@
+#include <ctime>
+#include <Constants.h>
+#include <CryptoException.h>
+#include <Utils.h>
+#include "CSPRNG.h"
+#include "SessionTicketKey.h"
+
+namespace fourinarow {
+
+std::vector<unsigned char> SessionTicketKey::generateKey() {
+    std::vector<unsigned char> key(AES_128_GCM_KEY_SIZE);
+    CSPRNG::nextBytes(key, AES_128_GCM_KEY_SIZE);
+    return key;
+}
+
+SessionTicketKey::SessionTicketKey() : authenticatedEncryption(generateKey()) {}
+
+std::vector<unsigned char> SessionTicketKey::issue(const std::string &username,
+                                                   const std::vector<unsigned char> &resumptionSecret,
+                                                   uint8_t cipherSuite) const {
+    if (resumptionSecret.size() != RESUMPTION_SECRET_SIZE) {
+        throw CryptoException("The resumption secret must be on " + std::to_string(RESUMPTION_SECRET_SIZE) + " bytes");
+    }
+
+    // The expiration time is serialized in network byte order, followed by the cipher suite and the secret.
+    uint64_t expiration = static_cast<uint64_t>(std::time(nullptr)) + SERVER_TICKET_LIFETIME;
+    std::vector<unsigned char> plaintext(sizeof(expiration) + sizeof(cipherSuite) + RESUMPTION_SECRET_SIZE);
+
+    for (size_t i = 0; i < sizeof(expiration); i++) {
+        plaintext[i] = static_cast<unsigned char>(expiration >> (8 * (sizeof(expiration) - 1 - i)));
+    }
+    plaintext[sizeof(expiration)] = cipherSuite;
+    std::copy(resumptionSecret.begin(), resumptionSecret.end(),
+              plaintext.begin() + sizeof(expiration) + sizeof(cipherSuite));
+
+    std::vector<unsigned char> aad(username.begin(), username.end());
+    auto ticket = authenticatedEncryption.encrypt(plaintext, aad);
+    cleanse(plaintext);
+
+    return ticket;
+}
+
+std::pair<std::vector<unsigned char>, uint8_t> SessionTicketKey::redeem(const std::vector<unsigned char> &ticket,
+                                                                        const std::string &username) const {
+    checkSessionTicketSize<CryptoException>(ticket);
+
+    std::vector<unsigned char> aad(username.begin(), username.end());
+    auto plaintext = authenticatedEncryption.decrypt(ticket, aad);
+
+    uint64_t expiration = 0;
+    for (size_t i = 0; i < sizeof(expiration); i++) {
+        expiration = (expiration << 8) | plaintext[i];
+    }
+
+    if (static_cast<uint64_t>(std::time(nullptr)) >= expiration) {
+        cleanse(plaintext);
+        throw CryptoException("The session ticket is expired");
+    }
+
+    uint8_t cipherSuite = plaintext[sizeof(expiration)];
+    std::vector<unsigned char> resumptionSecret(plaintext.begin() + sizeof(expiration) + sizeof(cipherSuite),
+                                                plaintext.end());
+    cleanse(plaintext);
+
+    return std::make_pair(std::move(resumptionSecret), cipherSuite);
+}
+
+}
@@ -0,0 +1,64 @@
+#ifndef INC_4INAROW_SESSIONTICKETKEY_H
+#define INC_4INAROW_SESSIONTICKETKEY_H
+
+#include <string>
+#include <utility>
+#include <vector>
+#include "AuthenticatedEncryption.h"
+
+namespace fourinarow {
+
+/**
+ * Class representing the key used by the server to issue and redeem session tickets.
+ * A ticket is the authenticated encryption of its expiration time, of the cipher suite of the session
+ * and of a resumption secret,
+ * bound to the username of the player it was issued to, so that the server does not need to store
+ * any state to resume a session. The key is randomly generated when the object is created,
+ * hence the tickets issued by a key cannot be redeemed by a different one.
+ */
+class SessionTicketKey {
+    private:
+        AuthenticatedEncryption authenticatedEncryption;
+
+        static std::vector<unsigned char> generateKey();
+    public:
+        /**
+         * Creates a ticket key, randomly generating the underlying AES-128 GCM key.
+         * @throws CryptoException  if an error occurs while generating the key.
+         */
+        SessionTicketKey();
+        ~SessionTicketKey() = default;
+
+        SessionTicketKey(SessionTicketKey&&) = default;
+        SessionTicketKey& operator=(SessionTicketKey&&) = default;
+        SessionTicketKey(const SessionTicketKey&) = delete;
+        SessionTicketKey& operator=(const SessionTicketKey&) = delete;
+
+        /**
+         * Issues a ticket bound to the given username, valid for <code>SERVER_TICKET_LIFETIME</code> seconds.
+         * @param username          the username of the player the ticket is issued to.
+         * @param resumptionSecret  the resumption secret, on <code>RESUMPTION_SECRET_SIZE</code> bytes.
+         * @param cipherSuite       the cipher suite of the session, used again by the resumed one.
+         * @return                  the ticket, on <code>SESSION_TICKET_SIZE</code> bytes.
+         * @throws CryptoException  if the resumption secret is wrongly sized, or an error occurs while encrypting.
+         */
+        std::vector<unsigned char> issue(const std::string &username,
+                                         const std::vector<unsigned char> &resumptionSecret,
+                                         uint8_t cipherSuite) const;
+
+        /**
+         * Redeems a ticket presented by the given player, returning the resumption secret
+         * and the cipher suite it carries.
+         * @param ticket    the ticket.
+         * @param username  the username of the player presenting the ticket.
+         * @return          a pair containing the resumption secret and the cipher suite.
+         * @throws CryptoException  if the ticket is malformed, was not issued by this key to the given player,
+         *                          or is expired.
+         */
+        std::pair<std::vector<unsigned char>, uint8_t> redeem(const std::vector<unsigned char> &ticket,
+                                                              const std::string &username) const;
+};
+
+}
+
+#endif //INC_4INAROW_SESSIONTICKETKEY_H
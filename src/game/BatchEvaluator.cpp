@@ -0,0 +1,220 @@
+#include <type_traits>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#include "BatchEvaluator.h"
+
+namespace fourinarow {
+
+const int BatchEvaluator::OPEN_TWO_WEIGHT;
+const int BatchEvaluator::OPEN_THREE_WEIGHT;
+const unsigned int BatchEvaluator::DIRECTIONS;
+
+const std::array<unsigned int, BatchEvaluator::DIRECTIONS> BatchEvaluator::distances = {
+        Position::Geometry::VERTICAL,
+        Position::Geometry::HORIZONTAL,
+        Position::Geometry::LEFT_DIAGONAL,
+        Position::Geometry::RIGHT_DIAGONAL
+};
+
+const std::array<uint64_t, BatchEvaluator::DIRECTIONS> BatchEvaluator::windowStarts = BatchEvaluator::generateWindowStarts();
+
+BatchEvaluator::BatchEvaluator() : BatchEvaluator(Kernel::AVX2) {}
+
+BatchEvaluator::BatchEvaluator(Kernel preferredKernel)
+    : kernel(isSupported(preferredKernel) ? preferredKernel : Kernel::SCALAR) {
+    static_assert(std::is_same<Position::Bitboard, uint64_t>::value, "The classic game must fit into 64-bit bitboards");
+    static_assert(CONNECT_LENGTH == 4, "The windows of the classic game must hold four spaces");
+}
+
+BatchEvaluator::Kernel BatchEvaluator::getKernel() const {
+    return kernel;
+}
+
+bool BatchEvaluator::isSupported(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::SCALAR:
+            return true;
+        case Kernel::AVX2:
+#if defined(__x86_64__) || defined(__i386__)
+            return __builtin_cpu_supports("avx2");
+#else
+            return false;
+#endif
+    }
+
+    return false;
+}
+
+std::array<uint64_t, BatchEvaluator::DIRECTIONS> BatchEvaluator::generateWindowStarts() {
+    std::array<uint64_t, DIRECTIONS> starts{};
+    const int rowOffsets[DIRECTIONS] = {1, 0, -1, 1};
+    const int columnOffsets[DIRECTIONS] = {0, 1, 1, 1};
+
+    for (auto direction = 0u; direction < DIRECTIONS; direction++) {
+        for (auto column = 0; column < COLUMNS; column++) {
+            for (auto row = 0; row < ROWS; row++) {
+                auto lastRow = row + (CONNECT_LENGTH - 1)*rowOffsets[direction];
+                auto lastColumn = column + (CONNECT_LENGTH - 1)*columnOffsets[direction];
+
+                if (lastRow >= 0 && lastRow < ROWS && lastColumn < COLUMNS) {
+                    starts[direction] |= Position::Geometry::spaceMask(row, column);
+                }
+            }
+        }
+    }
+
+    return starts;
+}
+
+void BatchEvaluator::evaluateScalar(const uint64_t *current, const uint64_t *mask, size_t count, int *scores) const {
+    for (size_t i = 0; i < count; i++) {
+        const uint64_t players[2] = {current[i], current[i] ^ mask[i]};
+        int openTwos[2] = {0, 0};
+        int openThrees[2] = {0, 0};
+
+        for (auto direction = 0u; direction < DIRECTIONS; direction++) {
+            auto distance = distances[direction];
+
+            for (auto player = 0; player < 2; player++) {
+                auto own = players[player];
+                auto other = players[1 - player];
+
+                // The windows of this direction without discs of the other player.
+                auto free = windowStarts[direction]
+                            & ~(other | other >> distance | other >> 2*distance | other >> 3*distance);
+
+                // Bit-sliced sum of the four discs of every window.
+                auto a = own, b = own >> distance, c = own >> 2*distance, d = own >> 3*distance;
+                auto lowSum = a ^ b, lowCarry = a & b;
+                auto highSum = c ^ d, highCarry = c & d;
+                auto ones = lowSum ^ highSum;
+                auto twos = lowCarry ^ highCarry ^ (lowSum & highSum);
+                auto fours = lowCarry & highCarry;
+
+                openTwos[player] += __builtin_popcountll(free & twos & ~ones & ~fours);
+                openThrees[player] += __builtin_popcountll(free & twos & ones);
+            }
+        }
+
+        scores[i] = OPEN_TWO_WEIGHT*(openTwos[0] - openTwos[1]) + OPEN_THREE_WEIGHT*(openThrees[0] - openThrees[1]);
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+/**
+ * Counts the bits of each 64-bit lane, using the nibble lookup table of the AVX2 shuffle.
+ * @param value  the lanes.
+ * @return       the number of bits of each lane.
+ */
+__attribute__((target("avx2")))
+static inline __m256i popcount64(__m256i value) {
+    const auto lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                         0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const auto lowNibbles = _mm256_set1_epi8(0x0F);
+
+    auto low = _mm256_and_si256(value, lowNibbles);
+    auto high = _mm256_and_si256(_mm256_srli_epi16(value, 4), lowNibbles);
+    auto counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low), _mm256_shuffle_epi8(lookup, high));
+    return _mm256_sad_epu8(counts, _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2")))
+void BatchEvaluator::evaluateAvx2(const uint64_t *current, const uint64_t *mask, size_t count, int *scores) const {
+    const size_t lanes = 4;
+    size_t i = 0;
+
+    for (; i + lanes <= count; i += lanes) {
+        auto own = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(current + i));
+        auto other = _mm256_xor_si256(own, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask + i)));
+        const __m256i players[2] = {own, other};
+        __m256i openTwos = _mm256_setzero_si256();
+        __m256i openThrees = _mm256_setzero_si256();
+
+        for (auto direction = 0u; direction < DIRECTIONS; direction++) {
+            auto starts = _mm256_set1_epi64x(windowStarts[direction]);
+            const __m128i shifts[3] = {_mm_cvtsi32_si128(distances[direction]),
+                                       _mm_cvtsi32_si128(2*distances[direction]),
+                                       _mm_cvtsi32_si128(3*distances[direction])};
+
+            for (auto player = 0; player < 2; player++) {
+                auto a = players[player];
+                auto b = _mm256_srl_epi64(a, shifts[0]);
+                auto c = _mm256_srl_epi64(a, shifts[1]);
+                auto d = _mm256_srl_epi64(a, shifts[2]);
+
+                auto blocker = players[1 - player];
+                blocker = _mm256_or_si256(_mm256_or_si256(blocker, _mm256_srl_epi64(blocker, shifts[0])),
+                                          _mm256_or_si256(_mm256_srl_epi64(blocker, shifts[1]),
+                                                          _mm256_srl_epi64(blocker, shifts[2])));
+                auto free = _mm256_andnot_si256(blocker, starts);
+
+                auto lowSum = _mm256_xor_si256(a, b), lowCarry = _mm256_and_si256(a, b);
+                auto highSum = _mm256_xor_si256(c, d), highCarry = _mm256_and_si256(c, d);
+                auto ones = _mm256_xor_si256(lowSum, highSum);
+                auto twos = _mm256_xor_si256(_mm256_xor_si256(lowCarry, highCarry), _mm256_and_si256(lowSum, highSum));
+                auto fours = _mm256_and_si256(lowCarry, highCarry);
+
+                auto exactTwos = _mm256_andnot_si256(_mm256_or_si256(ones, fours), _mm256_and_si256(free, twos));
+                auto exactThrees = _mm256_and_si256(free, _mm256_and_si256(twos, ones));
+
+                // The counts of the opponent are subtracted, so the lanes hold the differences.
+                if (player == 0) {
+                    openTwos = _mm256_add_epi64(openTwos, popcount64(exactTwos));
+                    openThrees = _mm256_add_epi64(openThrees, popcount64(exactThrees));
+                } else {
+                    openTwos = _mm256_sub_epi64(openTwos, popcount64(exactTwos));
+                    openThrees = _mm256_sub_epi64(openThrees, popcount64(exactThrees));
+                }
+            }
+        }
+
+        alignas(32) int64_t twoDifferences[lanes];
+        alignas(32) int64_t threeDifferences[lanes];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(twoDifferences), openTwos);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(threeDifferences), openThrees);
+
+        for (size_t lane = 0; lane < lanes; lane++) {
+            scores[i + lane] = static_cast<int>(OPEN_TWO_WEIGHT*twoDifferences[lane]
+                                                + OPEN_THREE_WEIGHT*threeDifferences[lane]);
+        }
+    }
+
+    evaluateScalar(current + i, mask + i, count - i, scores + i);
+}
+
+#else
+
+void BatchEvaluator::evaluateAvx2(const uint64_t *current, const uint64_t *mask, size_t count, int *scores) const {
+    evaluateScalar(current, mask, count, scores);
+}
+
+#endif
+
+void BatchEvaluator::evaluate(const uint64_t *current, const uint64_t *mask, size_t count, int *scores) const {
+    if (kernel == Kernel::AVX2) {
+        evaluateAvx2(current, mask, count, scores);
+    } else {
+        evaluateScalar(current, mask, count, scores);
+    }
+}
+
+std::vector<int> BatchEvaluator::evaluate(const std::vector<Position> &positions) const {
+    std::vector<uint64_t> current;
+    std::vector<uint64_t> mask;
+    std::vector<int> scores(positions.size());
+
+    current.reserve(positions.size());
+    mask.reserve(positions.size());
+
+    for (const auto &position : positions) {
+        current.push_back(position.getCurrentPlayerDiscs());
+        mask.push_back(position.getMask());
+    }
+
+    evaluate(current.data(), mask.data(), positions.size(), scores.data());
+    return scores;
+}
+
+}
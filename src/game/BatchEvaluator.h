@@ -0,0 +1,92 @@
+#ifndef INC_4INAROW_BATCHEVALUATOR_H
+#define INC_4INAROW_BATCHEVALUATOR_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Position.h"
+
+namespace fourinarow {
+
+/**
+ * Class used to compute the heuristic score of many positions of the classic game at once.
+ * The score counts, for each player, the open twos and the open threes, i.e. the windows of four
+ * aligned spaces holding two or three discs of the player and no disc of the opponent.
+ * The windows are counted with bit-sliced arithmetic: the four discs of every window
+ * of a direction are added in parallel, one window per bit of the bitboard.
+ * The positions are given as packed arrays of bitboards, and are processed by the AVX2 kernel,
+ * four positions per instruction, if the processor supports it, or by a portable scalar kernel otherwise.
+ * The kernel is selected at runtime, and both kernels return the same scores.
+ */
+class BatchEvaluator {
+    public:
+        enum class Kernel {
+                SCALAR,
+                AVX2
+        };
+
+        static const int OPEN_TWO_WEIGHT = 1;
+        static const int OPEN_THREE_WEIGHT = 4;
+    private:
+        static const unsigned int DIRECTIONS = 4;
+
+        // The distance between two consecutive spaces of a window, for each direction.
+        static const std::array<unsigned int, DIRECTIONS> distances;
+
+        // The spaces where a window can start, for each direction.
+        static const std::array<uint64_t, DIRECTIONS> windowStarts;
+
+        Kernel kernel;
+
+        /**
+         * Returns the spaces where a window can start, for each direction.
+         */
+        static std::array<uint64_t, DIRECTIONS> generateWindowStarts();
+
+        void evaluateScalar(const uint64_t *current, const uint64_t *mask, size_t count, int *scores) const;
+        void evaluateAvx2(const uint64_t *current, const uint64_t *mask, size_t count, int *scores) const;
+    public:
+        /**
+         * Creates an evaluator using the fastest kernel supported by the processor.
+         */
+        BatchEvaluator();
+
+        /**
+         * Creates an evaluator using the given kernel, if it is supported by the processor,
+         * or the scalar kernel otherwise.
+         * @param preferredKernel  the kernel to use.
+         */
+        explicit BatchEvaluator(Kernel preferredKernel);
+
+        Kernel getKernel() const;
+
+        /**
+         * Checks if a kernel can run on the processor.
+         * @param kernel  the kernel.
+         * @return        true if the kernel is supported, false otherwise.
+         */
+        static bool isSupported(Kernel kernel);
+
+        /**
+         * Computes the scores of a batch of positions. The score of a position is given from the point
+         * of view of the player to move, and is the weighted difference between the open twos and threes
+         * of the player and the ones of the opponent.
+         * @param current  the bitboards of the discs of the players to move.
+         * @param mask     the bitboards of the discs of both players.
+         * @param count    the number of positions.
+         * @param scores   the array that will store the scores. It must hold <code>count</code> elements.
+         */
+        void evaluate(const uint64_t *current, const uint64_t *mask, size_t count, int *scores) const;
+
+        /**
+         * Computes the scores of a batch of positions, packing their bitboards first.
+         * @param positions  the positions.
+         * @return           the scores of the positions.
+         */
+        std::vector<int> evaluate(const std::vector<Position> &positions) const;
+};
+
+}
+
+#endif //INC_4INAROW_BATCHEVALUATOR_H
@@ -0,0 +1,188 @@
+#ifndef INC_4INAROW_BOARDGEOMETRY_H
+#define INC_4INAROW_BOARDGEOMETRY_H
+
+#include <cstdint>
+#include <type_traits>
+
+namespace fourinarow {
+
+/*
+ * Unsigned 128-bit integer used by the boards that do not fit into 64 bits.
+ * The __extension__ keyword silences the pedantic warnings about the type not being ISO C++.
+ */
+__extension__ typedef unsigned __int128 UInt128;
+
+/**
+ * Returns the number of bits set in a 64-bit bitboard.
+ * @param bitboard  the bitboard.
+ * @return          the number of bits set.
+ */
+inline unsigned int countBits(uint64_t bitboard) {
+    return __builtin_popcountll(bitboard);
+}
+
+/**
+ * Returns the number of bits set in a 128-bit bitboard.
+ * @param bitboard  the bitboard.
+ * @return          the number of bits set.
+ */
+inline unsigned int countBits(UInt128 bitboard) {
+    return __builtin_popcountll(static_cast<uint64_t>(bitboard))
+           + __builtin_popcountll(static_cast<uint64_t>(bitboard >> 64));
+}
+
+/**
+ * Class holding the compile-time quantities of a board with the given geometry.
+ * A board is represented with bitboards laid out column by column in a bottom-up way,
+ * reserving <code>Rows + 1</code> bits to each column: the bit of index
+ * <code>c*(Rows + 1) + r</code> represents the space (r,c), where (0,0)
+ * is the bottom-left space of the board. The extra bit on top of each column is always
+ * empty and separates the columns, so that the lines of discs can be detected with
+ * shift-and-mask operations without wrapping from one column to the next one.
+ * The bitboard is a 64-bit integer whenever the board fits into it, a 128-bit integer otherwise.
+ * All the masks are computed at compile time.
+ * @tparam Rows           the number of rows of the board.
+ * @tparam Columns        the number of columns of the board.
+ * @tparam ConnectLength  the number of aligned discs needed to win.
+ */
+template<uint8_t Rows, uint8_t Columns, uint8_t ConnectLength>
+class BoardGeometry {
+    static_assert(Rows > 0 && Columns > 0, "The board must have at least one row and one column");
+    static_assert(ConnectLength > 1, "At least two aligned discs must be needed to win");
+    static_assert((Rows + 1)*Columns <= 128, "The board must fit into a 128-bit bitboard");
+    public:
+        using Bitboard = typename std::conditional<(Rows + 1)*Columns <= 64, uint64_t, UInt128>::type;
+
+        static constexpr unsigned int COLUMN_HEIGHT = Rows + 1;
+        static constexpr unsigned int SPACES = Rows*Columns;
+
+        // Distance, in bits, between two adjacent spaces of a line.
+        static constexpr unsigned int VERTICAL = 1;
+        static constexpr unsigned int HORIZONTAL = Rows + 1;
+        static constexpr unsigned int LEFT_DIAGONAL = Rows;
+        static constexpr unsigned int RIGHT_DIAGONAL = Rows + 2;
+
+        BoardGeometry() = delete;
+        ~BoardGeometry() = delete;
+        BoardGeometry(const BoardGeometry&) = delete;
+        BoardGeometry& operator=(const BoardGeometry&) = delete;
+        BoardGeometry(BoardGeometry&&) = delete;
+        BoardGeometry& operator=(BoardGeometry&&) = delete;
+
+        /**
+         * Returns the mask of a single space of the board.
+         * @param rowIndex     the row index of the space.
+         * @param columnIndex  the column index of the space.
+         * @return             the mask having only the bit of the space set.
+         */
+        static constexpr Bitboard spaceMask(unsigned int rowIndex, unsigned int columnIndex) {
+            return Bitboard(1) << (columnIndex*COLUMN_HEIGHT + rowIndex);
+        }
+
+        /**
+         * Returns the mask of the bottom space of the given column.
+         * @param columnIndex  the column index.
+         * @return             the mask having only the bit of the bottom space of the column set.
+         */
+        static constexpr Bitboard bottomMask(unsigned int columnIndex) {
+            return spaceMask(0, columnIndex);
+        }
+
+        /**
+         * Returns the mask of the top space of the given column.
+         * @param columnIndex  the column index.
+         * @return             the mask having only the bit of the top space of the column set.
+         */
+        static constexpr Bitboard topMask(unsigned int columnIndex) {
+            return spaceMask(Rows - 1, columnIndex);
+        }
+
+        /**
+         * Returns the mask of all the spaces of the given column.
+         * @param columnIndex  the column index.
+         * @return             the mask having the bits of the column set.
+         */
+        static constexpr Bitboard columnMask(unsigned int columnIndex) {
+            return ((Bitboard(1) << Rows) - 1) << (columnIndex*COLUMN_HEIGHT);
+        }
+
+        /**
+         * Returns the mask of the bottom row of the board.
+         * @return  the mask having the bits of the bottom row set.
+         */
+        static constexpr Bitboard bottomRowMask() {
+            Bitboard mask = 0;
+            for (unsigned int i = 0; i < Columns; i++) {
+                mask |= bottomMask(i);
+            }
+            return mask;
+        }
+
+        /**
+         * Returns the mask of all the spaces of the board.
+         * The separator bits on top of the columns are not set.
+         * @return  the mask having the bits of the board set.
+         */
+        static constexpr Bitboard boardMask() {
+            return bottomRowMask()*((Bitboard(1) << Rows) - 1);
+        }
+
+        /**
+         * Checks if <code>ConnectLength</code> aligned discs are present in the given bitboard,
+         * considering the lines whose adjacent spaces are represented by bits at the given distance.
+         * The check doubles the length of the detected lines at each step: after the i-th step,
+         * a bit is set only if it is followed by <code>2^i - 1</code> discs along the line.
+         * A final step covers the remaining length when it is not a power of two.
+         * @param discs     the bitboard holding the discs of a player.
+         * @param distance  the distance, in bits, between two adjacent spaces of a line.
+         * @return          true if the aligned discs are present, false otherwise.
+         */
+        static constexpr bool hasLine(Bitboard discs, unsigned int distance) {
+            auto length = 1u;
+            while (2*length <= ConnectLength) {
+                discs &= discs >> (length*distance);
+                length *= 2;
+            }
+
+            if (length < ConnectLength) {
+                discs &= discs >> ((ConnectLength - length)*distance);
+            }
+
+            return discs != 0;
+        }
+
+        /**
+         * Checks if <code>ConnectLength</code> aligned discs are present in the given bitboard,
+         * along any vertical, horizontal or diagonal line.
+         * @param discs  the bitboard holding the discs of a player.
+         * @return       true if the aligned discs are present, false otherwise.
+         */
+        static constexpr bool hasLine(Bitboard discs) {
+            return hasLine(discs, VERTICAL)
+                   || hasLine(discs, HORIZONTAL)
+                   || hasLine(discs, LEFT_DIAGONAL)
+                   || hasLine(discs, RIGHT_DIAGONAL);
+        }
+};
+
+template<uint8_t Rows, uint8_t Columns, uint8_t ConnectLength>
+constexpr unsigned int BoardGeometry<Rows, Columns, ConnectLength>::COLUMN_HEIGHT;
+
+template<uint8_t Rows, uint8_t Columns, uint8_t ConnectLength>
+constexpr unsigned int BoardGeometry<Rows, Columns, ConnectLength>::SPACES;
+
+template<uint8_t Rows, uint8_t Columns, uint8_t ConnectLength>
+constexpr unsigned int BoardGeometry<Rows, Columns, ConnectLength>::VERTICAL;
+
+template<uint8_t Rows, uint8_t Columns, uint8_t ConnectLength>
+constexpr unsigned int BoardGeometry<Rows, Columns, ConnectLength>::HORIZONTAL;
+
+template<uint8_t Rows, uint8_t Columns, uint8_t ConnectLength>
+constexpr unsigned int BoardGeometry<Rows, Columns, ConnectLength>::LEFT_DIAGONAL;
+
+template<uint8_t Rows, uint8_t Columns, uint8_t ConnectLength>
+constexpr unsigned int BoardGeometry<Rows, Columns, ConnectLength>::RIGHT_DIAGONAL;
+
+}
+
+#endif //INC_4INAROW_BOARDGEOMETRY_H
@@ -1,30 +1,44 @@
 #ifndef INC_4INAROW_FOURINAROW_H
 #define INC_4INAROW_FOURINAROW_H
 
+#include <array>
 #include <cstdint>
-#include <vector>
 #include <string>
+#include <Constants.h>
+#include <Utils.h>
+#include "BoardGeometry.h"
+#include "MatchResult.h"
 
 namespace fourinarow {
 
 /**
- * Class representing a "Four-in-a-row" game board.
+ * Class representing a "Four-in-a-row" game board with the given geometry.
  * It allows to register the moves of two players checking for their validity,
- * and to detect the end of the game. The board is represented as a matrix
- * in a bottom-up way, namely the (0,0) element is the bottom-left space of the board.
+ * and to detect the end of the game. The board is represented with two bitboards,
+ * one holding the discs of this player and one holding the discs of the opponent,
+ * plus the number of discs stored in each column. The layout of the bitboards
+ * is described by <code>BoardGeometry</code>. The geometry is fixed at compile time,
+ * so that every variant gets its own specialized code. The classic game is
+ * available through the <code>FourInARow</code> alias.
+ * @tparam Rows           the number of rows of the board.
+ * @tparam Columns        the number of columns of the board.
+ * @tparam ConnectLength  the number of aligned discs needed to win.
  */
-class FourInARow {
+template<uint8_t Rows, uint8_t Columns, uint8_t ConnectLength>
+class BasicFourInARow {
     public:
-        enum class Result { WIN, DRAW, LOSS };
+        using Result = MatchResult;
+        using Geometry = BoardGeometry<Rows, Columns, ConnectLength>;
+        using Bitboard = typename Geometry::Bitboard;
     private:
-        static const int EMPTY_SPACE = 0;
-        static const int OPPONENT_DISC = -1;
-        static const int MY_DISC = 1;
+        static const unsigned int MY_DISCS = 0;
+        static const unsigned int OPPONENT_DISCS = 1;
 
         bool matchFinished;
         Result result;
         unsigned int turn;
-        std::vector<std::vector<int>> board;
+        std::array<Bitboard, 2> discs;
+        std::array<uint8_t, Columns> heights;
         std::string opponent;
 
         /**
@@ -38,73 +52,51 @@ class FourInARow {
         bool isValidMove(const uint8_t &columnIndex) const;
 
         /**
-         * Checks if a vertical line of four aligned discs has been achieved by the player.
-         * The check is performed starting from the given disc position and examining
-         * the three rows below. If the given disc position is outside the board,
-         * the method returns false.
-         * @param rowIndex     the row index of the disc.
-         * @param columnIndex  the column index of the disc.
-         * @param opponent     true if the player is the opponent, false otherwise.
-         * @return             true if a vertical line of four aligned discs has been achieved by
-         *                     the player, false otherwise.
+         * Checks if a vertical line of aligned discs is present in the given bitboard.
+         * @param playerDiscs  the bitboard holding the discs of a player.
+         * @return             true if a vertical line of aligned discs is present, false otherwise.
          */
-        bool checkWinOnVerticalLine(const uint8_t &rowIndex, const uint8_t &columnIndex, bool opponentMove) const;
+        static bool checkWinOnVerticalLine(Bitboard playerDiscs);
 
         /**
-         * Checks if a horizontal line of four aligned discs has been achieved by the player.
-         * The check is performed examining all the possible horizontal lines of four discs
-         * that include the given disc. If the given disc position is outside the board,
-         * the method returns false.
-         * @param rowIndex     the row index of the disc.
-         * @param columnIndex  the column index of the disc.
-         * @param opponent     true if the player is the opponent, false otherwise.
-         * @return             true if a horizontal line of four aligned discs has been achieved by
-         *                     the player, false otherwise.
+         * Checks if a horizontal line of aligned discs is present in the given bitboard.
+         * @param playerDiscs  the bitboard holding the discs of a player.
+         * @return             true if a horizontal line of aligned discs is present, false otherwise.
          */
-        bool checkWinOnHorizontalLine(const uint8_t &rowIndex, const uint8_t &columnIndex, bool opponentMove) const;
+        static bool checkWinOnHorizontalLine(Bitboard playerDiscs);
 
         /**
-         * Checks if a left diagonal line of four aligned discs has been achieved by the player.
-         * The check is performed examining all the possible left diagonal lines of four discs
-         * that include the given disc. If the given disc position is outside the board,
-         * the method returns false.
-         * @param rowIndex     the row index of the disc.
-         * @param columnIndex  the column index of the disc.
-         * @param opponent     true if the player is the opponent, false otherwise.
-         * @return             true if a left diagonal line of four aligned discs has been achieved by
-         *                     the player, false otherwise.
+         * Checks if a left diagonal line of aligned discs, i.e. a diagonal going from the top-left
+         * to the bottom-right of the board, is present in the given bitboard.
+         * @param playerDiscs  the bitboard holding the discs of a player.
+         * @return             true if a left diagonal line of aligned discs is present, false otherwise.
          */
-        bool checkWinOnLeftDiagonalLine(const uint8_t &rowIndex, const uint8_t &columnIndex, bool opponentMove) const;
+        static bool checkWinOnLeftDiagonalLine(Bitboard playerDiscs);
 
         /**
-         * Checks if a right diagonal line of four aligned discs has been achieved by the player.
-         * The check is performed examining all the possible right diagonal lines of four discs
-         * that include the given disc. If the given disc position is outside the board,
-         * the method returns false.
-         * @param rowIndex     the row index of the disc.
-         * @param columnIndex  the column index of the disc.
-         * @param opponent     true if the player is the opponent, false otherwise.
-         * @return             true if a right diagonal line of four aligned discs has been achieved by
-         *                     the player, false otherwise.
+         * Checks if a right diagonal line of aligned discs, i.e. a diagonal going from the bottom-left
+         * to the top-right of the board, is present in the given bitboard.
+         * @param playerDiscs  the bitboard holding the discs of a player.
+         * @return             true if a right diagonal line of aligned discs is present, false otherwise.
          */
-        bool checkWinOnRightDiagonalLine(const uint8_t &rowIndex, const uint8_t &columnIndex, bool opponentMove) const;
+        static bool checkWinOnRightDiagonalLine(Bitboard playerDiscs);
     public:
-        explicit FourInARow(std::string opponent);
+        explicit BasicFourInARow(std::string opponent);
 
         /**
          * Destroys the object and securely wipes the information about the match from memory.
          */
-        ~FourInARow();
+        ~BasicFourInARow();
 
-        FourInARow(FourInARow&&) = default;
-        FourInARow& operator=(FourInARow&&) = default;
-        FourInARow(const FourInARow&) = default;
-        FourInARow& operator=(const FourInARow&) = default;
+        BasicFourInARow(BasicFourInARow&&) = default;
+        BasicFourInARow& operator=(BasicFourInARow&&) = default;
+        BasicFourInARow(const BasicFourInARow&) = default;
+        BasicFourInARow& operator=(const BasicFourInARow&) = default;
 
         /**
          * Returns a flag signaling if the match has ended or not. A match ends
          * when either one of the two players is able to achieve a
-         * vertical/horizontal/diagonal line of four discs, or the board is full.
+         * vertical/horizontal/diagonal line of aligned discs, or the board is full.
          * @return  true if the match has ended, false otherwise.
          */
         bool isMatchFinished() const;
@@ -135,6 +127,160 @@ class FourInARow {
         std::string toString() const;
 };
 
+/**
+ * The classic game: 6 rows, 7 columns and four aligned discs to win.
+ * It is the only geometry spoken by the protocol.
+ */
+using FourInARow = BasicFourInARow<ROWS, COLUMNS, CONNECT_LENGTH>;
+
+template<uint8_t Rows, uint8_t Columns, uint8_t ConnectLength>
+const unsigned int BasicFourInARow<Rows, Columns, ConnectLength>::MY_DISCS;
+
+template<uint8_t Rows, uint8_t Columns, uint8_t ConnectLength>
+const unsigned int BasicFourInARow<Rows, Columns, ConnectLength>::OPPONENT_DISCS;
+
+// Common variants of the game.
+using FourInARow8x7 = BasicFourInARow<7, 8, 4>;
+using FourInARow9x7 = BasicFourInARow<7, 9, 4>;
+using FiveInARow = BasicFourInARow<6, 9, 5>;
+
+template<uint8_t Rows, uint8_t Columns, uint8_t ConnectLength>
+BasicFourInARow<Rows, Columns, ConnectLength>::BasicFourInARow(std::string opponent)
+    : matchFinished(false),
+      result(Result::LOSS),
+      turn(0),
+      discs(),
+      heights(),
+      opponent(std::move(opponent)) {}
+
+template<uint8_t Rows, uint8_t Columns, uint8_t ConnectLength>
+BasicFourInARow<Rows, Columns, ConnectLength>::~BasicFourInARow() {
+    cleanse(discs);
+    cleanse(heights);
+    cleanse(opponent);
+    cleanse(matchFinished);
+    cleanse(turn);
+    cleanse(result);
+}
+
+template<uint8_t Rows, uint8_t Columns, uint8_t ConnectLength>
+bool BasicFourInARow<Rows, Columns, ConnectLength>::isMatchFinished() const {
+    return matchFinished;
+}
+
+template<uint8_t Rows, uint8_t Columns, uint8_t ConnectLength>
+MatchResult BasicFourInARow<Rows, Columns, ConnectLength>::getResult() const {
+    return result;
+}
+
+template<uint8_t Rows, uint8_t Columns, uint8_t ConnectLength>
+unsigned int BasicFourInARow<Rows, Columns, ConnectLength>::getTurn() const {
+    return turn;
+}
+
+template<uint8_t Rows, uint8_t Columns, uint8_t ConnectLength>
+const std::string& BasicFourInARow<Rows, Columns, ConnectLength>::getOpponent() const {
+    return opponent;
+}
+
+template<uint8_t Rows, uint8_t Columns, uint8_t ConnectLength>
+bool BasicFourInARow<Rows, Columns, ConnectLength>::isValidMove(const uint8_t &columnIndex) const {
+    return !matchFinished
+           && (columnIndex < Columns)
+           && (heights[columnIndex] < Rows);
+}
+
+template<uint8_t Rows, uint8_t Columns, uint8_t ConnectLength>
+bool BasicFourInARow<Rows, Columns, ConnectLength>::checkWinOnVerticalLine(Bitboard playerDiscs) {
+    return Geometry::hasLine(playerDiscs, Geometry::VERTICAL);
+}
+
+template<uint8_t Rows, uint8_t Columns, uint8_t ConnectLength>
+bool BasicFourInARow<Rows, Columns, ConnectLength>::checkWinOnHorizontalLine(Bitboard playerDiscs) {
+    return Geometry::hasLine(playerDiscs, Geometry::HORIZONTAL);
+}
+
+template<uint8_t Rows, uint8_t Columns, uint8_t ConnectLength>
+bool BasicFourInARow<Rows, Columns, ConnectLength>::checkWinOnLeftDiagonalLine(Bitboard playerDiscs) {
+    return Geometry::hasLine(playerDiscs, Geometry::LEFT_DIAGONAL);
+}
+
+template<uint8_t Rows, uint8_t Columns, uint8_t ConnectLength>
+bool BasicFourInARow<Rows, Columns, ConnectLength>::checkWinOnRightDiagonalLine(Bitboard playerDiscs) {
+    return Geometry::hasLine(playerDiscs, Geometry::RIGHT_DIAGONAL);
+}
+
+template<uint8_t Rows, uint8_t Columns, uint8_t ConnectLength>
+bool BasicFourInARow<Rows, Columns, ConnectLength>::registerMove(const uint8_t &columnIndex, bool opponentMove) {
+    if (!isValidMove(columnIndex))
+        return false;
+
+    turn++;
+
+    // The above check ensures that there is at least one empty space in the column.
+    auto &playerDiscs = discs[opponentMove ? OPPONENT_DISCS : MY_DISCS];
+    playerDiscs |= Geometry::spaceMask(heights[columnIndex], columnIndex);
+    heights[columnIndex]++;
+
+    if (checkWinOnVerticalLine(playerDiscs)
+        || checkWinOnHorizontalLine(playerDiscs)
+        || checkWinOnLeftDiagonalLine(playerDiscs)
+        || checkWinOnRightDiagonalLine(playerDiscs)) {
+        matchFinished = true;
+        result = opponentMove ? Result::LOSS : Result::WIN;
+        return true;
+    }
+
+    if (turn == Geometry::SPACES) {
+        matchFinished = true;
+        result = Result::DRAW;
+    }
+
+    return true;
+}
+
+template<uint8_t Rows, uint8_t Columns, uint8_t ConnectLength>
+std::string BasicFourInARow<Rows, Columns, ConnectLength>::toString() const {
+    std::string boardPrint;
+
+    for (int i = Rows - 1; i >= 0; i--) {
+        for (auto j = 0u; j < Columns; j++) {
+            auto space = Geometry::spaceMask(i, j);
+
+            if (discs[MY_DISCS] & space) {
+                boardPrint += "| O ";
+                continue;
+            }
+            if (discs[OPPONENT_DISCS] & space) {
+                boardPrint += "| X ";
+                continue;
+            }
+            boardPrint += "|   ";
+        }
+        boardPrint += "|\n";
+    }
+
+    for (auto i = 0u; i < Columns; i++) {
+        if (i == (Columns - 1u)) {
+            boardPrint += "-----\n";
+        } else {
+            boardPrint += "----";
+        }
+    }
+
+    /*
+     * Print the column index. This works only
+     * if numberOfColumns <= 9, otherwise the
+     * indexes come out not aligned.
+     */
+    for (auto i = 0u; i < Columns; i++) {
+        boardPrint += ("  " + std::to_string(i) + " ");
+    }
+
+    boardPrint += ("\n\nYou: O   " + opponent + ": X   Turn: " + std::to_string(turn)) + "\n";
+    return boardPrint;
+}
+
 }
 
 #endif //INC_4INAROW_FOURINAROW_H
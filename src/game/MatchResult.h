@@ -0,0 +1,14 @@
+#ifndef INC_4INAROW_MATCHRESULT_H
+#define INC_4INAROW_MATCHRESULT_H
+
+namespace fourinarow {
+
+/**
+ * Result of a match, from the point of view of the player owning the board.
+ * It is shared by all the board geometries.
+ */
+enum class MatchResult { WIN, DRAW, LOSS };
+
+}
+
+#endif //INC_4INAROW_MATCHRESULT_H
@@ -0,0 +1,226 @@
+#include <stdexcept>
+#include "MatchTable.h"
+
+namespace fourinarow {
+
+const uint8_t MatchTable::TURN_FLAG;
+const uint8_t MatchTable::FINISHED_FLAG;
+const uint8_t MatchTable::LEFT_SHIFT;
+const uint8_t MatchTable::STARTER_FLAG;
+const unsigned int MatchTable::BITS_PER_MOVE;
+const unsigned int MatchTable::MOVES_PER_WORD;
+const size_t MatchTable::BYTES_PER_MATCH;
+
+MatchTable::MatchTable(size_t capacity) : matchCount(0) {
+    static_assert(Position::Geometry::SPACES <= UINT8_MAX, "The number of moves must fit into 8 bits");
+    static_assert(COLUMNS <= (1u << BITS_PER_MOVE), "The columns must fit into the bits of a move");
+    static_assert(Position::Geometry::SPACES <= 2*MOVES_PER_WORD, "The moves must fit into two words");
+
+    firstParticipantDiscs.reserve(capacity);
+    masks.reserve(capacity);
+    moveCounts.reserve(capacity);
+    states.reserve(capacity);
+    generations.reserve(capacity);
+    participants.reserve(2*capacity);
+    moveLists.reserve(2*capacity);
+    startTimes.reserve(capacity);
+}
+
+size_t MatchTable::getMatchCount() const {
+    return matchCount;
+}
+
+size_t MatchTable::getSlotCount() const {
+    return states.size();
+}
+
+void MatchTable::checkHandle(const Handle &match) const {
+    if (!contains(match)) {
+        throw std::runtime_error("The match does not exist");
+    }
+}
+
+void MatchTable::release(uint32_t slot) {
+    generations[slot]++;
+    freeSlots.push_back(slot);
+    matchCount--;
+}
+
+MatchTable::Handle MatchTable::create(uint32_t firstParticipant,
+                                     uint32_t secondParticipant,
+                                     bool firstParticipantStarts,
+                                     uint64_t startTime) {
+    uint32_t slot;
+
+    if (freeSlots.empty()) {
+        if (states.size() == UINT32_MAX) {
+            throw std::runtime_error("The match table is full");
+        }
+
+        slot = static_cast<uint32_t>(states.size());
+        firstParticipantDiscs.push_back(0);
+        masks.push_back(0);
+        moveCounts.push_back(0);
+        states.push_back(0);
+        generations.push_back(0);
+        participants.push_back(0);
+        participants.push_back(0);
+        moveLists.push_back(0);
+        moveLists.push_back(0);
+        startTimes.push_back(0);
+    } else {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+        generations[slot]++;
+    }
+
+    firstParticipantDiscs[slot] = 0;
+    masks[slot] = 0;
+    moveCounts[slot] = 0;
+    states[slot] = firstParticipantStarts ? 0 : TURN_FLAG | STARTER_FLAG;
+    participants[2*slot] = firstParticipant;
+    participants[2*slot + 1] = secondParticipant;
+    moveLists[2*slot] = 0;
+    moveLists[2*slot + 1] = 0;
+    startTimes[slot] = startTime;
+    matchCount++;
+
+    return Handle{slot, generations[slot]};
+}
+
+bool MatchTable::contains(const Handle &match) const {
+    // A free slot has an odd generation, a live slot an even one.
+    return match.slot < generations.size() && generations[match.slot] == match.generation
+           && (match.generation & 1) == 0;
+}
+
+uint32_t MatchTable::getParticipant(const Handle &match, unsigned int participant) const {
+    checkHandle(match);
+    return participants[2*match.slot + (participant & 1)];
+}
+
+unsigned int MatchTable::findParticipant(const Handle &match, uint32_t participantHandle) const {
+    checkHandle(match);
+
+    if (participants[2*match.slot] == participantHandle) {
+        return 0;
+    }
+
+    if (participants[2*match.slot + 1] == participantHandle) {
+        return 1;
+    }
+
+    throw std::runtime_error("The participant does not take part in the match");
+}
+
+unsigned int MatchTable::getStartingParticipant(const Handle &match) const {
+    checkHandle(match);
+    return (states[match.slot] & STARTER_FLAG) != 0 ? 1 : 0;
+}
+
+uint64_t MatchTable::getStartTime(const Handle &match) const {
+    checkHandle(match);
+    return startTimes[match.slot];
+}
+
+void MatchTable::getMoves(const Handle &match, std::vector<uint8_t> &moves) const {
+    checkHandle(match);
+    const auto moveMask = (1u << BITS_PER_MOVE) - 1;
+    moves.resize(moveCounts[match.slot]);
+
+    for (size_t i = 0; i < moves.size(); i++) {
+        moves[i] = (moveLists[2*match.slot + i/MOVES_PER_WORD] >> (BITS_PER_MOVE*(i % MOVES_PER_WORD))) & moveMask;
+    }
+}
+
+bool MatchTable::hasLeft(const Handle &match, unsigned int participant) const {
+    checkHandle(match);
+    return (states[match.slot] & (1u << (LEFT_SHIFT + (participant & 1)))) != 0;
+}
+
+bool MatchTable::isFinished(const Handle &match) const {
+    checkHandle(match);
+    return (states[match.slot] & FINISHED_FLAG) != 0;
+}
+
+void MatchTable::finish(const Handle &match) {
+    checkHandle(match);
+    states[match.slot] |= FINISHED_FLAG;
+}
+
+void MatchTable::leave(const Handle &match, unsigned int participant) {
+    checkHandle(match);
+    const uint8_t bothLeft = 3u << LEFT_SHIFT;
+    states[match.slot] |= FINISHED_FLAG | (1u << (LEFT_SHIFT + (participant & 1)));
+
+    if ((states[match.slot] & bothLeft) == bothLeft) {
+        release(match.slot);
+    }
+}
+
+void MatchTable::submitMove(const Handle &match, unsigned int participant, uint8_t column) {
+    pendingMoves.push_back(PendingMove{match, participant & 1, column});
+}
+
+size_t MatchTable::getPendingMoveCount() const {
+    return pendingMoves.size();
+}
+
+MatchTable::Outcome MatchTable::playMove(const PendingMove &move) {
+    if (!contains(move.match)) {
+        return Outcome::IGNORED;
+    }
+
+    auto slot = move.match.slot;
+    auto &state = states[slot];
+
+    if (state & FINISHED_FLAG) {
+        return Outcome::IGNORED;
+    }
+
+    auto mask = masks[slot];
+    auto turn = static_cast<unsigned int>(state & TURN_FLAG);
+    if (move.participant != turn || move.column >= COLUMNS || (mask & Position::Geometry::topMask(move.column))) {
+        state |= FINISHED_FLAG;
+        return Outcome::REJECTED;
+    }
+
+    // The discs of the second participant are the ones of the mask not belonging to the first one.
+    auto moverDiscs = turn == 0 ? firstParticipantDiscs[slot] : firstParticipantDiscs[slot] ^ mask;
+    Position position(moverDiscs, mask, moveCounts[slot]);
+    auto winning = position.isWinningMove(move.column);
+
+    auto disc = (mask + Position::Geometry::bottomMask(move.column)) & Position::Geometry::columnMask(move.column);
+    masks[slot] = mask | disc;
+    if (turn == 0) {
+        firstParticipantDiscs[slot] |= disc;
+    }
+    auto moveIndex = moveCounts[slot]++;
+    moveLists[2*slot + moveIndex/MOVES_PER_WORD] |= static_cast<uint64_t>(move.column) << (BITS_PER_MOVE*(moveIndex % MOVES_PER_WORD));
+    state ^= TURN_FLAG;
+
+    if (winning) {
+        state |= FINISHED_FLAG;
+        return Outcome::WIN;
+    }
+
+    if (moveCounts[slot] == Position::Geometry::SPACES) {
+        state |= FINISHED_FLAG;
+        return Outcome::DRAW;
+    }
+
+    return Outcome::ACCEPTED;
+}
+
+void MatchTable::processMoves(std::vector<MoveResult> &results) {
+    results.clear();
+    results.reserve(pendingMoves.size());
+
+    for (const auto &move : pendingMoves) {
+        results.push_back(MoveResult{move.match, move.participant, move.column, playMove(move)});
+    }
+
+    pendingMoves.clear();
+}
+
+}
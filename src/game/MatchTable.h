@@ -0,0 +1,241 @@
+#ifndef INC_4INAROW_MATCHTABLE_H
+#define INC_4INAROW_MATCHTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Position.h"
+
+namespace fourinarow {
+
+/**
+ * Class representing a table of live matches of the classic game, hosted by a server.
+ * The matches are stored as a structure of arrays: each field of a match lives in its own
+ * packed array, indexed by the slot of the match, so that a match occupies
+ * <code>BYTES_PER_MATCH</code> bytes and the fields read while validating a move are contiguous.
+ * A match keeps the discs of the first participant and the mask of all the discs, from which
+ * the discs of the second participant and the heights of the columns are derived, the number
+ * of moves, a state byte holding the turn, the starting participant, the end of the match
+ * and the participants that left it, the opaque handles of the two participants (e.g. their
+ * socket descriptors), the start time and the sequence of the moves, packed at
+ * <code>BITS_PER_MOVE</code> bits per column index, so that the match can be recorded once finished.
+ * The slots of the released matches are recycled through a free list, and each slot carries
+ * a generation number, incremented when the slot is released and when it is reused, so that
+ * a stale handle of a match is never confused with a newer match occupying the same slot.
+ * The moves are submitted during a tick of the event loop and validated together
+ * by <code>processMoves()</code>, in order of submission.
+ */
+class MatchTable {
+    public:
+        /**
+         * Handle of a match, valid until the match is released.
+         */
+        struct Handle {
+            uint32_t slot;
+            uint32_t generation;
+        };
+
+        enum class Outcome : uint8_t {
+                ACCEPTED,  // The move is valid, and the match goes on.
+                WIN,       // The move is valid, and the mover wins the match.
+                DRAW,      // The move is valid, and fills the board.
+                REJECTED,  // The move is invalid or out of turn, and the match has been finished.
+                IGNORED    // The match was already finished or released when the move was validated.
+        };
+
+        struct MoveResult {
+            Handle match;
+            unsigned int participant;
+            uint8_t column;
+            Outcome outcome;
+        };
+    private:
+        static const uint8_t TURN_FLAG = 1;       // Set if the second participant has to move.
+        static const uint8_t FINISHED_FLAG = 2;
+        static const uint8_t LEFT_SHIFT = 2;      // The bits marking the participants that left the match.
+        static const uint8_t STARTER_FLAG = 16;   // Set if the second participant made the first move.
+        static const unsigned int BITS_PER_MOVE = 3;
+        static const unsigned int MOVES_PER_WORD = 64/BITS_PER_MOVE;
+
+        struct PendingMove {
+            Handle match;
+            unsigned int participant;
+            uint8_t column;
+        };
+
+        std::vector<Position::Bitboard> firstParticipantDiscs;
+        std::vector<Position::Bitboard> masks;
+        std::vector<uint8_t> moveCounts;
+        std::vector<uint8_t> states;
+        std::vector<uint32_t> generations;
+        std::vector<uint32_t> participants;  // Two handles per slot.
+        std::vector<uint64_t> moveLists;     // Two words per slot.
+        std::vector<uint64_t> startTimes;
+        std::vector<uint32_t> freeSlots;
+        std::vector<PendingMove> pendingMoves;
+        size_t matchCount;
+
+        /**
+         * Checks that a handle refers to a live match.
+         * @param match  the handle of the match.
+         * @throws runtime_error  if the match has been released, or the handle is invalid.
+         */
+        void checkHandle(const Handle &match) const;
+
+        /**
+         * Releases a match, making its slot available for a new match.
+         * @param slot  the slot of the match.
+         */
+        void release(uint32_t slot);
+
+        /**
+         * Validates and plays a pending move.
+         * @param move  the move.
+         * @return      the outcome of the move.
+         */
+        Outcome playMove(const PendingMove &move);
+    public:
+        static const size_t BYTES_PER_MATCH = 2*sizeof(Position::Bitboard) + 2*sizeof(uint8_t) + 3*sizeof(uint32_t)
+                                              + 3*sizeof(uint64_t);
+
+        /**
+         * Creates an empty table.
+         * @param capacity  the number of matches for which memory is reserved in advance.
+         */
+        explicit MatchTable(size_t capacity = 0);
+
+        ~MatchTable() = default;
+
+        MatchTable(const MatchTable&) = delete;
+        MatchTable& operator=(const MatchTable&) = delete;
+        MatchTable(MatchTable&&) = default;
+        MatchTable& operator=(MatchTable&&) = default;
+
+        /**
+         * Returns the number of live matches, i.e. the matches created and not yet released.
+         */
+        size_t getMatchCount() const;
+
+        /**
+         * Returns the number of slots of the table, either live or free.
+         */
+        size_t getSlotCount() const;
+
+        /**
+         * Creates a new match, reusing a free slot if available.
+         * @param firstParticipant   the handle of the first participant.
+         * @param secondParticipant  the handle of the second participant.
+         * @param firstParticipantStarts  true if the first participant has the first turn, false otherwise.
+         * @param startTime          the start time of the match, in a unit chosen by the caller.
+         * @return                   the handle of the match.
+         */
+        Handle create(uint32_t firstParticipant, uint32_t secondParticipant, bool firstParticipantStarts, uint64_t startTime);
+
+        /**
+         * Checks if a handle refers to a live match.
+         * @param match  the handle of the match.
+         * @return       true if the match has not been released, false otherwise.
+         */
+        bool contains(const Handle &match) const;
+
+        /**
+         * Returns the handle of a participant.
+         * @param match        the handle of the match.
+         * @param participant  the index of the participant, either 0 or 1.
+         * @return             the handle of the participant.
+         * @throws runtime_error  if the match has been released.
+         */
+        uint32_t getParticipant(const Handle &match, unsigned int participant) const;
+
+        /**
+         * Finds the index of a participant from its handle.
+         * @param match              the handle of the match.
+         * @param participantHandle  the handle of the participant.
+         * @return                   the index of the participant, either 0 or 1.
+         * @throws runtime_error  if the match has been released, or the handle is not one of its participants.
+         */
+        unsigned int findParticipant(const Handle &match, uint32_t participantHandle) const;
+
+        /**
+         * Returns the index of the participant who made, or has to make, the first move.
+         * @param match  the handle of the match.
+         * @return       the index of the starting participant, either 0 or 1.
+         * @throws runtime_error  if the match has been released.
+         */
+        unsigned int getStartingParticipant(const Handle &match) const;
+
+        /**
+         * Returns the start time of a match, as given to <code>create()</code>.
+         * @param match  the handle of the match.
+         * @return       the start time.
+         * @throws runtime_error  if the match has been released.
+         */
+        uint64_t getStartTime(const Handle &match) const;
+
+        /**
+         * Returns the moves played in a match, in order.
+         * @param match  the handle of the match.
+         * @param moves  the vector that will store the columns of the moves. Its previous content is discarded.
+         * @throws runtime_error  if the match has been released.
+         */
+        void getMoves(const Handle &match, std::vector<uint8_t> &moves) const;
+
+        /**
+         * Checks if a participant has left a match.
+         * @param match        the handle of the match.
+         * @param participant  the index of the participant.
+         * @return             true if the participant has left the match, false otherwise.
+         * @throws runtime_error  if the match has been released.
+         */
+        bool hasLeft(const Handle &match, unsigned int participant) const;
+
+        /**
+         * Checks if a match is finished, i.e. it has been won, drawn or interrupted.
+         * @param match  the handle of the match.
+         * @return       true if the match is finished, false otherwise.
+         * @throws runtime_error  if the match has been released.
+         */
+        bool isFinished(const Handle &match) const;
+
+        /**
+         * Marks a match as finished. The pending moves of the match will be ignored.
+         * @param match  the handle of the match.
+         * @throws runtime_error  if the match has been released.
+         */
+        void finish(const Handle &match);
+
+        /**
+         * Removes a participant from a match, finishing the match. When both participants
+         * have left, the match is released and its handle becomes stale.
+         * @param match        the handle of the match.
+         * @param participant  the index of the participant.
+         * @throws runtime_error  if the match has been released.
+         */
+        void leave(const Handle &match, unsigned int participant);
+
+        /**
+         * Submits a move, which will be validated by the next call to <code>processMoves()</code>.
+         * @param match        the handle of the match.
+         * @param participant  the index of the participant making the move.
+         * @param column       the column of the move.
+         */
+        void submitMove(const Handle &match, unsigned int participant, uint8_t column);
+
+        /**
+         * Returns the number of moves submitted and not yet validated.
+         */
+        size_t getPendingMoveCount() const;
+
+        /**
+         * Validates the submitted moves in order of submission, playing the valid ones.
+         * A move is valid if the match is not finished, it is the turn of the participant
+         * and the column is not full. An invalid move finishes the match.
+         * @param results  the vector that will store the results, one for each submitted move.
+         *                 Its previous content is discarded.
+         */
+        void processMoves(std::vector<MoveResult> &results);
+};
+
+}
+
+#endif //INC_4INAROW_MATCHTABLE_H
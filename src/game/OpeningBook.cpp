@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <SerializationException.h>
+#include "OpeningBook.h"
+
+namespace fourinarow {
+
+const char OpeningBook::MAGIC[8] = {'4', 'I', 'N', 'A', 'R', 'O', 'W', 'B'};
+
+OpeningBook::OpeningBook(const std::vector<Entry> &solvedPositions, unsigned int maxMoves)
+    : mapping(nullptr), mappingSize(0), header(nullptr), buckets(nullptr), entries(nullptr) {
+    static_assert(Position::KEY_BITS + 8 <= 64, "The keys of the classic game must fit into 56 bits");
+
+    std::vector<uint64_t> packedEntries;
+    packedEntries.reserve(solvedPositions.size());
+
+    for (const auto &entry : solvedPositions) {
+        auto mirrored = false;
+        auto hashedKey = Position::scrambleKey(entry.position.getCanonicalKey(mirrored));
+        packedEntries.push_back((hashedKey << 8) | static_cast<uint64_t>(entry.score + 128));
+    }
+
+    std::sort(packedEntries.begin(), packedEntries.end());
+    packedEntries.erase(std::unique(packedEntries.begin(), packedEntries.end()), packedEntries.end());
+
+    auto bucketBits = 0u;
+    while ((packedEntries.size() >> bucketBits) > ENTRIES_PER_BUCKET && bucketBits < Position::KEY_BITS) {
+        bucketBits++;
+    }
+
+    auto prefixWords = computePrefixWords(bucketBits);
+    image.assign(prefixWords + packedEntries.size(), 0);
+
+    Header bookHeader{};
+    memcpy(bookHeader.magic, MAGIC, sizeof(MAGIC));
+    bookHeader.version = VERSION;
+    bookHeader.rows = ROWS;
+    bookHeader.columns = COLUMNS;
+    bookHeader.connectLength = CONNECT_LENGTH;
+    bookHeader.maxMoves = maxMoves;
+    bookHeader.bucketBits = bucketBits;
+    bookHeader.entryCount = packedEntries.size();
+    memcpy(image.data(), &bookHeader, sizeof(bookHeader));
+
+    // The bucket table holds one more element, so that the end of a bucket is the start of the next one.
+    std::vector<uint32_t> bucketTable((size_t(1) << bucketBits) + 1, 0);
+    size_t entryIndex = 0;
+    for (size_t bucket = 0; bucket < bucketTable.size(); bucket++) {
+        while (entryIndex < packedEntries.size()
+               && ((packedEntries[entryIndex] >> 8) >> (Position::KEY_BITS - bucketBits)) < bucket) {
+            entryIndex++;
+        }
+        bucketTable[bucket] = entryIndex;
+    }
+
+    memcpy(reinterpret_cast<unsigned char*>(image.data()) + sizeof(Header),
+           bucketTable.data(),
+           bucketTable.size()*sizeof(uint32_t));
+    std::copy(packedEntries.begin(), packedEntries.end(), image.begin() + prefixWords);
+
+    parse(image.data(), image.size()*sizeof(uint64_t));
+}
+
+OpeningBook::OpeningBook(const std::string &path)
+    : mapping(nullptr), mappingSize(0), header(nullptr), buckets(nullptr), entries(nullptr) {
+    auto descriptor = open(path.data(), O_RDONLY);
+
+    if (descriptor == -1) {
+        throw SerializationException("Impossible to open the book file: " + std::string(strerror(errno)));
+    }
+
+    struct stat fileStatus{};
+    if (fstat(descriptor, &fileStatus) == -1 || fileStatus.st_size <= 0) {
+        close(descriptor);
+        throw SerializationException("Impossible to read the size of the book file");
+    }
+
+    mappingSize = fileStatus.st_size;
+    mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+
+    if (mapping == MAP_FAILED) {
+        mapping = nullptr;
+        throw SerializationException("Impossible to map the book file: " + std::string(strerror(errno)));
+    }
+
+    // The lookups hit random pages: reading ahead would only waste memory.
+    madvise(mapping, mappingSize, MADV_RANDOM);
+
+    try {
+        parse(mapping, mappingSize);
+    } catch (const SerializationException &exception) {
+        unmap();
+        throw;
+    }
+}
+
+OpeningBook::~OpeningBook() {
+    unmap();
+}
+
+void OpeningBook::unmap() {
+    if (mapping != nullptr) {
+        munmap(mapping, mappingSize);
+        mapping = nullptr;
+    }
+}
+
+size_t OpeningBook::computePrefixWords(unsigned int bucketBits) {
+    auto prefixSize = sizeof(Header) + ((size_t(1) << bucketBits) + 1)*sizeof(uint32_t);
+    return (prefixSize + sizeof(uint64_t) - 1)/sizeof(uint64_t);
+}
+
+void OpeningBook::parse(const void *data, size_t size) {
+    if (size < sizeof(Header)) {
+        throw SerializationException("Malformed book: missing header");
+    }
+
+    header = static_cast<const Header*>(data);
+
+    if (memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION) {
+        throw SerializationException("Malformed book: unknown format");
+    }
+
+    if (header->rows != ROWS || header->columns != COLUMNS || header->connectLength != CONNECT_LENGTH) {
+        throw SerializationException("The book belongs to a different board geometry");
+    }
+
+    if (header->bucketBits > Position::KEY_BITS) {
+        throw SerializationException("Malformed book: invalid bucket table");
+    }
+
+    auto prefixWords = computePrefixWords(header->bucketBits);
+    if (size/sizeof(uint64_t) < prefixWords || (size/sizeof(uint64_t) - prefixWords) < header->entryCount) {
+        throw SerializationException("Malformed book: truncated file");
+    }
+
+    buckets = reinterpret_cast<const uint32_t*>(static_cast<const unsigned char*>(data) + sizeof(Header));
+    entries = static_cast<const uint64_t*>(data) + prefixWords;
+
+    // A non-decreasing table ending at the entry count keeps every bucket inside the entry array.
+    auto bucketCount = size_t(1) << header->bucketBits;
+    if (buckets[bucketCount] != header->entryCount) {
+        throw SerializationException("Malformed book: invalid bucket table");
+    }
+
+    for (size_t bucket = 0; bucket < bucketCount; bucket++) {
+        if (buckets[bucket] > buckets[bucket + 1]) {
+            throw SerializationException("Malformed book: invalid bucket table");
+        }
+    }
+}
+
+unsigned int OpeningBook::getMaxMoves() const {
+    return header->maxMoves;
+}
+
+size_t OpeningBook::getEntryCount() const {
+    return header->entryCount;
+}
+
+bool OpeningBook::lookup(const Position &position, int &score) const {
+    if (position.getMoves() > header->maxMoves) {
+        return false;
+    }
+
+    auto mirrored = false;
+    auto hashedKey = Position::scrambleKey(position.getCanonicalKey(mirrored));
+    auto bucket = hashedKey >> (Position::KEY_BITS - header->bucketBits);
+
+    for (auto i = buckets[bucket]; i < buckets[bucket + 1]; i++) {
+        auto entryKey = entries[i] >> 8;
+
+        if (entryKey == hashedKey) {
+            score = static_cast<int>(entries[i] & 0xFF) - 128;
+            return true;
+        }
+
+        if (entryKey > hashedKey) {
+            break;
+        }
+    }
+
+    return false;
+}
+
+void OpeningBook::save(const std::string &path) const {
+    auto prefixWords = computePrefixWords(header->bucketBits);
+    auto size = (prefixWords + header->entryCount)*sizeof(uint64_t);
+    auto file = fopen(path.data(), "wb");
+
+    if (!file) {
+        throw SerializationException("Impossible to open the book file: " + std::string(strerror(errno)));
+    }
+
+    auto written = fwrite(header, 1, size, file);
+    auto closed = fclose(file);
+
+    if (written != size || closed != 0) {
+        throw SerializationException("Impossible to write the book file");
+    }
+}
+
+}
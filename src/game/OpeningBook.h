@@ -0,0 +1,123 @@
+#ifndef INC_4INAROW_OPENINGBOOK_H
+#define INC_4INAROW_OPENINGBOOK_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Position.h"
+
+namespace fourinarow {
+
+/**
+ * Class representing an opening book, i.e. a read-only collection of the exact scores
+ * of the positions of the classic game having at most a given number of discs.
+ * The book is a binary image made of:
+ * 1) a header, holding the geometry of the board, the maximum number of discs and the number of entries;
+ * 2) a bucket table, holding for each bucket the index of its first entry;
+ * 3) the entries, sorted by scrambled canonical key. Each entry packs the scrambled key
+ *    in the most significant bits and the score, offset by 128, in the least significant byte.
+ * The bucket of an entry is given by the most significant bits of its scrambled key,
+ * and the buckets hold a few entries on average, so that a lookup costs one access
+ * to the bucket table and one access to a short run of contiguous entries.
+ * A book saved to a file is memory-mapped read-only: loading it does not copy the entries,
+ * and the pages are shared by all the processes using the same file.
+ * The image uses the byte order of the machine that wrote it.
+ */
+class OpeningBook {
+    public:
+        struct Entry {
+            Position position;
+            int score;
+        };
+    private:
+        struct Header {
+            char magic[8];
+            uint32_t version;
+            uint8_t rows;
+            uint8_t columns;
+            uint8_t connectLength;
+            uint8_t maxMoves;
+            uint32_t bucketBits;
+            uint32_t reserved;
+            uint64_t entryCount;
+        };
+
+        static const char MAGIC[8];
+        static const uint32_t VERSION = 1;
+        static const unsigned int ENTRIES_PER_BUCKET = 4;
+
+        std::vector<uint64_t> image;  // Holds the book when it is not memory-mapped.
+        void *mapping;
+        size_t mappingSize;
+        const Header *header;
+        const uint32_t *buckets;
+        const uint64_t *entries;
+
+        /**
+         * Returns the number of 64-bit words occupied by the header and the bucket table.
+         * @param bucketBits  the number of bits of a bucket index.
+         * @return            the size of the header and the bucket table, in 64-bit words.
+         */
+        static size_t computePrefixWords(unsigned int bucketBits);
+
+        /**
+         * Validates a binary image of a book, and initializes the pointers to its parts.
+         * @param data  the start of the image.
+         * @param size  the size of the image, in bytes.
+         * @throws SerializationException  if the image is malformed, or belongs to a different board geometry.
+         */
+        void parse(const void *data, size_t size);
+
+        /**
+         * Releases the memory-mapped file, if any.
+         */
+        void unmap();
+    public:
+        /**
+         * Creates a book from a set of solved positions, holding the image in memory.
+         * The positions are not required to be canonical, nor to be free of duplicates.
+         * @param solvedPositions  the solved positions.
+         * @param maxMoves         the maximum number of discs of the positions covered by the book.
+         */
+        OpeningBook(const std::vector<Entry> &solvedPositions, unsigned int maxMoves);
+
+        /**
+         * Loads a book from a file, memory-mapping it read-only.
+         * @param path  the path of the book file.
+         * @throws SerializationException  if the file cannot be opened or mapped,
+         *                                 or it is not a valid book for the classic game.
+         */
+        explicit OpeningBook(const std::string &path);
+
+        /**
+         * Destroys the book, unmapping the file if needed.
+         */
+        ~OpeningBook();
+
+        OpeningBook(const OpeningBook&) = delete;
+        OpeningBook& operator=(const OpeningBook&) = delete;
+        OpeningBook(OpeningBook&&) = delete;
+        OpeningBook& operator=(OpeningBook&&) = delete;
+
+        unsigned int getMaxMoves() const;
+        size_t getEntryCount() const;
+
+        /**
+         * Looks up the score of a position.
+         * @param position  the position.
+         * @param score     the variable that will store the score, from the point of view of the player to move.
+         * @return          true if the position is in the book, false otherwise.
+         */
+        bool lookup(const Position &position, int &score) const;
+
+        /**
+         * Writes the book to a file.
+         * @param path  the path of the book file.
+         * @throws SerializationException  if the file cannot be written.
+         */
+        void save(const std::string &path) const;
+};
+
+}
+
+#endif //INC_4INAROW_OPENINGBOOK_H
@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "ParallelSolver.h"
+
+namespace fourinarow {
+
+ParallelSolver::ParallelSolver(unsigned int threads)
+    : ParallelSolver(threads, std::make_shared<TranspositionTable>(DEFAULT_TRANSPOSITION_TABLE_SIZE)) {}
+
+ParallelSolver::ParallelSolver(unsigned int threads, std::shared_ptr<TranspositionTable> table)
+    : table(std::move(table)), book(), threadCount(std::max(1u, threads)), nodeLimit(0), timeLimit(0) {}
+
+unsigned int ParallelSolver::getThreadCount() const {
+    return threadCount;
+}
+
+void ParallelSolver::setThreadCount(unsigned int threads) {
+    threadCount = std::max(1u, threads);
+}
+
+void ParallelSolver::setNodeLimit(uint64_t limit) {
+    nodeLimit = limit;
+}
+
+void ParallelSolver::setTimeLimit(std::chrono::milliseconds limit) {
+    timeLimit = limit;
+}
+
+void ParallelSolver::setOpeningBook(std::shared_ptr<const OpeningBook> openingBook) {
+    book = std::move(openingBook);
+}
+
+Solver::Evaluation ParallelSolver::solve(const Position &position) {
+    std::atomic<bool> stop(false);
+    std::vector<Solver::Evaluation> evaluations(threadCount);
+    std::vector<std::thread> helpers;
+
+    auto search = [this, &position, &stop, &evaluations](unsigned int variant) {
+        Solver solver(table);
+        solver.setOpeningBook(book);
+        solver.setNodeLimit(nodeLimit);
+        solver.setTimeLimit(timeLimit);
+        solver.setStopFlag(&stop);
+        solver.setSearchVariant(variant);
+
+        evaluations[variant] = solver.solve(position);
+
+        // The first thread completing the search stops the others.
+        if (evaluations[variant].isExact()) {
+            stop.store(true, std::memory_order_relaxed);
+        }
+    };
+
+    for (auto i = 1u; i < threadCount; i++) {
+        helpers.emplace_back(search, i);
+    }
+    search(0);
+
+    for (auto &helper : helpers) {
+        helper.join();
+    }
+
+    /*
+     * The bounds proven by every thread are valid, so they can be combined. The best move
+     * is the one of the thread proving the highest lower bound, preferring the main thread.
+     */
+    auto result = evaluations[0];
+    result.nodes = 0;
+
+    for (const auto &evaluation : evaluations) {
+        if (evaluation.lowerBound > result.lowerBound) {
+            result.lowerBound = evaluation.lowerBound;
+            result.bestMove = evaluation.bestMove;
+        }
+        result.upperBound = std::min(result.upperBound, evaluation.upperBound);
+        result.nodes += evaluation.nodes;
+    }
+
+    return result;
+}
+
+}
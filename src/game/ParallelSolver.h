@@ -0,0 +1,77 @@
+#ifndef INC_4INAROW_PARALLELSOLVER_H
+#define INC_4INAROW_PARALLELSOLVER_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include "OpeningBook.h"
+#include "Position.h"
+#include "Solver.h"
+#include "TranspositionTable.h"
+
+namespace fourinarow {
+
+/**
+ * Class used to solve positions of the classic game with several threads, following the Lazy SMP scheme.
+ * Every thread runs a complete search of the position with its own solver, and all the solvers share
+ * the same transposition table: the results proven by a thread are immediately reused by the others,
+ * so the threads split the work without any explicit synchronization. The helper threads use different
+ * search variants, so that they explore different parts of the tree instead of duplicating the work.
+ * The search ends as soon as one thread completes it, or a budget is exhausted.
+ */
+class ParallelSolver {
+    private:
+        std::shared_ptr<TranspositionTable> table;
+        std::shared_ptr<const OpeningBook> book;
+        unsigned int threadCount;
+        uint64_t nodeLimit;
+        std::chrono::milliseconds timeLimit;
+    public:
+        /**
+         * Creates a parallel solver without budgets, owning a transposition table
+         * of <code>DEFAULT_TRANSPOSITION_TABLE_SIZE</code> bytes.
+         * @param threads  the number of search threads. Zero is treated as one.
+         */
+        explicit ParallelSolver(unsigned int threads);
+
+        /**
+         * Creates a parallel solver without budgets, using the given transposition table.
+         * @param threads  the number of search threads. Zero is treated as one.
+         * @param table    the transposition table.
+         */
+        ParallelSolver(unsigned int threads, std::shared_ptr<TranspositionTable> table);
+
+        unsigned int getThreadCount() const;
+        void setThreadCount(unsigned int threads);
+
+        /**
+         * Sets the maximum number of nodes explored by each thread during a call to <code>solve()</code>.
+         * @param limit  the node budget of each thread. Zero means no budget.
+         */
+        void setNodeLimit(uint64_t limit);
+
+        /**
+         * Sets the maximum time spent by a call to <code>solve()</code>.
+         * @param limit  the time budget. Zero means no budget.
+         */
+        void setTimeLimit(std::chrono::milliseconds limit);
+
+        /**
+         * Sets the opening book shared by the search threads.
+         * @param openingBook  the opening book. Null disables the book.
+         */
+        void setOpeningBook(std::shared_ptr<const OpeningBook> openingBook);
+
+        /**
+         * Solves a position. If a budget is exhausted before any thread completes the search,
+         * the bounds are the tightest ones proven by the threads.
+         * @param position  the position.
+         * @return          the evaluation of the position. The number of nodes is the total
+         *                  over all the threads.
+         */
+        Solver::Evaluation solve(const Position &position);
+};
+
+}
+
+#endif //INC_4INAROW_PARALLELSOLVER_H
@@ -14,11 +14,18 @@ fourinarow::Player::Player()
     : status(Status::OFFLINE),
       clientKeys(nullptr),
       serverKeys(nullptr),
+      cipherSuite(CIPHER_AES_128_GCM),
       cipher(nullptr),
       sequenceNumberReads(0),
       sequenceNumberWrites(0),
       matchmakingInitiator(false) {}
 
+Player::~Player() {
+    if (!resumptionSecret.empty()) {
+        cleanse(resumptionSecret);
+    }
+}
+
 const std::string& Player::getUsername() const {
     return username;
 }
@@ -68,6 +75,14 @@ const AuthenticatedEncryption& Player::getCipher() const {
     return *cipher;
 }
 
+bool Player::hasCipher() const {
+    return cipher != nullptr;
+}
+
+const std::vector<unsigned char>& Player::getResumptionSecret() const {
+    return resumptionSecret;
+}
+
 uint32_t Player::getSequenceNumberReads() const {
     return sequenceNumberReads;
 }
@@ -80,6 +95,10 @@ bool Player::isMatchmakingInitiator() const {
     return matchmakingInitiator;
 }
 
+uint8_t Player::getCipherSuite() const {
+    return cipherSuite;
+}
+
 void Player::setStatus(Player::Status newStatus) {
     status = newStatus;
 }
@@ -92,6 +111,12 @@ void Player::setAsMatchmakingInitiator(bool initiator) {
     matchmakingInitiator = initiator;
 }
 
+void Player::setCipherSuite(uint8_t newCipherSuite) {
+    // Throws if the cipher suite is not supported.
+    AuthenticatedEncryption::getKeySize(newCipherSuite);
+    cipherSuite = newCipherSuite;
+}
+
 void Player::setUsername(std::string newUsername) {
     checkUsernameValidity<SerializationException>(newUsername);
     username = std::move(newUsername);
@@ -159,10 +184,12 @@ void Player::generateClientKeys() {
                               "The public key of the client must be set, not generated");
     }
 
-    clientKeys = std::make_unique<DiffieHellman>();
+    // The client follows the group chosen by the server, if its public key is already known.
+    auto group = serverPublicKey.empty() ? KEY_EXCHANGE_ECDH_P256 : DiffieHellman::getGroup(serverPublicKey);
+    clientKeys = std::make_unique<DiffieHellman>(group);
 }
 
-void Player::generateServerKeys() {
+void Player::generateServerKeys(uint8_t group) {
     if (!serverPublicKey.empty()) {
         throw CryptoException("The public key of the server has already been set, so it cannot be generated");
     }
@@ -172,7 +199,7 @@ void Player::generateServerKeys() {
                               "The public key of the server must be set, not generated");
     }
 
-    serverKeys = std::make_unique<DiffieHellman>();
+    serverKeys = std::make_unique<DiffieHellman>(group);
 }
 
 void Player::checkIfClientNonceInitialized() const {
@@ -215,24 +242,7 @@ void Player::initCipher() {
         sharedSecret = serverKeys->deriveSharedSecret(clientPublicKey);
     }
 
-    // Concatenate the shared secret, the client nonce and the server nonce to generate the entropy source.
-    std::vector<unsigned char> entropySource;
-    entropySource.reserve(sharedSecret.size() + clientNonce.size() + serverNonce.size());
-    concatenate(entropySource, sharedSecret, clientNonce, serverNonce);
-
-    // Derive the key for the cipher.
-    auto secretBlock = SHA256::hash(entropySource);
-
-    /*
-     * Security check in case the symmetric cipher is changed carelessly.
-     * It never throws if KEY_SIZE is compliant with AES-128 GCM.
-     */
-    if (secretBlock.size() < KEY_SIZE) {
-        throw CryptoException("The secret block is too small to extract the key");
-    }
-
-    cipher = std::make_unique<AuthenticatedEncryption>(std::vector<unsigned char>(secretBlock.begin(),
-                                                                                  secretBlock.begin() + KEY_SIZE));
+    deriveCipher(sharedSecret);
 
     // Cleansing.
     if (clientKeys != nullptr) {
@@ -243,6 +253,52 @@ void Player::initCipher() {
         serverKeys = nullptr;
     }
     cleanse(sharedSecret);
+}
+
+void Player::resumeCipher(const std::vector<unsigned char> &previousResumptionSecret) {
+    checkIfClientNonceInitialized();
+    checkIfServerNonceInitialized();
+
+    if (previousResumptionSecret.size() != RESUMPTION_SECRET_SIZE) {
+        throw CryptoException("The resumption secret is wrongly sized");
+    }
+
+    deriveCipher(previousResumptionSecret);
+}
+
+void Player::deriveCipher(const std::vector<unsigned char> &secret) {
+    // Concatenate the secret, the client nonce and the server nonce to generate the entropy source.
+    std::vector<unsigned char> entropySource;
+    entropySource.reserve(secret.size() + clientNonce.size() + serverNonce.size());
+    concatenate(entropySource, secret, clientNonce, serverNonce);
+
+    // Derive the key for the cipher and the resumption secret.
+    auto keySize = AuthenticatedEncryption::getKeySize(cipherSuite);
+    auto secretBlock = SHA256::hash(entropySource);
+
+    // Extend the block if the key of the cipher suite is too long to extract it together with the resumption secret.
+    while (secretBlock.size() < keySize + RESUMPTION_SECRET_SIZE) {
+        std::vector<unsigned char> chainedSource;
+        chainedSource.reserve(secretBlock.size() + entropySource.size());
+        concatenate(chainedSource, secretBlock, entropySource);
+
+        auto extension = SHA256::hash(chainedSource);
+        secretBlock.insert(secretBlock.end(), extension.begin(), extension.end());
+
+        cleanse(chainedSource);
+        cleanse(extension);
+    }
+
+    cipher = std::make_unique<AuthenticatedEncryption>(std::vector<unsigned char>(secretBlock.begin(),
+                                                                                  secretBlock.begin() + keySize),
+                                                       cipherSuite);
+
+    if (!resumptionSecret.empty()) {
+        cleanse(resumptionSecret);
+    }
+    resumptionSecret.assign(secretBlock.begin() + keySize, secretBlock.begin() + keySize + RESUMPTION_SECRET_SIZE);
+
+    // Cleansing.
     cleanse(entropySource);
     cleanse(secretBlock);
 }
@@ -251,7 +307,7 @@ void Player::generateServerFreshnessProof() {
     checkIfClientNonceInitialized();
     checkIfServerKeyInitialized();
 
-    serverFreshnessProof.reserve(NONCE_SIZE + ECDH_PUBLIC_KEY_SIZE);
+    serverFreshnessProof.reserve(NONCE_SIZE + MAX_ECDH_PUBLIC_KEY_SIZE);
     concatenate(serverFreshnessProof, clientNonce, getServerPublicKey());
 }
 
@@ -259,7 +315,7 @@ void Player::generateClientFreshnessProof() {
     checkIfServerNonceInitialized();
     checkIfClientKeyInitialized();
 
-    clientFreshnessProof.reserve(NONCE_SIZE + ECDH_PUBLIC_KEY_SIZE);
+    clientFreshnessProof.reserve(NONCE_SIZE + MAX_ECDH_PUBLIC_KEY_SIZE);
     concatenate(clientFreshnessProof, serverNonce, getClientPublicKey());
 }
 
@@ -37,7 +37,7 @@ class Player {
                 AVAILABLE,                // The player completed the handshake successfully and is available for playing.
                 MATCHMAKING,              // The player is exchanging messages to set up a match.
                 MATCHMAKING_INTERRUPTED,  // The matchmaking failed. The player will become AVAILABLE at the next message exchange.
-                PLAYING                   // The player is doing a P2P match.
+                PLAYING                   // The player is doing a match, either P2P or relayed by the server.
         };
     private:
         std::string username;
@@ -50,7 +50,9 @@ class Player {
         std::vector<unsigned char> serverPublicKey;
         std::vector<unsigned char> clientFreshnessProof;
         std::vector<unsigned char> serverFreshnessProof;
+        uint8_t cipherSuite;
         std::unique_ptr<AuthenticatedEncryption> cipher;
+        std::vector<unsigned char> resumptionSecret;
         uint32_t sequenceNumberReads;
         uint32_t sequenceNumberWrites;
         std::string matchmakingPlayer;
@@ -81,6 +83,17 @@ class Player {
          *                          or has been destroyed.
          */
         void checkIfServerKeyInitialized() const;
+
+        /**
+         * Derives the key of the cipher and the resumption secret from the SHA256 hash of an entropy source,
+         * obtained concatenating the given secret, the client nonce and the server nonce.
+         * If the hash is too short, it is extended with the SHA256 hash of the hash itself and the entropy source.
+         * The first bytes of the result form the key of the cipher suite of the player, the following
+         * <code>RESUMPTION_SECRET_SIZE</code> bytes the resumption secret.
+         * @param secret  the secret.
+         * @throws CryptoException  if an error occurs while deriving the secret quantities.
+         */
+        void deriveCipher(const std::vector<unsigned char> &secret);
     public:
         /**
          * Creates a player object, setting its status to <code>OFFLINE</code>.
@@ -90,7 +103,7 @@ class Player {
         /**
          * Destroys the object and securely wipes the cryptographic secrets from memory.
          */
-        ~Player() = default;
+        ~Player();
 
         Player(Player&&) = default;
         Player& operator=(Player&&) = default;
@@ -107,6 +120,7 @@ class Player {
         uint32_t getSequenceNumberReads() const;
         uint32_t getSequenceNumberWrites() const;
         bool isMatchmakingInitiator() const;
+        uint8_t getCipherSuite() const;
 
         /**
          * Returns the public key of the client. If the key was part of a generated
@@ -137,10 +151,32 @@ class Player {
          */
         const AuthenticatedEncryption& getCipher() const;
 
+        /**
+         * Returns true if the cipher has been generated, either by <code>initCipher()</code>
+         * or by <code>resumeCipher()</code>.
+         */
+        bool hasCipher() const;
+
+        /**
+         * Returns the resumption secret derived together with the cipher, which can be
+         * used to resume the session with <code>resumeCipher()</code>.
+         * Calls preceding the generation of the cipher return an empty vector.
+         * @return  the resumption secret.
+         */
+        const std::vector<unsigned char>& getResumptionSecret() const;
+
         void setStatus(Status newStatus);
         void setMatchmakingPlayer(std::string matchmakingPlayer);
         void setAsMatchmakingInitiator(bool matchmakingInitiator);
 
+        /**
+         * Sets the cipher suite used by the next call to <code>initCipher()</code> or <code>resumeCipher()</code>.
+         * By default, AES-128 GCM is used.
+         * @param cipherSuite  the cipher suite.
+         * @throws CryptoException  if the cipher suite is not supported.
+         */
+        void setCipherSuite(uint8_t cipherSuite);
+
         /**
          * Sets the username of the player.
          * @param username  the username.
@@ -198,12 +234,14 @@ class Player {
 
         /**
          * Generates and stores a private-public key pair for the client
-         * using Elliptic-curve Diffie-Hellman. The pair can be generated only
+         * using Elliptic-curve Diffie-Hellman, in the group of the public key of the server
+         * if it has already been set, in the prime256v1 group otherwise. The pair can be generated only
          * if the key pair of the server has not already been generated and
          * the public key of the client has not already been set.
-         * @throws CryptoException  if the public key of the client has already been set,
-         *                          or the server key pair has already been generated,
-         *                          or an error occurs while generating the pair.
+         * @throws CryptoException         if the public key of the client has already been set,
+         *                                 or the server key pair has already been generated,
+         *                                 or an error occurs while generating the pair.
+         * @throws SerializationException  if the public key of the server belongs to an unsupported group.
          */
         void generateClientKeys();
 
@@ -212,18 +250,20 @@ class Player {
          * using Elliptic-curve Diffie-Hellman. The pair can be generated only
          * if the key pair of the client has not already been generated and
          * the public key of the server has not already been set.
+         * @param group  the key exchange group, by default prime256v1.
          * @throws CryptoException  if the public key of the server has already been set,
          *                          or the client key pair has already been generated,
          *                          or an error occurs while generating the pair.
          */
-        void generateServerKeys();
+        void generateServerKeys(uint8_t group = KEY_EXCHANGE_ECDH_P256);
 
         /**
-         * Initializes the cipher used to encrypt, decrypt and authenticate the communications.
-         * The key is derived from the SHA256 hash of an entropy source. The latter is obtained concatenating:
+         * Initializes the cipher used to encrypt, decrypt and authenticate the communications,
+         * using the cipher suite of the player. The key is derived from the SHA256 hash of an entropy source. The latter is obtained concatenating:
          * 1) the Elliptic-curve Diffie-Hellman shared secret;
          * 2) the client nonce;
          * 3) the server nonce.
+         * A resumption secret is derived from the same hash.
          * At the end of the method, the ECDH key pair that was previously generated
          * is securely destroyed and made unrecoverable.
          * @throws CryptoException         if at least one of the above quantities has not been set/generated,
@@ -234,6 +274,16 @@ class Player {
          */
         void initCipher();
 
+        /**
+         * Initializes the cipher of a resumed session, without performing Elliptic-curve Diffie-Hellman.
+         * The key is derived as in <code>initCipher()</code>, replacing the shared secret
+         * with the resumption secret of the previous session. A new resumption secret is derived too.
+         * @param previousResumptionSecret  the resumption secret of the previous session.
+         * @throws CryptoException  if the nonces have not been set/generated, the resumption secret
+         *                          is wrongly sized, or an error occurs while deriving the secret quantities.
+         */
+        void resumeCipher(const std::vector<unsigned char> &previousResumptionSecret);
+
         /**
          * Generates the proof of freshness used by a server.
          * This method can be used for both client-server and P2P handshakes.
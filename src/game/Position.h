@@ -0,0 +1,317 @@
+#ifndef INC_4INAROW_POSITION_H
+#define INC_4INAROW_POSITION_H
+
+#include <cstdint>
+#include <string>
+#include <Constants.h>
+#include "BoardGeometry.h"
+
+namespace fourinarow {
+
+/**
+ * Class representing a position of a "Four-in-a-row" game, as seen by the
+ * player that has to move. Differently from <code>BasicFourInARow</code>, which tracks a match
+ * from the point of view of one of the two players, a position is meant to be explored
+ * by a search: it stores only the discs of the player to move and the mask of all the discs,
+ * so that a move is a couple of bit operations and copying a position is cheap.
+ * The layout of the bitboards is described by <code>BoardGeometry</code>.
+ * A position never contains a line of aligned discs: the moves that would end the game
+ * must be detected with <code>isWinningMove()</code> before being played.
+ * @tparam Rows           the number of rows of the board.
+ * @tparam Columns        the number of columns of the board.
+ * @tparam ConnectLength  the number of aligned discs needed to win.
+ */
+template<uint8_t Rows, uint8_t Columns, uint8_t ConnectLength>
+class BasicPosition {
+    public:
+        using Geometry = BoardGeometry<Rows, Columns, ConnectLength>;
+        using Bitboard = typename Geometry::Bitboard;
+
+        /*
+         * Bounds of the score of a position. The score is positive if the player to move
+         * can win, negative if the opponent can win, zero if the game ends in a draw.
+         * Its absolute value is the number of discs the winner has not played yet when
+         * the game ends, plus one: the faster the win, the higher the score.
+         */
+        static constexpr int MIN_SCORE = -static_cast<int>(Geometry::SPACES)/2 + ConnectLength - 1;
+        static constexpr int MAX_SCORE = (static_cast<int>(Geometry::SPACES) + 1)/2 - ConnectLength + 1;
+
+        // Number of significant bits of a key.
+        static constexpr unsigned int KEY_BITS = Geometry::COLUMN_HEIGHT*Columns;
+    private:
+        Bitboard currentPlayer;
+        Bitboard mask;
+        unsigned int moves;
+
+        /**
+         * Shifts a bitboard to the left if the given amount is positive,
+         * to the right if it is negative.
+         * @param bitboard  the bitboard.
+         * @param amount    the number of bits of the shift.
+         * @return          the shifted bitboard.
+         */
+        static constexpr Bitboard shift(Bitboard bitboard, int amount) {
+            return amount >= 0 ? bitboard << amount : bitboard >> -amount;
+        }
+
+        /**
+         * Returns the spaces that would complete a line of aligned discs, considering the lines
+         * whose adjacent spaces are represented by bits at the given distance. For each possible
+         * position of the missing disc inside a line, the discs of the line are shifted on top
+         * of the missing one and intersected.
+         * @param discs     the bitboard holding the discs of a player.
+         * @param distance  the distance, in bits, between two adjacent spaces of a line.
+         * @return          the bitboard of the spaces completing a line. Occupied spaces,
+         *                  as well as spaces outside the board, can be included.
+         */
+        static constexpr Bitboard computeLineCompletions(Bitboard discs, unsigned int distance) {
+            Bitboard completions = 0;
+
+            for (auto missing = 0; missing < ConnectLength; missing++) {
+                auto line = ~Bitboard(0);
+                for (auto i = 0; i < ConnectLength; i++) {
+                    if (i != missing) {
+                        line &= shift(discs, (missing - i)*static_cast<int>(distance));
+                    }
+                }
+                completions |= line;
+            }
+
+            return completions;
+        }
+
+        /**
+         * Returns the empty spaces that would give a win to the player owning the given discs.
+         * The spaces are not necessarily playable, i.e. they can be above the top disc of a column.
+         * @param discs  the bitboard holding the discs of a player.
+         * @param mask   the bitboard holding the discs of both players.
+         * @return       the bitboard of the winning spaces.
+         */
+        static constexpr Bitboard computeWinningPositions(Bitboard discs, Bitboard mask) {
+            return (computeLineCompletions(discs, Geometry::VERTICAL)
+                    | computeLineCompletions(discs, Geometry::HORIZONTAL)
+                    | computeLineCompletions(discs, Geometry::LEFT_DIAGONAL)
+                    | computeLineCompletions(discs, Geometry::RIGHT_DIAGONAL))
+                   & (Geometry::boardMask() ^ mask);
+        }
+
+        Bitboard winningPositions() const {
+            return computeWinningPositions(currentPlayer, mask);
+        }
+
+        Bitboard opponentWinningPositions() const {
+            return computeWinningPositions(currentPlayer ^ mask, mask);
+        }
+    public:
+        /**
+         * Creates the position of an empty board.
+         */
+        BasicPosition() : currentPlayer(0), mask(0), moves(0) {}
+
+        /**
+         * Creates a position from its bitboards.
+         * @param currentPlayer  the discs of the player to move.
+         * @param mask           the discs of both players.
+         * @param moves          the number of discs on the board.
+         */
+        BasicPosition(Bitboard currentPlayer, Bitboard mask, unsigned int moves)
+            : currentPlayer(currentPlayer), mask(mask), moves(moves) {}
+
+        Bitboard getCurrentPlayerDiscs() const {
+            return currentPlayer;
+        }
+
+        Bitboard getMask() const {
+            return mask;
+        }
+
+        unsigned int getMoves() const {
+            return moves;
+        }
+
+        /**
+         * Returns a key identifying the position. The sum of the two bitboards sets the bit
+         * on top of the highest disc of each column, which encodes the mask, while the bits below
+         * encode the discs of the player to move. The key is unique for each position.
+         * @return  the key of the position.
+         */
+        Bitboard getKey() const {
+            return currentPlayer + mask;
+        }
+
+        /**
+         * Returns the key of the mirror image of a position, given the key of the position.
+         * The key is mirrored column by column, including the bit on top of each column.
+         * @param key  the key of the position.
+         * @return     the key of the mirrored position.
+         */
+        static constexpr Bitboard mirrorKey(Bitboard key) {
+            Bitboard mirrored = 0;
+            const auto columnBits = (Bitboard(1) << Geometry::COLUMN_HEIGHT) - 1;
+
+            for (auto i = 0u; i < Columns; i++) {
+                auto column = (key >> (i*Geometry::COLUMN_HEIGHT)) & columnBits;
+                mirrored |= column << ((Columns - 1 - i)*Geometry::COLUMN_HEIGHT);
+            }
+
+            return mirrored;
+        }
+
+        /**
+         * Returns a key shared by the position and its mirror image, namely the lowest of the two keys.
+         * Two mirrored positions have mirrored best moves and the same score, so they can share
+         * the results of a search.
+         * @param mirrored  the variable that will store true if the returned key is the one
+         *                  of the mirror image, false otherwise.
+         * @return          the canonical key of the position.
+         */
+        Bitboard getCanonicalKey(bool &mirrored) const {
+            auto key = getKey();
+            auto mirroredKey = mirrorKey(key);
+            mirrored = mirroredKey < key;
+            return mirrored ? mirroredKey : key;
+        }
+
+        /**
+         * Scrambles a key with a bijective function over <code>KEY_BITS</code> bits, namely
+         * a multiplication by an odd constant modulo <code>2^KEY_BITS</code>. The most significant bits
+         * of the result are uniformly distributed and can be used as an index, while the whole result
+         * still identifies the position exactly.
+         * @param key  the key of a position.
+         * @return     the scrambled key.
+         */
+        static constexpr Bitboard scrambleKey(Bitboard key) {
+            return (key*Bitboard(UINT64_C(0x9E3779B97F4A7C15)))
+                   & (KEY_BITS == 8*sizeof(Bitboard) ? ~Bitboard(0) : (Bitboard(1) << (KEY_BITS % (8*sizeof(Bitboard)))) - 1);
+        }
+
+        /**
+         * Checks if a disc can be inserted in the given column.
+         * @param columnIndex  the column index. It must be lower than <code>Columns</code>.
+         * @return             true if the column has at least one empty space, false otherwise.
+         */
+        bool canPlay(uint8_t columnIndex) const {
+            return (mask & Geometry::topMask(columnIndex)) == 0;
+        }
+
+        /**
+         * Plays a move, given as the bitboard having only the bit of the new disc set.
+         * The turn passes to the other player.
+         * @param move  the move. It must be a playable space.
+         */
+        void play(Bitboard move) {
+            currentPlayer ^= mask;
+            mask |= move;
+            moves++;
+        }
+
+        /**
+         * Plays a move in the given column. The turn passes to the other player.
+         * @param columnIndex  the column index. The column must be playable.
+         */
+        void playColumn(uint8_t columnIndex) {
+            play((mask + Geometry::bottomMask(columnIndex)) & Geometry::columnMask(columnIndex));
+        }
+
+        /**
+         * Plays a sequence of moves, given as a string of column indexes (e.g. "3342").
+         * The sequence is played only if all its moves are valid and none of them wins the game.
+         * @param sequence  the sequence of column indexes, starting from 0.
+         * @return          true if the sequence has been played, false if it is invalid. In the
+         *                  latter case the position is left unchanged.
+         */
+        bool playSequence(const std::string &sequence) {
+            auto position = *this;
+
+            for (auto move : sequence) {
+                auto columnIndex = move - '0';
+                if (columnIndex < 0
+                    || columnIndex >= Columns
+                    || !position.canPlay(columnIndex)
+                    || position.isWinningMove(columnIndex)) {
+                    return false;
+                }
+                position.playColumn(columnIndex);
+            }
+
+            *this = position;
+            return true;
+        }
+
+        /**
+         * Returns the playable spaces, i.e. the space above the top disc of each non-full column.
+         * @return  the bitboard of the playable spaces.
+         */
+        Bitboard possible() const {
+            return (mask + Geometry::bottomRowMask()) & Geometry::boardMask();
+        }
+
+        /**
+         * Checks if the player to move wins by inserting a disc in the given column.
+         * @param columnIndex  the column index. It must be lower than <code>Columns</code>.
+         * @return             true if the move wins the game, false otherwise.
+         */
+        bool isWinningMove(uint8_t columnIndex) const {
+            return (winningPositions() & possible() & Geometry::columnMask(columnIndex)) != 0;
+        }
+
+        /**
+         * Checks if the player to move can win with the next move.
+         * @return  true if at least one of the playable spaces wins the game, false otherwise.
+         */
+        bool canWinNext() const {
+            return (winningPositions() & possible()) != 0;
+        }
+
+        /**
+         * Returns the moves that do not give the opponent an immediate win.
+         * If the opponent threatens to win in a playable space, the only candidate move
+         * is the forced block; if the opponent threatens two playable spaces, the game
+         * is lost and no move is returned. The moves directly below a winning space of
+         * the opponent are discarded as well. This method must be called only
+         * if the player to move cannot win with the next move.
+         * @return  the bitboard of the non-losing moves.
+         */
+        Bitboard possibleNonLosingMoves() const {
+            auto possibleMoves = possible();
+            auto opponentWins = opponentWinningPositions();
+            auto forcedMoves = possibleMoves & opponentWins;
+
+            if (forcedMoves) {
+                if (forcedMoves & (forcedMoves - 1)) {
+                    return 0;
+                }
+                possibleMoves = forcedMoves;
+            }
+
+            return possibleMoves & ~(opponentWins >> 1);
+        }
+
+        /**
+         * Scores a move for ordering purposes, counting the winning spaces
+         * the player to move would have after playing it.
+         * @param move  the move, as a bitboard having only the bit of the new disc set.
+         * @return      the number of winning spaces created by the move.
+         */
+        unsigned int moveScore(Bitboard move) const {
+            return countBits(computeWinningPositions(currentPlayer | move, mask));
+        }
+};
+
+template<uint8_t Rows, uint8_t Columns, uint8_t ConnectLength>
+constexpr int BasicPosition<Rows, Columns, ConnectLength>::MIN_SCORE;
+
+template<uint8_t Rows, uint8_t Columns, uint8_t ConnectLength>
+constexpr int BasicPosition<Rows, Columns, ConnectLength>::MAX_SCORE;
+
+template<uint8_t Rows, uint8_t Columns, uint8_t ConnectLength>
+constexpr unsigned int BasicPosition<Rows, Columns, ConnectLength>::KEY_BITS;
+
+/**
+ * A position of the classic game.
+ */
+using Position = BasicPosition<ROWS, COLUMNS, CONNECT_LENGTH>;
+
+}
+
+#endif //INC_4INAROW_POSITION_H
@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include "QuickMatchQueue.h"
+
+namespace fourinarow {
+
+QuickMatchQueue::QuickMatchQueue(unsigned int bucketWidth, uint64_t wideningPeriod)
+: bucketWidth(bucketWidth), wideningPeriod(wideningPeriod) {
+    if (bucketWidth == 0 || wideningPeriod == 0) {
+        throw std::invalid_argument("The bucket width and the widening period must be positive");
+    }
+}
+
+uint64_t QuickMatchQueue::getTolerance(const Entry &entry, uint64_t now) const {
+    return now > entry.arrivalTime ? (now - entry.arrivalTime)/wideningPeriod : 0;
+}
+
+QuickMatchQueue::BucketMap::iterator QuickMatchQueue::findPartnerBucket(BucketMap::iterator bucket, uint64_t now) {
+    auto tolerance = getTolerance(bucket->second.front(), now);
+    auto partner = buckets.end();
+
+    // Only the neighbours can be the nearest buckets, since the empty ones are not stored.
+    auto next = std::next(bucket);
+    if (next != buckets.end() && next->first - bucket->first <= tolerance) {
+        partner = next;
+    }
+
+    if (bucket != buckets.begin()) {
+        auto previous = std::prev(bucket);
+        auto distance = bucket->first - previous->first;
+
+        if (distance <= tolerance &&
+            (partner == buckets.end() || distance < partner->first - bucket->first ||
+             (distance == partner->first - bucket->first &&
+              previous->second.front().arrivalTime <= partner->second.front().arrivalTime))) {
+            partner = previous;
+        }
+    }
+
+    return partner;
+}
+
+void QuickMatchQueue::scheduleWakeup(BucketMap::iterator bucket) {
+    auto distance = std::numeric_limits<unsigned int>::max();
+    auto next = std::next(bucket);
+    if (next != buckets.end()) {
+        distance = next->first - bucket->first;
+    }
+    if (bucket != buckets.begin()) {
+        distance = std::min(distance, bucket->first - std::prev(bucket)->first);
+    }
+
+    if (distance != std::numeric_limits<unsigned int>::max()) {
+        wakeups.emplace(bucket->second.front().arrivalTime + static_cast<uint64_t>(distance)*wideningPeriod, bucket->first);
+    }
+}
+
+QuickMatchQueue::Entry QuickMatchQueue::takeFirst(BucketMap::iterator bucket) {
+    auto entry = std::move(bucket->second.front());
+    bucket->second.pop_front();
+    index.erase(entry.username);
+    return entry;
+}
+
+bool QuickMatchQueue::push(Entry entry) {
+    if (index.count(entry.username) != 0) {
+        return false;
+    }
+
+    auto bucketIndex = entry.rating/bucketWidth;
+    auto inserted = buckets.emplace(bucketIndex, Bucket());
+    auto &bucket = inserted.first->second;
+
+    // A new bucket becomes the nearest one of its neighbours, which can now reach it sooner.
+    changedBuckets.push_back(bucketIndex);
+    if (inserted.second) {
+        if (std::next(inserted.first) != buckets.end()) {
+            changedBuckets.push_back(std::next(inserted.first)->first);
+        }
+        if (inserted.first != buckets.begin()) {
+            changedBuckets.push_back(std::prev(inserted.first)->first);
+        }
+    }
+
+    // A new player arrives last, so the scan stops immediately unless the player is put back.
+    auto position = bucket.end();
+    while (position != bucket.begin() && std::prev(position)->arrivalTime > entry.arrivalTime) {
+        position--;
+    }
+
+    auto username = entry.username;
+    auto iterator = bucket.insert(position, std::move(entry));
+    index.emplace(std::move(username), std::make_pair(bucketIndex, iterator));
+    return true;
+}
+
+bool QuickMatchQueue::erase(const std::string &username) {
+    auto entry = index.find(username);
+    if (entry == index.end()) {
+        return false;
+    }
+
+    auto bucket = buckets.find(entry->second.first);
+    bucket->second.erase(entry->second.second);
+    if (bucket->second.empty()) {
+        buckets.erase(bucket);
+    }
+
+    index.erase(entry);
+    return true;
+}
+
+bool QuickMatchQueue::contains(const std::string &username) const {
+    return index.count(username) != 0;
+}
+
+void QuickMatchQueue::match(uint64_t now, std::vector<Pairing> &pairings) {
+    while (!wakeups.empty() && wakeups.top().first <= now) {
+        changedBuckets.push_back(wakeups.top().second);
+        wakeups.pop();
+    }
+
+    // The buckets are visited in ascending order, as a walk of the whole map would do.
+    std::sort(changedBuckets.begin(), changedBuckets.end());
+    changedBuckets.erase(std::unique(changedBuckets.begin(), changedBuckets.end()), changedBuckets.end());
+
+    /*
+     * The buckets not visited cannot pair their players: they hold a single player, and their neighbours
+     * are farther than its tolerance. A pairing only removes buckets, so it does not make new pairings possible.
+     */
+    for (auto bucketIndex : changedBuckets) {
+        auto bucket = buckets.find(bucketIndex);
+        if (bucket == buckets.end()) {
+            continue;
+        }
+
+        while (bucket->second.size() >= 2) {
+            auto first = takeFirst(bucket);
+            auto second = takeFirst(bucket);
+            pairings.push_back(Pairing{std::move(first), std::move(second)});
+        }
+
+        if (bucket->second.empty()) {
+            buckets.erase(bucket);
+            continue;
+        }
+
+        /*
+         * The player is alone in its bucket. A neighbour left with a single player could not
+         * reach this one with its own tolerance, so the pairing is granted by the longest waiting time.
+         */
+        auto partner = findPartnerBucket(bucket, now);
+        if (partner == buckets.end()) {
+            scheduleWakeup(bucket);
+            continue;
+        }
+
+        auto first = takeFirst(bucket);
+        auto second = takeFirst(partner);
+        if (second.arrivalTime < first.arrivalTime) {
+            std::swap(first, second);
+        }
+        pairings.push_back(Pairing{std::move(first), std::move(second)});
+
+        if (partner->second.empty()) {
+            buckets.erase(partner);
+        }
+        buckets.erase(bucket);
+    }
+
+    changedBuckets.clear();
+}
+
+size_t QuickMatchQueue::size() const {
+    return index.size();
+}
+
+bool QuickMatchQueue::empty() const {
+    return index.empty();
+}
+
+}
@@ -0,0 +1,135 @@
+#ifndef INC_4INAROW_QUICKMATCHQUEUE_H
+#define INC_4INAROW_QUICKMATCHQUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace fourinarow {
+
+/**
+ * Class representing the queue of the players asking for a quick match, hosted by a server.
+ * The players are grouped in buckets of <code>bucketWidth</code> rating points, kept in an ordered map
+ * holding only the non-empty buckets, and each bucket is a list ordered by the time of arrival.
+ * Two players of the same bucket are paired as soon as possible, the ones waiting for the longest time first.
+ * A player alone in its bucket accepts an opponent from a bucket up to <code>w/wideningPeriod</code>
+ * buckets away, where <code>w</code> is its waiting time: the nearest non-empty buckets are
+ * the neighbours in the map, so that finding a partner costs <code>O(log b)</code>,
+ * where <code>b</code> is the number of non-empty buckets. A sweep does not walk all the buckets:
+ * it visits only the ones changed by the arrivals since the previous sweep and the ones whose player
+ * has waited long enough to reach its nearest neighbour, each at the cost of <code>O(log b)</code>.
+ * An index by username makes the removal of a player leaving the queue cost <code>O(log b)</code> as well.
+ */
+class QuickMatchQueue {
+    public:
+        struct Entry {
+            std::string username;
+            uint32_t handle;       // Opaque handle of the player (e.g. its socket descriptor).
+            unsigned int rating;
+            uint64_t arrivalTime;  // In milliseconds.
+        };
+
+        struct Pairing {
+            Entry first;
+            Entry second;
+        };
+    private:
+        using Bucket = std::list<Entry>;
+        using BucketMap = std::map<unsigned int, Bucket>;
+        using Wakeup = std::pair<uint64_t, unsigned int>;  // The time of the visit and the bucket index.
+
+        BucketMap buckets;  // By bucket index. Only the non-empty buckets are stored.
+        std::unordered_map<std::string, std::pair<unsigned int, Bucket::iterator>> index;
+        std::vector<unsigned int> changedBuckets;  // The buckets to visit at the next sweep, with repetitions.
+        std::priority_queue<Wakeup, std::vector<Wakeup>, std::greater<Wakeup>> wakeups;
+        unsigned int bucketWidth;
+        uint64_t wideningPeriod;
+
+        /**
+         * Returns the maximum distance between the bucket of a player and the one of its opponent.
+         * @param entry  the entry of the player.
+         * @param now    the current time, in milliseconds.
+         * @return       the maximum distance, in buckets.
+         */
+        uint64_t getTolerance(const Entry &entry, uint64_t now) const;
+
+        /**
+         * Finds the nearest bucket from which the only player of the given bucket accepts an opponent.
+         * If two buckets are at the same distance, the one whose first player arrived earlier is chosen.
+         * @param bucket  the bucket holding a single player.
+         * @param now     the current time, in milliseconds.
+         * @return        the bucket of the opponent, or the end of the map if no bucket is near enough.
+         */
+        BucketMap::iterator findPartnerBucket(BucketMap::iterator bucket, uint64_t now);
+
+        /**
+         * Schedules the visit of a bucket holding a single player, at the time when the tolerance of the player
+         * reaches the nearest non-empty bucket. A bucket without neighbours is visited when one is created.
+         * The visits scheduled before are left in place: a visit finding no partner is harmless.
+         * @param bucket  the bucket holding a single player.
+         */
+        void scheduleWakeup(BucketMap::iterator bucket);
+
+        /**
+         * Removes the player who arrived first in a bucket. The bucket is not erased if it becomes empty.
+         * @param bucket  the bucket.
+         * @return        the entry of the player.
+         */
+        Entry takeFirst(BucketMap::iterator bucket);
+    public:
+        /**
+         * Creates an empty queue.
+         * @param bucketWidth     the width of the buckets, in rating points. It must be positive.
+         * @param wideningPeriod  the waiting time after which a player accepts an opponent one more bucket away,
+         *                        in milliseconds. It must be positive.
+         * @throws invalid_argument  if a parameter is zero.
+         */
+        QuickMatchQueue(unsigned int bucketWidth, uint64_t wideningPeriod);
+
+        ~QuickMatchQueue() = default;
+        QuickMatchQueue(const QuickMatchQueue&) = delete;
+        QuickMatchQueue& operator=(const QuickMatchQueue&) = delete;
+        QuickMatchQueue(QuickMatchQueue&&) = default;
+        QuickMatchQueue& operator=(QuickMatchQueue&&) = default;
+
+        /**
+         * Adds a player to the queue. A player put back in the queue keeps its original arrival time,
+         * so that it does not lose its turn.
+         * @param entry  the entry of the player.
+         * @return       true if the player has been added, false if it is already in the queue.
+         */
+        bool push(Entry entry);
+
+        /**
+         * Removes a player from the queue.
+         * @param username  the username of the player.
+         * @return          true if the player has been removed, false if it was not in the queue.
+         */
+        bool erase(const std::string &username);
+
+        bool contains(const std::string &username) const;
+
+        /**
+         * Pairs the players of the queue, removing them. Each player is paired at most once,
+         * with a player of the same bucket if possible, otherwise with the one of the nearest bucket
+         * within the tolerance granted by the longest waiting time of the two.
+         * Only the buckets changed since the previous call and the ones whose visit is due are visited.
+         * @param now       the current time, in milliseconds.
+         * @param pairings  the vector to which the pairings are appended.
+         */
+        void match(uint64_t now, std::vector<Pairing> &pairings);
+
+        size_t size() const;
+        bool empty() const;
+};
+
+}
+
+#endif //INC_4INAROW_QUICKMATCHQUEUE_H
@@ -0,0 +1,30 @@
+#include <algorithm>
+#include <cmath>
+#include <Constants.h>
+#include "RatingTable.h"
+
+namespace fourinarow {
+
+unsigned int RatingTable::get(const std::string &username) const {
+    auto rating = ratings.find(username);
+    return rating == ratings.end() ? INITIAL_RATING : rating->second;
+}
+
+void RatingTable::update(const std::string &player, const std::string &opponent, MatchResult result) {
+    auto playerRating = static_cast<double>(get(player));
+    auto opponentRating = static_cast<double>(get(opponent));
+
+    auto expectedScore = 1/(1 + std::pow(10, (opponentRating - playerRating)/400));
+    auto score = result == MatchResult::WIN ? 1.0 : (result == MatchResult::DRAW ? 0.5 : 0.0);
+    auto change = RATING_K_FACTOR*(score - expectedScore);
+
+    // The points gained by a player are lost by the other one, unless a rating would drop below zero.
+    ratings[player] = static_cast<unsigned int>(std::max(0.0, std::round(playerRating + change)));
+    ratings[opponent] = static_cast<unsigned int>(std::max(0.0, std::round(opponentRating - change)));
+}
+
+size_t RatingTable::size() const {
+    return ratings.size();
+}
+
+}
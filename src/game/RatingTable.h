@@ -0,0 +1,46 @@
+#ifndef INC_4INAROW_RATINGTABLE_H
+#define INC_4INAROW_RATINGTABLE_H
+
+#include <string>
+#include <unordered_map>
+#include "MatchResult.h"
+
+namespace fourinarow {
+
+/**
+ * Class representing the Elo ratings of the players, kept by a server until it is restarted.
+ * A player starts from <code>INITIAL_RATING</code>, and after each match gains or loses up to
+ * <code>RATING_K_FACTOR</code> points, depending on the result and on the rating of the opponent.
+ */
+class RatingTable {
+    private:
+        std::unordered_map<std::string, unsigned int> ratings;
+    public:
+        RatingTable() = default;
+        ~RatingTable() = default;
+        RatingTable(const RatingTable&) = delete;
+        RatingTable& operator=(const RatingTable&) = delete;
+        RatingTable(RatingTable&&) = default;
+        RatingTable& operator=(RatingTable&&) = default;
+
+        /**
+         * Returns the rating of a player.
+         * @param username  the username of the player.
+         * @return          the rating, or <code>INITIAL_RATING</code> if the player has not finished any match.
+         */
+        unsigned int get(const std::string &username) const;
+
+        /**
+         * Updates the ratings of the two players of a finished match.
+         * @param player    the username of a player.
+         * @param opponent  the username of the other player.
+         * @param result    the result of the match, from the point of view of <code>player</code>.
+         */
+        void update(const std::string &player, const std::string &opponent, MatchResult result);
+
+        size_t size() const;
+};
+
+}
+
+#endif //INC_4INAROW_RATINGTABLE_H
@@ -0,0 +1,365 @@
+#include <algorithm>
+#include "Solver.h"
+
+namespace fourinarow {
+
+const std::array<uint8_t, COLUMNS> Solver::columnOrder = Solver::generateColumnOrder();
+const uint64_t Solver::CLOCK_CHECK_INTERVAL;
+
+Solver::MoveSorter::MoveSorter() : entries(), size(0) {}
+
+void Solver::MoveSorter::add(Position::Bitboard move, uint8_t column, unsigned int score) {
+    auto position = size++;
+
+    for (; position > 0 && entries[position - 1].score > score; position--) {
+        entries[position] = entries[position - 1];
+    }
+
+    entries[position] = Entry{move, column, score};
+}
+
+bool Solver::MoveSorter::next(Position::Bitboard &move, uint8_t &column) {
+    if (size == 0) {
+        return false;
+    }
+
+    size--;
+    move = entries[size].move;
+    column = entries[size].column;
+    return true;
+}
+
+Solver::Solver() : Solver(std::make_shared<TranspositionTable>(DEFAULT_TRANSPOSITION_TABLE_SIZE)) {}
+
+Solver::Solver(std::shared_ptr<TranspositionTable> table)
+    : table(std::move(table)), book(), moveOrder(columnOrder), variant(0), nodeCount(0), nodeLimit(0),
+      timeLimit(0), deadline(), stopFlag(nullptr), aborted(false) {}
+
+std::array<uint8_t, COLUMNS> Solver::generateColumnOrder() {
+    std::array<uint8_t, COLUMNS> order{};
+
+    for (auto i = 0; i < COLUMNS; i++) {
+        order[i] = COLUMNS/2 + (1 - 2*(i % 2))*(i + 1)/2;
+    }
+
+    return order;
+}
+
+void Solver::sortMoves(const Position &position, Position::Bitboard moves, uint8_t bestMove, MoveSorter &sorter) const {
+    // The columns are added in reverse order, so that the first columns win the ties.
+    for (auto i = COLUMNS; i > 0; i--) {
+        auto column = moveOrder[i - 1];
+        auto move = moves & Position::Geometry::columnMask(column);
+
+        if (move) {
+            auto score = column == bestMove ? ~0u : position.moveScore(move);
+            sorter.add(move, column, score);
+        }
+    }
+}
+
+bool Solver::isBudgetExhausted() {
+    if (nodeLimit != 0 && nodeCount > nodeLimit) {
+        aborted = true;
+    } else if (stopFlag != nullptr && stopFlag->load(std::memory_order_relaxed)) {
+        aborted = true;
+    } else if (timeLimit.count() != 0 && nodeCount % CLOCK_CHECK_INTERVAL == 0
+               && std::chrono::steady_clock::now() >= deadline) {
+        aborted = true;
+    }
+    return aborted;
+}
+
+int Solver::negamax(const Position &position, int alpha, int beta) {
+    nodeCount++;
+
+    if (isBudgetExhausted()) {
+        return alpha;
+    }
+
+    const int spaces = Position::Geometry::SPACES;
+    const int moves = position.getMoves();
+    auto next = position.possibleNonLosingMoves();
+
+    if (next == 0) { // The opponent wins with the next move.
+        return -(spaces - moves)/2;
+    }
+
+    if (moves >= spaces - 2) { // Neither player can win with the last two discs.
+        return 0;
+    }
+
+    // The opponent cannot win with the next move, so the score is at least the one of a loss two moves later.
+    auto min = -(spaces - 2 - moves)/2;
+    if (alpha < min) {
+        alpha = min;
+        if (alpha >= beta) {
+            return alpha;
+        }
+    }
+
+    // This player cannot win with the next move, so the score is at most the one of a win two moves later.
+    auto max = (spaces - 1 - moves)/2;
+    if (beta > max) {
+        beta = max;
+        if (alpha >= beta) {
+            return beta;
+        }
+    }
+
+    int bookScore;
+    if (book && book->lookup(position, bookScore)) {
+        return bookScore;
+    }
+
+    auto originalAlpha = alpha;
+    TranspositionTable::Entry entry{};
+    auto bestMove = TranspositionTable::NO_MOVE;
+
+    if (table->load(position, entry)) {
+        if (entry.bound == TranspositionTable::Bound::EXACT) {
+            return entry.value;
+        }
+
+        if (entry.bound == TranspositionTable::Bound::LOWER && alpha < entry.value) {
+            alpha = entry.value;
+            if (alpha >= beta) {
+                return alpha;
+            }
+        }
+
+        if (entry.bound == TranspositionTable::Bound::UPPER && beta > entry.value) {
+            beta = entry.value;
+            if (alpha >= beta) {
+                return beta;
+            }
+        }
+
+        bestMove = entry.bestMove;
+    }
+
+    MoveSorter sorter;
+    sortMoves(position, next, bestMove, sorter);
+
+    Position::Bitboard move;
+    uint8_t column;
+    while (sorter.next(move, column)) {
+        auto child = position;
+        child.play(move);
+        auto score = -negamax(child, -beta, -alpha);
+
+        if (aborted) {
+            return alpha;
+        }
+
+        if (score >= beta) {
+            table->store(position, TranspositionTable::Entry{TranspositionTable::Bound::LOWER, score, column});
+            return score;
+        }
+
+        if (score > alpha) {
+            alpha = score;
+            bestMove = column;
+        }
+    }
+
+    auto bound = alpha > originalAlpha ? TranspositionTable::Bound::EXACT : TranspositionTable::Bound::UPPER;
+    table->store(position, TranspositionTable::Entry{bound, alpha, bestMove});
+    return alpha;
+}
+
+int Solver::searchRoot(const Position &position, int alpha, int beta, uint8_t &bestMove) {
+    nodeCount++;
+
+    TranspositionTable::Entry entry{};
+    auto tableMove = TranspositionTable::NO_MOVE;
+    if (table->load(position, entry)) {
+        tableMove = entry.bestMove;
+    }
+
+    MoveSorter sorter;
+    sortMoves(position, position.possibleNonLosingMoves(), tableMove, sorter);
+
+    Position::Bitboard move;
+    uint8_t column;
+    while (sorter.next(move, column)) {
+        auto child = position;
+        child.play(move);
+        auto score = -negamax(child, -beta, -alpha);
+
+        if (aborted) {
+            return alpha;
+        }
+
+        if (score >= beta) {
+            bestMove = column;
+            return score;
+        }
+
+        if (score > alpha) {
+            alpha = score;
+        }
+    }
+
+    return alpha;
+}
+
+bool Solver::solveFromBook(const Position &position, Evaluation &evaluation) const {
+    int score;
+    if (!book || !book->lookup(position, score)) {
+        return false;
+    }
+
+    auto next = position.possibleNonLosingMoves();
+    auto bestMove = COLUMNS;
+    auto bestScore = 0;
+
+    for (auto column : columnOrder) {
+        auto move = next & Position::Geometry::columnMask(column);
+        if (!move) {
+            continue;
+        }
+
+        auto child = position;
+        child.play(move);
+
+        int childScore;
+        if (!book->lookup(child, childScore)) {
+            return false;
+        }
+
+        if (bestMove == COLUMNS || -childScore > bestScore) {
+            bestMove = column;
+            bestScore = -childScore;
+        }
+    }
+
+    if (bestMove == COLUMNS || bestScore != score) {
+        return false;
+    }
+
+    evaluation = Evaluation{score, score, bestMove, 0};
+    return true;
+}
+
+void Solver::setNodeLimit(uint64_t limit) {
+    nodeLimit = limit;
+}
+
+void Solver::setTimeLimit(std::chrono::milliseconds limit) {
+    timeLimit = limit;
+}
+
+void Solver::setStopFlag(const std::atomic<bool> *flag) {
+    stopFlag = flag;
+}
+
+void Solver::setSearchVariant(unsigned int searchVariant) {
+    variant = searchVariant;
+    moveOrder = columnOrder;
+
+    // The central column stays first, while the others are rotated.
+    if (COLUMNS > 2) {
+        auto shift = variant % (COLUMNS - 1);
+        for (auto i = 0u; i < COLUMNS - 1; i++) {
+            moveOrder[1 + i] = columnOrder[1 + (i + shift) % (COLUMNS - 1)];
+        }
+    }
+}
+
+void Solver::setOpeningBook(std::shared_ptr<const OpeningBook> openingBook) {
+    book = std::move(openingBook);
+}
+
+Solver::Evaluation Solver::solve(const Position &position) {
+    nodeCount = 0;
+    aborted = false;
+    deadline = std::chrono::steady_clock::now() + timeLimit;
+
+    const int spaces = Position::Geometry::SPACES;
+    const int moves = position.getMoves();
+
+    if (position.canWinNext()) {
+        uint8_t winningMove = 0;
+        for (auto column : columnOrder) {
+            if (position.canPlay(column) && position.isWinningMove(column)) {
+                winningMove = column;
+                break;
+            }
+        }
+
+        auto score = (spaces + 1 - moves)/2;
+        return Evaluation{score, score, winningMove, 0};
+    }
+
+    if (moves >= spaces) {
+        return Evaluation{0, 0, COLUMNS, 0};
+    }
+
+    // When every move loses, any playable column is a best move.
+    auto fallbackMove = COLUMNS;
+    for (auto column : columnOrder) {
+        if (position.canPlay(column)) {
+            fallbackMove = column;
+            break;
+        }
+    }
+
+    auto next = position.possibleNonLosingMoves();
+    if (next == 0) {
+        auto score = -(spaces - moves)/2;
+        return Evaluation{score, score, fallbackMove, 0};
+    }
+
+    Evaluation evaluation{};
+    if (solveFromBook(position, evaluation)) {
+        return evaluation;
+    }
+
+    MoveSorter sorter;
+    sortMoves(position, next, TranspositionTable::NO_MOVE, sorter);
+    Position::Bitboard move;
+    sorter.next(move, fallbackMove);
+
+    auto min = -(spaces - moves)/2;
+    auto max = (spaces + 1 - moves)/2;
+    auto bestMove = fallbackMove;
+
+    while (min < max) {
+        /*
+         * Test the middle of the range, moving the threshold towards zero:
+         * the scores close to zero belong to long games, and are the most expensive to prove.
+         */
+        auto threshold = min + (max - min)/2;
+        if (threshold <= 0 && min/2 < threshold) {
+            threshold = min/2;
+        } else if (threshold >= 0 && max/2 > threshold) {
+            threshold = max/2;
+        }
+
+        // The variants move the threshold by one in either direction, staying inside the range.
+        if (variant % 3 == 1) {
+            threshold = std::min(max - 1, threshold + 1);
+        } else if (variant % 3 == 2) {
+            threshold = std::max(min, threshold - 1);
+        }
+
+        auto candidateMove = bestMove;
+        auto score = searchRoot(position, threshold, threshold + 1, candidateMove);
+
+        if (aborted) {
+            break;
+        }
+
+        if (score <= threshold) {
+            max = score;
+        } else {
+            min = score;
+            bestMove = candidateMove;
+        }
+    }
+
+    return Evaluation{min, max, bestMove, nodeCount};
+}
+
+}
@@ -0,0 +1,206 @@
+#ifndef INC_4INAROW_SOLVER_H
+#define INC_4INAROW_SOLVER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <Constants.h>
+#include "OpeningBook.h"
+#include "Position.h"
+#include "TranspositionTable.h"
+
+namespace fourinarow {
+
+/**
+ * Class used to solve positions of the classic game, i.e. to compute the score of a position
+ * assuming that both players play perfectly, together with a best move.
+ * The search is a negamax with alpha-beta pruning, exploring the columns from the center
+ * to the sides and, among them, the moves creating more winning spaces first.
+ * Immediate wins are detected before searching, and the moves are restricted to the forced block
+ * when the opponent threatens to win. The bounds proven for each node are kept in a transposition table,
+ * which also provides the best move found so far to be explored first; the table can be shared
+ * with other solvers. The score is found with iterative deepening over null-window
+ * searches: each iteration tests whether the score is above a threshold, halving the range of
+ * possible scores, so that short wins and losses are proven by cheap shallow searches first.
+ * If a node budget is set and exhausted, the search stops and returns the bounds proven so far.
+ * The search can also be bounded by a time budget, or stopped by another thread through a shared flag.
+ * If an opening book is set, the positions it covers are scored without searching.
+ */
+class Solver {
+    public:
+        /**
+         * Result of a search. The score of the position is guaranteed to lie between
+         * the two bounds, which coincide if the search completed.
+         */
+        struct Evaluation {
+            int lowerBound;
+            int upperBound;
+            uint8_t bestMove;  // The column of the best move found, COLUMNS if the board is full.
+            uint64_t nodes;    // The number of nodes explored by the search.
+
+            bool isExact() const {
+                return lowerBound == upperBound;
+            }
+        };
+    private:
+        /**
+         * Class used to sort the moves of a node by decreasing score. The moves are inserted
+         * with an insertion sort, which is the fastest option for the few moves of a node.
+         * Among moves with the same score, the last inserted one is returned first.
+         */
+        class MoveSorter {
+            private:
+                struct Entry {
+                    Position::Bitboard move;
+                    uint8_t column;
+                    unsigned int score;
+                };
+
+                std::array<Entry, COLUMNS> entries;
+                unsigned int size;
+            public:
+                MoveSorter();
+
+                void add(Position::Bitboard move, uint8_t column, unsigned int score);
+
+                /**
+                 * Removes and returns the move with the highest score.
+                 * @param move    the variable that will store the move.
+                 * @param column  the variable that will store the column of the move.
+                 * @return        true if a move was returned, false if the sorter is empty.
+                 */
+                bool next(Position::Bitboard &move, uint8_t &column);
+        };
+
+        static const std::array<uint8_t, COLUMNS> columnOrder;
+        static const uint64_t CLOCK_CHECK_INTERVAL = 4096;  // Nodes explored between two reads of the clock.
+
+        std::shared_ptr<TranspositionTable> table;
+        std::shared_ptr<const OpeningBook> book;
+        std::array<uint8_t, COLUMNS> moveOrder;
+        unsigned int variant;
+        uint64_t nodeCount;
+        uint64_t nodeLimit;
+        std::chrono::milliseconds timeLimit;
+        std::chrono::steady_clock::time_point deadline;
+        const std::atomic<bool> *stopFlag;
+        bool aborted;
+
+        /**
+         * Returns the columns sorted from the center to the sides.
+         */
+        static std::array<uint8_t, COLUMNS> generateColumnOrder();
+
+        /**
+         * Fills a sorter with the given moves of a position, scoring each move
+         * with the number of winning spaces it creates. The best move stored
+         * in the transposition table, if any, is placed first. The ties are broken
+         * by the column order of the search variant.
+         * @param position  the position.
+         * @param moves     the bitboard of the moves to sort.
+         * @param bestMove  the column of the move to explore first, <code>TranspositionTable::NO_MOVE</code> if none.
+         * @param sorter    the sorter that will hold the moves.
+         */
+        void sortMoves(const Position &position, Position::Bitboard moves, uint8_t bestMove, MoveSorter &sorter) const;
+
+        /**
+         * Checks if the node or time budget has been exhausted, or the search has been stopped
+         * from outside, marking the search as aborted.
+         * @return  true if the search must be aborted, false otherwise.
+         */
+        bool isBudgetExhausted();
+
+        /**
+         * Searches a position with alpha-beta pruning. The returned value is the exact score
+         * if it lies inside the window, an upper bound if it is lower than or equal to alpha,
+         * a lower bound if it is greater than or equal to beta.
+         * The player to move must not be able to win with the next move.
+         * @param position  the position.
+         * @param alpha     the lower bound of the window.
+         * @param beta      the upper bound of the window.
+         * @return          the score of the position, relative to the window.
+         */
+        int negamax(const Position &position, int alpha, int beta);
+
+        /**
+         * Searches the root position like <code>negamax()</code>, returning also
+         * the move that proved the score to be greater than or equal to beta, if any.
+         * @param position  the position.
+         * @param alpha     the lower bound of the window.
+         * @param beta      the upper bound of the window.
+         * @param bestMove  the variable that will store the column of the move reaching beta.
+         *                  It is left unchanged if no move reaches beta.
+         * @return          the score of the position, relative to the window.
+         */
+        int searchRoot(const Position &position, int alpha, int beta, uint8_t &bestMove);
+
+        /**
+         * Scores a position using the opening book. The best move is the one leading to the child
+         * with the lowest score, so the position is scored only if all its children are in the book.
+         * @param position    the position. The player to move must not be able to win with the next move.
+         * @param evaluation  the variable that will store the evaluation of the position.
+         * @return            true if the position has been scored, false otherwise.
+         */
+        bool solveFromBook(const Position &position, Evaluation &evaluation) const;
+    public:
+        /**
+         * Creates a solver without budgets, owning a transposition table
+         * of <code>DEFAULT_TRANSPOSITION_TABLE_SIZE</code> bytes.
+         */
+        Solver();
+
+        /**
+         * Creates a solver without budgets, using the given transposition table.
+         * @param table  the transposition table, possibly shared with other solvers.
+         */
+        explicit Solver(std::shared_ptr<TranspositionTable> table);
+
+        /**
+         * Sets the maximum number of nodes explored by a call to <code>solve()</code>.
+         * @param limit  the node budget. Zero means no budget.
+         */
+        void setNodeLimit(uint64_t limit);
+
+        /**
+         * Sets the maximum time spent by a call to <code>solve()</code>.
+         * @param limit  the time budget. Zero means no budget.
+         */
+        void setTimeLimit(std::chrono::milliseconds limit);
+
+        /**
+         * Sets a flag that stops the search as soon as another thread raises it.
+         * The flag must outlive the searches of the solver.
+         * @param flag  the stop flag, possibly shared with other threads. Null disables it.
+         */
+        void setStopFlag(const std::atomic<bool> *flag);
+
+        /**
+         * Sets the search variant. Variant zero is the default search, while the other variants
+         * change the column order used to break the ties and the thresholds of the null-window searches,
+         * so that solvers sharing a transposition table explore different parts of the tree.
+         * The result of a search does not depend on the variant.
+         * @param searchVariant  the search variant.
+         */
+        void setSearchVariant(unsigned int searchVariant);
+
+        /**
+         * Sets the opening book used to score the positions with few discs.
+         * @param openingBook  the opening book, possibly shared with other solvers. Null disables the book.
+         */
+        void setOpeningBook(std::shared_ptr<const OpeningBook> openingBook);
+
+        /**
+         * Solves a position. If the player to move can win immediately or has lost,
+         * the result is returned without searching.
+         * @param position  the position.
+         * @return          the evaluation of the position. It is exact, unless a budget
+         *                  has been exhausted or the search has been stopped.
+         */
+        Evaluation solve(const Position &position);
+};
+
+}
+
+#endif //INC_4INAROW_SOLVER_H
@@ -0,0 +1,82 @@
+#include "TranspositionTable.h"
+
+namespace fourinarow {
+
+const uint8_t TranspositionTable::NO_MOVE;
+
+TranspositionTable::TranspositionTable(size_t size) : entryCount(1024), indexBits(10) {
+    static_assert(KEY_BITS < 64, "The keys of the classic game must fit into 64 bits");
+    static_assert(Position::MAX_SCORE < 128 && Position::MIN_SCORE >= -128, "The scores must fit into 8 bits");
+    static_assert(COLUMNS < NO_MOVE, "The columns must fit into 4 bits");
+
+    while (entryCount*2*sizeof(uint64_t) <= size && indexBits < KEY_BITS) {
+        entryCount *= 2;
+        indexBits++;
+    }
+
+    entries.reset(new std::atomic<uint64_t>[entryCount]);
+    clear();
+}
+
+size_t TranspositionTable::getEntryCount() const {
+    return entryCount;
+}
+
+size_t TranspositionTable::getSize() const {
+    return entryCount*sizeof(uint64_t);
+}
+
+void TranspositionTable::clear() {
+    for (size_t i = 0; i < entryCount; i++) {
+        entries[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t TranspositionTable::hash(const Position &position, bool &mirrored) {
+    return Position::scrambleKey(position.getCanonicalKey(mirrored));
+}
+
+bool TranspositionTable::load(const Position &position, Entry &entry) const {
+    auto mirrored = false;
+    auto hashedKey = hash(position, mirrored);
+    auto index = hashedKey >> (KEY_BITS - indexBits);
+    auto check = hashedKey & ((UINT64_C(1) << (KEY_BITS - indexBits)) - 1);
+
+    auto packed = entries[index].load(std::memory_order_relaxed);
+    auto bound = static_cast<Bound>((packed >> VALUE_BITS) & ((1u << BOUND_BITS) - 1));
+
+    if (bound == Bound::NONE || (packed >> CHECK_SHIFT) != check) {
+        return false;
+    }
+
+    entry.bound = bound;
+    entry.value = static_cast<int>(packed & ((1u << VALUE_BITS) - 1)) - 128;
+    entry.bestMove = (packed >> (VALUE_BITS + BOUND_BITS)) & ((1u << MOVE_BITS) - 1);
+
+    if (mirrored && entry.bestMove != NO_MOVE) {
+        entry.bestMove = COLUMNS - 1 - entry.bestMove;
+    }
+
+    return true;
+}
+
+void TranspositionTable::store(const Position &position, const Entry &entry) {
+    auto mirrored = false;
+    auto hashedKey = hash(position, mirrored);
+    auto index = hashedKey >> (KEY_BITS - indexBits);
+    auto check = hashedKey & ((UINT64_C(1) << (KEY_BITS - indexBits)) - 1);
+
+    uint64_t bestMove = entry.bestMove;
+    if (mirrored && bestMove != NO_MOVE) {
+        bestMove = COLUMNS - 1 - bestMove;
+    }
+
+    auto packed = (check << CHECK_SHIFT)
+                  | (bestMove << (VALUE_BITS + BOUND_BITS))
+                  | (static_cast<uint64_t>(entry.bound) << VALUE_BITS)
+                  | static_cast<uint64_t>(entry.value + 128);
+
+    entries[index].store(packed, std::memory_order_relaxed);
+}
+
+}
@@ -0,0 +1,109 @@
+#ifndef INC_4INAROW_TRANSPOSITIONTABLE_H
+#define INC_4INAROW_TRANSPOSITIONTABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "Position.h"
+
+namespace fourinarow {
+
+/**
+ * Class representing a fixed-size transposition table, storing the results of the searches
+ * over positions of the classic game. A position and its mirror image share the same entry,
+ * because the table is indexed by canonical keys and the best moves are stored mirrored when needed.
+ * Each entry is packed into a single 64-bit word holding a part of the key, the bound type,
+ * the value and the best move, so that the entries can be read and written atomically
+ * without locks by several search threads. The replacement policy is "always replace":
+ * a concurrent write can overwrite a more valuable entry, but never corrupt it.
+ * The table never allocates memory after construction.
+ */
+class TranspositionTable {
+    public:
+        enum class Bound : uint8_t {
+                NONE  = 0,  // The entry is empty.
+                LOWER = 1,  // The value is a lower bound of the score.
+                UPPER = 2,  // The value is an upper bound of the score.
+                EXACT = 3   // The value is the score.
+        };
+
+        static const uint8_t NO_MOVE = 15;
+
+        struct Entry {
+            Bound bound;
+            int value;
+            uint8_t bestMove;  // The column of the best move, NO_MOVE if unknown.
+        };
+    private:
+        /*
+         * Layout of a packed entry, from the least significant bit:
+         * 8 bits for the value, 2 bits for the bound, 4 bits for the best move
+         * and the remaining bits for the part of the hashed key not used as index.
+         */
+        static const unsigned int VALUE_BITS = 8;
+        static const unsigned int BOUND_BITS = 2;
+        static const unsigned int MOVE_BITS = 4;
+        static const unsigned int CHECK_SHIFT = VALUE_BITS + BOUND_BITS + MOVE_BITS;
+        static const unsigned int KEY_BITS = Position::KEY_BITS;
+
+        std::unique_ptr<std::atomic<uint64_t>[]> entries;
+        size_t entryCount;
+        unsigned int indexBits;
+
+        /**
+         * Returns the scrambled canonical key of a position. Its most significant bits are used
+         * as index, while the others are stored in the entry: since the scrambling is bijective,
+         * they identify the position exactly.
+         * @param position  the position.
+         * @param mirrored  the variable that will store true if the key is the one of the mirror image.
+         * @return          the scrambled canonical key.
+         */
+        static uint64_t hash(const Position &position, bool &mirrored);
+    public:
+        /**
+         * Creates a table occupying at most the given amount of memory. The number of entries
+         * is the highest power of two fitting into the given size, with a minimum of 1024 entries.
+         * @param size  the maximum size of the table, in bytes.
+         */
+        explicit TranspositionTable(size_t size);
+
+        ~TranspositionTable() = default;
+
+        TranspositionTable(const TranspositionTable&) = delete;
+        TranspositionTable& operator=(const TranspositionTable&) = delete;
+        TranspositionTable(TranspositionTable&&) = delete;
+        TranspositionTable& operator=(TranspositionTable&&) = delete;
+
+        size_t getEntryCount() const;
+
+        /**
+         * Returns the memory occupied by the entries of the table.
+         * @return  the size of the table, in bytes.
+         */
+        size_t getSize() const;
+
+        /**
+         * Empties the table. It must not be called while other threads are using the table.
+         */
+        void clear();
+
+        /**
+         * Retrieves the entry of a position. The best move is mirrored back
+         * if the entry was stored for the mirror image of the position.
+         * @param position  the position.
+         * @param entry     the variable that will store the entry.
+         * @return          true if the position has an entry, false otherwise.
+         */
+        bool load(const Position &position, Entry &entry) const;
+
+        /**
+         * Stores the entry of a position, replacing the entry occupying the same slot.
+         * @param position  the position.
+         * @param entry     the entry. Its value must lie in the score range of the classic game.
+         */
+        void store(const Position &position, const Entry &entry);
+};
+
+}
+
+#endif //INC_4INAROW_TRANSPOSITIONTABLE_H
@@ -0,0 +1,617 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <FourInARow.h>
+#include <GameJournalReader.h>
+#include <GameRecord.h>
+#include <OpeningBook.h>
+#include <Position.h>
+#include <Solver.h>
+#include <TranspositionTable.h>
+
+const size_t BATCH_SIZE = 4096;              // Games handed to a worker at once.
+const unsigned int BATCHES_PER_THREAD = 4;   // Batches waiting in the queue for each worker.
+const unsigned int MAX_OPENING_PLY = 16;
+
+struct Options {
+    std::string journal;
+    unsigned int threads;
+    unsigned int openingPly;
+    unsigned int top;         // The number of openings and players reported.
+    bool evaluate;
+    uint64_t nodeLimit;       // The node budget of the solver for each position, zero means no budget.
+    std::string book;
+    size_t memory;            // The size of the shared transposition table, in bytes.
+};
+
+/**
+ * Statistics of a player, counted over the games the player took part in.
+ */
+struct PlayerStatistics {
+    uint64_t games;
+    uint64_t wins;
+    uint64_t draws;
+    uint64_t losses;
+    uint64_t moves;
+    uint64_t evaluatedMoves;  // The moves whose score has been proven by the solver.
+    uint64_t optimalMoves;    // The evaluated moves keeping the score of the position.
+    uint64_t blunders;        // The evaluated moves turning a win into a draw or a loss, or a draw into a loss.
+
+    void merge(const PlayerStatistics &other) {
+        games += other.games;
+        wins += other.wins;
+        draws += other.draws;
+        losses += other.losses;
+        moves += other.moves;
+        evaluatedMoves += other.evaluatedMoves;
+        optimalMoves += other.optimalMoves;
+        blunders += other.blunders;
+    }
+};
+
+/**
+ * Statistics of the games starting with the same sequence of moves.
+ */
+struct OpeningStatistics {
+    uint64_t games;
+    std::array<uint64_t, 4> results;  // Indexed by the result of the game.
+};
+
+/**
+ * Statistics of a set of games. Each worker fills its own statistics, merged at the end.
+ */
+struct Statistics {
+    uint64_t games;
+    uint64_t inconsistentGames;       // The games with invalid moves, or whose moves do not lead to the recorded result.
+    std::array<uint64_t, 4> results;  // Indexed by the result of the game.
+    std::array<uint64_t, 4> moves;    // Indexed by the result of the game.
+    uint64_t evaluatedMoves;
+    uint64_t optimalMoves;
+    uint64_t blunders;
+    std::unordered_map<std::string, PlayerStatistics> players;
+    std::unordered_map<uint64_t, OpeningStatistics> openings;  // Indexed by the moves of the opening, 3 bits each.
+
+    void merge(const Statistics &other) {
+        games += other.games;
+        inconsistentGames += other.inconsistentGames;
+        evaluatedMoves += other.evaluatedMoves;
+        optimalMoves += other.optimalMoves;
+        blunders += other.blunders;
+
+        for (size_t i = 0; i < results.size(); i++) {
+            results[i] += other.results[i];
+            moves[i] += other.moves[i];
+        }
+
+        for (const auto &player : other.players) {
+            players[player.first].merge(player.second);
+        }
+
+        for (const auto &opening : other.openings) {
+            auto &entry = openings[opening.first];
+            entry.games += opening.second.games;
+            for (size_t i = 0; i < entry.results.size(); i++) {
+                entry.results[i] += opening.second.results[i];
+            }
+        }
+    }
+};
+
+/**
+ * Bounded queue of batches of games, moving the games from the reader to the workers.
+ * The processed batches are handed back to the reader, so that the memory of the records is reused.
+ */
+class BatchQueue {
+    private:
+        std::mutex mutex;
+        std::condition_variable notEmpty;
+        std::condition_variable notFull;
+        std::deque<std::vector<fourinarow::GameRecord>> batches;
+        std::vector<std::vector<fourinarow::GameRecord>> recycledBatches;
+        size_t capacity;
+        bool closed;
+    public:
+        explicit BatchQueue(size_t capacity) : capacity(capacity), closed(false) {}
+
+        /**
+         * Returns an empty batch, possibly one already processed by a worker.
+         */
+        std::vector<fourinarow::GameRecord> acquire() {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (recycledBatches.empty()) {
+                return {};
+            }
+
+            auto batch = std::move(recycledBatches.back());
+            recycledBatches.pop_back();
+            return batch;
+        }
+
+        /**
+         * Adds a batch to the queue, waiting while the queue is full.
+         * @param batch  the batch.
+         */
+        void push(std::vector<fourinarow::GameRecord> &&batch) {
+            std::unique_lock<std::mutex> lock(mutex);
+            notFull.wait(lock, [this]() { return batches.size() < capacity; });
+            batches.push_back(std::move(batch));
+            notEmpty.notify_one();
+        }
+
+        /**
+         * Removes a batch from the queue, waiting while the queue is empty and not closed.
+         * @param batch  the variable holding the batch previously processed, which is recycled,
+         *               and that will store the next batch.
+         * @return       true if a batch has been returned, false if the queue is closed and empty.
+         */
+        bool pop(std::vector<fourinarow::GameRecord> &batch) {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!batch.empty()) {
+                recycledBatches.push_back(std::move(batch));
+            }
+
+            notEmpty.wait(lock, [this]() { return !batches.empty() || closed; });
+            if (batches.empty()) {
+                return false;
+            }
+
+            batch = std::move(batches.front());
+            batches.pop_front();
+            notFull.notify_one();
+            return true;
+        }
+
+        /**
+         * Signals that no more batches will be added.
+         */
+        void close() {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+            notEmpty.notify_all();
+        }
+};
+
+/**
+ * Prints a help message describing how to invoke the program from the command line.
+ */
+void printHelp() {
+    std::string helpMessage("Usage: game-analytics [-h] [-t THREADS] [-p PLY] [-n TOP] [-e NODES] [-b BOOK] [-m MEMORY] -j JOURNAL\n"
+                            "\n"
+                            "Options:\n"
+                            " -h, --help             Show this help message and exit\n"
+                            " -t, --threads THREADS  The number of analysis threads (default: the number of cores)\n"
+                            " -p, --ply     PLY      The number of moves of an opening (default: 4)\n"
+                            " -n, --top     TOP      The number of openings and players reported (default: 10)\n"
+                            " -e, --evaluate NODES   Evaluate every move with the solver, exploring at most NODES\n"
+                            "                        nodes for each position (0: no budget)\n"
+                            " -b, --book    BOOK     The opening book used by the solver\n"
+                            " -m, --memory  MEMORY   The size of the shared transposition table, in MiB (default: 64)\n"
+                            " -j, --journal JOURNAL  The path of the journal file");
+    std::cout << helpMessage << std::endl;
+}
+
+/**
+ * Parses the arguments passed via command line. All the options except the journal are optional,
+ * but each given option must be followed by a value.
+ * @param argc     the number of arguments passed via command line.
+ * @param argv     the arguments passed via command line.
+ * @param options  a reference to the variable that will store the options.
+ * @return         true if the arguments are valid, false otherwise.
+ */
+bool parseArguments(int argc, char *argv[], Options &options) {
+    if (argc % 2 != 1) {
+        printHelp();
+        return false;
+    }
+
+    try {
+        for (auto i = 1; i < argc; i += 2) {
+            std::string arg(argv[i]);
+
+            if (arg == "-t" || arg == "--threads") {
+                options.threads = std::stoul(argv[i + 1]);
+            } else if (arg == "-p" || arg == "--ply") {
+                options.openingPly = std::stoul(argv[i + 1]);
+            } else if (arg == "-n" || arg == "--top") {
+                options.top = std::stoul(argv[i + 1]);
+            } else if (arg == "-e" || arg == "--evaluate") {
+                options.evaluate = true;
+                options.nodeLimit = std::stoull(argv[i + 1]);
+            } else if (arg == "-b" || arg == "--book") {
+                options.book = argv[i + 1];
+            } else if (arg == "-m" || arg == "--memory") {
+                options.memory = std::stoul(argv[i + 1])*1024*1024;
+            } else if (arg == "-j" || arg == "--journal") {
+                options.journal = argv[i + 1];
+            } else {
+                printHelp();
+                return false;
+            }
+        }
+    } catch (const std::exception &exception) {
+        printHelp();
+        return false;
+    }
+
+    if (options.journal.empty() || options.threads == 0) {
+        printHelp();
+        return false;
+    }
+
+    if (options.openingPly > MAX_OPENING_PLY) {
+        std::cerr << "The number of moves of an opening must be at most " << MAX_OPENING_PLY << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Replays a game on a board, checking that all the moves are valid
+ * and that they lead to the recorded result.
+ * @param game  the game.
+ * @return      true if the game is consistent, false otherwise.
+ */
+bool replayGame(const fourinarow::GameRecord &game) {
+    // The board belongs to the first player, so the moves in odd positions are made by the opponent.
+    fourinarow::FourInARow board(game.secondPlayer);
+
+    for (size_t i = 0; i < game.moves.size(); i++) {
+        if (!board.registerMove(game.moves[i], i % 2 == 1)) {
+            return false;
+        }
+    }
+
+    if (game.result == fourinarow::GameRecord::Result::INTERRUPTED) {
+        return !board.isMatchFinished();
+    }
+
+    if (!board.isMatchFinished()) {
+        return false;
+    }
+
+    switch (board.getResult()) {
+        case fourinarow::MatchResult::WIN:
+            return game.result == fourinarow::GameRecord::Result::FIRST_PLAYER_WINS;
+        case fourinarow::MatchResult::LOSS:
+            return game.result == fourinarow::GameRecord::Result::SECOND_PLAYER_WINS;
+        default:
+            return game.result == fourinarow::GameRecord::Result::DRAW;
+    }
+}
+
+/**
+ * Evaluates the moves of a consistent game with the solver. The position before each move is solved once:
+ * the score of a move is the opposite of the score of the next position, or the score of a win if the move
+ * ends the game. A move is optimal if its score equals the score of the position, and it is a blunder
+ * if it worsens the outcome of the game. The moves whose scores are not proven within the budget are skipped.
+ * @param game        the game.
+ * @param solver      the solver.
+ * @param players     the statistics of the first and the second player.
+ * @param statistics  the statistics of the games.
+ */
+void evaluateGame(const fourinarow::GameRecord &game,
+                  fourinarow::Solver &solver,
+                  const std::array<PlayerStatistics*, 2> &players,
+                  Statistics &statistics) {
+    const int spaces = fourinarow::Position::Geometry::SPACES;
+    std::array<fourinarow::Solver::Evaluation, fourinarow::Position::Geometry::SPACES + 1> evaluations{};
+    fourinarow::Position position;
+    auto moves = game.moves.size();
+    auto lastMoveWins = false;
+
+    for (size_t i = 0; ; i++) {
+        evaluations[i] = solver.solve(position);
+        if (i == moves) {
+            break;
+        }
+
+        // The game is consistent, so only its last move can be a winning one.
+        if (position.isWinningMove(game.moves[i])) {
+            lastMoveWins = true;
+            break;
+        }
+        position.playColumn(game.moves[i]);
+    }
+
+    auto sign = [](int score) { return (score > 0) - (score < 0); };
+
+    for (size_t i = 0; i < moves; i++) {
+        if (!evaluations[i].isExact()) {
+            continue;
+        }
+
+        int moveScore;
+        if (lastMoveWins && i + 1 == moves) {
+            moveScore = (spaces + 1 - static_cast<int>(i))/2;
+        } else if (evaluations[i + 1].isExact()) {
+            moveScore = -evaluations[i + 1].lowerBound;
+        } else {
+            continue;
+        }
+
+        auto &player = *players[i % 2];
+        auto optimal = moveScore == evaluations[i].lowerBound;
+        auto blunder = sign(moveScore) < sign(evaluations[i].lowerBound);
+
+        player.evaluatedMoves++;
+        player.optimalMoves += optimal;
+        player.blunders += blunder;
+        statistics.evaluatedMoves++;
+        statistics.optimalMoves += optimal;
+        statistics.blunders += blunder;
+    }
+}
+
+/**
+ * Analyzes a game, updating the statistics of the games, of the players and of the opening.
+ * The inconsistent games are only counted.
+ * @param game        the game.
+ * @param openingPly  the number of moves of an opening.
+ * @param solver      the solver evaluating the moves, or null if the moves are not evaluated.
+ * @param statistics  the statistics of the games.
+ */
+void analyzeGame(const fourinarow::GameRecord &game,
+                 unsigned int openingPly,
+                 fourinarow::Solver *solver,
+                 Statistics &statistics) {
+    if (!replayGame(game)) {
+        statistics.inconsistentGames++;
+        return;
+    }
+
+    auto result = static_cast<size_t>(game.result);
+    statistics.games++;
+    statistics.results[result]++;
+    statistics.moves[result] += game.moves.size();
+
+    std::array<PlayerStatistics*, 2> players{{&statistics.players[game.firstPlayer],
+                                              &statistics.players[game.secondPlayer]}};
+
+    for (size_t i = 0; i < players.size(); i++) {
+        auto &player = *players[i];
+        player.games++;
+        player.moves += (game.moves.size() + 1 - i)/2;
+
+        if (game.result == fourinarow::GameRecord::Result::DRAW) {
+            player.draws++;
+        } else if (game.result != fourinarow::GameRecord::Result::INTERRUPTED) {
+            // The result of a won game is the index of the winner.
+            (result == i ? player.wins : player.losses)++;
+        }
+    }
+
+    if (openingPly > 0 && game.moves.size() >= openingPly) {
+        uint64_t key = 0;
+        for (size_t i = 0; i < openingPly; i++) {
+            key = (key << 3) | game.moves[i];
+        }
+
+        auto &opening = statistics.openings[key];
+        opening.games++;
+        opening.results[result]++;
+    }
+
+    if (solver != nullptr) {
+        evaluateGame(game, *solver, players, statistics);
+    }
+}
+
+/**
+ * Analyzes the batches of games taken from the queue, until the queue is closed.
+ * If the moves are evaluated, the worker owns a solver, while the transposition table
+ * and the opening book are shared with the other workers.
+ * @param queue       the queue of batches.
+ * @param options     the options of the analysis.
+ * @param table       the shared transposition table.
+ * @param book        the opening book, possibly null.
+ * @param statistics  the statistics that will store the results of the worker.
+ */
+void analyzeGames(BatchQueue &queue,
+                  const Options &options,
+                  const std::shared_ptr<fourinarow::TranspositionTable> &table,
+                  const std::shared_ptr<const fourinarow::OpeningBook> &book,
+                  Statistics &statistics) {
+    std::unique_ptr<fourinarow::Solver> solver;
+    if (options.evaluate) {
+        solver.reset(new fourinarow::Solver(table));
+        solver->setNodeLimit(options.nodeLimit);
+        solver->setOpeningBook(book);
+    }
+
+    std::vector<fourinarow::GameRecord> batch;
+    while (queue.pop(batch)) {
+        for (const auto &game : batch) {
+            analyzeGame(game, options.openingPly, solver.get(), statistics);
+        }
+    }
+}
+
+/**
+ * Reads the games of the journal and hands them in batches to the workers.
+ * @param journal  the path of the journal file.
+ * @param queue    the queue of batches. It is closed when all the games have been read, or an error occurs.
+ * @throws SerializationException  if the journal cannot be read.
+ */
+void readGames(const std::string &journal, BatchQueue &queue) {
+    try {
+        fourinarow::GameJournalReader reader(journal);
+        auto batch = queue.acquire();
+        batch.resize(BATCH_SIZE);
+        size_t count = 0;
+
+        while (reader.next(batch[count])) {
+            if (++count == BATCH_SIZE) {
+                queue.push(std::move(batch));
+                batch = queue.acquire();
+                batch.resize(BATCH_SIZE);
+                count = 0;
+            }
+        }
+
+        if (count > 0) {
+            batch.resize(count);
+            queue.push(std::move(batch));
+        }
+    } catch (...) {
+        queue.close();
+        throw;
+    }
+
+    queue.close();
+}
+
+/**
+ * Returns a fraction as a percentage, or zero if the total is zero.
+ */
+double percentage(uint64_t part, uint64_t total) {
+    return total == 0 ? 0.0 : 100.0*part/total;
+}
+
+/**
+ * Returns the average of a quantity, or zero if the count is zero.
+ */
+double average(uint64_t sum, uint64_t count) {
+    return count == 0 ? 0.0 : static_cast<double>(sum)/count;
+}
+
+/**
+ * Prints the aggregate statistics of the games.
+ * @param statistics  the statistics of the games.
+ * @param options     the options of the analysis.
+ */
+void printReport(const Statistics &statistics, const Options &options) {
+    uint64_t moves = 0;
+    for (auto count : statistics.moves) {
+        moves += count;
+    }
+
+    const auto &results = statistics.results;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Games: " << statistics.games << ", inconsistent: " << statistics.inconsistentGames << '\n';
+    std::cout << "First player wins: " << results[0] << ", second player wins: " << results[1];
+    std::cout << ", draws: " << results[2] << ", interrupted: " << results[3] << '\n';
+    std::cout << "Average length: " << average(moves, statistics.games) << " moves (first player wins: ";
+    std::cout << average(statistics.moves[0], results[0]) << ", second player wins: " << average(statistics.moves[1], results[1]);
+    std::cout << ", draws: " << average(statistics.moves[2], results[2]) << ", interrupted: ";
+    std::cout << average(statistics.moves[3], results[3]) << ")\n";
+
+    if (options.evaluate) {
+        std::cout << "Evaluated moves: " << statistics.evaluatedMoves << " of " << moves;
+        std::cout << ", accuracy: " << percentage(statistics.optimalMoves, statistics.evaluatedMoves) << "%";
+        std::cout << ", blunder rate: " << percentage(statistics.blunders, statistics.evaluatedMoves) << "%\n";
+    }
+
+    if (options.openingPly > 0) {
+        std::vector<std::pair<uint64_t, OpeningStatistics>> openings(statistics.openings.begin(), statistics.openings.end());
+        auto count = std::min<size_t>(options.top, openings.size());
+        std::partial_sort(openings.begin(), openings.begin() + count, openings.end(),
+                          [](const std::pair<uint64_t, OpeningStatistics> &a, const std::pair<uint64_t, OpeningStatistics> &b) {
+                              return a.second.games > b.second.games || (a.second.games == b.second.games && a.first < b.first);
+                          });
+
+        std::cout << "\nMost common openings (" << options.openingPly << " moves): " << openings.size() << " distinct\n";
+        for (size_t i = 0; i < count; i++) {
+            std::string sequence;
+            for (auto j = options.openingPly; j > 0; j--) {
+                sequence += static_cast<char>('0' + ((openings[i].first >> (3*(j - 1))) & 7));
+            }
+
+            const auto &opening = openings[i].second;
+            std::cout << ' ' << sequence << "  games: " << opening.games;
+            std::cout << ", first player wins: " << percentage(opening.results[0], opening.games) << "%";
+            std::cout << ", second player wins: " << percentage(opening.results[1], opening.games) << "%";
+            std::cout << ", draws: " << percentage(opening.results[2], opening.games) << "%\n";
+        }
+    }
+
+    std::vector<std::pair<std::string, PlayerStatistics>> players(statistics.players.begin(), statistics.players.end());
+    auto count = std::min<size_t>(options.top, players.size());
+    std::partial_sort(players.begin(), players.begin() + count, players.end(),
+                      [](const std::pair<std::string, PlayerStatistics> &a, const std::pair<std::string, PlayerStatistics> &b) {
+                          return a.second.games > b.second.games || (a.second.games == b.second.games && a.first < b.first);
+                      });
+
+    std::cout << "\nMost active players: " << players.size() << " distinct\n";
+    for (size_t i = 0; i < count; i++) {
+        const auto &player = players[i].second;
+        std::cout << ' ' << (players[i].first.empty() ? "-" : players[i].first) << "  games: " << player.games;
+        std::cout << ", wins: " << player.wins << ", draws: " << player.draws << ", losses: " << player.losses;
+        std::cout << ", moves per game: " << average(player.moves, player.games);
+
+        if (options.evaluate) {
+            std::cout << ", accuracy: " << percentage(player.optimalMoves, player.evaluatedMoves) << "%";
+            std::cout << ", blunder rate: " << percentage(player.blunders, player.evaluatedMoves) << "%";
+        }
+        std::cout << '\n';
+    }
+}
+
+int main(int argc, char *argv[]) {
+    Options options{"", std::max(1u, std::thread::hardware_concurrency()), 4, 10, false, 0, "", 64*1024*1024};
+
+    if (!parseArguments(argc, argv, options)) {
+        return 1;
+    }
+
+    try {
+        std::shared_ptr<fourinarow::TranspositionTable> table;
+        std::shared_ptr<const fourinarow::OpeningBook> book;
+        if (options.evaluate) {
+            table = std::make_shared<fourinarow::TranspositionTable>(options.memory);
+            if (!options.book.empty()) {
+                book = std::make_shared<const fourinarow::OpeningBook>(options.book);
+            }
+        }
+
+        BatchQueue queue(BATCHES_PER_THREAD*options.threads);
+        std::vector<Statistics> statistics(options.threads, Statistics{});
+        std::vector<std::thread> workers;
+
+        auto start = std::chrono::steady_clock::now();
+        for (auto i = 0u; i < options.threads; i++) {
+            workers.emplace_back(analyzeGames, std::ref(queue), std::cref(options), std::cref(table), std::cref(book),
+                                 std::ref(statistics[i]));
+        }
+
+        std::exception_ptr failure;
+        try {
+            readGames(options.journal, queue);
+        } catch (...) {
+            failure = std::current_exception();
+        }
+
+        for (auto &worker : workers) {
+            worker.join();
+        }
+
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+
+        for (auto i = 1u; i < options.threads; i++) {
+            statistics[0].merge(statistics[i]);
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        printReport(statistics[0], options);
+        auto games = statistics[0].games + statistics[0].inconsistentGames;
+        std::cout << "\nAnalyzed in " << elapsed.count() << " s (";
+        std::cout << (elapsed.count() > 0 ? games/elapsed.count() : 0.0) << " games/s)" << std::endl;
+    } catch (const std::exception &exception) {
+        std::cerr << "Fatal error. " << exception.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <SerializationException.h>
+#include "JournalFormat.h"
+#include "GameJournal.h"
+
+namespace fourinarow {
+
+GameJournal::GameJournal(const std::string &path, size_t capacity, std::chrono::milliseconds syncPeriod)
+    : descriptor(-1), mapping(nullptr), capacity(capacity), end(0), droppedGames(0),
+      syncPeriod(syncPeriod), stopping(false) {
+    static_assert(COLUMNS <= (1u << JournalFormat::BITS_PER_MOVE), "The columns must fit into the bits of a move");
+    static_assert(ROWS*COLUMNS <= JournalFormat::MAX_MOVES, "The moves of a game must fit into a record");
+
+    openFile(path);
+
+    try {
+        syncThread = std::thread(&GameJournal::syncLoop, this);
+    } catch (const std::exception &exception) {
+        munmap(mapping, this->capacity);
+        ::close(descriptor);
+        throw SerializationException("Impossible to start the journal flushes: " + std::string(exception.what()));
+    }
+}
+
+GameJournal::~GameJournal() {
+    closeFile();
+}
+
+void GameJournal::openFile(const std::string &path) {
+    descriptor = ::open(path.data(), O_RDWR | O_CREAT, 0644);
+
+    if (descriptor == -1) {
+        throw SerializationException("Impossible to open the journal file: " + std::string(strerror(errno)));
+    }
+
+    struct stat fileStatus{};
+    if (fstat(descriptor, &fileStatus) == -1) {
+        ::close(descriptor);
+        throw SerializationException("Impossible to read the size of the journal file");
+    }
+
+    auto created = fileStatus.st_size == 0;
+    if (created) {
+        if (capacity < sizeof(JournalFormat::Header) + JournalFormat::MAX_RECORD_SIZE
+            || ftruncate(descriptor, capacity) == -1) {
+            ::close(descriptor);
+            throw SerializationException("Impossible to allocate the journal file");
+        }
+    } else {
+        capacity = fileStatus.st_size;
+    }
+
+    auto address = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    if (address == MAP_FAILED) {
+        ::close(descriptor);
+        throw SerializationException("Impossible to map the journal file: " + std::string(strerror(errno)));
+    }
+    mapping = static_cast<unsigned char*>(address);
+
+    if (created) {
+        JournalFormat::Header header{};
+        memcpy(header.magic, JournalFormat::MAGIC, sizeof(JournalFormat::MAGIC));
+        header.version = JournalFormat::VERSION;
+        header.rows = ROWS;
+        header.columns = COLUMNS;
+        header.bitsPerMove = JournalFormat::BITS_PER_MOVE;
+        header.capacity = capacity;
+        memcpy(mapping, &header, sizeof(header));
+        end = sizeof(header);
+        return;
+    }
+
+    JournalFormat::Header header{};
+    if (capacity >= sizeof(header)) {
+        memcpy(&header, mapping, sizeof(header));
+    }
+
+    if (capacity < sizeof(header) || memcmp(header.magic, JournalFormat::MAGIC, sizeof(JournalFormat::MAGIC)) != 0
+        || header.version != JournalFormat::VERSION || header.capacity != capacity
+        || header.rows != ROWS || header.columns != COLUMNS || header.bitsPerMove != JournalFormat::BITS_PER_MOVE) {
+        munmap(mapping, capacity);
+        ::close(descriptor);
+        throw SerializationException("Malformed journal: unknown format or different board geometry");
+    }
+
+    // A record interrupted by a crash is overwritten, so its leftovers must not look like a complete record.
+    end = findEnd();
+    memset(mapping + end, 0, std::min<size_t>(capacity - end, JournalFormat::MAX_RECORD_SIZE));
+}
+
+uint64_t GameJournal::findEnd() const {
+    uint64_t offset = sizeof(JournalFormat::Header);
+
+    while (offset + sizeof(JournalFormat::RecordHeader) <= capacity) {
+        JournalFormat::RecordHeader record{};
+        memcpy(&record, mapping + offset, sizeof(record));
+
+        if (record.commit != JournalFormat::RECORD_COMMIT || record.size < sizeof(record)
+            || offset + record.size > capacity) {
+            break;
+        }
+        offset += record.size;
+    }
+
+    return offset;
+}
+
+void GameJournal::sync(uint64_t &synced) {
+    const uint64_t pageSize = sysconf(_SC_PAGESIZE);
+    auto current = std::min<uint64_t>(end.load(std::memory_order_acquire), capacity);
+
+    if (current <= synced) {
+        return;
+    }
+
+    // The records reserved before the last flush may have been completed after it.
+    auto start = synced > JournalFormat::MAX_RECORD_SIZE ? synced - JournalFormat::MAX_RECORD_SIZE : 0;
+    start -= start % pageSize;
+
+    msync(mapping + start, current - start, MS_SYNC);
+    synced = current;
+}
+
+void GameJournal::syncLoop() {
+    uint64_t synced = 0;
+    std::unique_lock<std::mutex> lock(syncMutex);
+
+    while (!stopping) {
+        syncCondition.wait_for(lock, syncPeriod, [this] { return stopping; });
+        lock.unlock();
+        sync(synced);
+        lock.lock();
+    }
+}
+
+void GameJournal::closeFile() {
+    {
+        std::lock_guard<std::mutex> lock(syncMutex);
+        stopping = true;
+    }
+    syncCondition.notify_one();
+    syncThread.join();
+
+    msync(mapping, std::min<uint64_t>(end.load(), capacity), MS_SYNC);
+    munmap(mapping, capacity);
+    ::close(descriptor);
+}
+
+size_t GameJournal::getCapacity() const {
+    return capacity;
+}
+
+size_t GameJournal::getSize() const {
+    return std::min<uint64_t>(end.load(std::memory_order_relaxed), capacity);
+}
+
+uint64_t GameJournal::getDroppedGames() const {
+    return droppedGames.load(std::memory_order_relaxed);
+}
+
+bool GameJournal::append(const GameRecord &game) {
+    if (game.moves.size() > ROWS*COLUMNS || game.firstPlayer.size() > UINT8_MAX || game.secondPlayer.size() > UINT8_MAX) {
+        throw SerializationException("The game cannot be stored in a journal record");
+    }
+
+    for (auto move : game.moves) {
+        if (move >= COLUMNS) {
+            throw SerializationException("The game has an invalid move");
+        }
+    }
+
+    auto size = JournalFormat::computeRecordSize(game.firstPlayer.size(), game.secondPlayer.size());
+    auto offset = end.fetch_add(size, std::memory_order_relaxed);
+
+    if (offset + size > capacity) {
+        droppedGames.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    JournalFormat::RecordHeader record{};
+    record.commit = 0;
+    record.size = size;
+    record.result = static_cast<uint8_t>(game.result);
+    record.moveCount = game.moves.size();
+    record.startTime = game.startTime;
+    record.endTime = game.endTime;
+    JournalFormat::packMoves(game.moves, record.moves);
+    record.firstPlayerLength = game.firstPlayer.size();
+    record.secondPlayerLength = game.secondPlayer.size();
+
+    auto destination = mapping + offset;
+    memcpy(destination + sizeof(record.commit), reinterpret_cast<const unsigned char*>(&record) + sizeof(record.commit),
+           sizeof(record) - sizeof(record.commit));
+    memcpy(destination + sizeof(record), game.firstPlayer.data(), game.firstPlayer.size());
+    memcpy(destination + sizeof(record) + game.firstPlayer.size(), game.secondPlayer.data(), game.secondPlayer.size());
+
+    // Publish the record: the readers see its content once they see the commit word.
+    __atomic_store_n(reinterpret_cast<uint32_t*>(destination), JournalFormat::RECORD_COMMIT, __ATOMIC_RELEASE);
+    return true;
+}
+
+}
@@ -0,0 +1,112 @@
+#ifndef INC_4INAROW_GAMEJOURNAL_H
+#define INC_4INAROW_GAMEJOURNAL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "GameRecord.h"
+
+namespace fourinarow {
+
+/**
+ * Class used to append finished games to a journal file, whose format is described by <code>JournalFormat</code>.
+ * The file is preallocated to a fixed capacity and memory-mapped: an append reserves the space
+ * of its record by atomically advancing the end of the journal, copies the record into the mapping
+ * and publishes it by writing its first word, so that concurrent appends never take a lock
+ * and never wait for the disk. A background thread periodically flushes the written part
+ * of the mapping to the disk. When the journal is full, the games are dropped and counted.
+ * If the file already exists, the new games are appended after the last complete record.
+ */
+class GameJournal {
+    private:
+        int descriptor;
+        unsigned char *mapping;
+        size_t capacity;
+        std::atomic<uint64_t> end;          // The offset at which the next record will be written.
+        std::atomic<uint64_t> droppedGames;
+        std::chrono::milliseconds syncPeriod;
+        std::mutex syncMutex;
+        std::condition_variable syncCondition;
+        bool stopping;
+        std::thread syncThread;
+
+        /**
+         * Opens the journal file, creating it if needed, and maps it into memory.
+         * @param path  the path of the journal file.
+         * @throws SerializationException  if the file cannot be opened or mapped, or it is not a valid journal.
+         */
+        void openFile(const std::string &path);
+
+        /**
+         * Finds the end of the journal, i.e. the offset following the last complete record.
+         * @return  the end of the journal.
+         */
+        uint64_t findEnd() const;
+
+        /**
+         * Flushes to the disk the part of the mapping written after the given offset.
+         * @param synced  the offset up to which the journal has already been flushed.
+         *                It is updated to the new end of the flushed part.
+         */
+        void sync(uint64_t &synced);
+
+        /**
+         * Body of the background thread: flushes the journal every <code>syncPeriod</code>,
+         * until the journal is closed.
+         */
+        void syncLoop();
+
+        /**
+         * Stops the background thread and releases the mapping and the file.
+         */
+        void closeFile();
+    public:
+        /**
+         * Opens a journal, creating it if it does not exist, and starts the background flushes.
+         * @param path        the path of the journal file.
+         * @param capacity    the size of the file, in bytes, used only if the file is created.
+         * @param syncPeriod  the time between two flushes to the disk.
+         * @throws SerializationException  if the file cannot be opened or mapped, or it is not a valid journal.
+         */
+        GameJournal(const std::string &path, size_t capacity, std::chrono::milliseconds syncPeriod);
+
+        /**
+         * Flushes the journal to the disk and closes it.
+         */
+        ~GameJournal();
+
+        GameJournal(const GameJournal&) = delete;
+        GameJournal& operator=(const GameJournal&) = delete;
+        GameJournal(GameJournal&&) = delete;
+        GameJournal& operator=(GameJournal&&) = delete;
+
+        size_t getCapacity() const;
+
+        /**
+         * Returns the space occupied by the header and the records appended so far.
+         * @return  the size of the journal, in bytes.
+         */
+        size_t getSize() const;
+
+        /**
+         * Returns the number of games that have not been appended because the journal was full.
+         */
+        uint64_t getDroppedGames() const;
+
+        /**
+         * Appends a game to the journal. It can be called concurrently by several threads,
+         * and never blocks.
+         * @param game  the game. Its moves must be valid column indexes of the classic game.
+         * @return      true if the game has been appended, false if the journal is full.
+         * @throws SerializationException  if the game has too many moves or invalid columns.
+         */
+        bool append(const GameRecord &game);
+};
+
+}
+
+#endif //INC_4INAROW_GAMEJOURNAL_H
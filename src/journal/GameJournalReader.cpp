@@ -0,0 +1,88 @@
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <SerializationException.h>
+#include "JournalFormat.h"
+#include "GameJournalReader.h"
+
+namespace fourinarow {
+
+GameJournalReader::GameJournalReader(const std::string &path)
+    : mapping(nullptr), capacity(0), offset(sizeof(JournalFormat::Header)) {
+    auto descriptor = open(path.data(), O_RDONLY);
+
+    if (descriptor == -1) {
+        throw SerializationException("Impossible to open the journal file: " + std::string(strerror(errno)));
+    }
+
+    struct stat fileStatus{};
+    if (fstat(descriptor, &fileStatus) == -1 || static_cast<size_t>(fileStatus.st_size) < sizeof(JournalFormat::Header)) {
+        close(descriptor);
+        throw SerializationException("Malformed journal: missing header");
+    }
+
+    capacity = fileStatus.st_size;
+    auto address = mmap(nullptr, capacity, PROT_READ, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+
+    if (address == MAP_FAILED) {
+        throw SerializationException("Impossible to map the journal file: " + std::string(strerror(errno)));
+    }
+    mapping = static_cast<const unsigned char*>(address);
+
+    // The records are read in order, so the pages can be read ahead.
+    madvise(address, capacity, MADV_SEQUENTIAL);
+
+    JournalFormat::Header header{};
+    memcpy(&header, mapping, sizeof(header));
+
+    if (memcmp(header.magic, JournalFormat::MAGIC, sizeof(JournalFormat::MAGIC)) != 0
+        || header.version != JournalFormat::VERSION || header.capacity != capacity
+        || header.bitsPerMove != JournalFormat::BITS_PER_MOVE) {
+        munmap(address, capacity);
+        throw SerializationException("Malformed journal: unknown format");
+    }
+}
+
+GameJournalReader::~GameJournalReader() {
+    munmap(const_cast<unsigned char*>(mapping), capacity);
+}
+
+bool GameJournalReader::next(GameRecord &game) {
+    if (offset + sizeof(JournalFormat::RecordHeader) > capacity) {
+        return false;
+    }
+
+    auto source = mapping + offset;
+    if (__atomic_load_n(reinterpret_cast<const uint32_t*>(source), __ATOMIC_ACQUIRE) != JournalFormat::RECORD_COMMIT) {
+        return false;
+    }
+
+    JournalFormat::RecordHeader record{};
+    memcpy(&record, source, sizeof(record));
+
+    if (record.size != JournalFormat::computeRecordSize(record.firstPlayerLength, record.secondPlayerLength)
+        || offset + record.size > capacity || record.moveCount > JournalFormat::MAX_MOVES
+        || record.result > static_cast<uint8_t>(GameRecord::Result::INTERRUPTED)) {
+        throw SerializationException("Malformed journal: invalid record");
+    }
+
+    auto usernames = reinterpret_cast<const char*>(source + sizeof(record));
+    game.firstPlayer.assign(usernames, record.firstPlayerLength);
+    game.secondPlayer.assign(usernames + record.firstPlayerLength, record.secondPlayerLength);
+    game.startTime = record.startTime;
+    game.endTime = record.endTime;
+    game.result = static_cast<GameRecord::Result>(record.result);
+    JournalFormat::unpackMoves(record.moves, record.moveCount, game.moves);
+
+    offset += record.size;
+    return true;
+}
+
+void GameJournalReader::rewind() {
+    offset = sizeof(JournalFormat::Header);
+}
+
+}
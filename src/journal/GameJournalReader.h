@@ -0,0 +1,54 @@
+#ifndef INC_4INAROW_GAMEJOURNALREADER_H
+#define INC_4INAROW_GAMEJOURNALREADER_H
+
+#include <cstddef>
+#include <string>
+#include "GameRecord.h"
+
+namespace fourinarow {
+
+/**
+ * Class used to read the games stored in a journal file, in order of append.
+ * The file is memory-mapped read-only and scanned sequentially, without copying it:
+ * the only work done for each game is the decoding of its record. The journal can be read
+ * while another process is appending to it: the reader returns the complete records only,
+ * and can be polled again to get the games appended later.
+ */
+class GameJournalReader {
+    private:
+        const unsigned char *mapping;
+        size_t capacity;
+        size_t offset;  // The offset of the next record to read.
+    public:
+        /**
+         * Opens a journal file.
+         * @param path  the path of the journal file.
+         * @throws SerializationException  if the file cannot be opened or mapped, or it is not a valid journal.
+         */
+        explicit GameJournalReader(const std::string &path);
+
+        ~GameJournalReader();
+
+        GameJournalReader(const GameJournalReader&) = delete;
+        GameJournalReader& operator=(const GameJournalReader&) = delete;
+        GameJournalReader(GameJournalReader&&) = delete;
+        GameJournalReader& operator=(GameJournalReader&&) = delete;
+
+        /**
+         * Reads the next game. The game object can be reused across calls,
+         * to avoid allocating memory for each game.
+         * @param game  the object that will store the game.
+         * @return      true if a game has been read, false if there are no more complete records.
+         * @throws SerializationException  if the record is malformed.
+         */
+        bool next(GameRecord &game);
+
+        /**
+         * Moves the reader back to the first game of the journal.
+         */
+        void rewind();
+};
+
+}
+
+#endif //INC_4INAROW_GAMEJOURNALREADER_H
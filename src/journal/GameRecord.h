@@ -0,0 +1,32 @@
+#ifndef INC_4INAROW_GAMERECORD_H
+#define INC_4INAROW_GAMERECORD_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace fourinarow {
+
+/**
+ * Record of a finished game, as stored in a game journal.
+ * The first player is the one who made the first move.
+ */
+struct GameRecord {
+    enum class Result : uint8_t {
+            FIRST_PLAYER_WINS  = 0,
+            SECOND_PLAYER_WINS = 1,
+            DRAW               = 2,
+            INTERRUPTED        = 3  // The game has been abandoned, or a player made an invalid move.
+    };
+
+    std::string firstPlayer;
+    std::string secondPlayer;
+    uint64_t startTime;          // In milliseconds since the epoch.
+    uint64_t endTime;            // In milliseconds since the epoch.
+    Result result;
+    std::vector<uint8_t> moves;  // The columns of the moves, in the order they were played.
+};
+
+}
+
+#endif //INC_4INAROW_GAMERECORD_H
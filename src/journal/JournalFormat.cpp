@@ -0,0 +1,37 @@
+#include "JournalFormat.h"
+
+namespace fourinarow {
+
+const char JournalFormat::MAGIC[8] = {'4', 'I', 'N', 'A', 'R', 'O', 'W', 'J'};
+const uint32_t JournalFormat::VERSION;
+const uint32_t JournalFormat::RECORD_COMMIT;
+const unsigned int JournalFormat::BITS_PER_MOVE;
+const unsigned int JournalFormat::MAX_MOVES;
+const size_t JournalFormat::MAX_RECORD_SIZE;
+
+size_t JournalFormat::computeRecordSize(size_t firstPlayerLength, size_t secondPlayerLength) {
+    auto size = sizeof(RecordHeader) + firstPlayerLength + secondPlayerLength;
+    return (size + 7) & ~size_t(7);
+}
+
+void JournalFormat::packMoves(const std::vector<uint8_t> &moves, uint64_t packed[2]) {
+    const auto movesPerWord = 64/BITS_PER_MOVE;
+    packed[0] = 0;
+    packed[1] = 0;
+
+    for (size_t i = 0; i < moves.size(); i++) {
+        packed[i/movesPerWord] |= static_cast<uint64_t>(moves[i]) << (BITS_PER_MOVE*(i % movesPerWord));
+    }
+}
+
+void JournalFormat::unpackMoves(const uint64_t packed[2], unsigned int moveCount, std::vector<uint8_t> &moves) {
+    const auto movesPerWord = 64/BITS_PER_MOVE;
+    const auto moveMask = (1u << BITS_PER_MOVE) - 1;
+    moves.resize(moveCount);
+
+    for (unsigned int i = 0; i < moveCount; i++) {
+        moves[i] = (packed[i/movesPerWord] >> (BITS_PER_MOVE*(i % movesPerWord))) & moveMask;
+    }
+}
+
+}
@@ -0,0 +1,88 @@
+#ifndef INC_4INAROW_JOURNALFORMAT_H
+#define INC_4INAROW_JOURNALFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <Constants.h>
+#include "GameRecord.h"
+
+namespace fourinarow {
+
+/**
+ * Class describing the binary format of a game journal, shared by the writer and the reader.
+ * A journal is a file of fixed capacity made of a header followed by the records of the games,
+ * in order of append. Each record is made of a fixed header, holding the timestamps, the result,
+ * the lengths of the usernames and the moves packed at <code>BITS_PER_MOVE</code> bits per column index,
+ * followed by the two usernames; every record is padded to a multiple of 8 bytes.
+ * The first word of a record is written last, so that a record is visible to the readers
+ * only after it has been written completely: the journal ends at the first record whose
+ * first word is zero. The file uses the byte order of the machine that wrote it.
+ */
+class JournalFormat {
+    public:
+        struct Header {
+            char magic[8];
+            uint32_t version;
+            uint8_t rows;
+            uint8_t columns;
+            uint8_t bitsPerMove;
+            uint8_t reserved;
+            uint64_t capacity;  // The size of the file, in bytes.
+            uint8_t padding[40];
+        };
+
+        struct RecordHeader {
+            uint32_t commit;     // <code>RECORD_COMMIT</code> if the record has been written completely.
+            uint16_t size;       // The size of the record, in bytes, including the usernames and the padding.
+            uint8_t result;
+            uint8_t moveCount;
+            uint64_t startTime;
+            uint64_t endTime;
+            uint64_t moves[2];
+            uint8_t firstPlayerLength;
+            uint8_t secondPlayerLength;
+            uint8_t padding[6];
+        };
+
+        static const char MAGIC[8];
+        static const uint32_t VERSION = 1;
+        static const uint32_t RECORD_COMMIT = 0x4D414752;  // "RGAM" in little endian.
+        static const unsigned int BITS_PER_MOVE = 3;
+        static const unsigned int MAX_MOVES = 2*64/BITS_PER_MOVE;
+        static const size_t MAX_RECORD_SIZE = sizeof(RecordHeader) + 2*UINT8_MAX + 8;
+
+        JournalFormat() = delete;
+        ~JournalFormat() = delete;
+        JournalFormat(const JournalFormat&) = delete;
+        JournalFormat(JournalFormat&&) = delete;
+        JournalFormat& operator=(const JournalFormat&) = delete;
+        JournalFormat& operator=(JournalFormat&&) = delete;
+
+        /**
+         * Returns the size of the record of a game, including the padding.
+         * @param firstPlayerLength   the length of the username of the first player.
+         * @param secondPlayerLength  the length of the username of the second player.
+         * @return                    the size of the record, in bytes.
+         */
+        static size_t computeRecordSize(size_t firstPlayerLength, size_t secondPlayerLength);
+
+        /**
+         * Packs the moves of a game into two words, at <code>BITS_PER_MOVE</code> bits per move.
+         * @param moves  the moves. There must be at most <code>MAX_MOVES</code> moves,
+         *               each one lower than <code>2^BITS_PER_MOVE</code>.
+         * @param packed the array that will store the packed moves.
+         */
+        static void packMoves(const std::vector<uint8_t> &moves, uint64_t packed[2]);
+
+        /**
+         * Unpacks the moves of a game.
+         * @param packed     the packed moves.
+         * @param moveCount  the number of moves.
+         * @param moves      the vector that will store the moves. Its previous content is discarded.
+         */
+        static void unpackMoves(const uint64_t packed[2], unsigned int moveCount, std::vector<uint8_t> &moves);
+};
+
+}
+
+#endif //INC_4INAROW_JOURNALFORMAT_H
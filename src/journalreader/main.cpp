@@ -0,0 +1,129 @@
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <GameJournalReader.h>
+#include <GameRecord.h>
+
+/**
+ * Prints a help message describing how to invoke the program from the command line.
+ */
+void printHelp() {
+    std::string helpMessage("Usage: journal-reader [-h] [-m MODE] -j JOURNAL\n"
+                            "\n"
+                            "Options:\n"
+                            " -h, --help             Show this help message and exit\n"
+                            " -m, --mode    MODE     'summary' to print only the statistics of the journal,\n"
+                            "                        'games' to print also every game (default: summary)\n"
+                            " -j, --journal JOURNAL  The path of the journal file");
+    std::cout << helpMessage << std::endl;
+}
+
+/**
+ * Parses the arguments passed via command line. The mode is optional,
+ * but each given option must be followed by a value.
+ * @param argc        the number of arguments passed via command line.
+ * @param argv        the arguments passed via command line.
+ * @param printGames  a reference to the variable that will store true if every game must be printed.
+ * @param journal     a reference to the variable that will store the path of the journal file.
+ * @return            true if the arguments are valid, false otherwise.
+ */
+bool parseArguments(int argc, char *argv[], bool &printGames, std::string &journal) {
+    if (argc % 2 != 1) {
+        printHelp();
+        return false;
+    }
+
+    for (auto i = 1; i < argc; i += 2) {
+        std::string arg(argv[i]);
+        std::string value(argv[i + 1]);
+
+        if ((arg == "-m" || arg == "--mode") && (value == "summary" || value == "games")) {
+            printGames = value == "games";
+        } else if (arg == "-j" || arg == "--journal") {
+            journal = value;
+        } else {
+            printHelp();
+            return false;
+        }
+    }
+
+    if (journal.empty()) {
+        printHelp();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Converts the result of a game into a human readable string.
+ * @param result  the result of the game.
+ * @return        the string describing the result.
+ */
+std::string convertResult(fourinarow::GameRecord::Result result) {
+    switch (result) {
+        case fourinarow::GameRecord::Result::FIRST_PLAYER_WINS:
+            return "FIRST_PLAYER_WINS";
+        case fourinarow::GameRecord::Result::SECOND_PLAYER_WINS:
+            return "SECOND_PLAYER_WINS";
+        case fourinarow::GameRecord::Result::DRAW:
+            return "DRAW";
+        default:
+            return "INTERRUPTED";
+    }
+}
+
+/**
+ * Prints a game on a single line, as: start time, end time, first player, second player,
+ * result and the sequence of the columns played.
+ * @param game  the game.
+ */
+void printGame(const fourinarow::GameRecord &game) {
+    std::string moves;
+    for (auto move : game.moves) {
+        moves += static_cast<char>('0' + move);
+    }
+
+    std::cout << game.startTime << ' ' << game.endTime << ' ' << game.firstPlayer << ' ' << game.secondPlayer << ' ';
+    std::cout << convertResult(game.result) << ' ' << (moves.empty() ? "-" : moves) << '\n';
+}
+
+int main(int argc, char *argv[]) {
+    try {
+        auto printGames = false;
+        std::string journal;
+
+        if (!parseArguments(argc, argv, printGames, journal)) {
+            return 1;
+        }
+
+        fourinarow::GameJournalReader reader(journal);
+        fourinarow::GameRecord game{};
+        std::array<uint64_t, 4> results{};
+        uint64_t games = 0;
+        uint64_t moves = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        while (reader.next(game)) {
+            games++;
+            moves += game.moves.size();
+            results[static_cast<size_t>(game.result)]++;
+
+            if (printGames) {
+                printGame(game);
+            }
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout << "Games: " << games << '\n';
+        std::cout << "First player wins: " << results[0] << ", second player wins: " << results[1];
+        std::cout << ", draws: " << results[2] << ", interrupted: " << results[3] << '\n';
+        std::cout << "Average length: " << (games == 0 ? 0.0 : static_cast<double>(moves)/games) << " moves\n";
+        std::cout << "Read in " << elapsed.count() << " s (";
+        std::cout << (elapsed.count() > 0 ? games/elapsed.count() : 0.0) << " games/s)" << std::endl;
+    } catch (const std::exception &exception) {
+        std::cerr << "Fatal error. " << exception.what() << std::endl;
+        return 1;
+    }
+}
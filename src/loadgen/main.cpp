@@ -0,0 +1,725 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <sys/resource.h>
+#include <Constants.h>
+#include <Utils.h>
+#include <CertificateStore.h>
+#include <DigitalSignature.h>
+#include <ClientSession.h>
+#include <SessionListener.h>
+#include <SessionLoop.h>
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Protocol steps whose latency is measured. Each step starts when the client sends its request
+ * and ends when the response that completes it is received.
+ */
+enum class Step : unsigned int {
+        HANDSHAKE,    // From the connection to the first PLAYER_LIST.
+        RESUMPTION,   // From the connection to the first PLAYER_LIST, resuming the previous session.
+        PLAYER_LIST,  // From REQ_PLAYER_LIST to PLAYER_LIST.
+        CHALLENGE,    // From CHALLENGE to the response of the challenged player.
+        MATCHMAKING,  // From the acceptance of a challenge to the PLAYER or RELAYED_PLAYER message.
+        END_GAME,     // From END_GAME to the PLAYER_LIST confirming that the client is available again.
+        GOODBYE,      // From GOODBYE to the closure of the connection by the server.
+        COUNT
+};
+
+const std::array<const char*, static_cast<size_t>(Step::COUNT)> STEP_NAMES = {
+        "handshake", "resumption", "player_list", "challenge", "matchmaking", "end_game", "goodbye"
+};
+
+/**
+ * Actions chosen by an available client, according to the weights of the scenario mix.
+ */
+enum class Action : unsigned int {
+        LIST,       // Poll the player list.
+        CHALLENGE,  // Challenge a player of the last list, and report END_GAME if the challenge is accepted.
+        RECONNECT,  // Leave the server and perform a new handshake, resuming the session if enabled.
+        COUNT
+};
+
+const std::array<const char*, static_cast<size_t>(Action::COUNT)> ACTION_NAMES = {"list", "challenge", "reconnect"};
+
+struct Options {
+    std::string mode;           // Either "run" or "provision".
+    std::string serverAddress;
+    std::string key;            // The private key signing for every client, or the public key to provision.
+    std::string playersFolder;  // The folder of the public keys of the server, written when provisioning.
+    std::string prefix;         // The usernames of the clients are the prefix followed by an index.
+    unsigned int clients;
+    unsigned int threads;
+    unsigned int duration;      // In seconds.
+    std::array<unsigned int, static_cast<size_t>(Action::COUNT)> mix;
+    unsigned int acceptance;    // The percentage of incoming challenges accepted.
+    unsigned long seed;
+    bool resume;                // True if the clients ask a session ticket before reconnecting.
+};
+
+/**
+ * Statistics of a load test. Each worker fills its own statistics, merged at the end.
+ */
+struct Statistics {
+    std::array<std::vector<uint32_t>, static_cast<size_t>(Step::COUNT)> latencies;  // In microseconds.
+    uint64_t challengesAccepted;
+    uint64_t challengesRefused;
+    uint64_t playersNotAvailable;
+    uint64_t preemptedRequests;   // The requests ignored by the server because a CHALLENGE arrived first.
+    uint64_t timeouts;
+    uint64_t errors;
+    uint64_t failedConnections;
+
+    void merge(Statistics &other) {
+        for (size_t i = 0; i < latencies.size(); i++) {
+            latencies[i].insert(latencies[i].end(), other.latencies[i].begin(), other.latencies[i].end());
+            other.latencies[i].clear();
+            other.latencies[i].shrink_to_fit();
+        }
+
+        challengesAccepted += other.challengesAccepted;
+        challengesRefused += other.challengesRefused;
+        playersNotAvailable += other.playersNotAvailable;
+        preemptedRequests += other.preemptedRequests;
+        timeouts += other.timeouts;
+        errors += other.errors;
+        failedConnections += other.failedConnections;
+    }
+};
+
+/**
+ * Simulated client, driven by a worker through its session. At most one request is pending at a time.
+ */
+struct Client {
+    enum class State {
+            DISCONNECTED,
+            HANDSHAKE,           // Connected, either with a full handshake or resuming the previous session.
+            PLAYER_LIST,         // REQ_PLAYER_LIST sent.
+            CHALLENGE_RESPONSE,  // CHALLENGE sent.
+            PLAYER,              // Challenge accepted, either sent or received.
+            END_GAME,            // END_GAME and REQ_PLAYER_LIST sent.
+            SESSION_TICKET,      // REQ_TICKET sent, before leaving.
+            GOODBYE,             // GOODBYE sent.
+            STOPPED
+    };
+
+    std::unique_ptr<fourinarow::ClientSession> session;
+    State state;
+    bool resuming;
+    Clock::time_point stepStart;
+    std::vector<std::string> availablePlayers;  // The players of the last list received.
+};
+
+/**
+ * Drives a subset of the simulated clients over a single session loop, receiving the events of their sessions.
+ * The clients are closed-loop: as soon as a step completes, the client starts the next one.
+ */
+class Worker : public fourinarow::SessionListener {
+    private:
+        const Options &options;
+        fourinarow::CertificateStore certificateStore;
+        fourinarow::SessionLoop loop;
+        std::vector<Client> clients;
+        std::unordered_map<const fourinarow::ClientSession*, size_t> clientsBySession;
+        std::deque<size_t> connectionQueue;
+        size_t pendingHandshakes;
+        size_t maxPendingHandshakes;  // Keeps the connections within the backlog of the server.
+        size_t activeClients;
+        std::mt19937_64 generator;
+        Clock::time_point deadline;
+        bool stopping;
+        Statistics &statistics;
+
+        void record(Step step, const Client &client) {
+            auto now = Clock::now();
+            if (now > deadline) {
+                return;
+            }
+
+            auto latency = std::chrono::duration_cast<std::chrono::microseconds>(now - client.stepStart).count();
+            statistics.latencies[static_cast<size_t>(step)].push_back(static_cast<uint32_t>(latency));
+        }
+
+        void startStep(Client &client, Client::State state) {
+            client.state = state;
+            client.stepStart = Clock::now();
+        }
+
+        Client& getClient(const fourinarow::ClientSession &session) {
+            return clients[clientsBySession.at(&session)];
+        }
+
+        /**
+         * Closes the session of a client, if still open, queueing a new connection unless the test is stopping.
+         * The connections are started by the run loop, outside the events of the sessions.
+         */
+        void disconnect(Client &client) {
+            if (client.state == Client::State::HANDSHAKE) {
+                pendingHandshakes--;
+            }
+
+            client.session->close();
+
+            if (stopping) {
+                client.state = Client::State::STOPPED;
+                activeClients--;
+            } else {
+                client.state = Client::State::DISCONNECTED;
+                connectionQueue.push_back(clientsBySession.at(client.session.get()));
+            }
+        }
+
+        void connect(size_t index) {
+            auto &client = clients[index];
+            client.resuming = client.session->hasSessionTicket();
+            startStep(client, Client::State::HANDSHAKE);
+
+            try {
+                client.session->connect(options.serverAddress);
+            } catch (const std::exception &exception) {
+                statistics.failedConnections++;
+                client.state = Client::State::STOPPED;
+                activeClients--;
+                return;
+            }
+
+            loop.add(*client.session);
+            pendingHandshakes++;
+        }
+
+        void startConnections() {
+            if (stopping) {
+                connectionQueue.clear();
+                return;
+            }
+
+            while (!connectionQueue.empty() && pendingHandshakes < maxPendingHandshakes) {
+                auto index = connectionQueue.front();
+                connectionQueue.pop_front();
+                connect(index);
+            }
+        }
+
+        Action chooseAction() {
+            unsigned int total = 0;
+            for (auto weight : options.mix) {
+                total += weight;
+            }
+
+            auto value = std::uniform_int_distribution<unsigned int>(0, total - 1)(generator);
+            for (size_t i = 0; i < options.mix.size(); i++) {
+                if (value < options.mix[i]) {
+                    return static_cast<Action>(i);
+                }
+                value -= options.mix[i];
+            }
+
+            return Action::LIST;
+        }
+
+        /**
+         * Starts the next step of an available client, or makes it leave if the test is stopping.
+         */
+        void startNextAction(Client &client) {
+            auto &session = *client.session;
+            if (session.getState() != fourinarow::ClientSession::State::AVAILABLE) {
+                return;
+            }
+
+            if (stopping) {
+                disconnect(client);
+                return;
+            }
+
+            auto action = chooseAction();
+            if (action == Action::CHALLENGE && client.availablePlayers.empty()) {
+                action = Action::LIST;
+            }
+
+            if (action == Action::LIST) {
+                startStep(client, Client::State::PLAYER_LIST);
+                session.requestPlayerList();
+            } else if (action == Action::CHALLENGE) {
+                auto target = std::uniform_int_distribution<size_t>(0, client.availablePlayers.size() - 1)(generator);
+                startStep(client, Client::State::CHALLENGE_RESPONSE);
+                session.challenge(client.availablePlayers[target]);
+            } else if (options.resume) {
+                // The GOODBYE follows the ticket.
+                startStep(client, Client::State::SESSION_TICKET);
+                session.requestSessionTicket();
+            } else {
+                startStep(client, Client::State::GOODBYE);
+                session.leave();
+            }
+        }
+
+        /**
+         * Closes all the sessions still open, without waiting for the steps in progress.
+         */
+        void closeAll() {
+            for (auto &client : clients) {
+                if (client.state != Client::State::STOPPED) {
+                    disconnect(client);
+                }
+            }
+        }
+
+        void stop() {
+            stopping = true;
+            connectionQueue.clear();
+
+            for (auto &client : clients) {
+                if (client.state == Client::State::DISCONNECTED) {
+                    client.state = Client::State::STOPPED;
+                    activeClients--;
+                }
+            }
+        }
+    public:
+        Worker(const Options &options,
+               const fourinarow::DigitalSignature &digitalSignature,
+               const std::vector<std::string> &usernames,
+               unsigned long seed,
+               Clock::time_point deadline,
+               Statistics &statistics)
+               : options(options), pendingHandshakes(0),
+                 maxPendingHandshakes(std::max<size_t>(1, fourinarow::BACKLOG_SIZE/options.threads)),
+                 activeClients(usernames.size()), generator(seed), deadline(deadline), stopping(false),
+                 statistics(statistics) {
+            certificateStore.addCertificate(fourinarow::CLIENT_CERTIFICATES_FOLDER + "UnipiCA_cert.pem");
+            certificateStore.addCertificateRevocationList(fourinarow::CLIENT_CERTIFICATES_FOLDER + "UnipiCA_crl.pem");
+
+            // The sessions keep the ticket and the certificate of the server across the connections.
+            clients.resize(usernames.size());
+            for (size_t i = 0; i < usernames.size(); i++) {
+                clients[i].session = std::make_unique<fourinarow::ClientSession>(usernames[i], digitalSignature,
+                                                                                 certificateStore, *this);
+                clients[i].state = Client::State::DISCONNECTED;
+                clientsBySession[clients[i].session.get()] = i;
+                connectionQueue.push_back(i);
+            }
+        }
+
+        void onPlayerList(fourinarow::ClientSession &session, const std::vector<std::string> &players) override {
+            auto &client = getClient(session);
+            client.availablePlayers = players;
+
+            if (client.state == Client::State::HANDSHAKE) {
+                record(client.resuming ? Step::RESUMPTION : Step::HANDSHAKE, client);
+                pendingHandshakes--;
+            } else if (client.state == Client::State::PLAYER_LIST || client.state == Client::State::END_GAME) {
+                record(client.state == Client::State::PLAYER_LIST ? Step::PLAYER_LIST : Step::END_GAME, client);
+            }
+
+            startNextAction(client);
+        }
+
+        void onSessionTicket(fourinarow::ClientSession &session) override {
+            auto &client = getClient(session);
+            startStep(client, Client::State::GOODBYE);
+            session.leave();
+        }
+
+        void onChallenge(fourinarow::ClientSession &session, const std::string&) override {
+            auto &client = getClient(session);
+
+            // A pending request is ignored by the server, which has put the client in matchmaking.
+            if (client.state == Client::State::PLAYER_LIST || client.state == Client::State::CHALLENGE_RESPONSE
+                || client.state == Client::State::END_GAME || client.state == Client::State::SESSION_TICKET) {
+                statistics.preemptedRequests++;
+            }
+
+            auto accept = !stopping && std::uniform_int_distribution<unsigned int>(0, 99)(generator) < options.acceptance;
+            if (accept) {
+                startStep(client, Client::State::PLAYER);
+                session.acceptChallenge();
+                return;
+            }
+
+            session.refuseChallenge();
+            startNextAction(client);
+        }
+
+        void onChallengeAccepted(fourinarow::ClientSession &session) override {
+            auto &client = getClient(session);
+            record(Step::CHALLENGE, client);
+            statistics.challengesAccepted++;
+            startStep(client, Client::State::PLAYER);
+        }
+
+        void onMatchmakingFailed(fourinarow::ClientSession &session, fourinarow::MatchmakingFailure failure) override {
+            auto &client = getClient(session);
+
+            // The preempted challenge is counted when the challenge received is notified, right after.
+            if (failure == fourinarow::MatchmakingFailure::PREEMPTED) {
+                return;
+            }
+
+            if (failure == fourinarow::MatchmakingFailure::TIMEOUT) {
+                statistics.timeouts++;
+            } else {
+                record(Step::CHALLENGE, client);
+                (failure == fourinarow::MatchmakingFailure::REFUSED ? statistics.challengesRefused
+                                                                   : statistics.playersNotAvailable)++;
+            }
+
+            startNextAction(client);
+        }
+
+        void onMatchStarted(fourinarow::ClientSession &session, const std::string&, const fourinarow::PlayerMessage&) override {
+            auto &client = getClient(session);
+            record(Step::MATCHMAKING, client);
+
+            // The match is not played: the client reports its end and asks for the list to time the report.
+            startStep(client, Client::State::END_GAME);
+            session.leaveMatch();
+            if (session.getState() == fourinarow::ClientSession::State::AVAILABLE) {
+                session.requestPlayerList();
+            }
+        }
+
+        void onLeft(fourinarow::ClientSession &session) override {
+            auto &client = getClient(session);
+            record(Step::GOODBYE, client);
+            disconnect(client);
+        }
+
+        void onClosed(fourinarow::ClientSession &session, const std::string &reason) override {
+            auto &client = getClient(session);
+
+            // The session is closed when the server does not respond within the protocol timeout.
+            if (Clock::now() - client.stepStart >= std::chrono::seconds(fourinarow::CLIENT_PROTOCOL_TIMEOUT)) {
+                statistics.timeouts++;
+            } else {
+                statistics.errors++;
+                if (statistics.errors == 1) {
+                    std::cerr << "Error of the client '" << session.getUsername() << "'. " << reason << std::endl;
+                }
+            }
+
+            disconnect(client);
+        }
+
+        void run() {
+            // The challenges left pending by a player leaving the server are never answered: they are not waited for.
+            const auto hardDeadline = deadline + std::chrono::seconds(fourinarow::CLIENT_PROTOCOL_TIMEOUT);
+
+            while (activeClients > 0) {
+                auto now = Clock::now();
+                if (!stopping && now >= deadline) {
+                    stop();
+                }
+
+                if (now >= hardDeadline) {
+                    closeAll();
+                    break;
+                }
+
+                startConnections();
+                loop.runOnce(1);
+            }
+        }
+};
+
+/**
+ * Prints a help message describing how to invoke the program from the command line.
+ */
+void printHelp() {
+    std::string helpMessage("Usage: loadgen [-h] [-m MODE] -k KEY [-s ADDRESS] [-f FOLDER] [-c CLIENTS] [-u PREFIX]\n"
+                            "               [-t THREADS] [-d DURATION] [-x MIX] [-a ACCEPTANCE] [-r SEED] [-e RESUME]\n"
+                            "\n"
+                            "Options:\n"
+                            " -h, --help                 Show this help message and exit\n"
+                            " -m, --mode       MODE      'run' to simulate the clients, 'provision' to register them\n"
+                            "                            on the server (default: run)\n"
+                            " -k, --key        KEY       The private key signing for every client when running,\n"
+                            "                            the matching public key when provisioning\n"
+                            " -s, --server     ADDRESS   The IPv4 address of the server (required when running)\n"
+                            " -f, --folder     FOLDER    The players folder of the server (required when provisioning)\n"
+                            " -c, --clients    CLIENTS   The number of simulated clients (default: 100)\n"
+                            " -u, --prefix     PREFIX    The prefix of the usernames of the clients (default: load)\n"
+                            " -t, --threads    THREADS   The number of threads driving the clients (default: 1)\n"
+                            " -d, --duration   DURATION  The duration of the test, in seconds (default: 10)\n"
+                            " -x, --mix        MIX       The weights of the actions of an available client\n"
+                            "                            (default: list=60,challenge=30,reconnect=10)\n"
+                            " -a, --acceptance PERCENT   The percentage of challenges accepted (default: 50)\n"
+                            " -r, --seed       SEED      The seed of the choices of the clients (default: 1)\n"
+                            " -e, --resume     RESUME    'on' to resume the session with a ticket when reconnecting,\n"
+                            "                            'off' to perform a full handshake (default: off)");
+    std::cout << helpMessage << std::endl;
+}
+
+/**
+ * Parses a scenario mix, given as a comma separated list of action=weight pairs.
+ * The actions not listed have weight zero.
+ * @param value  the scenario mix.
+ * @param mix    a reference to the variable that will store the weights.
+ * @return       true if the mix is valid and has at least a positive weight, false otherwise.
+ */
+bool parseMix(const std::string &value, std::array<unsigned int, static_cast<size_t>(Action::COUNT)> &mix) {
+    mix.fill(0);
+    unsigned int total = 0;
+    size_t begin = 0;
+
+    while (begin <= value.size()) {
+        auto end = value.find(',', begin);
+        auto entry = value.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+        auto separator = entry.find('=');
+        if (separator == std::string::npos) {
+            return false;
+        }
+
+        auto action = std::find(ACTION_NAMES.begin(), ACTION_NAMES.end(), entry.substr(0, separator));
+        if (action == ACTION_NAMES.end()) {
+            return false;
+        }
+
+        auto weight = std::stoul(entry.substr(separator + 1));
+        mix[std::distance(ACTION_NAMES.begin(), action)] = weight;
+        total += weight;
+
+        if (end == std::string::npos) {
+            break;
+        }
+        begin = end + 1;
+    }
+
+    return total > 0;
+}
+
+/**
+ * Parses the arguments passed via command line. The key is always required, the server address
+ * only when running and the players folder only when provisioning. Each given option must be followed by a value.
+ * @param argc     the number of arguments passed via command line.
+ * @param argv     the arguments passed via command line.
+ * @param options  a reference to the variable that will store the options.
+ * @return         true if the arguments are valid, false otherwise.
+ */
+bool parseArguments(int argc, char *argv[], Options &options) {
+    if (argc % 2 != 1) {
+        printHelp();
+        return false;
+    }
+
+    try {
+        for (auto i = 1; i < argc; i += 2) {
+            std::string arg(argv[i]);
+            std::string value(argv[i + 1]);
+
+            if ((arg == "-m" || arg == "--mode") && (value == "run" || value == "provision")) {
+                options.mode = value;
+            } else if (arg == "-k" || arg == "--key") {
+                options.key = value;
+            } else if (arg == "-s" || arg == "--server") {
+                options.serverAddress = value;
+            } else if (arg == "-f" || arg == "--folder") {
+                options.playersFolder = value;
+            } else if (arg == "-c" || arg == "--clients") {
+                options.clients = std::stoul(value);
+            } else if (arg == "-u" || arg == "--prefix") {
+                options.prefix = value;
+            } else if (arg == "-t" || arg == "--threads") {
+                options.threads = std::stoul(value);
+            } else if (arg == "-d" || arg == "--duration") {
+                options.duration = std::stoul(value);
+            } else if ((arg == "-x" || arg == "--mix") && parseMix(value, options.mix)) {
+                continue;
+            } else if (arg == "-a" || arg == "--acceptance") {
+                options.acceptance = std::stoul(value);
+            } else if (arg == "-r" || arg == "--seed") {
+                options.seed = std::stoul(value);
+            } else if ((arg == "-e" || arg == "--resume") && (value == "on" || value == "off")) {
+                options.resume = (value == "on");
+            } else {
+                printHelp();
+                return false;
+            }
+        }
+    } catch (const std::exception &exception) {
+        printHelp();
+        return false;
+    }
+
+    auto running = options.mode == "run";
+    if (options.key.empty() || options.clients == 0 || options.threads == 0 || options.acceptance > 100
+        || (running && options.serverAddress.empty()) || (!running && options.playersFolder.empty())) {
+        printHelp();
+        return false;
+    }
+
+    try {
+        fourinarow::checkUsernameValidity<std::runtime_error>(options.prefix + std::to_string(options.clients - 1));
+        return true;
+    } catch (const std::runtime_error &exception) {
+        std::cerr << exception.what() << std::endl;
+        return false;
+    }
+}
+
+/**
+ * Generates the usernames of the simulated clients.
+ */
+std::vector<std::string> generateUsernames(const Options &options) {
+    std::vector<std::string> usernames;
+    usernames.reserve(options.clients);
+
+    for (auto i = 0u; i < options.clients; i++) {
+        usernames.push_back(options.prefix + std::to_string(i));
+    }
+
+    return usernames;
+}
+
+/**
+ * Registers the simulated clients on the server, copying the same public key
+ * in the players folder of the server under the username of each client.
+ * @param options  the options of the tool.
+ * @throws runtime_error  if the public key cannot be read or a copy cannot be written.
+ */
+void provisionClients(const Options &options) {
+    std::ifstream keyFile(options.key, std::ios::binary);
+    std::string key((std::istreambuf_iterator<char>(keyFile)), std::istreambuf_iterator<char>());
+    if (!keyFile || key.empty()) {
+        throw std::runtime_error("Cannot read the public key " + options.key);
+    }
+
+    auto folder = options.playersFolder;
+    if (folder.back() != '/') {
+        folder += '/';
+    }
+
+    for (const auto &username : generateUsernames(options)) {
+        std::ofstream file(folder + username + fourinarow::SERVER_PLAYER_KEY_SUFFIX, std::ios::binary);
+        file << key;
+
+        if (!file) {
+            throw std::runtime_error("Cannot write the public key of " + username);
+        }
+    }
+
+    std::cout << "Registered " << options.clients << " clients, from " << options.prefix << "0 to ";
+    std::cout << options.prefix << options.clients - 1 << ", in " << folder << std::endl;
+}
+
+/**
+ * Raises the limit of open descriptors of the process to its hard limit, since each client holds a socket.
+ */
+void raiseDescriptorLimit(const Options &options) {
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+        return;
+    }
+
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+
+    if (limit.rlim_cur != RLIM_INFINITY && limit.rlim_cur < options.clients + 16u) {
+        std::cerr << "Warning: the process can open at most " << limit.rlim_cur << " descriptors" << std::endl;
+    }
+}
+
+/**
+ * Returns the latency at the given quantile of the sorted samples, in milliseconds.
+ */
+double quantile(const std::vector<uint32_t> &samples, double quantile) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+
+    auto rank = static_cast<size_t>(std::ceil(quantile*samples.size()));
+    return samples[std::min(samples.size(), std::max<size_t>(rank, 1)) - 1]/1000.0;
+}
+
+/**
+ * Prints the throughput and the latency distribution of each protocol step.
+ * @param statistics  the statistics of the test. The latencies are sorted in place.
+ * @param options     the options of the test.
+ */
+void printReport(Statistics &statistics, const Options &options) {
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Clients: " << options.clients << ", threads: " << options.threads;
+    std::cout << ", duration: " << options.duration << " s\n\n";
+    std::cout << std::left << std::setw(12) << "step" << std::right << std::setw(10) << "count";
+    std::cout << std::setw(12) << "ops/s" << std::setw(10) << "p50 ms" << std::setw(10) << "p99 ms";
+    std::cout << std::setw(10) << "p999 ms" << std::setw(10) << "max ms" << '\n';
+
+    for (size_t i = 0; i < statistics.latencies.size(); i++) {
+        auto &samples = statistics.latencies[i];
+        std::sort(samples.begin(), samples.end());
+
+        std::cout << std::left << std::setw(12) << STEP_NAMES[i] << std::right << std::setw(10) << samples.size();
+        std::cout << std::setw(12) << std::setprecision(1) << static_cast<double>(samples.size())/options.duration;
+        std::cout << std::setprecision(3) << std::setw(10) << quantile(samples, 0.5) << std::setw(10) << quantile(samples, 0.99);
+        std::cout << std::setw(10) << quantile(samples, 0.999) << std::setw(10) << quantile(samples, 1.0) << '\n';
+    }
+
+    std::cout << "\nChallenges accepted: " << statistics.challengesAccepted << ", refused: " << statistics.challengesRefused;
+    std::cout << ", player not available: " << statistics.playersNotAvailable << '\n';
+    std::cout << "Requests preempted by a challenge: " << statistics.preemptedRequests << ", timeouts: " << statistics.timeouts;
+    std::cout << ", errors: " << statistics.errors << ", failed connections: " << statistics.failedConnections << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    Options options{"run", "", "", "", "load", 100, 1, 10, {60, 30, 10}, 50, 1, false};
+
+    if (!parseArguments(argc, argv, options)) {
+        return 1;
+    }
+
+    try {
+        if (options.mode == "provision") {
+            provisionClients(options);
+            return 0;
+        }
+
+        raiseDescriptorLimit(options);
+        fourinarow::DigitalSignature digitalSignature(options.key);
+        auto usernames = generateUsernames(options);
+
+        std::vector<Statistics> statistics(options.threads, Statistics{});
+        std::vector<std::unique_ptr<Worker>> workers;
+        auto deadline = Clock::now() + std::chrono::seconds(options.duration);
+
+        // The clients are dealt to the workers in turn.
+        for (auto i = 0u; i < options.threads; i++) {
+            std::vector<std::string> workerUsernames;
+            for (auto j = i; j < usernames.size(); j += options.threads) {
+                workerUsernames.push_back(usernames[j]);
+            }
+            workers.push_back(std::make_unique<Worker>(options, digitalSignature, workerUsernames,
+                                                       options.seed + i, deadline, statistics[i]));
+        }
+
+        std::vector<std::thread> threads;
+        for (auto &worker : workers) {
+            threads.emplace_back(&Worker::run, worker.get());
+        }
+
+        for (auto &thread : threads) {
+            thread.join();
+        }
+
+        for (auto i = 1u; i < options.threads; i++) {
+            statistics[0].merge(statistics[i]);
+        }
+
+        printReport(statistics[0], options);
+    } catch (const std::exception &exception) {
+        std::cerr << "Fatal error. " << exception.what() << std::endl;
+        return 1;
+    }
+}
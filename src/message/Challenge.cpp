@@ -6,7 +6,7 @@
 
 namespace fourinarow {
 
-Challenge::Challenge(std::string username) : username(std::move(username)) {}
+Challenge::Challenge(std::string username, uint8_t type) : type(type), username(std::move(username)) {}
 
 Challenge::~Challenge() {
     cleanse(type);
@@ -22,6 +22,9 @@ const std::string& Challenge::getUsername() const {
 }
 
 std::vector<unsigned char> Challenge::serialize() const {
+    if (type != CHALLENGE && type != QUICK_MATCH_FOUND) {
+        throw SerializationException("Malformed message");
+    }
     checkUsernameValidity<SerializationException>(username);
 
     size_t processedBytes = 0;
@@ -51,9 +54,10 @@ void Challenge::deserialize(const std::vector<unsigned char> &message) {
     memcpy(&receivedType, message.data(), sizeof(receivedType));
     processedBytes += sizeof(receivedType);
 
-    if (receivedType != CHALLENGE) {
+    if (receivedType != CHALLENGE && receivedType != QUICK_MATCH_FOUND) {
         throw SerializationException("Malformed message");
     }
+    type = receivedType;
 
     // Deserialize the username and its length.
     uint8_t usernameLength;
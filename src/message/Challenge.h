@@ -9,7 +9,8 @@
 namespace fourinarow {
 
 /**
- * Class representing a <code>CHALLENGE</code> message.
+ * Class representing a <code>CHALLENGE</code> message. The same format is used by the
+ * <code>QUICK_MATCH_FOUND</code> message, carrying the username of the opponent found by the quick match.
  */
 class Challenge : public Message {
     private:
@@ -17,7 +18,7 @@ class Challenge : public Message {
         std::string username;
     public:
         Challenge() = default;
-        explicit Challenge(std::string username);
+        explicit Challenge(std::string username, uint8_t type = CHALLENGE);
 
         /**
          * Destroys the message and securely wipes its content from memory.
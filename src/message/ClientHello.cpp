@@ -5,8 +5,18 @@
 
 namespace fourinarow {
 
-ClientHello::ClientHello(std::string username, std::vector<unsigned char> nonce)
-: username(std::move(username)), nonce(std::move(nonce)) {}
+ClientHello::ClientHello(std::string username,
+                         std::vector<unsigned char> nonce,
+                         std::vector<uint8_t> signatureSchemes,
+                         std::vector<uint8_t> keyExchangeGroups,
+                         std::vector<uint8_t> cipherSuites,
+                         std::vector<unsigned char> certificateFingerprint)
+: username(std::move(username)),
+  nonce(std::move(nonce)),
+  signatureSchemes(std::move(signatureSchemes)),
+  keyExchangeGroups(std::move(keyExchangeGroups)),
+  cipherSuites(std::move(cipherSuites)),
+  certificateFingerprint(std::move(certificateFingerprint)) {}
 
 uint8_t ClientHello::getType() const {
     return type;
@@ -20,12 +30,38 @@ const std::vector<unsigned char>& ClientHello::getNonce() const {
     return nonce;
 }
 
+const std::vector<uint8_t>& ClientHello::getSignatureSchemes() const {
+    return signatureSchemes;
+}
+
+const std::vector<uint8_t>& ClientHello::getKeyExchangeGroups() const {
+    return keyExchangeGroups;
+}
+
+const std::vector<uint8_t>& ClientHello::getCipherSuites() const {
+    return cipherSuites;
+}
+
+const std::vector<unsigned char>& ClientHello::getCertificateFingerprint() const {
+    return certificateFingerprint;
+}
+
 std::vector<unsigned char> ClientHello::serialize() const {
     checkUsernameValidity<SerializationException>(username);
     checkNonceSize<SerializationException>(nonce);
 
+    if (signatureSchemes.size() > UINT8_MAX || keyExchangeGroups.size() > UINT8_MAX || cipherSuites.size() > UINT8_MAX) {
+        throw SerializationException("Too many signature schemes, key exchange groups or cipher suites");
+    }
+
+    if (!certificateFingerprint.empty() && certificateFingerprint.size() != CERTIFICATE_FINGERPRINT_SIZE) {
+        throw SerializationException("Wrongly sized certificate fingerprint");
+    }
+
     size_t processedBytes = 0;
-    size_t outputSize = sizeof(type) + sizeof(MAX_USERNAME_SIZE) + username.size() + nonce.size();
+    size_t outputSize = sizeof(type) + sizeof(MAX_USERNAME_SIZE) + username.size() + nonce.size() +
+                        sizeof(uint8_t) + signatureSchemes.size() + sizeof(uint8_t) + keyExchangeGroups.size() +
+                        sizeof(uint8_t) + cipherSuites.size() + sizeof(uint8_t) + certificateFingerprint.size();
     std::vector<unsigned char> message(outputSize);
 
     // Serialize the type.
@@ -42,6 +78,36 @@ std::vector<unsigned char> ClientHello::serialize() const {
 
     // Serialize the nonce.
     memcpy(message.data() + processedBytes, nonce.data(), nonce.size());
+    processedBytes += nonce.size();
+
+    // Serialize the signature schemes, the key exchange groups, the cipher suites and their numbers,
+    // followed by the certificate fingerprint and its length.
+    uint8_t schemeCount = signatureSchemes.size();
+    memcpy(message.data() + processedBytes, &schemeCount, sizeof(schemeCount));
+    processedBytes += sizeof(schemeCount);
+
+    memcpy(message.data() + processedBytes, signatureSchemes.data(), signatureSchemes.size());
+    processedBytes += signatureSchemes.size();
+
+    uint8_t groupCount = keyExchangeGroups.size();
+    memcpy(message.data() + processedBytes, &groupCount, sizeof(groupCount));
+    processedBytes += sizeof(groupCount);
+
+    memcpy(message.data() + processedBytes, keyExchangeGroups.data(), keyExchangeGroups.size());
+    processedBytes += keyExchangeGroups.size();
+
+    uint8_t cipherSuiteCount = cipherSuites.size();
+    memcpy(message.data() + processedBytes, &cipherSuiteCount, sizeof(cipherSuiteCount));
+    processedBytes += sizeof(cipherSuiteCount);
+
+    memcpy(message.data() + processedBytes, cipherSuites.data(), cipherSuites.size());
+    processedBytes += cipherSuites.size();
+
+    uint8_t fingerprintLength = certificateFingerprint.size();
+    memcpy(message.data() + processedBytes, &fingerprintLength, sizeof(fingerprintLength));
+    processedBytes += sizeof(fingerprintLength);
+
+    memcpy(message.data() + processedBytes, certificateFingerprint.data(), certificateFingerprint.size());
 
     return message;
 }
@@ -79,6 +145,48 @@ void ClientHello::deserialize(const std::vector<unsigned char> &message) {
     checkIfEnoughSpace(message, processedBytes, NONCE_SIZE);
     nonce.resize(NONCE_SIZE);
     memcpy(nonce.data(), message.data() + processedBytes, NONCE_SIZE);
+    processedBytes += NONCE_SIZE;
+
+    // Deserialize the signature schemes, the key exchange groups, the cipher suites and their numbers,
+    // followed by the certificate fingerprint and its length.
+    uint8_t schemeCount;
+    checkIfEnoughSpace(message, processedBytes, sizeof(schemeCount));
+    memcpy(&schemeCount, message.data() + processedBytes, sizeof(schemeCount));
+    processedBytes += sizeof(schemeCount);
+
+    checkIfEnoughSpace(message, processedBytes, schemeCount);
+    signatureSchemes.assign(message.begin() + processedBytes, message.begin() + processedBytes + schemeCount);
+    processedBytes += schemeCount;
+
+    uint8_t groupCount;
+    checkIfEnoughSpace(message, processedBytes, sizeof(groupCount));
+    memcpy(&groupCount, message.data() + processedBytes, sizeof(groupCount));
+    processedBytes += sizeof(groupCount);
+
+    checkIfEnoughSpace(message, processedBytes, groupCount);
+    keyExchangeGroups.assign(message.begin() + processedBytes, message.begin() + processedBytes + groupCount);
+    processedBytes += groupCount;
+
+    uint8_t cipherSuiteCount;
+    checkIfEnoughSpace(message, processedBytes, sizeof(cipherSuiteCount));
+    memcpy(&cipherSuiteCount, message.data() + processedBytes, sizeof(cipherSuiteCount));
+    processedBytes += sizeof(cipherSuiteCount);
+
+    checkIfEnoughSpace(message, processedBytes, cipherSuiteCount);
+    cipherSuites.assign(message.begin() + processedBytes, message.begin() + processedBytes + cipherSuiteCount);
+    processedBytes += cipherSuiteCount;
+
+    uint8_t fingerprintLength;
+    checkIfEnoughSpace(message, processedBytes, sizeof(fingerprintLength));
+    memcpy(&fingerprintLength, message.data() + processedBytes, sizeof(fingerprintLength));
+    processedBytes += sizeof(fingerprintLength);
+
+    if ((fingerprintLength != 0 && fingerprintLength != CERTIFICATE_FINGERPRINT_SIZE) ||
+        message.size() != processedBytes + fingerprintLength) {
+        throw SerializationException("Malformed message");
+    }
+
+    certificateFingerprint.assign(message.begin() + processedBytes, message.end());
 }
 
 }
@@ -88,6 +196,22 @@ std::ostream& operator<<(std::ostream &ostream, const fourinarow::ClientHello &c
     ostream << "type=" << fourinarow::convertMessageType(clientHello.getType()) << ',' << std::endl;
     ostream << "username=" << clientHello.getUsername() << ',' << std::endl;
     ostream << "nonce=" << std::endl << fourinarow::dumpVector(clientHello.getNonce());
+    ostream << "signatureSchemes=";
+    for (auto scheme : clientHello.getSignatureSchemes()) {
+        ostream << fourinarow::convertSignatureScheme(scheme) << ' ';
+    }
+    ostream << std::endl;
+    ostream << "keyExchangeGroups=";
+    for (auto group : clientHello.getKeyExchangeGroups()) {
+        ostream << fourinarow::convertKeyExchangeGroup(group) << ' ';
+    }
+    ostream << std::endl;
+    ostream << "cipherSuites=";
+    for (auto cipherSuite : clientHello.getCipherSuites()) {
+        ostream << fourinarow::convertCipherSuite(cipherSuite) << ' ';
+    }
+    ostream << std::endl;
+    ostream << "certificateFingerprint=" << std::endl << fourinarow::dumpVector(clientHello.getCertificateFingerprint());
     ostream << '}';
     return ostream;
 }
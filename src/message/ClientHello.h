@@ -9,16 +9,33 @@
 namespace fourinarow {
 
 /**
- * Class representing a <code>CLIENT_HELLO</code> message.
+ * Class representing a <code>CLIENT_HELLO</code> message. The message ends with the list
+ * of the signature schemes accepted by the client, the list of the key exchange groups
+ * and the list of the cipher suites it supports, by preference, each preceded by its number
+ * of entries, possibly zero, followed by the fingerprint of the certificate of the server
+ * cached by the client, preceded by its length, possibly zero. If a list is empty, the server
+ * respectively signs with the key of its certificate, uses prime256v1 or uses AES-128 GCM.
+ * If the fingerprint is empty, the server sends its certificate.
+ * The lists are mandatory: a message without them, sent by a client predating them, is malformed,
+ * since such a client could not parse the length-prefixed fields of the later handshake messages anyway.
  */
 class ClientHello : public Message {
     private:
         uint8_t type = CLIENT_HELLO;
         std::string username;
         std::vector<unsigned char> nonce;
+        std::vector<uint8_t> signatureSchemes;
+        std::vector<uint8_t> keyExchangeGroups;
+        std::vector<uint8_t> cipherSuites;
+        std::vector<unsigned char> certificateFingerprint;
     public:
         ClientHello() = default;
-        ClientHello(std::string username, std::vector<unsigned char> nonce);
+        ClientHello(std::string username,
+                    std::vector<unsigned char> nonce,
+                    std::vector<uint8_t> signatureSchemes = {},
+                    std::vector<uint8_t> keyExchangeGroups = {},
+                    std::vector<uint8_t> cipherSuites = {},
+                    std::vector<unsigned char> certificateFingerprint = {});
         ~ClientHello() override = default;
 
         ClientHello(ClientHello&&) = default;
@@ -29,6 +46,10 @@ class ClientHello : public Message {
         uint8_t getType() const;
         const std::string& getUsername() const;
         const std::vector<unsigned char>& getNonce() const;
+        const std::vector<uint8_t>& getSignatureSchemes() const;
+        const std::vector<uint8_t>& getKeyExchangeGroups() const;
+        const std::vector<uint8_t>& getCipherSuites() const;
+        const std::vector<unsigned char>& getCertificateFingerprint() const;
 
         std::vector<unsigned char> serialize() const override;
         void deserialize(const std::vector<unsigned char> &message) override;
@@ -1,4 +1,5 @@
 #include <string.h>
+#include <arpa/inet.h>
 #include <ostream>
 #include <Utils.h>
 #include <SerializationException.h>
@@ -26,18 +27,27 @@ std::vector<unsigned char> EndHandshake::serialize() const {
     checkEcdhPublicKeySize<SerializationException>(publicKey);
 
     size_t processedBytes = 0;
-    size_t outputSize = sizeof(type) + publicKey.size() + digitalSignature.size();
+    size_t outputSize = sizeof(type) + sizeof(MAX_ECDH_PUBLIC_KEY_SIZE) + publicKey.size() +
+                        sizeof(MAX_DIGITAL_SIGNATURE_SIZE) + digitalSignature.size();
     std::vector<unsigned char> message(outputSize);
 
     // Serialize the type.
     memcpy(message.data(), &type, sizeof(type));
     processedBytes += sizeof(type);
 
-    // Serialize the public key.
+    // Serialize the public key and its length.
+    uint8_t publicKeyLength = publicKey.size();
+    memcpy(message.data() + processedBytes, &publicKeyLength, sizeof(publicKeyLength));
+    processedBytes += sizeof(publicKeyLength);
+
     memcpy(message.data() + processedBytes, publicKey.data(), publicKey.size());
     processedBytes += publicKey.size();
 
-    // Serialize the digital signature.
+    // Serialize the digital signature and its length.
+    uint16_t signatureLength = htons(digitalSignature.size());
+    memcpy(message.data() + processedBytes, &signatureLength, sizeof(signatureLength));
+    processedBytes += sizeof(signatureLength);
+
     memcpy(message.data() + processedBytes, digitalSignature.data(), digitalSignature.size());
 
     return message;
@@ -56,16 +66,29 @@ void EndHandshake::deserialize(const std::vector<unsigned char> &message) {
         throw SerializationException("Malformed message");
     }
 
-    // Deserialize the public key.
-    checkIfEnoughSpace(message, processedBytes, ECDH_PUBLIC_KEY_SIZE);
-    publicKey.resize(ECDH_PUBLIC_KEY_SIZE);
-    memcpy(publicKey.data(), message.data() + processedBytes, ECDH_PUBLIC_KEY_SIZE);
-    processedBytes += ECDH_PUBLIC_KEY_SIZE;
+    // Deserialize the public key and its length.
+    uint8_t publicKeyLength;
+    checkIfEnoughSpace(message, processedBytes, sizeof(publicKeyLength));
+    memcpy(&publicKeyLength, message.data() + processedBytes, sizeof(publicKeyLength));
+    processedBytes += sizeof(publicKeyLength);
 
-    // Deserialize the digital signature.
-    checkIfEnoughSpace(message, processedBytes, DIGITAL_SIGNATURE_SIZE);
-    digitalSignature.resize(DIGITAL_SIGNATURE_SIZE);
-    memcpy(digitalSignature.data(), message.data() + processedBytes, DIGITAL_SIGNATURE_SIZE);
+    checkIfEnoughSpace(message, processedBytes, publicKeyLength);
+    publicKey.resize(publicKeyLength);
+    memcpy(publicKey.data(), message.data() + processedBytes, publicKeyLength);
+    checkEcdhPublicKeySize<SerializationException>(publicKey);
+    processedBytes += publicKeyLength;
+
+    // Deserialize the digital signature and its length.
+    uint16_t signatureLength;
+    checkIfEnoughSpace(message, processedBytes, sizeof(signatureLength));
+    memcpy(&signatureLength, message.data() + processedBytes, sizeof(signatureLength));
+    signatureLength = ntohs(signatureLength);
+    processedBytes += sizeof(signatureLength);
+
+    checkIfEnoughSpace(message, processedBytes, signatureLength);
+    digitalSignature.resize(signatureLength);
+    memcpy(digitalSignature.data(), message.data() + processedBytes, signatureLength);
+    checkDigitalSignatureSize<SerializationException>(digitalSignature);
 }
 
 }
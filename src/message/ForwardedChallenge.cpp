@@ -0,0 +1,143 @@
+#include <string.h>
+#include <SerializationException.h>
+#include <Utils.h>
+#include "ForwardedChallenge.h"
+
+namespace fourinarow {
+
+ForwardedChallenge::ForwardedChallenge(uint8_t type,
+                                       std::string challenger,
+                                       std::string challenged,
+                                       uint8_t response,
+                                       bool challengerFirstToPlay)
+: type(type),
+  challenger(std::move(challenger)),
+  challenged(std::move(challenged)),
+  response(response),
+  challengerFirstToPlay(challengerFirstToPlay) {}
+
+ForwardedChallenge::~ForwardedChallenge() {
+    cleanse(type);
+    cleanse(challenger);
+    cleanse(challenged);
+    cleanse(response);
+    cleanse(challengerFirstToPlay);
+}
+
+uint8_t ForwardedChallenge::getType() const {
+    return type;
+}
+
+const std::string& ForwardedChallenge::getChallenger() const {
+    return challenger;
+}
+
+const std::string& ForwardedChallenge::getChallenged() const {
+    return challenged;
+}
+
+uint8_t ForwardedChallenge::getResponse() const {
+    return response;
+}
+
+bool ForwardedChallenge::isChallengerFirstToPlay() const {
+    return challengerFirstToPlay;
+}
+
+void ForwardedChallenge::checkTypeAndResponse() const {
+    if (type == PEER_CHALLENGE_RESPONSE) {
+        if (response != CHALLENGE_ACCEPTED && response != CHALLENGE_REFUSED && response != PLAYER_NOT_AVAILABLE) {
+            throw SerializationException("Malformed message");
+        }
+        return;
+    }
+
+    if ((type != PEER_CHALLENGE && type != PEER_CHALLENGE_CANCEL) || response != 0) {
+        throw SerializationException("Malformed message");
+    }
+}
+
+std::vector<unsigned char> ForwardedChallenge::serialize() const {
+    checkTypeAndResponse();
+    checkUsernameValidity<SerializationException>(challenger);
+    checkUsernameValidity<SerializationException>(challenged);
+
+    size_t processedBytes = 0;
+    size_t outputSize = sizeof(type) + sizeof(MAX_USERNAME_SIZE) + challenger.size() +
+                        sizeof(MAX_USERNAME_SIZE) + challenged.size() + sizeof(response) + sizeof(uint8_t);
+    std::vector<unsigned char> message(outputSize);
+
+    // Serialize the type.
+    memcpy(message.data(), &type, sizeof(type));
+    processedBytes += sizeof(type);
+
+    // Serialize the usernames and their lengths.
+    for (const auto *username : {&challenger, &challenged}) {
+        uint8_t usernameLength = username->size();
+        memcpy(message.data() + processedBytes, &usernameLength, sizeof(usernameLength));
+        processedBytes += sizeof(usernameLength);
+
+        memcpy(message.data() + processedBytes, username->data(), username->size());
+        processedBytes += username->size();
+    }
+
+    // Serialize the response and the boolean.
+    memcpy(message.data() + processedBytes, &response, sizeof(response));
+    processedBytes += sizeof(response);
+
+    uint8_t firstToPlayRepresentation = (challengerFirstToPlay ? 1 : 0);
+    memcpy(message.data() + processedBytes, &firstToPlayRepresentation, sizeof(firstToPlayRepresentation));
+
+    return message;
+}
+
+void ForwardedChallenge::deserialize(const std::vector<unsigned char> &message) {
+    size_t processedBytes = 0;
+
+    // Deserialize the type. It is checked together with the response.
+    checkIfEnoughSpace(message, processedBytes, sizeof(type));
+    memcpy(&type, message.data(), sizeof(type));
+    processedBytes += sizeof(type);
+
+    // Deserialize the usernames and their lengths.
+    for (auto *username : {&challenger, &challenged}) {
+        uint8_t usernameLength;
+        checkIfEnoughSpace(message, processedBytes, sizeof(usernameLength));
+        memcpy(&usernameLength, message.data() + processedBytes, sizeof(usernameLength));
+        processedBytes += sizeof(usernameLength);
+
+        if (usernameLength == 0) {
+            throw SerializationException("Malformed message");
+        }
+
+        checkIfEnoughSpace(message, processedBytes, usernameLength);
+        username->resize(usernameLength);
+        memcpy(&(*username)[0], message.data() + processedBytes, usernameLength);
+        checkUsernameValidity<SerializationException>(*username);
+        processedBytes += usernameLength;
+    }
+
+    // Deserialize the response and the boolean.
+    checkIfEnoughSpace(message, processedBytes, sizeof(response));
+    memcpy(&response, message.data() + processedBytes, sizeof(response));
+    processedBytes += sizeof(response);
+    checkTypeAndResponse();
+
+    uint8_t firstToPlayRepresentation;
+    checkIfEnoughSpace(message, processedBytes, sizeof(firstToPlayRepresentation));
+    memcpy(&firstToPlayRepresentation, message.data() + processedBytes, sizeof(firstToPlayRepresentation));
+    challengerFirstToPlay = (firstToPlayRepresentation == 0 ? false : true);
+}
+
+}
+
+std::ostream& operator<<(std::ostream &ostream, const fourinarow::ForwardedChallenge &forwardedChallenge) {
+    ostream << "ForwardedChallenge{";
+    ostream << "type=" << fourinarow::convertMessageType(forwardedChallenge.getType()) << ", ";
+    ostream << "challenger=" << forwardedChallenge.getChallenger() << ", ";
+    ostream << "challenged=" << forwardedChallenge.getChallenged() << ", ";
+    ostream << "response=" << fourinarow::convertMessageType(forwardedChallenge.getResponse()) << ", ";
+    ostream << "challengerFirstToPlay=" << std::boolalpha << forwardedChallenge.isChallengerFirstToPlay() << std::noboolalpha;
+    ostream << '}';
+    return ostream;
+}
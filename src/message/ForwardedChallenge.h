@@ -0,0 +1,66 @@
+#ifndef INC_4INAROW_FORWARDEDCHALLENGE_H
+#define INC_4INAROW_FORWARDEDCHALLENGE_H
+
+#include <ostream>
+#include <string>
+#include <Constants.h>
+#include "Message.h"
+
+namespace fourinarow {
+
+/**
+ * Class representing a message exchanged between server processes or cluster nodes, to carry out
+ * a challenge between players connected to different processes or nodes. The type of the message can be:
+ * 1) <code>PEER_CHALLENGE</code>, sent to the process of the challenged player;
+ * 2) <code>PEER_CHALLENGE_RESPONSE</code>, sent back to the process of the challenger, carrying either
+ *    <code>CHALLENGE_ACCEPTED</code>, <code>CHALLENGE_REFUSED</code> or <code>PLAYER_NOT_AVAILABLE</code>
+ *    and, if the challenge has been accepted, the turn of the challenger;
+ * 3) <code>PEER_CHALLENGE_CANCEL</code>, sent to the process of the opponent when a player leaves the matchmaking.
+ */
+class ForwardedChallenge : public Message {
+    private:
+        uint8_t type = PEER_CHALLENGE;
+        std::string challenger;
+        std::string challenged;
+        uint8_t response = 0;
+        bool challengerFirstToPlay = false;
+
+        /**
+         * Checks if the type and the response of the message are consistent.
+         * @throws SerializationException  if the type is not a peer one, or the response
+         *                                 is not valid for the type.
+         */
+        void checkTypeAndResponse() const;
+    public:
+        ForwardedChallenge() = default;
+        ForwardedChallenge(uint8_t type,
+                           std::string challenger,
+                           std::string challenged,
+                           uint8_t response = 0,
+                           bool challengerFirstToPlay = false);
+
+        /**
+         * Destroys the message and securely wipes its content from memory.
+         */
+        ~ForwardedChallenge() override;
+
+        ForwardedChallenge(ForwardedChallenge&&) = default;
+        ForwardedChallenge(const ForwardedChallenge&) = default;
+        ForwardedChallenge& operator=(const ForwardedChallenge&) = default;
+        ForwardedChallenge& operator=(ForwardedChallenge&&) = default;
+
+        uint8_t getType() const;
+        const std::string& getChallenger() const;
+        const std::string& getChallenged() const;
+        uint8_t getResponse() const;
+        bool isChallengerFirstToPlay() const;
+
+        std::vector<unsigned char> serialize() const override;
+        void deserialize(const std::vector<unsigned char> &message) override;
+};
+
+}
+
+std::ostream& operator<<(std::ostream &ostream, const fourinarow::ForwardedChallenge &forwardedChallenge);
+
+#endif //INC_4INAROW_FORWARDEDCHALLENGE_H
@@ -5,7 +5,8 @@
 
 namespace fourinarow {
 
-Player1Hello::Player1Hello(std::vector<unsigned char> nonce) : nonce(std::move(nonce)) {}
+Player1Hello::Player1Hello(std::vector<unsigned char> nonce, std::vector<uint8_t> keyExchangeGroups)
+: nonce(std::move(nonce)), keyExchangeGroups(std::move(keyExchangeGroups)) {}
 
 uint8_t Player1Hello::getType() const {
     return type;
@@ -15,11 +16,23 @@ const std::vector<unsigned char>& Player1Hello::getNonce() const {
     return nonce;
 }
 
+const std::vector<uint8_t>& Player1Hello::getKeyExchangeGroups() const {
+    return keyExchangeGroups;
+}
+
 std::vector<unsigned char> Player1Hello::serialize() const {
     checkNonceSize<SerializationException>(nonce);
 
+    if (keyExchangeGroups.size() > UINT8_MAX) {
+        throw SerializationException("Too many key exchange groups");
+    }
+
     size_t processedBytes = 0;
     size_t outputSize = sizeof(type) + nonce.size();
+
+    if (!keyExchangeGroups.empty()) {
+        outputSize += sizeof(uint8_t) + keyExchangeGroups.size();
+    }
     std::vector<unsigned char> message(outputSize);
 
     // Serialize the type.
@@ -28,6 +41,16 @@ std::vector<unsigned char> Player1Hello::serialize() const {
 
     // Serialize the nonce.
     memcpy(message.data() + processedBytes, nonce.data(), nonce.size());
+    processedBytes += nonce.size();
+
+    // Serialize the key exchange groups and their number, if any.
+    if (!keyExchangeGroups.empty()) {
+        uint8_t groupCount = keyExchangeGroups.size();
+        memcpy(message.data() + processedBytes, &groupCount, sizeof(groupCount));
+        processedBytes += sizeof(groupCount);
+
+        memcpy(message.data() + processedBytes, keyExchangeGroups.data(), keyExchangeGroups.size());
+    }
 
     return message;
 }
@@ -49,6 +72,23 @@ void Player1Hello::deserialize(const std::vector<unsigned char> &message) {
     checkIfEnoughSpace(message, processedBytes, NONCE_SIZE);
     nonce.resize(NONCE_SIZE);
     memcpy(nonce.data(), message.data() + processedBytes, NONCE_SIZE);
+    processedBytes += NONCE_SIZE;
+
+    // Deserialize the key exchange groups and their number, if present.
+    keyExchangeGroups.clear();
+    if (processedBytes == message.size()) {
+        return;
+    }
+
+    uint8_t groupCount;
+    memcpy(&groupCount, message.data() + processedBytes, sizeof(groupCount));
+    processedBytes += sizeof(groupCount);
+
+    if (groupCount == 0 || message.size() != processedBytes + groupCount) {
+        throw SerializationException("Malformed message");
+    }
+
+    keyExchangeGroups.assign(message.begin() + processedBytes, message.end());
 }
 
 }
@@ -57,6 +97,11 @@ std::ostream& operator<<(std::ostream &ostream, const fourinarow::Player1Hello &
     ostream << "Player1Hello{" << std::endl;
     ostream << "type=" << fourinarow::convertMessageType(player1Hello.getType()) << ',' << std::endl;
     ostream << "nonce=" << std::endl << fourinarow::dumpVector(player1Hello.getNonce());
+    ostream << "keyExchangeGroups=";
+    for (auto group : player1Hello.getKeyExchangeGroups()) {
+        ostream << fourinarow::convertKeyExchangeGroup(group) << ' ';
+    }
+    ostream << std::endl;
     ostream << '}';
     return ostream;
 }
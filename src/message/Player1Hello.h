@@ -8,15 +8,17 @@
 namespace fourinarow {
 
 /**
- * Class representing a <code>PLAYER1_HELLO</code> message.
+ * Class representing a <code>PLAYER1_HELLO</code> message. The message can end with the list
+ * of the key exchange groups supported by the player; if the list is missing, prime256v1 is used.
  */
 class Player1Hello : public Message {
     private:
         uint8_t type = PLAYER1_HELLO;
         std::vector<unsigned char> nonce;
+        std::vector<uint8_t> keyExchangeGroups;
     public:
         Player1Hello() = default;
-        explicit Player1Hello(std::vector<unsigned char> nonce);
+        explicit Player1Hello(std::vector<unsigned char> nonce, std::vector<uint8_t> keyExchangeGroups = {});
         ~Player1Hello() override = default;
 
         Player1Hello(Player1Hello&&) = default;
@@ -26,6 +28,7 @@ class Player1Hello : public Message {
 
         uint8_t getType() const;
         const std::vector<unsigned char>& getNonce() const;
+        const std::vector<uint8_t>& getKeyExchangeGroups() const;
 
         std::vector<unsigned char> serialize() const override;
         void deserialize(const std::vector<unsigned char> &message) override;
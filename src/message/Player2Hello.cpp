@@ -1,4 +1,5 @@
 #include <string.h>
+#include <arpa/inet.h>
 #include <SerializationException.h>
 #include <Utils.h>
 #include "Player2Hello.h"
@@ -32,7 +33,8 @@ std::vector<unsigned char> Player2Hello::serialize() const {
     checkDigitalSignatureSize<SerializationException>(digitalSignature);
 
     size_t processedBytes = 0;
-    size_t outputSize = sizeof(type) + nonce.size() + publicKey.size() + digitalSignature.size();
+    size_t outputSize = sizeof(type) + nonce.size() + sizeof(MAX_ECDH_PUBLIC_KEY_SIZE) + publicKey.size() +
+                        sizeof(MAX_DIGITAL_SIGNATURE_SIZE) + digitalSignature.size();
     std::vector<unsigned char> message(outputSize);
 
     // Serialize the type.
@@ -43,11 +45,19 @@ std::vector<unsigned char> Player2Hello::serialize() const {
     memcpy(message.data() + processedBytes, nonce.data(), nonce.size());
     processedBytes += nonce.size();
 
-    // Serialize the public key.
+    // Serialize the public key and its length.
+    uint8_t publicKeyLength = publicKey.size();
+    memcpy(message.data() + processedBytes, &publicKeyLength, sizeof(publicKeyLength));
+    processedBytes += sizeof(publicKeyLength);
+
     memcpy(message.data() + processedBytes, publicKey.data(), publicKey.size());
     processedBytes += publicKey.size();
 
-    // Serialize the digital signature.
+    // Serialize the digital signature and its length.
+    uint16_t signatureLength = htons(digitalSignature.size());
+    memcpy(message.data() + processedBytes, &signatureLength, sizeof(signatureLength));
+    processedBytes += sizeof(signatureLength);
+
     memcpy(message.data() + processedBytes, digitalSignature.data(), digitalSignature.size());
 
     return message;
@@ -72,16 +82,29 @@ void Player2Hello::deserialize(const std::vector<unsigned char> &message) {
     memcpy(nonce.data(), message.data() + processedBytes, NONCE_SIZE);
     processedBytes += NONCE_SIZE;
 
-    // Deserialize the public key.
-    checkIfEnoughSpace(message, processedBytes, ECDH_PUBLIC_KEY_SIZE);
-    publicKey.resize(ECDH_PUBLIC_KEY_SIZE);
-    memcpy(publicKey.data(), message.data() + processedBytes, ECDH_PUBLIC_KEY_SIZE);
-    processedBytes += ECDH_PUBLIC_KEY_SIZE;
+    // Deserialize the public key and its length.
+    uint8_t publicKeyLength;
+    checkIfEnoughSpace(message, processedBytes, sizeof(publicKeyLength));
+    memcpy(&publicKeyLength, message.data() + processedBytes, sizeof(publicKeyLength));
+    processedBytes += sizeof(publicKeyLength);
 
-    // Deserialize the digital signature.
-    checkIfEnoughSpace(message, processedBytes, DIGITAL_SIGNATURE_SIZE);
-    digitalSignature.resize(DIGITAL_SIGNATURE_SIZE);
-    memcpy(digitalSignature.data(), message.data() + processedBytes, DIGITAL_SIGNATURE_SIZE);
+    checkIfEnoughSpace(message, processedBytes, publicKeyLength);
+    publicKey.resize(publicKeyLength);
+    memcpy(publicKey.data(), message.data() + processedBytes, publicKeyLength);
+    checkEcdhPublicKeySize<SerializationException>(publicKey);
+    processedBytes += publicKeyLength;
+
+    // Deserialize the digital signature and its length.
+    uint16_t signatureLength;
+    checkIfEnoughSpace(message, processedBytes, sizeof(signatureLength));
+    memcpy(&signatureLength, message.data() + processedBytes, sizeof(signatureLength));
+    signatureLength = ntohs(signatureLength);
+    processedBytes += sizeof(signatureLength);
+
+    checkIfEnoughSpace(message, processedBytes, signatureLength);
+    digitalSignature.resize(signatureLength);
+    memcpy(digitalSignature.data(), message.data() + processedBytes, signatureLength);
+    checkDigitalSignatureSize<SerializationException>(digitalSignature);
 }
 
 }
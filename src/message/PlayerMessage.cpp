@@ -9,6 +9,8 @@ namespace fourinarow {
 PlayerMessage::PlayerMessage(std::string ipAddress, std::vector<unsigned char> publicKey, bool firstToPlay)
 : ipAddress(std::move(ipAddress)), publicKey(std::move(publicKey)), firstToPlay(firstToPlay) {}
 
+PlayerMessage::PlayerMessage(bool firstToPlay) : type(RELAYED_PLAYER), firstToPlay(firstToPlay) {}
+
 PlayerMessage::~PlayerMessage() {
     cleanse(type);
     cleanse(ipAddress);
@@ -32,7 +34,20 @@ bool fourinarow::PlayerMessage::isFirstToPlay() const {
     return firstToPlay;
 }
 
+bool PlayerMessage::isRelayed() const {
+    return type == RELAYED_PLAYER;
+}
+
 std::vector<unsigned char> PlayerMessage::serialize() const {
+    uint8_t firstToPlayRepresentation = (firstToPlay ? 1 : 0);
+
+    if (isRelayed()) {
+        std::vector<unsigned char> message(sizeof(type) + sizeof(firstToPlayRepresentation));
+        memcpy(message.data(), &type, sizeof(type));
+        memcpy(message.data() + sizeof(type), &firstToPlayRepresentation, sizeof(firstToPlayRepresentation));
+        return message;
+    }
+
     sockaddr_in dummySockaddr;
     auto result = inet_pton(AF_INET, ipAddress.data(), &dummySockaddr.sin_addr);
 
@@ -40,11 +55,11 @@ std::vector<unsigned char> PlayerMessage::serialize() const {
         throw SerializationException("Invalid network address");
     }
 
-    checkRsaPublicKeySize<SerializationException>(publicKey);
+    checkSignaturePublicKeySize<SerializationException>(publicKey);
 
     size_t processedBytes = 0;
     size_t outputSize = sizeof(type) + sizeof(MAX_IPV4_ADDRESS_SIZE) + ipAddress.size() +
-                        publicKey.size() + sizeof(uint8_t);
+                        sizeof(MAX_SIGNATURE_PUBLIC_KEY_SIZE) + publicKey.size() + sizeof(uint8_t);
     std::vector<unsigned char> message(outputSize);
 
     // Serialize the type.
@@ -59,12 +74,15 @@ std::vector<unsigned char> PlayerMessage::serialize() const {
     memcpy(message.data() + processedBytes, ipAddress.data(), ipAddress.size());
     processedBytes += ipAddress.size();
 
-    // Serialize the public key.
+    // Serialize the public key and its length.
+    uint16_t publicKeyLength = htons(publicKey.size());
+    memcpy(message.data() + processedBytes, &publicKeyLength, sizeof(publicKeyLength));
+    processedBytes += sizeof(publicKeyLength);
+
     memcpy(message.data() + processedBytes, publicKey.data(), publicKey.size());
     processedBytes += publicKey.size();
 
     // Serialize the boolean.
-    uint8_t firstToPlayRepresentation = (firstToPlay ? 1 : 0);
     memcpy(message.data() + processedBytes, &firstToPlayRepresentation, sizeof(firstToPlayRepresentation));
 
     return message;
@@ -79,31 +97,44 @@ void PlayerMessage::deserialize(const std::vector<unsigned char> &message) {
     memcpy(&receivedType, message.data(), sizeof(receivedType));
     processedBytes += sizeof(receivedType);
 
-    if (receivedType != PLAYER) {
+    if (receivedType != PLAYER && receivedType != RELAYED_PLAYER) {
         throw SerializationException("Malformed message");
     }
 
-    // Deserialize the IPv4 address and its length.
-    uint8_t addressLength;
-    checkIfEnoughSpace(message, processedBytes, sizeof(addressLength));
-    memcpy(&addressLength, message.data() + processedBytes, sizeof(addressLength));
-    processedBytes += sizeof(addressLength);
-
-    if (addressLength == 0 || addressLength > MAX_IPV4_ADDRESS_SIZE) {
-        throw SerializationException("Malformed message");
+    type = receivedType;
+    if (isRelayed()) {
+        ipAddress.clear();
+        publicKey.clear();
+    } else {
+        // Deserialize the IPv4 address and its length.
+        uint8_t addressLength;
+        checkIfEnoughSpace(message, processedBytes, sizeof(addressLength));
+        memcpy(&addressLength, message.data() + processedBytes, sizeof(addressLength));
+        processedBytes += sizeof(addressLength);
+
+        if (addressLength == 0 || addressLength > MAX_IPV4_ADDRESS_SIZE) {
+            throw SerializationException("Malformed message");
+        }
+
+        checkIfEnoughSpace(message, processedBytes, addressLength);
+        ipAddress.resize(addressLength);
+        memcpy(&ipAddress[0], message.data() + processedBytes, addressLength);
+        processedBytes += addressLength;
+
+        // Deserialize the public key and its length.
+        uint16_t publicKeyLength;
+        checkIfEnoughSpace(message, processedBytes, sizeof(publicKeyLength));
+        memcpy(&publicKeyLength, message.data() + processedBytes, sizeof(publicKeyLength));
+        publicKeyLength = ntohs(publicKeyLength);
+        processedBytes += sizeof(publicKeyLength);
+
+        checkIfEnoughSpace(message, processedBytes, publicKeyLength);
+        publicKey.resize(publicKeyLength);
+        memcpy(publicKey.data(), message.data() + processedBytes, publicKeyLength);
+        checkSignaturePublicKeySize<SerializationException>(publicKey);
+        processedBytes += publicKeyLength;
     }
 
-    checkIfEnoughSpace(message, processedBytes, addressLength);
-    ipAddress.resize(addressLength);
-    memcpy(&ipAddress[0], message.data() + processedBytes, addressLength);
-    processedBytes += addressLength;
-
-    // Deserialize the public key.
-    checkIfEnoughSpace(message, processedBytes, RSA_PUBLIC_KEY_SIZE);
-    publicKey.resize(RSA_PUBLIC_KEY_SIZE);
-    memcpy(publicKey.data(), message.data() + processedBytes, RSA_PUBLIC_KEY_SIZE);
-    processedBytes += RSA_PUBLIC_KEY_SIZE;
-
     // Deserialize the boolean.
     uint8_t firstToPlayRepresentation;
     checkIfEnoughSpace(message, processedBytes, sizeof(firstToPlayRepresentation));
@@ -9,7 +9,10 @@
 namespace fourinarow {
 
 /**
- * Class representing a <code>PLAYER</code> message.
+ * Class representing a <code>PLAYER</code> message. The message has also a relayed form,
+ * sent by a server relaying the match, which has type <code>RELAYED_PLAYER</code> and carries
+ * only the turn order: the moves are exchanged through the server, so the address
+ * and the public key of the opponent are not needed.
  */
 class PlayerMessage : public Message {
     private:
@@ -21,6 +24,12 @@ class PlayerMessage : public Message {
         PlayerMessage() = default;
         PlayerMessage(std::string ipAddress, std::vector<unsigned char> publicKey, bool firstToPlay);
 
+        /**
+         * Creates a message in the relayed form.
+         * @param firstToPlay  true if the receiver has the first turn, false otherwise.
+         */
+        explicit PlayerMessage(bool firstToPlay);
+
         /**
          * Destroys the message and securely wipes its content from memory.
          */
@@ -35,6 +44,7 @@ class PlayerMessage : public Message {
         const std::string& getIpAddress() const;
         const std::vector<unsigned char>& getPublicKey() const;
         bool isFirstToPlay() const;
+        bool isRelayed() const;
 
         std::vector<unsigned char> serialize() const override;
         void deserialize(const std::vector<unsigned char> &message) override;
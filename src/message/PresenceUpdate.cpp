@@ -0,0 +1,133 @@
+#include <string.h>
+#include <SerializationException.h>
+#include <Utils.h>
+#include "PresenceUpdate.h"
+
+namespace fourinarow {
+
+PresenceUpdate::PresenceUpdate(std::vector<Entry> entries) : entries(std::move(entries)) {}
+
+PresenceUpdate::~PresenceUpdate() {
+    cleanse(type);
+    for (auto &entry : entries) {
+        cleanse(entry.username);
+        cleanse(entry.address);
+        cleanse(entry.status);
+    }
+}
+
+uint8_t PresenceUpdate::getType() const {
+    return type;
+}
+
+const std::vector<PresenceUpdate::Entry>& PresenceUpdate::getEntries() const {
+    return entries;
+}
+
+std::vector<unsigned char> PresenceUpdate::serialize() const {
+    if (type != PEER_PRESENCE || entries.empty() || entries.size() > MAX_PRESENCE_UPDATE_ENTRIES) {
+        throw SerializationException("Malformed message");
+    }
+
+    size_t outputSize = sizeof(type) + sizeof(MAX_PRESENCE_UPDATE_ENTRIES);
+    for (const auto &entry : entries) {
+        checkUsernameValidity<SerializationException>(entry.username);
+        if (entry.address.size() > MAX_IPV4_ADDRESS_SIZE || (entry.status != 0) == entry.address.empty()) {
+            throw SerializationException("Malformed message");
+        }
+        outputSize += sizeof(entry.status) + sizeof(MAX_USERNAME_SIZE) + entry.username.size() +
+                      sizeof(MAX_IPV4_ADDRESS_SIZE) + entry.address.size();
+    }
+
+    size_t processedBytes = 0;
+    std::vector<unsigned char> message(outputSize);
+
+    // Serialize the type and the number of entries.
+    memcpy(message.data(), &type, sizeof(type));
+    processedBytes += sizeof(type);
+
+    uint8_t entryCount = entries.size();
+    memcpy(message.data() + processedBytes, &entryCount, sizeof(entryCount));
+    processedBytes += sizeof(entryCount);
+
+    // Serialize each entry: the status, then the username and the address preceded by their lengths.
+    for (const auto &entry : entries) {
+        memcpy(message.data() + processedBytes, &entry.status, sizeof(entry.status));
+        processedBytes += sizeof(entry.status);
+
+        for (const auto *field : {&entry.username, &entry.address}) {
+            uint8_t fieldLength = field->size();
+            memcpy(message.data() + processedBytes, &fieldLength, sizeof(fieldLength));
+            processedBytes += sizeof(fieldLength);
+
+            memcpy(message.data() + processedBytes, field->data(), field->size());
+            processedBytes += field->size();
+        }
+    }
+
+    return message;
+}
+
+void PresenceUpdate::deserialize(const std::vector<unsigned char> &message) {
+    size_t processedBytes = 0;
+
+    // Deserialize the type and the number of entries.
+    checkIfEnoughSpace(message, processedBytes, sizeof(type));
+    memcpy(&type, message.data(), sizeof(type));
+    processedBytes += sizeof(type);
+
+    if (type != PEER_PRESENCE) {
+        throw SerializationException("Malformed message");
+    }
+
+    uint8_t entryCount;
+    checkIfEnoughSpace(message, processedBytes, sizeof(entryCount));
+    memcpy(&entryCount, message.data() + processedBytes, sizeof(entryCount));
+    processedBytes += sizeof(entryCount);
+
+    if (entryCount == 0 || entryCount > MAX_PRESENCE_UPDATE_ENTRIES) {
+        throw SerializationException("Malformed message");
+    }
+
+    // Deserialize each entry.
+    entries.clear();
+    entries.resize(entryCount);
+    for (auto &entry : entries) {
+        checkIfEnoughSpace(message, processedBytes, sizeof(entry.status));
+        memcpy(&entry.status, message.data() + processedBytes, sizeof(entry.status));
+        processedBytes += sizeof(entry.status);
+
+        for (auto *field : {&entry.username, &entry.address}) {
+            uint8_t fieldLength;
+            checkIfEnoughSpace(message, processedBytes, sizeof(fieldLength));
+            memcpy(&fieldLength, message.data() + processedBytes, sizeof(fieldLength));
+            processedBytes += sizeof(fieldLength);
+
+            checkIfEnoughSpace(message, processedBytes, fieldLength);
+            field->assign(reinterpret_cast<const char*>(message.data() + processedBytes), fieldLength);
+            processedBytes += fieldLength;
+        }
+
+        checkUsernameValidity<SerializationException>(entry.username);
+        if (entry.address.size() > MAX_IPV4_ADDRESS_SIZE || (entry.status != 0) == entry.address.empty()) {
+            throw SerializationException("Malformed message");
+        }
+    }
+}
+
+}
+
+std::ostream& operator<<(std::ostream &ostream, const fourinarow::PresenceUpdate &presenceUpdate) {
+    ostream << "PresenceUpdate{";
+    ostream << "type=" << fourinarow::convertMessageType(presenceUpdate.getType()) << ", ";
+    ostream << "entries=[";
+
+    for (size_t i = 0; i < presenceUpdate.getEntries().size(); i++) {
+        const auto &entry = presenceUpdate.getEntries()[i];
+        ostream << (i == 0 ? "" : ", ");
+        ostream << entry.username << '@' << entry.address << ':' << static_cast<unsigned int>(entry.status);
+    }
+
+    ostream << "]}";
+    return ostream;
+}
@@ -0,0 +1,54 @@
+#ifndef INC_4INAROW_PRESENCEUPDATE_H
+#define INC_4INAROW_PRESENCEUPDATE_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <Constants.h>
+#include "Message.h"
+
+namespace fourinarow {
+
+/**
+ * Class representing a <code>PEER_PRESENCE</code> message, exchanged between the nodes of a cluster
+ * to replicate the players connected to each of them. A node sends the players whose status changed
+ * since the last message, or all its players when a link is established. Each entry carries the username,
+ * the IPv4 address and the status of a player: a zero status means that the player disconnected,
+ * and the address is then empty. A message carries at most <code>MAX_PRESENCE_UPDATE_ENTRIES</code> entries.
+ */
+class PresenceUpdate : public Message {
+    public:
+        struct Entry {
+            std::string username;
+            std::string address;
+            uint8_t status;
+        };
+    private:
+        uint8_t type = PEER_PRESENCE;
+        std::vector<Entry> entries;
+    public:
+        PresenceUpdate() = default;
+        explicit PresenceUpdate(std::vector<Entry> entries);
+
+        /**
+         * Destroys the message and securely wipes its content from memory.
+         */
+        ~PresenceUpdate() override;
+
+        PresenceUpdate(PresenceUpdate&&) = default;
+        PresenceUpdate(const PresenceUpdate&) = default;
+        PresenceUpdate& operator=(const PresenceUpdate&) = default;
+        PresenceUpdate& operator=(PresenceUpdate&&) = default;
+
+        uint8_t getType() const;
+        const std::vector<Entry>& getEntries() const;
+
+        std::vector<unsigned char> serialize() const override;
+        void deserialize(const std::vector<unsigned char> &message) override;
+};
+
+}
+
+std::ostream& operator<<(std::ostream &ostream, const fourinarow::PresenceUpdate &presenceUpdate);
+
+#endif //INC_4INAROW_PRESENCEUPDATE_H
@@ -0,0 +1,73 @@
+#include <string.h>
+#include <SerializationException.h>
+#include <Utils.h>
+#include "ResumeAccepted.h"
+
+namespace fourinarow {
+
+ResumeAccepted::ResumeAccepted(std::vector<unsigned char> nonce, uint8_t cipherSuite)
+: nonce(std::move(nonce)), cipherSuite(cipherSuite) {}
+
+uint8_t ResumeAccepted::getType() const {
+    return type;
+}
+
+const std::vector<unsigned char>& ResumeAccepted::getNonce() const {
+    return nonce;
+}
+
+uint8_t ResumeAccepted::getCipherSuite() const {
+    return cipherSuite;
+}
+
+std::vector<unsigned char> ResumeAccepted::serialize() const {
+    checkNonceSize<SerializationException>(nonce);
+
+    std::vector<unsigned char> message(sizeof(type) + nonce.size() + sizeof(cipherSuite));
+
+    // Serialize the type.
+    memcpy(message.data(), &type, sizeof(type));
+
+    // Serialize the nonce.
+    memcpy(message.data() + sizeof(type), nonce.data(), nonce.size());
+
+    // Serialize the cipher suite.
+    memcpy(message.data() + sizeof(type) + nonce.size(), &cipherSuite, sizeof(cipherSuite));
+
+    return message;
+}
+
+void ResumeAccepted::deserialize(const std::vector<unsigned char> &message) {
+    size_t processedBytes = 0;
+
+    // Check if the type matches the expected one.
+    uint8_t receivedType;
+    checkIfEnoughSpace(message, processedBytes, sizeof(receivedType));
+    memcpy(&receivedType, message.data(), sizeof(receivedType));
+    processedBytes += sizeof(receivedType);
+
+    if (receivedType != RESUME_ACCEPTED) {
+        throw SerializationException("Malformed message");
+    }
+
+    // Deserialize the nonce.
+    checkIfEnoughSpace(message, processedBytes, NONCE_SIZE);
+    nonce.resize(NONCE_SIZE);
+    memcpy(nonce.data(), message.data() + processedBytes, NONCE_SIZE);
+    processedBytes += NONCE_SIZE;
+
+    // Deserialize the cipher suite.
+    checkIfEnoughSpace(message, processedBytes, sizeof(cipherSuite));
+    memcpy(&cipherSuite, message.data() + processedBytes, sizeof(cipherSuite));
+}
+
+}
+
+std::ostream& operator<<(std::ostream &ostream, const fourinarow::ResumeAccepted &resumeAccepted) {
+    ostream << "ResumeAccepted{" << std::endl;
+    ostream << "type=" << fourinarow::convertMessageType(resumeAccepted.getType()) << ',' << std::endl;
+    ostream << "nonce=" << std::endl << fourinarow::dumpVector(resumeAccepted.getNonce());
+    ostream << "cipherSuite=" << fourinarow::convertCipherSuite(resumeAccepted.getCipherSuite()) << std::endl;
+    ostream << '}';
+    return ostream;
+}
@@ -0,0 +1,42 @@
+#ifndef INC_4INAROW_RESUMEACCEPTED_H
+#define INC_4INAROW_RESUMEACCEPTED_H
+
+#include <ostream>
+#include <Constants.h>
+#include "Message.h"
+
+namespace fourinarow {
+
+/**
+ * Class representing a <code>RESUME_ACCEPTED</code> message, sent by the server
+ * in response to a <code>RESUME_HELLO</code> carrying a valid ticket. The message carries
+ * the cipher suite of the resumed session, the same of the session the ticket was issued in.
+ */
+class ResumeAccepted : public Message {
+    private:
+        uint8_t type = RESUME_ACCEPTED;
+        std::vector<unsigned char> nonce;
+        uint8_t cipherSuite = 0;
+    public:
+        ResumeAccepted() = default;
+        ResumeAccepted(std::vector<unsigned char> nonce, uint8_t cipherSuite);
+        ~ResumeAccepted() override = default;
+
+        ResumeAccepted(ResumeAccepted&&) = default;
+        ResumeAccepted(const ResumeAccepted&) = default;
+        ResumeAccepted& operator=(const ResumeAccepted&) = default;
+        ResumeAccepted& operator=(ResumeAccepted&&) = default;
+
+        uint8_t getType() const;
+        const std::vector<unsigned char>& getNonce() const;
+        uint8_t getCipherSuite() const;
+
+        std::vector<unsigned char> serialize() const override;
+        void deserialize(const std::vector<unsigned char> &message) override;
+};
+
+}
+
+std::ostream& operator<<(std::ostream &ostream, const fourinarow::ResumeAccepted &resumeAccepted);
+
+#endif //INC_4INAROW_RESUMEACCEPTED_H
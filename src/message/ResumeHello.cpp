@@ -0,0 +1,109 @@
+#include <string.h>
+#include <SerializationException.h>
+#include <Utils.h>
+#include "ResumeHello.h"
+
+namespace fourinarow {
+
+ResumeHello::ResumeHello(std::string username, std::vector<unsigned char> nonce, std::vector<unsigned char> ticket)
+: username(std::move(username)), nonce(std::move(nonce)), ticket(std::move(ticket)) {}
+
+uint8_t ResumeHello::getType() const {
+    return type;
+}
+
+const std::string& ResumeHello::getUsername() const {
+    return username;
+}
+
+const std::vector<unsigned char>& ResumeHello::getNonce() const {
+    return nonce;
+}
+
+const std::vector<unsigned char>& ResumeHello::getTicket() const {
+    return ticket;
+}
+
+std::vector<unsigned char> ResumeHello::serialize() const {
+    checkUsernameValidity<SerializationException>(username);
+    checkNonceSize<SerializationException>(nonce);
+    checkSessionTicketSize<SerializationException>(ticket);
+
+    size_t processedBytes = 0;
+    size_t outputSize = sizeof(type) + sizeof(MAX_USERNAME_SIZE) + username.size() + nonce.size() + ticket.size();
+    std::vector<unsigned char> message(outputSize);
+
+    // Serialize the type.
+    memcpy(message.data(), &type, sizeof(type));
+    processedBytes += sizeof(type);
+
+    // Serialize the username and its length.
+    uint8_t usernameLength = username.size();
+    memcpy(message.data() + processedBytes, &usernameLength, sizeof(usernameLength));
+    processedBytes += sizeof(usernameLength);
+
+    memcpy(message.data() + processedBytes, username.data(), username.size());
+    processedBytes += username.size();
+
+    // Serialize the nonce.
+    memcpy(message.data() + processedBytes, nonce.data(), nonce.size());
+    processedBytes += nonce.size();
+
+    // Serialize the ticket.
+    memcpy(message.data() + processedBytes, ticket.data(), ticket.size());
+
+    return message;
+}
+
+void ResumeHello::deserialize(const std::vector<unsigned char> &message) {
+    size_t processedBytes = 0;
+
+    // Check if the type matches the expected one.
+    uint8_t receivedType;
+    checkIfEnoughSpace(message, processedBytes, sizeof(receivedType));
+    memcpy(&receivedType, message.data(), sizeof(receivedType));
+    processedBytes += sizeof(receivedType);
+
+    if (receivedType != RESUME_HELLO) {
+        throw SerializationException("Malformed message");
+    }
+
+    // Deserialize the username and its length.
+    uint8_t usernameLength;
+    checkIfEnoughSpace(message, processedBytes, sizeof(usernameLength));
+    memcpy(&usernameLength, message.data() + processedBytes, sizeof(usernameLength));
+    processedBytes += sizeof(usernameLength);
+
+    if (usernameLength == 0) {
+        throw SerializationException("Malformed message");
+    }
+
+    checkIfEnoughSpace(message, processedBytes, usernameLength);
+    username.resize(usernameLength);
+    memcpy(&username[0], message.data() + processedBytes, usernameLength);
+    checkUsernameValidity<SerializationException>(username);
+    processedBytes += usernameLength;
+
+    // Deserialize the nonce.
+    checkIfEnoughSpace(message, processedBytes, NONCE_SIZE);
+    nonce.resize(NONCE_SIZE);
+    memcpy(nonce.data(), message.data() + processedBytes, NONCE_SIZE);
+    processedBytes += NONCE_SIZE;
+
+    // Deserialize the ticket.
+    checkIfEnoughSpace(message, processedBytes, SESSION_TICKET_SIZE);
+    ticket.resize(SESSION_TICKET_SIZE);
+    memcpy(ticket.data(), message.data() + processedBytes, SESSION_TICKET_SIZE);
+}
+
+}
+
+std::ostream& operator<<(std::ostream &ostream, const fourinarow::ResumeHello &resumeHello) {
+    ostream << "ResumeHello{" << std::endl;
+    ostream << "type=" << fourinarow::convertMessageType(resumeHello.getType()) << ',' << std::endl;
+    ostream << "username=" << resumeHello.getUsername() << ',' << std::endl;
+    ostream << "nonce=" << std::endl << fourinarow::dumpVector(resumeHello.getNonce()) << ',' << std::endl;
+    ostream << "ticket=" << std::endl << fourinarow::dumpVector(resumeHello.getTicket());
+    ostream << '}';
+    return ostream;
+}
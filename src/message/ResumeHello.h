@@ -0,0 +1,44 @@
+#ifndef INC_4INAROW_RESUMEHELLO_H
+#define INC_4INAROW_RESUMEHELLO_H
+
+#include <ostream>
+#include <string>
+#include <Constants.h>
+#include "Message.h"
+
+namespace fourinarow {
+
+/**
+ * Class representing a <code>RESUME_HELLO</code> message, sent in place of a <code>CLIENT_HELLO</code>
+ * to resume a previous session with a ticket issued by the server.
+ */
+class ResumeHello : public Message {
+    private:
+        uint8_t type = RESUME_HELLO;
+        std::string username;
+        std::vector<unsigned char> nonce;
+        std::vector<unsigned char> ticket;
+    public:
+        ResumeHello() = default;
+        ResumeHello(std::string username, std::vector<unsigned char> nonce, std::vector<unsigned char> ticket);
+        ~ResumeHello() override = default;
+
+        ResumeHello(ResumeHello&&) = default;
+        ResumeHello(const ResumeHello&) = default;
+        ResumeHello& operator=(const ResumeHello&) = default;
+        ResumeHello& operator=(ResumeHello&&) = default;
+
+        uint8_t getType() const;
+        const std::string& getUsername() const;
+        const std::vector<unsigned char>& getNonce() const;
+        const std::vector<unsigned char>& getTicket() const;
+
+        std::vector<unsigned char> serialize() const override;
+        void deserialize(const std::vector<unsigned char> &message) override;
+};
+
+}
+
+std::ostream& operator<<(std::ostream &ostream, const fourinarow::ResumeHello &resumeHello);
+
+#endif //INC_4INAROW_RESUMEHELLO_H
@@ -9,21 +9,30 @@ namespace fourinarow {
 ServerHello::ServerHello(std::vector<unsigned char> certificate,
                          std::vector<unsigned char> nonce,
                          std::vector<unsigned char> publicKey,
+                         uint8_t cipherSuite,
+                         std::vector<unsigned char> delegatedCredential,
                          std::vector<unsigned char> digitalSignature)
     : certificate(std::move(certificate)),
       nonce(std::move(nonce)),
       publicKey(std::move(publicKey)),
+      cipherSuite(cipherSuite),
+      delegatedCredential(std::move(delegatedCredential)),
       digitalSignature(std::move(digitalSignature)) {}
 
 std::vector<unsigned char> ServerHello::serialize() const {
-    checkCertificateSize<SerializationException>(certificate);
+    if (!certificate.empty()) {
+        checkCertificateSize<SerializationException>(certificate);
+    }
     checkNonceSize<SerializationException>(nonce);
     checkEcdhPublicKeySize<SerializationException>(publicKey);
+    checkDelegatedCredentialSize<SerializationException>(delegatedCredential);
     checkDigitalSignatureSize<SerializationException>(digitalSignature);
 
     size_t processedBytes = 0;
     size_t outputSize = sizeof(type) + sizeof(MAX_CERTIFICATE_SIZE) + certificate.size() +
-                        nonce.size() + publicKey.size() + digitalSignature.size();
+                        nonce.size() + sizeof(MAX_ECDH_PUBLIC_KEY_SIZE) + publicKey.size() + sizeof(cipherSuite) +
+                        sizeof(MAX_DELEGATED_CREDENTIAL_SIZE) + delegatedCredential.size() +
+                        sizeof(MAX_DIGITAL_SIGNATURE_SIZE) + digitalSignature.size();
     std::vector<unsigned char> message(outputSize);
 
     // Serialize the type.
@@ -42,11 +51,31 @@ std::vector<unsigned char> ServerHello::serialize() const {
     memcpy(message.data() + processedBytes, nonce.data(), nonce.size());
     processedBytes += nonce.size();
 
-    // Serialize the public key.
+    // Serialize the public key and its length.
+    uint8_t publicKeyLength = publicKey.size();
+    memcpy(message.data() + processedBytes, &publicKeyLength, sizeof(publicKeyLength));
+    processedBytes += sizeof(publicKeyLength);
+
     memcpy(message.data() + processedBytes, publicKey.data(), publicKey.size());
     processedBytes += publicKey.size();
 
-    // Serialize the digital signature.
+    // Serialize the cipher suite.
+    memcpy(message.data() + processedBytes, &cipherSuite, sizeof(cipherSuite));
+    processedBytes += sizeof(cipherSuite);
+
+    // Serialize the delegated credential and its length.
+    uint16_t credentialLength = htons(delegatedCredential.size());
+    memcpy(message.data() + processedBytes, &credentialLength, sizeof(credentialLength));
+    processedBytes += sizeof(credentialLength);
+
+    memcpy(message.data() + processedBytes, delegatedCredential.data(), delegatedCredential.size());
+    processedBytes += delegatedCredential.size();
+
+    // Serialize the digital signature and its length.
+    uint16_t signatureLength = htons(digitalSignature.size());
+    memcpy(message.data() + processedBytes, &signatureLength, sizeof(signatureLength));
+    processedBytes += sizeof(signatureLength);
+
     memcpy(message.data() + processedBytes, digitalSignature.data(), digitalSignature.size());
 
     return message;
@@ -65,21 +94,19 @@ void ServerHello::deserialize(const std::vector<unsigned char> &message) {
         throw SerializationException("Malformed message");
     }
 
-    // Deserialize the certificate and its length.
+    // Deserialize the certificate and its length. An empty certificate is allowed.
     uint16_t certificateLength;
     checkIfEnoughSpace(message, processedBytes, sizeof(certificateLength));
     memcpy(&certificateLength, message.data() + processedBytes, sizeof(certificateLength));
     certificateLength = ntohs(certificateLength);
     processedBytes += sizeof(certificateLength);
 
-    if (certificateLength == 0) {
-        throw SerializationException("Malformed message");
-    }
-
     checkIfEnoughSpace(message, processedBytes, certificateLength);
     certificate.resize(certificateLength);
     memcpy(certificate.data(), message.data() + processedBytes, certificateLength);
-    checkCertificateSize<SerializationException>(certificate);
+    if (!certificate.empty()) {
+        checkCertificateSize<SerializationException>(certificate);
+    }
     processedBytes += certificateLength;
 
     // Deserialize the nonce.
@@ -88,16 +115,47 @@ void ServerHello::deserialize(const std::vector<unsigned char> &message) {
     memcpy(nonce.data(), message.data() + processedBytes, NONCE_SIZE);
     processedBytes += NONCE_SIZE;
 
-    // Deserialize the public key.
-    checkIfEnoughSpace(message, processedBytes, ECDH_PUBLIC_KEY_SIZE);
-    publicKey.resize(ECDH_PUBLIC_KEY_SIZE);
-    memcpy(publicKey.data(), message.data() + processedBytes, ECDH_PUBLIC_KEY_SIZE);
-    processedBytes += ECDH_PUBLIC_KEY_SIZE;
+    // Deserialize the public key and its length.
+    uint8_t publicKeyLength;
+    checkIfEnoughSpace(message, processedBytes, sizeof(publicKeyLength));
+    memcpy(&publicKeyLength, message.data() + processedBytes, sizeof(publicKeyLength));
+    processedBytes += sizeof(publicKeyLength);
 
-    // Deserialize the digital signature.
-    checkIfEnoughSpace(message, processedBytes, DIGITAL_SIGNATURE_SIZE);
-    digitalSignature.resize(DIGITAL_SIGNATURE_SIZE);
-    memcpy(digitalSignature.data(), message.data() + processedBytes, DIGITAL_SIGNATURE_SIZE);
+    checkIfEnoughSpace(message, processedBytes, publicKeyLength);
+    publicKey.resize(publicKeyLength);
+    memcpy(publicKey.data(), message.data() + processedBytes, publicKeyLength);
+    checkEcdhPublicKeySize<SerializationException>(publicKey);
+    processedBytes += publicKeyLength;
+
+    // Deserialize the cipher suite.
+    checkIfEnoughSpace(message, processedBytes, sizeof(cipherSuite));
+    memcpy(&cipherSuite, message.data() + processedBytes, sizeof(cipherSuite));
+    processedBytes += sizeof(cipherSuite);
+
+    // Deserialize the delegated credential and its length. An empty credential is allowed.
+    uint16_t credentialLength;
+    checkIfEnoughSpace(message, processedBytes, sizeof(credentialLength));
+    memcpy(&credentialLength, message.data() + processedBytes, sizeof(credentialLength));
+    credentialLength = ntohs(credentialLength);
+    processedBytes += sizeof(credentialLength);
+
+    checkIfEnoughSpace(message, processedBytes, credentialLength);
+    delegatedCredential.resize(credentialLength);
+    memcpy(delegatedCredential.data(), message.data() + processedBytes, credentialLength);
+    checkDelegatedCredentialSize<SerializationException>(delegatedCredential);
+    processedBytes += credentialLength;
+
+    // Deserialize the digital signature and its length.
+    uint16_t signatureLength;
+    checkIfEnoughSpace(message, processedBytes, sizeof(signatureLength));
+    memcpy(&signatureLength, message.data() + processedBytes, sizeof(signatureLength));
+    signatureLength = ntohs(signatureLength);
+    processedBytes += sizeof(signatureLength);
+
+    checkIfEnoughSpace(message, processedBytes, signatureLength);
+    digitalSignature.resize(signatureLength);
+    memcpy(digitalSignature.data(), message.data() + processedBytes, signatureLength);
+    checkDigitalSignatureSize<SerializationException>(digitalSignature);
 }
 
 uint8_t ServerHello::getType() const {
@@ -116,6 +174,14 @@ const std::vector<unsigned char>& ServerHello::getPublicKey() const {
     return publicKey;
 }
 
+uint8_t ServerHello::getCipherSuite() const {
+    return cipherSuite;
+}
+
+const std::vector<unsigned char>& ServerHello::getDelegatedCredential() const {
+    return delegatedCredential;
+}
+
 const std::vector<unsigned char>& ServerHello::getDigitalSignature() const {
     return digitalSignature;
 }
@@ -128,6 +194,8 @@ std::ostream& operator<<(std::ostream &ostream, const fourinarow::ServerHello &s
     ostream << "certificate=" << std::endl << fourinarow::dumpVector(serverHello.getCertificate());
     ostream << "nonce=" << std::endl << fourinarow::dumpVector(serverHello.getNonce());
     ostream << "publicKey=" << std::endl << fourinarow::dumpVector(serverHello.getPublicKey());
+    ostream << "cipherSuite=" << fourinarow::convertCipherSuite(serverHello.getCipherSuite()) << ',' << std::endl;
+    ostream << "delegatedCredential=" << std::endl << fourinarow::dumpVector(serverHello.getDelegatedCredential());
     ostream << "digitalSignature=" << std::endl << fourinarow::dumpVector(serverHello.getDigitalSignature());
     ostream << '}';
     return ostream;
@@ -8,7 +8,10 @@
 namespace fourinarow {
 
 /**
- * Class representing a <code>SERVER_HELLO</code> message.
+ * Class representing a <code>SERVER_HELLO</code> message. The digital signature is made either
+ * by the key of the certificate, if the delegated credential is empty, or by the delegated key
+ * bound to the certificate by the credential. The message carries the cipher suite chosen by the server.
+ * The certificate is empty if the client announced a cached copy of it in the <code>CLIENT_HELLO</code>.
  */
 class ServerHello : public Message {
     private:
@@ -16,12 +19,16 @@ class ServerHello : public Message {
         std::vector<unsigned char> certificate;
         std::vector<unsigned char> nonce;
         std::vector<unsigned char> publicKey;
+        uint8_t cipherSuite = 0;
+        std::vector<unsigned char> delegatedCredential;
         std::vector<unsigned char> digitalSignature;
     public:
         ServerHello() = default;
         ServerHello(std::vector<unsigned char> certificate,
                     std::vector<unsigned char> nonce,
                     std::vector<unsigned char> publicKey,
+                    uint8_t cipherSuite,
+                    std::vector<unsigned char> delegatedCredential,
                     std::vector<unsigned char> digitalSignature);
         ~ServerHello() override = default;
 
@@ -34,6 +41,8 @@ class ServerHello : public Message {
         const std::vector<unsigned char>& getCertificate() const;
         const std::vector<unsigned char>& getNonce() const;
         const std::vector<unsigned char>& getPublicKey() const;
+        uint8_t getCipherSuite() const;
+        const std::vector<unsigned char>& getDelegatedCredential() const;
         const std::vector<unsigned char>& getDigitalSignature() const;
 
         std::vector<unsigned char> serialize() const override;
@@ -0,0 +1,59 @@
+#include <string.h>
+#include <SerializationException.h>
+#include <Utils.h>
+#include "SessionTicket.h"
+
+namespace fourinarow {
+
+SessionTicket::SessionTicket(std::vector<unsigned char> ticket) : ticket(std::move(ticket)) {}
+
+uint8_t SessionTicket::getType() const {
+    return type;
+}
+
+const std::vector<unsigned char>& SessionTicket::getTicket() const {
+    return ticket;
+}
+
+std::vector<unsigned char> SessionTicket::serialize() const {
+    checkSessionTicketSize<SerializationException>(ticket);
+
+    std::vector<unsigned char> message(sizeof(type) + ticket.size());
+
+    // Serialize the type.
+    memcpy(message.data(), &type, sizeof(type));
+
+    // Serialize the ticket.
+    memcpy(message.data() + sizeof(type), ticket.data(), ticket.size());
+
+    return message;
+}
+
+void SessionTicket::deserialize(const std::vector<unsigned char> &message) {
+    size_t processedBytes = 0;
+
+    // Check if the type matches the expected one.
+    uint8_t receivedType;
+    checkIfEnoughSpace(message, processedBytes, sizeof(receivedType));
+    memcpy(&receivedType, message.data(), sizeof(receivedType));
+    processedBytes += sizeof(receivedType);
+
+    if (receivedType != SESSION_TICKET) {
+        throw SerializationException("Malformed message");
+    }
+
+    // Deserialize the ticket.
+    checkIfEnoughSpace(message, processedBytes, SESSION_TICKET_SIZE);
+    ticket.resize(SESSION_TICKET_SIZE);
+    memcpy(ticket.data(), message.data() + processedBytes, SESSION_TICKET_SIZE);
+}
+
+}
+
+std::ostream& operator<<(std::ostream &ostream, const fourinarow::SessionTicket &sessionTicket) {
+    ostream << "SessionTicket{" << std::endl;
+    ostream << "type=" << fourinarow::convertMessageType(sessionTicket.getType()) << ',' << std::endl;
+    ostream << "ticket=" << std::endl << fourinarow::dumpVector(sessionTicket.getTicket());
+    ostream << '}';
+    return ostream;
+}
@@ -0,0 +1,39 @@
+#ifndef INC_4INAROW_SESSIONTICKET_H
+#define INC_4INAROW_SESSIONTICKET_H
+
+#include <ostream>
+#include <Constants.h>
+#include "Message.h"
+
+namespace fourinarow {
+
+/**
+ * Class representing a <code>SESSION_TICKET</code> message, carrying the opaque ticket
+ * the client can later present in a <code>RESUME_HELLO</code> to resume the session.
+ */
+class SessionTicket : public Message {
+    private:
+        uint8_t type = SESSION_TICKET;
+        std::vector<unsigned char> ticket;
+    public:
+        SessionTicket() = default;
+        explicit SessionTicket(std::vector<unsigned char> ticket);
+        ~SessionTicket() override = default;
+
+        SessionTicket(SessionTicket&&) = default;
+        SessionTicket(const SessionTicket&) = default;
+        SessionTicket& operator=(const SessionTicket&) = default;
+        SessionTicket& operator=(SessionTicket&&) = default;
+
+        uint8_t getType() const;
+        const std::vector<unsigned char>& getTicket() const;
+
+        std::vector<unsigned char> serialize() const override;
+        void deserialize(const std::vector<unsigned char> &message) override;
+};
+
+}
+
+std::ostream& operator<<(std::ostream &ostream, const fourinarow::SessionTicket &sessionTicket);
+
+#endif //INC_4INAROW_SESSIONTICKET_H
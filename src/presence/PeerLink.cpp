@@ -0,0 +1,26 @@
+#include <stdexcept>
+#include "PeerLink.h"
+
+namespace fourinarow {
+
+PeerLink::PeerLink(TcpSocket socket) : socket(std::move(socket)), session(nullptr) {}
+
+PeerLink::PeerLink(TcpSocket socket, Player session)
+: socket(std::move(socket)), session(std::make_unique<Player>(std::move(session))) {}
+
+const TcpSocket& PeerLink::getSocket() const {
+    return socket;
+}
+
+bool PeerLink::isEncrypted() const {
+    return session != nullptr;
+}
+
+Player& PeerLink::getSession() const {
+    if (session == nullptr) {
+        throw std::runtime_error("The link is not encrypted");
+    }
+    return *session;
+}
+
+}
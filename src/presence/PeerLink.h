@@ -0,0 +1,59 @@
+#ifndef INC_4INAROW_PEERLINK_H
+#define INC_4INAROW_PEERLINK_H
+
+#include <memory>
+#include <TcpSocket.h>
+#include <Player.h>
+
+namespace fourinarow {
+
+/**
+ * Class representing a link to another process or cluster node of the server.
+ * The processes of a group are linked by local sockets created before forking them, which carry
+ * the messages in cleartext. The nodes of a cluster are linked through the network: the links are
+ * authenticated by a handshake signed with the key of the server certificate, and the messages
+ * are encrypted with the session established by the handshake, held by a player object.
+ */
+class PeerLink {
+    private:
+        TcpSocket socket;
+        std::unique_ptr<Player> session;  // Null if the messages are exchanged in cleartext.
+    public:
+        /**
+         * Creates a link exchanging the messages in cleartext.
+         * @param socket  the connected socket.
+         */
+        explicit PeerLink(TcpSocket socket);
+
+        /**
+         * Creates a link protecting the messages with the given session.
+         * @param socket   the connected socket.
+         * @param session  the player object holding the cipher and the sequence numbers of the session.
+         */
+        PeerLink(TcpSocket socket, Player session);
+
+        ~PeerLink() = default;
+        PeerLink(PeerLink&&) = default;
+        PeerLink& operator=(PeerLink&&) = default;
+        PeerLink(const PeerLink&) = delete;
+        PeerLink& operator=(const PeerLink&) = delete;
+
+        const TcpSocket& getSocket() const;
+
+        /**
+         * Checks if the messages are protected by a session.
+         * @return  true if the messages are encrypted, false if they are exchanged in cleartext.
+         */
+        bool isEncrypted() const;
+
+        /**
+         * Returns the session protecting the messages.
+         * @return  the player object holding the session.
+         * @throws runtime_error  if the link exchanges the messages in cleartext.
+         */
+        Player& getSession() const;
+};
+
+}
+
+#endif //INC_4INAROW_PEERLINK_H
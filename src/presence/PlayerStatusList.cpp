@@ -0,0 +1,162 @@
+#include <stdexcept>
+#include "PlayerStatusList.h"
+
+namespace fourinarow {
+
+PlayerStatusList::PlayerStatusList() : presenceTable(nullptr), owner(0), recordingChanges(false) {}
+
+PlayerStatusList::PlayerStatusList(PresenceTable &presenceTable, unsigned int owner, bool recordingChanges)
+: presenceTable(&presenceTable), owner(owner), recordingChanges(recordingChanges) {}
+
+void PlayerStatusList::recordChange(const std::string &username) {
+    if (recordingChanges) {
+        changes.insert(username);
+    }
+}
+
+unsigned int PlayerStatusList::getOwner() const {
+    return owner;
+}
+
+bool PlayerStatusList::contains(const std::string &username) const {
+    return statuses.count(username) != 0;
+}
+
+bool PlayerStatusList::isConnected(const std::string &username) const {
+    PresenceTable::Entry entry;
+    return contains(username) || (presenceTable != nullptr && presenceTable->find(username, entry));
+}
+
+bool PlayerStatusList::find(const std::string &username, PresenceTable::Entry &entry) const {
+    return presenceTable != nullptr && presenceTable->find(username, entry);
+}
+
+bool PlayerStatusList::findRemote(const std::string &username, PresenceTable::Entry &entry) const {
+    return !contains(username) && find(username, entry) && entry.owner != owner;
+}
+
+Player::Status PlayerStatusList::get(const std::string &username) const {
+    auto iterator = statuses.find(username);
+    if (iterator == statuses.end()) {
+        throw std::runtime_error("Player not found");
+    }
+    return iterator->second;
+}
+
+bool PlayerStatusList::add(const std::string &username, const std::string &address, Player::Status status) {
+    if (contains(username)) {
+        return false;
+    }
+
+    if (presenceTable != nullptr && !presenceTable->insert(username, address, owner, status)) {
+        return false;
+    }
+
+    statuses[username] = status;
+    recordChange(username);
+    return true;
+}
+
+void PlayerStatusList::set(const std::string &username, Player::Status status) {
+    auto iterator = statuses.find(username);
+    if (iterator == statuses.end()) {
+        throw std::runtime_error("Player not found");
+    }
+
+    iterator->second = status;
+    recordChange(username);
+    if (presenceTable != nullptr) {
+        presenceTable->update(username, owner, status);
+    }
+}
+
+void PlayerStatusList::erase(const std::string &username) {
+    if (statuses.erase(username) == 0) {
+        return;
+    }
+
+    recordChange(username);
+    if (presenceTable != nullptr) {
+        presenceTable->erase(username, owner);
+    }
+}
+
+bool PlayerStatusList::addRemote(const std::string &username,
+                                 const std::string &address,
+                                 unsigned int node,
+                                 Player::Status status) {
+    if (presenceTable == nullptr) {
+        throw std::runtime_error("No presence table");
+    }
+
+    if (node == owner || contains(username)) {
+        return false;
+    }
+
+    if (presenceTable->insert(username, address, node, status)) {
+        return true;
+    }
+
+    // The player may have reconnected to the node from another address since the last update.
+    PresenceTable::Entry entry;
+    if (!presenceTable->find(username, entry) || entry.owner != node) {
+        return false;
+    }
+
+    if (entry.address != address) {
+        presenceTable->erase(username, node);
+        return presenceTable->insert(username, address, node, status);
+    }
+    return presenceTable->update(username, node, status);
+}
+
+void PlayerStatusList::eraseRemote(const std::string &username, unsigned int node) {
+    if (presenceTable != nullptr && node != owner) {
+        presenceTable->erase(username, node);
+    }
+}
+
+size_t PlayerStatusList::eraseRemoteOwner(unsigned int peer) {
+    if (presenceTable == nullptr || peer == owner) {
+        return 0;
+    }
+    return presenceTable->eraseOwner(peer);
+}
+
+std::vector<std::string> PlayerStatusList::takeChanges() {
+    std::vector<std::string> changedPlayers(changes.begin(), changes.end());
+    changes.clear();
+    return changedPlayers;
+}
+
+std::string PlayerStatusList::listAvailable(const std::string &excludedUsername) const {
+    if (presenceTable != nullptr) {
+        return presenceTable->listAvailable(excludedUsername);
+    }
+
+    std::string players;
+    for (const auto &iterator : statuses) {
+        if (iterator.first != excludedUsername && iterator.second == Player::Status::AVAILABLE) {
+            players += (iterator.first + ';');
+        }
+    }
+    return players;
+}
+
+size_t PlayerStatusList::size() const {
+    return statuses.size();
+}
+
+bool PlayerStatusList::empty() const {
+    return statuses.empty();
+}
+
+PlayerStatusList::const_iterator PlayerStatusList::begin() const {
+    return statuses.begin();
+}
+
+PlayerStatusList::const_iterator PlayerStatusList::end() const {
+    return statuses.end();
+}
+
+}
@@ -0,0 +1,177 @@
+#ifndef INC_4INAROW_PLAYERSTATUSLIST_H
+#define INC_4INAROW_PLAYERSTATUSLIST_H
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <Player.h>
+#include "PresenceTable.h"
+
+namespace fourinarow {
+
+/**
+ * Class representing the status of the players connected to a server process.
+ * If the process belongs to a group sharing a presence table, every change is mirrored
+ * in the table, so that the players connected to the other processes can be listed and challenged.
+ * If the process is a node of a cluster, the table is private to the node: the changes of the local
+ * players are recorded, to be sent to the other nodes, and the players of the other nodes are
+ * added to the table as their updates are received.
+ * The statuses of the local players are always read from the private list, without locking the table.
+ */
+class PlayerStatusList {
+    public:
+        using const_iterator = std::unordered_map<std::string, Player::Status>::const_iterator;
+    private:
+        std::unordered_map<std::string, Player::Status> statuses;
+        PresenceTable *presenceTable;
+        unsigned int owner;
+        bool recordingChanges;
+        std::unordered_set<std::string> changes;  // Local players changed since the last takeChanges().
+
+        /**
+         * Records a change of a local player, if the changes are recorded.
+         * @param username  the username of the player.
+         */
+        void recordChange(const std::string &username);
+    public:
+        /**
+         * Creates the list of a server running as a single process.
+         */
+        PlayerStatusList();
+
+        /**
+         * Creates the list of a server process belonging to a group, or of a node of a cluster.
+         * @param presenceTable     the presence table shared by the group, or private to the node.
+         * @param owner             the index of the process in the group, or of the node in the cluster.
+         * @param recordingChanges  true if the changes of the local players must be recorded, false otherwise.
+         */
+        PlayerStatusList(PresenceTable &presenceTable, unsigned int owner, bool recordingChanges = false);
+
+        ~PlayerStatusList() = default;
+        PlayerStatusList(const PlayerStatusList&) = delete;
+        PlayerStatusList(PlayerStatusList&&) = default;
+        PlayerStatusList& operator=(const PlayerStatusList&) = delete;
+        PlayerStatusList& operator=(PlayerStatusList&&) = default;
+
+        /**
+         * Returns the index of the process or node owning the list. It is zero if the server runs as a single process.
+         * @return  the index of the process or node.
+         */
+        unsigned int getOwner() const;
+
+        /**
+         * Checks if a player is connected to this process.
+         * @param username  the username of the player.
+         * @return          true if the player is connected to this process, false otherwise.
+         */
+        bool contains(const std::string &username) const;
+
+        /**
+         * Checks if a player is connected to this process or to any other process or node.
+         * @param username  the username of the player.
+         * @return          true if the player is connected, false otherwise.
+         */
+        bool isConnected(const std::string &username) const;
+
+        /**
+         * Finds a player in the presence table, regardless of the process or node it is connected to.
+         * @param username  the username of the player.
+         * @param entry     the variable that will store the entry of the player, if found.
+         * @return          true if the player is in the table, false otherwise.
+         */
+        bool find(const std::string &username, PresenceTable::Entry &entry) const;
+
+        /**
+         * Finds a player connected to another process or node.
+         * @param username  the username of the player.
+         * @param entry     the variable that will store the entry of the player, if found.
+         * @return          true if the player is connected to another process or node, false otherwise.
+         */
+        bool findRemote(const std::string &username, PresenceTable::Entry &entry) const;
+
+        /**
+         * Returns the status of a player connected to this process.
+         * @param username  the username of the player.
+         * @return          the status of the player.
+         * @throws runtime_error  if the player is not connected to this process.
+         */
+        Player::Status get(const std::string &username) const;
+
+        /**
+         * Adds a player connected to this process.
+         * @param username  the username of the player.
+         * @param address   the IPv4 address of the player.
+         * @param status    the status of the player.
+         * @return          true if the player has been added, false if it is already connected
+         *                  to this process or to another process or node.
+         * @throws runtime_error  if the presence table is full.
+         */
+        bool add(const std::string &username, const std::string &address, Player::Status status);
+
+        /**
+         * Changes the status of a player connected to this process.
+         * @param username  the username of the player.
+         * @param status    the new status.
+         * @throws runtime_error  if the player is not connected to this process.
+         */
+        void set(const std::string &username, Player::Status status);
+
+        /**
+         * Removes a player connected to this process. Nothing happens if the player is not in the list.
+         * @param username  the username of the player.
+         */
+        void erase(const std::string &username);
+
+        /**
+         * Adds or updates a player connected to another node of the cluster.
+         * @param username  the username of the player.
+         * @param address   the IPv4 address of the player.
+         * @param node      the index of the node.
+         * @param status    the status of the player.
+         * @return          true if the player has been added or updated, false if it is already
+         *                  connected to this node or to a different one.
+         * @throws runtime_error  if the presence table is full, or the list has no presence table.
+         */
+        bool addRemote(const std::string &username, const std::string &address, unsigned int node, Player::Status status);
+
+        /**
+         * Removes a player connected to another node of the cluster. Nothing happens
+         * if the player is not connected to the given node.
+         * @param username  the username of the player.
+         * @param node      the index of the node.
+         */
+        void eraseRemote(const std::string &username, unsigned int node);
+
+        /**
+         * Removes all the players connected to another process or node, when it terminates or its link is lost.
+         * @param peer  the index of the process or node.
+         * @return      the number of removed players.
+         */
+        size_t eraseRemoteOwner(unsigned int peer);
+
+        /**
+         * Returns the local players added, changed or removed since the last call, and forgets them.
+         * The result is empty if the changes are not recorded.
+         * @return  the usernames of the changed players.
+         */
+        std::vector<std::string> takeChanges();
+
+        /**
+         * Generates a string containing the list of players in the <code>AVAILABLE</code> status,
+         * connected to this process or to any other process or node.
+         * The string has format <code>"PLAYER1;PLAYER2;....;PLAYERn"</code>.
+         * @param excludedUsername  the username of the player that will receive the list.
+         * @return                  the list of available players. It can be empty.
+         */
+        std::string listAvailable(const std::string &excludedUsername) const;
+
+        size_t size() const;
+        bool empty() const;
+        const_iterator begin() const;
+        const_iterator end() const;
+};
+
+}
+
+#endif //INC_4INAROW_PLAYERSTATUSLIST_H
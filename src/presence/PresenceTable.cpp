@@ -0,0 +1,319 @@
+#include <errno.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <stdexcept>
+#include <Constants.h>
+#include "PresenceTable.h"
+
+namespace fourinarow {
+
+struct PresenceTable::Header {
+    pthread_mutex_t mutex;
+    size_t size;
+};
+
+struct PresenceTable::Record {
+    uint32_t hash;
+    uint32_t owner;
+    uint8_t status;
+    uint8_t usernameLength;
+    uint8_t addressLength;
+    char username[UINT8_MAX];  // Enough for any username, whose size fits a uint8_t.
+    char address[16];          // Checked against MAX_IPV4_ADDRESS_SIZE when creating the table.
+};
+
+PresenceTable::Lock::Lock(const PresenceTable &table) : header(*table.header) {
+    auto result = pthread_mutex_lock(&header.mutex);
+
+    /*
+     * The previous owner died holding the mutex, possibly in the middle of an update: the index is
+     * rebuilt before the mutex is marked consistent. The entries it owns are purged by the caller
+     * of eraseOwner().
+     */
+    if (result == EOWNERDEAD) {
+        table.rebuildIndex();
+        result = pthread_mutex_consistent(&header.mutex);
+    }
+
+    if (result != 0) {
+        throw std::runtime_error("Impossible to lock the presence table: " + std::string(strerror(result)));
+    }
+}
+
+PresenceTable::Lock::~Lock() {
+    pthread_mutex_unlock(&header.mutex);
+}
+
+PresenceTable::PresenceTable(size_t capacity) : capacity(capacity) {
+    if (capacity == 0 || capacity > UINT32_MAX / 2) {
+        throw std::runtime_error("Invalid capacity of the presence table");
+    }
+
+    if (MAX_IPV4_ADDRESS_SIZE > sizeof(Record::address)) {
+        throw std::runtime_error("The records of the presence table cannot hold a player");
+    }
+
+    // The index is kept at most half full, so that the probe sequences stay short.
+    size_t indexSize = 1;
+    while (indexSize < 2*capacity) {
+        indexSize *= 2;
+    }
+    indexMask = indexSize - 1;
+
+    auto recordsOffset = (sizeof(Header) + alignof(Record) - 1) / alignof(Record) * alignof(Record);
+    auto indexOffset = recordsOffset + capacity*sizeof(Record);
+    regionSize = indexOffset + indexSize*sizeof(uint32_t);
+
+    // The mapping is anonymous, so it is zeroed: the table is empty and every slot of the index is free.
+    region = mmap(nullptr, regionSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) {
+        throw std::runtime_error("Impossible to map the presence table: " + std::string(strerror(errno)));
+    }
+
+    header = static_cast<Header*>(region);
+    records = reinterpret_cast<Record*>(static_cast<unsigned char*>(region) + recordsOffset);
+    index = reinterpret_cast<uint32_t*>(static_cast<unsigned char*>(region) + indexOffset);
+
+    pthread_mutexattr_t attributes;
+    auto result = pthread_mutexattr_init(&attributes);
+    if (result == 0) {
+        result = pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+    }
+    if (result == 0) {
+        result = pthread_mutexattr_setrobust(&attributes, PTHREAD_MUTEX_ROBUST);
+    }
+    if (result == 0) {
+        result = pthread_mutex_init(&header->mutex, &attributes);
+    }
+    pthread_mutexattr_destroy(&attributes);
+
+    if (result != 0) {
+        munmap(region, regionSize);
+        throw std::runtime_error("Impossible to create the lock of the presence table: " + std::string(strerror(result)));
+    }
+}
+
+PresenceTable::~PresenceTable() {
+    // The mutex is not destroyed, since the other processes may still be using it.
+    munmap(region, regionSize);
+}
+
+uint32_t PresenceTable::hash(const std::string &username) {
+    uint32_t value = 2166136261u;
+    for (auto character : username) {
+        value ^= static_cast<unsigned char>(character);
+        value *= 16777619u;
+    }
+    return value;
+}
+
+size_t PresenceTable::findSlot(const std::string &username, uint32_t usernameHash) const {
+    auto slot = usernameHash & indexMask;
+
+    while (index[slot] != 0) {
+        const auto &record = records[index[slot] - 1];
+        if (record.hash == usernameHash && record.usernameLength == username.size() &&
+            memcmp(record.username, username.data(), username.size()) == 0) {
+            return slot;
+        }
+        slot = (slot + 1) & indexMask;
+    }
+
+    return slot;
+}
+
+void PresenceTable::rebuildIndex() const {
+    memset(index, 0, (indexMask + 1)*sizeof(uint32_t));
+
+    /*
+     * An interrupted insertion may leave a record partially written, and an interrupted erasure
+     * the last record copied over the erased one: such records are dropped, and the hashes recomputed.
+     */
+    auto previousSize = header->size < capacity ? header->size : capacity;
+    size_t size = 0;
+    for (size_t position = 0; position < previousSize; position++) {
+        auto record = records[position];
+        if (record.usernameLength == 0 || record.addressLength > sizeof(Record::address)) {
+            continue;
+        }
+
+        std::string username(record.username, record.usernameLength);
+        record.hash = hash(username);
+        auto slot = findSlot(username, record.hash);
+        if (index[slot] != 0) {
+            continue;
+        }
+
+        records[size] = record;
+        size++;
+        index[slot] = size;
+    }
+
+    memset(&records[size], 0, (previousSize - size)*sizeof(Record));
+    header->size = size;
+}
+
+bool PresenceTable::eraseSlot(size_t slot) {
+    if (index[slot] == 0) {
+        return false;
+    }
+
+    auto position = index[slot] - 1;
+
+    /*
+     * Shift back the following slots of the cluster, until an empty one: a slot is moved into the hole
+     * only if the hole lies between the home slot of its record and the slot itself.
+     */
+    auto hole = slot;
+    auto next = (hole + 1) & indexMask;
+    while (index[next] != 0) {
+        auto home = records[index[next] - 1].hash & indexMask;
+        if (((next - home) & indexMask) >= ((next - hole) & indexMask)) {
+            index[hole] = index[next];
+            hole = next;
+        }
+        next = (next + 1) & indexMask;
+    }
+    index[hole] = 0;
+
+    // Move the last record into the erased one, to keep the records packed.
+    auto last = header->size - 1;
+    if (position != last) {
+        records[position] = records[last];
+        std::string movedUsername(records[position].username, records[position].usernameLength);
+        index[findSlot(movedUsername, records[position].hash)] = position + 1;
+    }
+
+    memset(&records[last], 0, sizeof(Record));
+    header->size--;
+    return true;
+}
+
+bool PresenceTable::insert(const std::string &username,
+                           const std::string &address,
+                           unsigned int owner,
+                           Player::Status status) {
+    if (username.size() > sizeof(Record::username) || address.size() > sizeof(Record::address)) {
+        throw std::runtime_error("The player cannot be stored in the presence table");
+    }
+
+    auto usernameHash = hash(username);
+    Lock lock(*this);
+
+    auto slot = findSlot(username, usernameHash);
+    if (index[slot] != 0) {
+        return false;
+    }
+
+    if (header->size == capacity) {
+        throw std::runtime_error("The presence table is full");
+    }
+
+    auto &record = records[header->size];
+    record.hash = usernameHash;
+    record.owner = owner;
+    record.status = static_cast<uint8_t>(status);
+    record.usernameLength = username.size();
+    memcpy(record.username, username.data(), username.size());
+    record.addressLength = address.size();
+    memcpy(record.address, address.data(), address.size());
+
+    header->size++;
+    index[slot] = header->size;
+    return true;
+}
+
+bool PresenceTable::update(const std::string &username, unsigned int owner, Player::Status status) {
+    auto usernameHash = hash(username);
+    Lock lock(*this);
+
+    auto slot = findSlot(username, usernameHash);
+    if (index[slot] == 0 || records[index[slot] - 1].owner != owner) {
+        return false;
+    }
+
+    records[index[slot] - 1].status = static_cast<uint8_t>(status);
+    return true;
+}
+
+void PresenceTable::erase(const std::string &username, unsigned int owner) {
+    auto usernameHash = hash(username);
+    Lock lock(*this);
+
+    auto slot = findSlot(username, usernameHash);
+    if (index[slot] != 0 && records[index[slot] - 1].owner == owner) {
+        eraseSlot(slot);
+    }
+}
+
+size_t PresenceTable::eraseOwner(unsigned int owner) {
+    Lock lock(*this);
+    size_t erased = 0;
+
+    // An erased record is replaced by the last one, so the position is examined again.
+    size_t position = 0;
+    while (position < header->size) {
+        const auto &record = records[position];
+        if (record.owner != owner) {
+            position++;
+            continue;
+        }
+
+        // A record missing from the index is put back by rebuilding it, which may move the records.
+        std::string username(record.username, record.usernameLength);
+        if (!eraseSlot(findSlot(username, record.hash))) {
+            rebuildIndex();
+            position = 0;
+            continue;
+        }
+        erased++;
+    }
+
+    return erased;
+}
+
+bool PresenceTable::find(const std::string &username, Entry &entry) const {
+    auto usernameHash = hash(username);
+    Lock lock(*this);
+
+    auto slot = findSlot(username, usernameHash);
+    if (index[slot] == 0) {
+        return false;
+    }
+
+    const auto &record = records[index[slot] - 1];
+    entry.owner = record.owner;
+    entry.status = static_cast<Player::Status>(record.status);
+    entry.address.assign(record.address, record.addressLength);
+    return true;
+}
+
+std::string PresenceTable::listAvailable(const std::string &excludedUsername) const {
+    std::string players;
+    Lock lock(*this);
+
+    for (size_t position = 0; position < header->size; position++) {
+        const auto &record = records[position];
+        if (record.status != static_cast<uint8_t>(Player::Status::AVAILABLE)) {
+            continue;
+        }
+
+        if (record.usernameLength == excludedUsername.size() &&
+            memcmp(record.username, excludedUsername.data(), excludedUsername.size()) == 0) {
+            continue;
+        }
+
+        players.append(record.username, record.usernameLength);
+        players += ';';
+    }
+
+    return players;
+}
+
+size_t PresenceTable::getSize() const {
+    Lock lock(*this);
+    return header->size;
+}
+
+}
@@ -0,0 +1,170 @@
+#ifndef INC_4INAROW_PRESENCETABLE_H
+#define INC_4INAROW_PRESENCETABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <Player.h>
+
+namespace fourinarow {
+
+/**
+ * Class representing the table of the players connected to a group of server processes,
+ * stored in shared memory so that every process sees the players of the others.
+ * The table must be created before forking the processes, which then inherit the mapping.
+ * Each entry records the username of a player, the index of the process owning its connection,
+ * its status and its IPv4 address. Only the owner of an entry updates or erases it.
+ * The entries are packed in a dense array, so that listing the players costs as much as
+ * the number of players and not as the capacity, and are indexed by a hash table with
+ * linear probing, kept at most half full. An erased entry is replaced by the last one
+ * of the array, and its slot in the index is filled by shifting back the following slots,
+ * so that the index never accumulates tombstones.
+ * The table is guarded by a robust process-shared mutex: if a process dies while holding it,
+ * the next process acquiring it takes over, rebuilding the index from the entries, since the dead
+ * process may have left it half updated. The entries of the dead process can then be purged
+ * with <code>eraseOwner()</code>.
+ * A node of a cluster uses a private table, in which the owners are the nodes of the cluster.
+ */
+class PresenceTable {
+    public:
+        /**
+         * Entry of the table, as returned by <code>find()</code>.
+         */
+        struct Entry {
+            unsigned int owner;
+            Player::Status status;
+            std::string address;
+        };
+    private:
+        struct Header;
+        struct Record;
+
+        /**
+         * Scoped lock of the mutex of the table, which repairs the table if the previous owner
+         * of the mutex died holding it.
+         */
+        class Lock {
+            private:
+                Header &header;
+            public:
+                explicit Lock(const PresenceTable &table);
+                ~Lock();
+                Lock(const Lock&) = delete;
+                Lock& operator=(const Lock&) = delete;
+        };
+
+        void *region;
+        size_t regionSize;
+        size_t capacity;
+        size_t indexMask;
+        Header *header;
+        Record *records;
+        uint32_t *index;  // Each slot holds the position of a record plus one, or zero if empty.
+
+        /**
+         * Computes the FNV-1a hash of a username, which does not depend on the process computing it.
+         * @param username  the username.
+         * @return          the hash.
+         */
+        static uint32_t hash(const std::string &username);
+
+        /**
+         * Finds the slot of the index holding a username, or the empty slot where it would be inserted.
+         * @param username      the username.
+         * @param usernameHash  the hash of the username.
+         * @return              the slot.
+         */
+        size_t findSlot(const std::string &username, uint32_t usernameHash) const;
+
+        /**
+         * Rebuilds the index from the records, dropping the records left invalid or duplicated
+         * by a process which died while updating them. The records are packed again.
+         * The table lives in shared memory, so the method can be called while holding the lock
+         * of any operation, even a read-only one.
+         */
+        void rebuildIndex() const;
+
+        /**
+         * Erases the record referenced by a slot of the index.
+         * @param slot  the slot of the index.
+         * @return      false if the slot is empty, true otherwise.
+         */
+        bool eraseSlot(size_t slot);
+    public:
+        /**
+         * Creates an empty table in a shared memory mapping.
+         * @param capacity  the maximum number of players.
+         * @throws runtime_error  if the mapping or the mutex cannot be created.
+         */
+        explicit PresenceTable(size_t capacity);
+
+        /**
+         * Unmaps the table from the calling process.
+         */
+        ~PresenceTable();
+
+        PresenceTable(const PresenceTable&) = delete;
+        PresenceTable(PresenceTable&&) = delete;
+        PresenceTable& operator=(const PresenceTable&) = delete;
+        PresenceTable& operator=(PresenceTable&&) = delete;
+
+        /**
+         * Inserts a player, unless it is already connected to some process.
+         * @param username  the username of the player.
+         * @param address   the IPv4 address of the player.
+         * @param owner     the index of the process owning the connection of the player.
+         * @param status    the status of the player.
+         * @return          true if the player has been inserted, false if it is already in the table.
+         * @throws runtime_error  if the table is full, or the username or the address are too long.
+         */
+        bool insert(const std::string &username, const std::string &address, unsigned int owner, Player::Status status);
+
+        /**
+         * Updates the status of a player.
+         * @param username  the username of the player.
+         * @param owner     the index of the process owning the connection of the player.
+         * @param status    the new status.
+         * @return          true if the player is in the table and owned by the given process, false otherwise.
+         */
+        bool update(const std::string &username, unsigned int owner, Player::Status status);
+
+        /**
+         * Erases a player, if it is in the table and owned by the given process.
+         * @param username  the username of the player.
+         * @param owner     the index of the process owning the connection of the player.
+         */
+        void erase(const std::string &username, unsigned int owner);
+
+        /**
+         * Erases all the players owned by a process, e.g. because the process died.
+         * @param owner  the index of the process.
+         * @return       the number of players erased.
+         */
+        size_t eraseOwner(unsigned int owner);
+
+        /**
+         * Finds a player.
+         * @param username  the username of the player.
+         * @param entry     the variable that will store the entry of the player, if found.
+         * @return          true if the player is in the table, false otherwise.
+         */
+        bool find(const std::string &username, Entry &entry) const;
+
+        /**
+         * Generates a string containing the list of players in the <code>AVAILABLE</code> status,
+         * connected to any process. The string has format <code>"PLAYER1;PLAYER2;....;PLAYERn"</code>.
+         * @param excludedUsername  the username of the player that will receive the list.
+         * @return                  the list of available players. It can be empty.
+         */
+        std::string listAvailable(const std::string &excludedUsername) const;
+
+        /**
+         * Returns the number of players connected to all the processes.
+         * @return  the number of players.
+         */
+        size_t getSize() const;
+};
+
+}
+
+#endif //INC_4INAROW_PRESENCETABLE_H
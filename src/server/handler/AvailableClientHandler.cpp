@@ -5,6 +5,7 @@
 #include <CryptoException.h>
 #include <PlayerListMessage.h>
 #include <Challenge.h>
+#include <SessionTicket.h>
 #include "AvailableClientHandler.h"
 
 namespace fourinarow {
@@ -13,8 +14,26 @@ bool AvailableClientHandler::isValidChallenge(const std::string &challenger,
                                               const std::string &challenged,
                                               PlayerStatusList &statusList) {
     return (challenger != challenged)
-           && (statusList.count(challenged) != 0)
-           && (statusList[challenged] == Player::Status::AVAILABLE);
+           && statusList.contains(challenged)
+           && (statusList.get(challenged) == Player::Status::AVAILABLE);
+}
+
+void AvailableClientHandler::forwardChallenge(const TcpSocket &challengerSocket,
+                                              Player &challenger,
+                                              const std::string &challenged,
+                                              unsigned int process,
+                                              PlayerStatusList &statusList,
+                                              const PeerList &peers) {
+    std::cout << "Forwarding the CHALLENGE message to the peer " << process << ", serving '" << challenged << '\'';
+    std::cout << std::endl;
+    setMatchmakingStatus(challenger, statusList, challenged, true);
+
+    // The process of the challenged player responds with a PEER_CHALLENGE_RESPONSE message, handled by PeerHandler.
+    if (!forwardToPeer(peers, process, ForwardedChallenge(PEER_CHALLENGE, challenger.getUsername(), challenged))) {
+        cancelMatchmakingStatus(challenger, statusList);
+        InfoMessage notAvailable(PLAYER_NOT_AVAILABLE);
+        challengerSocket.send(encryptAndAuthenticate(&notAvailable, challenger));
+    }
 }
 
 void AvailableClientHandler::handleChallengeMessage(const TcpSocket &challengerSocket,
@@ -22,6 +41,7 @@ void AvailableClientHandler::handleChallengeMessage(const TcpSocket &challengerS
                                                     Player &challenger,
                                                     PlayerList &playerList,
                                                     PlayerStatusList &statusList,
+                                                    const PeerList &peers,
                                                     PlayerRemovalList &removalList) {
     /*
      * The exceptions caused by the challenger player are not caught in this method,
@@ -33,6 +53,13 @@ void AvailableClientHandler::handleChallengeMessage(const TcpSocket &challengerS
     Challenge challengeMessage;
     challengeMessage.deserialize(message);
 
+    // Only the process owning the connection of the challenged player can tell if it is still available.
+    PresenceTable::Entry entry;
+    if (statusList.findRemote(challengeMessage.getUsername(), entry) && entry.status == Player::Status::AVAILABLE) {
+        forwardChallenge(challengerSocket, challenger, challengeMessage.getUsername(), entry.owner, statusList, peers);
+        return;
+    }
+
     if (!isValidChallenge(challenger.getUsername(), challengeMessage.getUsername(), statusList)) {
         std::cout << "The player '" << challengeMessage.getUsername() << "' is not available" << std::endl;
         InfoMessage notAvailable(PLAYER_NOT_AVAILABLE);
@@ -73,6 +100,28 @@ void AvailableClientHandler::handleSendPlayerList(const TcpSocket &socket,
     socket.send(encryptAndAuthenticate(&playerListMessage, player));
 }
 
+void AvailableClientHandler::handleSendSessionTicket(const TcpSocket &socket,
+                                                     Player &player,
+                                                     const SessionTicketKey &ticketKey) {
+    std::cout << "Received a REQ_TICKET message. Sending back a SESSION_TICKET message" << std::endl;
+    SessionTicket sessionTicket(ticketKey.issue(player.getUsername(), player.getResumptionSecret(),
+                                                player.getCipherSuite()));
+    socket.send(encryptAndAuthenticate(&sessionTicket, player));
+}
+
+void AvailableClientHandler::handleQuickMatchMessage(const TcpSocket &socket,
+                                                     Player &player,
+                                                     PlayerStatusList &statusList,
+                                                     QuickMatchQueue &queue,
+                                                     const RatingTable &ratingTable) {
+    auto rating = ratingTable.get(player.getUsername());
+    std::cout << "Received a QUICK_MATCH message. Queueing the player with rating " << rating << std::endl;
+
+    // The opponent is chosen later by the server, so the player waits in MATCHMAKING with no opponent.
+    setMatchmakingStatus(player, statusList, "", true);
+    queue.push({player.getUsername(), static_cast<uint32_t>(socket.getDescriptor()), rating, currentTimeMillis()});
+}
+
 void AvailableClientHandler::handleGoodbye(Player &player, PlayerRemovalList &removalList) {
     std::cout << "Received a GOODBYE message. Disconnecting the client" << std::endl;
     removalList.insert(player.getUsername());
@@ -82,7 +131,11 @@ void AvailableClientHandler::handle(const TcpSocket &socket,
                                     Player &player,
                                     PlayerList &playerList,
                                     PlayerStatusList &statusList,
-                                    PlayerRemovalList &removalList) {
+                                    const PeerList &peers,
+                                    PlayerRemovalList &removalList,
+                                    const SessionTicketKey &ticketKey,
+                                    QuickMatchQueue &queue,
+                                    const RatingTable &ratingTable) {
     try {
         auto encryptedMessage = socket.receive();
         auto message = authenticateAndDecrypt(encryptedMessage, player);
@@ -102,8 +155,22 @@ void AvailableClientHandler::handle(const TcpSocket &socket,
             return;
         }
 
+        if (type == REQ_TICKET) {
+            handleSendSessionTicket(socket, player, ticketKey);
+            cleanse(message);
+            cleanse(type);
+            return;
+        }
+
         if (type == CHALLENGE) {
-            handleChallengeMessage(socket, message, player, playerList, statusList, removalList);
+            handleChallengeMessage(socket, message, player, playerList, statusList, peers, removalList);
+            cleanse(message);
+            cleanse(type);
+            return;
+        }
+
+        if (type == QUICK_MATCH) {
+            handleQuickMatchMessage(socket, player, statusList, queue, ratingTable);
             cleanse(message);
             cleanse(type);
             return;
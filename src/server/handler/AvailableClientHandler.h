@@ -1,6 +1,9 @@
 #ifndef INC_4INAROW_AVAILABLECLIENTHANDLER_H
 #define INC_4INAROW_AVAILABLECLIENTHANDLER_H
 
+#include <SessionTicketKey.h>
+#include <QuickMatchQueue.h>
+#include <RatingTable.h>
 #include "Handler.h"
 
 namespace fourinarow {
@@ -13,7 +16,7 @@ class AvailableClientHandler : public Handler {
         /**
          * Checks if the challenge is valid, namely if:
          * 1) the challenged and the challenger are different players;
-         * 2) the challenged is online and <code>AVAILABLE</code>.
+         * 2) the challenged is connected to this process and <code>AVAILABLE</code>.
          * @param challenger  the challenger player.
          * @param challenged  the challenged player.
          * @param statusList  the player status list.
@@ -24,12 +27,34 @@ class AvailableClientHandler : public Handler {
                                      PlayerStatusList &statusList);
 
         /**
-         * Handles the reception of a <code>CHALLENGE</code> message.
+         * Forwards a challenge to the process or node owning the connection of the challenged player,
+         * putting the challenger in the <code>MATCHMAKING</code> status until the process or node responds.
+         * @param challengerSocket  the socket of the challenger.
+         * @param challenger        the challenger player.
+         * @param challenged        the username of the challenged player.
+         * @param process           the index of the process or node of the challenged player.
+         * @param statusList        the player status list.
+         * @param peers             the links to the other processes or nodes of the server.
+         * @throws SocketException  if an error occurs while notifying the challenger about a failure.
+         * @throws CryptoException  if an error occurs while encrypting the notification,
+         *                          or the maximum sequence number has been reached.
+         */
+        static void forwardChallenge(const TcpSocket &challengerSocket,
+                                     Player &challenger,
+                                     const std::string &challenged,
+                                     unsigned int process,
+                                     PlayerStatusList &statusList,
+                                     const PeerList &peers);
+
+        /**
+         * Handles the reception of a <code>CHALLENGE</code> message. If the challenged player
+         * is connected to another process or node of the server, the challenge is forwarded to that process.
          * @param challengerSocket  the socket of the challenger.
          * @param message           the <code>CHALLENGE</code> message in binary format.
          * @param challenger        the challenger player.
          * @param playerList        the player list.
          * @param statusList        the player status list.
+         * @param peers             the links to the other processes or nodes of the server.
          * @param removalList       the player removal list.
          */
         static void handleChallengeMessage(const TcpSocket &challengerSocket,
@@ -37,6 +62,7 @@ class AvailableClientHandler : public Handler {
                                            Player &challenger,
                                            PlayerList &playerList,
                                            PlayerStatusList &statusList,
+                                           const PeerList &peers,
                                            PlayerRemovalList &removalList);
 
         /**
@@ -51,6 +77,35 @@ class AvailableClientHandler : public Handler {
         static void handleSendPlayerList(const TcpSocket &socket,
                                          Player &player,
                                          PlayerStatusList &statusList);
+        /**
+         * Handles the reception of a <code>REQ_TICKET</code> message, issuing a session ticket
+         * that the player can use to resume the session after disconnecting.
+         * @param socket     the socket used to communicate.
+         * @param player     the player.
+         * @param ticketKey  the key used to issue the session tickets.
+         * @throws  SocketException  if an error occurs while sending the response.
+         * @throws  CryptoException  if an error occurs while issuing the ticket or encrypting the response,
+         *                           or the maximum sequence number has been reached.
+         */
+        static void handleSendSessionTicket(const TcpSocket &socket,
+                                            Player &player,
+                                            const SessionTicketKey &ticketKey);
+
+        /**
+         * Handles the reception of a <code>QUICK_MATCH</code> message, putting the player in the quick match queue
+         * and in the <code>MATCHMAKING</code> status, with no opponent, until it is paired by the server.
+         * @param socket       the socket used to communicate.
+         * @param player       the player.
+         * @param statusList   the player status list.
+         * @param queue        the quick match queue.
+         * @param ratingTable  the rating table.
+         */
+        static void handleQuickMatchMessage(const TcpSocket &socket,
+                                            Player &player,
+                                            PlayerStatusList &statusList,
+                                            QuickMatchQueue &queue,
+                                            const RatingTable &ratingTable);
+
         /**
          * Handles the reception of a <code>GOODBYE</code> message.
          * @param player       the player.
@@ -72,13 +127,21 @@ class AvailableClientHandler : public Handler {
          * @param player       the player.
          * @param playerList   the player list.
          * @param statusList   the player status list.
+         * @param peers        the links to the other processes or nodes of the server.
          * @param removalList  the player removal list.
+         * @param ticketKey    the key used to issue the session tickets.
+         * @param queue        the quick match queue.
+         * @param ratingTable  the rating table.
          */
         static void handle(const TcpSocket &socket,
                            Player &player,
                            PlayerList &playerList,
                            PlayerStatusList &statusList,
-                           PlayerRemovalList &removalList);
+                           const PeerList &peers,
+                           PlayerRemovalList &removalList,
+                           const SessionTicketKey &ticketKey,
+                           QuickMatchQueue &queue,
+                           const RatingTable &ratingTable);
 };
 
 }
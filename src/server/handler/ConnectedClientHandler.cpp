@@ -1,14 +1,19 @@
+#include <algorithm>
 #include <iostream>
+#include <tuple>
 #include <Utils.h>
 #include <SerializationException.h>
 #include <SocketException.h>
+#include <CryptoException.h>
+#include <SHA256.h>
 #include <ServerHello.h>
+#include <ResumeAccepted.h>
 #include "ConnectedClientHandler.h"
 
 namespace fourinarow {
 
 bool ConnectedClientHandler::isPlayerAlreadyConnected(const PlayerStatusList &statusList, const std::string &username) {
-    return statusList.count(username) != 0;
+    return statusList.isConnected(username);
 }
 
 bool ConnectedClientHandler::isUsernameRegistered(const std::string &username) {
@@ -23,32 +28,108 @@ bool ConnectedClientHandler::isUsernameRegistered(const std::string &username) {
     return true;
 }
 
-void ConnectedClientHandler::updatePlayerQuantities(Player &player,
+void ConnectedClientHandler::updatePlayerQuantities(const TcpSocket &socket,
+                                                    Player &player,
                                                     PlayerStatusList &statusList,
                                                     const ClientHello &clientHello) {
+    if (!statusList.add(clientHello.getUsername(), socket.getDestinationAddress(), Player::Status::HANDSHAKE)) {
+        throw std::runtime_error("The player connected meanwhile to another server process");
+    }
     player.setUsername(clientHello.getUsername());
     player.setStatus(Player::Status::HANDSHAKE);
-    statusList[player.getUsername()] = Player::Status::HANDSHAKE;
 
     player.generateServerNonce();
-    player.generateServerKeys();
+    player.generateServerKeys(DiffieHellman::negotiateGroup(clientHello.getKeyExchangeGroups()));
     player.setClientNonce(clientHello.getNonce());
+    player.setCipherSuite(AuthenticatedEncryption::negotiateCipherSuite(clientHello.getCipherSuites()));
 
     player.generateServerFreshnessProof();
 }
 
+const DelegatedKey* ConnectedClientHandler::selectDelegatedKey(const std::vector<DelegatedKey> &delegatedKeys,
+                                                               const std::vector<uint8_t> &signatureSchemes) {
+    for (const auto &delegatedKey : delegatedKeys) {
+        if (std::find(signatureSchemes.begin(), signatureSchemes.end(), delegatedKey.getScheme()) != signatureSchemes.end()) {
+            return &delegatedKey;
+        }
+    }
+
+    return nullptr;
+}
+
+void ConnectedClientHandler::handleResumeHello(const TcpSocket &socket,
+                                               Player &player,
+                                               PlayerStatusList &statusList,
+                                               PlayerRemovalList &removalList,
+                                               const std::vector<unsigned char> &message,
+                                               const SessionTicketKey &ticketKey) {
+    ResumeHello resumeHello;
+    resumeHello.deserialize(message);
+
+    if (isPlayerAlreadyConnected(statusList, resumeHello.getUsername())) {
+        std::cerr << "A player with username '" << resumeHello.getUsername() << "' is already connected. ";
+        std::cerr << "Disconnecting the client." << std::endl;
+        socket.send(InfoMessage(PLAYER_ALREADY_CONNECTED).serialize());
+        removalList.insert(player.getUsername()); // The client is anonymous: an empty string ("") is inserted.
+        return;
+    }
+
+    // A player removed from the server after the ticket was issued cannot resume.
+    if (!isUsernameRegistered(resumeHello.getUsername())) {
+        std::cerr << "The player '" << resumeHello.getUsername() << "' is not registered. ";
+        std::cerr << "Disconnecting the client." << std::endl;
+        socket.send(InfoMessage(PLAYER_NOT_REGISTERED).serialize());
+        removalList.insert(player.getUsername()); // The client is anonymous: an empty string ("") is inserted.
+        return;
+    }
+
+    std::vector<unsigned char> resumptionSecret;
+    uint8_t cipherSuite;
+    try {
+        std::tie(resumptionSecret, cipherSuite) = ticketKey.redeem(resumeHello.getTicket(), resumeHello.getUsername());
+    } catch (const CryptoException &exception) {
+        std::cerr << "Rejecting the ticket of '" << resumeHello.getUsername() << "'. " << exception.what() << std::endl;
+        socket.send(InfoMessage(TICKET_REJECTED).serialize());
+        removalList.insert(player.getUsername()); // The client is anonymous: an empty string ("") is inserted.
+        return;
+    }
+
+    if (!statusList.add(resumeHello.getUsername(), socket.getDestinationAddress(), Player::Status::HANDSHAKE)) {
+        throw std::runtime_error("The player connected meanwhile to another server process");
+    }
+    player.setUsername(resumeHello.getUsername());
+    player.setStatus(Player::Status::HANDSHAKE);
+
+    player.generateServerNonce();
+    player.setClientNonce(resumeHello.getNonce());
+    player.setCipherSuite(cipherSuite);
+    player.resumeCipher(resumptionSecret);
+    cleanse(resumptionSecret);
+
+    std::cout << "Handshake: responding with a RESUME_ACCEPTED message" << std::endl;
+    socket.send(ResumeAccepted(player.getServerNonce(), player.getCipherSuite()).serialize());
+}
+
 void ConnectedClientHandler::handle(const TcpSocket &socket,
                                     Player &player,
                                     PlayerStatusList &statusList,
                                     PlayerRemovalList &removalList,
                                     const std::vector<unsigned char> &certificate,
-                                    const DigitalSignature &digitalSignature) {
-    std::cout << "Handshake: handling a CLIENT_HELLO message" << std::endl;
-
+                                    const DigitalSignature &digitalSignature,
+                                    const std::vector<DelegatedKey> &delegatedKeys,
+                                    const SessionTicketKey &ticketKey) {
     try {
         auto message = socket.receive();
         auto type = getMessageType<SerializationException>(message);
 
+        if (type == RESUME_HELLO) {
+            std::cout << "Handshake: handling a RESUME_HELLO message" << std::endl;
+            handleResumeHello(socket, player, statusList, removalList, message, ticketKey);
+            return;
+        }
+
+        std::cout << "Handshake: handling a CLIENT_HELLO message" << std::endl;
+
         if (type != CLIENT_HELLO) {
             std::cerr << "Protocol violation: received " << convertMessageType(type) << std::endl;
             socket.send(InfoMessage(PROTOCOL_VIOLATION).serialize());
@@ -75,12 +156,32 @@ void ConnectedClientHandler::handle(const TcpSocket &socket,
             return;
         }
 
-        updatePlayerQuantities(player, statusList, clientHello);
-        std::cout << "Handshake: responding with a SERVER_HELLO message" << std::endl;
-        socket.send(ServerHello(certificate,
+        updatePlayerQuantities(socket, player, statusList, clientHello);
+
+        // Sign with a delegated key if the client accepts one, falling back to the key of the certificate.
+        auto delegatedKey = selectDelegatedKey(delegatedKeys, clientHello.getSignatureSchemes());
+        const auto &signingKey = (delegatedKey != nullptr ? delegatedKey->getKey() : digitalSignature);
+        std::vector<unsigned char> delegatedCredential;
+
+        if (delegatedKey != nullptr) {
+            delegatedCredential = delegatedKey->getSerializedCredential();
+        }
+
+        // The certificate is omitted if the client cached it: hashing it is cheaper than sending and verifying it.
+        auto certificateCached = !clientHello.getCertificateFingerprint().empty() &&
+                                 clientHello.getCertificateFingerprint() == SHA256::hash(certificate);
+
+        std::cout << "Handshake: responding with a SERVER_HELLO message " << (certificateCached ? "without" : "with");
+        std::cout << " the certificate, signed with ";
+        std::cout << convertSignatureScheme(signingKey.getScheme()) << " and using ";
+        std::cout << convertKeyExchangeGroup(DiffieHellman::getGroup(player.getServerPublicKey())) << " and ";
+        std::cout << convertCipherSuite(player.getCipherSuite()) << std::endl;
+        socket.send(ServerHello(certificateCached ? std::vector<unsigned char>() : certificate,
                                 player.getServerNonce(),
                                 player.getServerPublicKey(),
-                                digitalSignature.sign(player.getServerFreshnessProof())
+                                player.getCipherSuite(),
+                                delegatedCredential,
+                                signingKey.sign(player.getServerFreshnessProof())
                                 ).serialize());
         return;
     } catch (const SocketException &exception) {
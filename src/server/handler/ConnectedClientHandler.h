@@ -3,18 +3,22 @@
 
 #include "Handler.h"
 #include <ClientHello.h>
+#include <ResumeHello.h>
 #include <DigitalSignature.h>
+#include <DelegatedKey.h>
+#include <SessionTicketKey.h>
 
 namespace fourinarow {
 
 /**
- * Class representing a handler for messages sent by a player in the <code>CONNECTED</code> status.
+ * Class representing a handler for messages sent by a player in the <code>CONNECTED</code> status,
+ * which can either start a full handshake or resume a previous session.
  */
 class ConnectedClientHandler : public Handler {
     private:
         /**
          * Checks if the given username belongs to a player already connected to the server,
-         * namely to a player at least in the <code>CONNECTED</code> status.
+         * namely to a player at least in the <code>CONNECTED</code> status, possibly on another process or node of the server.
          * @param statusList  the player status list.
          * @param username    the username.
          * @return            true if the player is already connected, false otherwise.
@@ -33,9 +37,10 @@ class ConnectedClientHandler : public Handler {
          * Updates the given <code>Player</code> object by:
          * 1) setting the username;
          * 2) setting the status to <code>HANDSHAKE</code>;
-         * 3) generating the server nonce and the server keys;
-         * 4) setting the client nonce;
+         * 3) generating the server nonce and the server keys, in the group chosen among the ones offered;
+         * 4) setting the client nonce and the cipher suite chosen among the ones offered;
          * 5) generating the proof of freshness of the server.
+         * @param socket       the socket used to communicate with the player.
          * @param player       the player.
          * @param statusList   the player status list.
          * @param clientHello  the <code>CLIENT_HELLO</code> message.
@@ -43,10 +48,46 @@ class ConnectedClientHandler : public Handler {
          * @throws CryptoException         if an error occurs while generating the nonce and the keys,
          *                                 or while generating the proof of freshness.
          * @throws SerializationException  if the message contains an invalid username, nonce or key.
+         * @throws runtime_error           if the player connected meanwhile to another process or node of the server.
          */
-        static void updatePlayerQuantities(Player &player,
+        static void updatePlayerQuantities(const TcpSocket &socket,
+                                           Player &player,
                                            PlayerStatusList &statusList,
                                            const ClientHello &clientHello);
+
+        /**
+         * Selects the delegated key used to sign the <code>SERVER_HELLO</code> message, namely the first key,
+         * in the order of preference of the server, whose scheme is accepted by the client.
+         * @param delegatedKeys     the delegated keys of the server, by preference.
+         * @param signatureSchemes  the signature schemes accepted by the client.
+         * @return                  the delegated key, or <code>nullptr</code> if the client accepts none of them.
+         */
+        static const DelegatedKey* selectDelegatedKey(const std::vector<DelegatedKey> &delegatedKeys,
+                                                      const std::vector<uint8_t> &signatureSchemes);
+
+        /**
+         * Handles a <code>RESUME_HELLO</code> message, resuming a previous session of the player
+         * without the signatures and the key exchange of a full handshake. If the ticket is valid,
+         * the player is set as <code>HANDSHAKE</code>, the cipher is derived from the resumption secret
+         * and a <code>RESUME_ACCEPTED</code> message is sent. Otherwise, a <code>TICKET_REJECTED</code>
+         * message is sent and the player is put into the removal list.
+         * @param socket       the socket used to communicate.
+         * @param player       the player.
+         * @param statusList   the player status list.
+         * @param removalList  the player removal list.
+         * @param message      the <code>RESUME_HELLO</code> message in binary format.
+         * @param ticketKey    the key used to redeem the session tickets.
+         * @throws SocketException         if an error occurs while sending the response.
+         * @throws CryptoException         if an error occurs while generating the nonce or deriving the cipher.
+         * @throws SerializationException  if the message is malformed.
+         * @throws runtime_error           if the player connected meanwhile to another process or node of the server.
+         */
+        static void handleResumeHello(const TcpSocket &socket,
+                                      Player &player,
+                                      PlayerStatusList &statusList,
+                                      PlayerRemovalList &removalList,
+                                      const std::vector<unsigned char> &message,
+                                      const SessionTicketKey &ticketKey);
     public:
         ConnectedClientHandler() = delete;
         ~ConnectedClientHandler() = delete;
@@ -62,15 +103,20 @@ class ConnectedClientHandler : public Handler {
          * @param player            the player.
          * @param statusList        the player status list.
          * @param removalList       the player removal list.
-         * @param certificate       the certificate of the server.
+         * @param certificate       the certificate of the server, omitted from the <code>SERVER_HELLO</code>
+         *                          if the client announces a cached copy of it.
          * @param digitalSignature  the digital signature tool of the server.
+         * @param delegatedKeys     the delegated keys of the server, by preference.
+         * @param ticketKey         the key used to redeem the session tickets.
          */
         static void handle(const TcpSocket &socket,
                            Player &player,
                            PlayerStatusList &statusList,
                            PlayerRemovalList &removalList,
                            const std::vector<unsigned char> &certificate,
-                           const DigitalSignature &digitalSignature);
+                           const DigitalSignature &digitalSignature,
+                           const std::vector<DelegatedKey> &delegatedKeys,
+                           const SessionTicketKey &ticketKey);
 };
 
 }
@@ -1,3 +1,4 @@
+#include <chrono>
 #include <iostream>
 #include <string.h>
 #include <arpa/inet.h>
@@ -7,19 +8,7 @@
 namespace fourinarow {
 
 std::string Handler::generatePlayerList(const PlayerStatusList &statusList, const std::string &excludedUsername) {
-    std::string players;
-
-    for (auto &iterator : statusList) {
-        if (iterator.first == excludedUsername) {
-            continue;
-        }
-
-        if (iterator.second == Player::Status::AVAILABLE) {
-            players += (iterator.first + ';');
-        }
-    }
-
-    return players;
+    return statusList.listAvailable(excludedUsername);
 }
 
 std::vector<unsigned char> Handler::encryptAndAuthenticate(const Message *message, Player &player) {
@@ -84,16 +73,59 @@ void Handler::setMatchmakingStatus(Player &player,
                                    const std::string &matchmakingPlayer,
                                    bool matchmakingInitiator) {
     player.setStatus(Player::Status::MATCHMAKING);
-    statusList[player.getUsername()] = Player::Status::MATCHMAKING;
+    statusList.set(player.getUsername(), Player::Status::MATCHMAKING);
     player.setMatchmakingPlayer(matchmakingPlayer);
     player.setAsMatchmakingInitiator(matchmakingInitiator);
 }
 
 void Handler::cancelMatchmakingStatus(Player &player, PlayerStatusList &statusList) {
     player.setStatus(Player::Status::MATCHMAKING_INTERRUPTED);
-    statusList[player.getUsername()] = Player::Status::MATCHMAKING_INTERRUPTED;
+    statusList.set(player.getUsername(), Player::Status::MATCHMAKING_INTERRUPTED);
     player.setMatchmakingPlayer("");
     player.setAsMatchmakingInitiator(false);
 }
 
+void Handler::setPlayingStatus(Player &player, PlayerStatusList &statusList) {
+    player.setStatus(Player::Status::PLAYING);
+    statusList.set(player.getUsername(), Player::Status::PLAYING);
+}
+
+void Handler::sendToPeer(const PeerLink &link, const Message *message) {
+    if (link.isEncrypted()) {
+        link.getSocket().send(encryptAndAuthenticate(message, link.getSession()));
+        return;
+    }
+    link.getSocket().send(message->serialize());
+}
+
+std::vector<unsigned char> Handler::receiveFromPeer(const PeerLink &link) {
+    auto message = link.getSocket().receive();
+    if (link.isEncrypted()) {
+        return authenticateAndDecrypt(message, link.getSession());
+    }
+    return message;
+}
+
+bool Handler::forwardToPeer(const PeerList &peers, unsigned int peer, const ForwardedChallenge &message) {
+    if (peer >= peers.size() || peers[peer] == nullptr) {
+        std::cerr << "Impossible to send a " << convertMessageType(message.getType()) << " message: ";
+        std::cerr << "no link to the peer " << peer << std::endl;
+        return false;
+    }
+
+    try {
+        sendToPeer(*peers[peer], &message);
+        return true;
+    } catch (const std::exception &exception) {
+        std::cerr << "Impossible to send a " << convertMessageType(message.getType()) << " message to the peer ";
+        std::cerr << peer << ". " << exception.what() << std::endl;
+        return false;
+    }
+}
+
+uint64_t Handler::currentTimeMillis() {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
+}
+
 }
@@ -1,12 +1,18 @@
 #ifndef INC_4INAROW_HANDLER_H
 #define INC_4INAROW_HANDLER_H
 
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 #include <TcpSocket.h>
 #include <Player.h>
 #include <TcpSocketHasher.h>
 #include <InfoMessage.h>
+#include <ForwardedChallenge.h>
+#include <MatchTable.h>
+#include <PlayerStatusList.h>
+#include <PeerLink.h>
 
 namespace fourinarow {
 
@@ -16,11 +22,14 @@ namespace fourinarow {
 class Handler {
     protected:
         using PlayerList = std::unordered_map<TcpSocket, Player, TcpSocketHasher>;
-        using PlayerStatusList = std::unordered_map<std::string, Player::Status>;
         using PlayerRemovalList = std::unordered_set<std::string>;
+        using PlayerDescriptorList = std::unordered_map<unsigned int, PlayerList::value_type*>;
+        using RelayedMatchList = std::unordered_map<std::string, MatchTable::Handle>;
+        using PeerList = std::vector<std::unique_ptr<PeerLink>>;  // By process or node index. Null for this process or node.
 
         /**
-         * Generates a string containing the list of players in the <code>AVAILABLE</code> status.
+         * Generates a string containing the list of players in the <code>AVAILABLE</code> status,
+         * including the ones connected to the other processes or nodes of the server, if any.
          * The string has format <code>"PLAYER1;PLAYER2;....;PLAYERn"</code>.
          * @param statusList        the player status list.
          * @param excludedUsername  the username of the player that will receive the list.
@@ -107,6 +116,47 @@ class Handler {
          * @param statusList  the player status list.
          */
         static void cancelMatchmakingStatus(Player &player, PlayerStatusList &statusList);
+
+        /**
+         * Sets the player status to <code>PLAYING</code>
+         * @param player      the player.
+         * @param statusList  the player status list.
+         */
+        static void setPlayingStatus(Player &player, PlayerStatusList &statusList);
+
+        /**
+         * Sends a message to another process or node of the server, encrypting it if the link is protected by a session.
+         * @param link     the link to the process or node.
+         * @param message  the message.
+         * @throws SocketException  if an error occurs while sending the message.
+         * @throws CryptoException  if an error occurs while encrypting the message,
+         *                          or the maximum sequence number has been reached.
+         */
+        static void sendToPeer(const PeerLink &link, const Message *message);
+
+        /**
+         * Receives a message from another process or node of the server, decrypting it if the link is protected by a session.
+         * @param link  the link to the process or node.
+         * @return      the message in cleartext.
+         * @throws SocketException  if an error occurs while receiving the message.
+         * @throws CryptoException  if the message cannot be authenticated or decrypted.
+         */
+        static std::vector<unsigned char> receiveFromPeer(const PeerLink &link);
+
+        /**
+         * Sends a message to another process or node of the server, without throwing an exception if a failure occurs.
+         * @param peers    the links to the other processes or nodes.
+         * @param peer     the index of the destination process or node.
+         * @param message  the message.
+         * @return         true if the message has been sent, false otherwise.
+         */
+        static bool forwardToPeer(const PeerList &peers, unsigned int peer, const ForwardedChallenge &message);
+
+        /**
+         * Returns the current wall-clock time.
+         * @return  the number of milliseconds elapsed since the epoch.
+         */
+        static uint64_t currentTimeMillis();
     public:
         Handler() = delete;
         ~Handler() = delete;
@@ -2,6 +2,7 @@
 #include <Utils.h>
 #include <SocketException.h>
 #include <SerializationException.h>
+#include <CryptoException.h>
 #include <InfoMessage.h>
 #include <EndHandshake.h>
 #include <PlayerListMessage.h>
@@ -41,7 +42,7 @@ bool HandshakeClientHandler::handleEndHandshake(const TcpSocket &socket,
         }
 
         player.setStatus(Player::Status::AVAILABLE);
-        statusList[player.getUsername()] = Player::Status::AVAILABLE;
+        statusList.set(player.getUsername(), Player::Status::AVAILABLE);
         player.initCipher();
         return true;
     } catch (const SocketException &exception) {
@@ -59,6 +60,49 @@ bool HandshakeClientHandler::handleEndHandshake(const TcpSocket &socket,
     return false;
 }
 
+bool HandshakeClientHandler::handleEndResume(const TcpSocket &socket,
+                                             Player &player,
+                                             PlayerStatusList &statusList,
+                                             PlayerRemovalList &removalList) {
+    std::cout << "Handshake: handling an END_RESUME message" << std::endl;
+
+    try {
+        auto encryptedMessage = socket.receive();
+        auto message = authenticateAndDecrypt(encryptedMessage, player);
+        InfoMessage endResume;
+        endResume.deserialize(message);
+        cleanse(message);
+
+        if (endResume.getType() != END_RESUME) {
+            std::cerr << "Protocol violation: received " << convertMessageType(endResume.getType()) << std::endl;
+            socket.send(InfoMessage(PROTOCOL_VIOLATION).serialize());
+            removalList.insert(player.getUsername());
+            return false;
+        }
+
+        player.setStatus(Player::Status::AVAILABLE);
+        statusList.set(player.getUsername(), Player::Status::AVAILABLE);
+        return true;
+    } catch (const SocketException &exception) {
+        std::cerr << "Error while resuming the session. " << exception.what() << std::endl;
+
+    } catch (const SerializationException &exception) {
+        std::cerr << "Error while resuming the session. " << exception.what() << std::endl;
+        failSafeSendErrorInCleartext(socket, InfoMessage(MALFORMED_MESSAGE));
+
+    } catch (const CryptoException &exception) {
+        // The client does not own the resumption secret, or the message was tampered with.
+        std::cerr << "Error while resuming the session. " << exception.what() << std::endl;
+        failSafeSendErrorInCleartext(socket, InfoMessage(MALFORMED_MESSAGE));
+
+    } catch (const std::exception &exception) {
+        std::cerr << "Error while resuming the session. " << exception.what() << std::endl;
+        failSafeSendErrorInCleartext(socket, InfoMessage(INTERNAL_ERROR));
+    }
+    removalList.insert(player.getUsername());
+    return false;
+}
+
 void HandshakeClientHandler::handleSendPlayerList(const TcpSocket &socket,
                                                   Player &player,
                                                   PlayerStatusList &statusList,
@@ -83,7 +127,10 @@ void HandshakeClientHandler::handle(const TcpSocket &socket,
                                     Player &player,
                                     PlayerStatusList &statusList,
                                     PlayerRemovalList &removalList) {
-    if (!handleEndHandshake(socket, player, statusList, removalList)) {
+    // Only a resumed session has a cipher before the end of the handshake.
+    bool proceed = player.hasCipher() ? handleEndResume(socket, player, statusList, removalList)
+                                      : handleEndHandshake(socket, player, statusList, removalList);
+    if (!proceed) {
         return;
     }
     handleSendPlayerList(socket, player, statusList, removalList);
@@ -29,6 +29,24 @@ class HandshakeClientHandler : public Handler {
                                        PlayerStatusList &statusList,
                                        PlayerRemovalList &removalList);
 
+        /**
+         * Implements the first part of the handler for a resumed session, in which an <code>END_RESUME</code>
+         * message must be received, encrypted with the cipher derived from the resumption secret.
+         * A valid message proves that the client owns the secret carried by the ticket.
+         * If the check succeeds, the player is set as <code>AVAILABLE</code>.
+         * If a failure occurs, the player is put into the removal list.
+         * @param socket       the socket used to communicate.
+         * @param player       the player.
+         * @param statusList   the player status list.
+         * @param removalList  the player removal list.
+         * @return             true if the connection with the client can continue,
+         *                     false if it must be closed.
+         */
+        static bool handleEndResume(const TcpSocket &socket,
+                                    Player &player,
+                                    PlayerStatusList &statusList,
+                                    PlayerRemovalList &removalList);
+
         /**
          * Implements the second part of the handler, in which a </code>PLAYER_LIST</code>
          * message is sent. In this part, messages are exchanged in ciphertext.
@@ -52,6 +70,8 @@ class HandshakeClientHandler : public Handler {
 
         /**
          * Handles a message sent by a player in the <code>HANDSHAKE</code> status.
+         * The message is an <code>END_HANDSHAKE</code>, or an <code>END_RESUME</code>
+         * if the player is resuming a previous session.
          * If an unrecoverable error is detected, the player is put into the removal list.
          * @param socket            the socket used to communicate.
          * @param player            the player.
@@ -13,7 +13,29 @@ bool MatchmakingClientHandler::isValidChallengeResponse(const Player &player, ui
     return !player.isMatchmakingInitiator() && (type == CHALLENGE_ACCEPTED || type == CHALLENGE_REFUSED);
 }
 
-void MatchmakingClientHandler::cancelMatchmaking(Player &player, PlayerList &playerList, PlayerStatusList &statusList) {
+void MatchmakingClientHandler::cancelMatchmaking(Player &player,
+                                                 PlayerList &playerList,
+                                                 PlayerStatusList &statusList,
+                                                 const PeerList &peers,
+                                                 QuickMatchQueue &queue) {
+    if (player.getMatchmakingPlayer().empty()) {
+        queue.erase(player.getUsername());
+        cancelMatchmakingStatus(player, statusList);
+        return;
+    }
+
+    // An opponent served by another process is reset by that process, if still connected.
+    PresenceTable::Entry entry;
+    if (!statusList.contains(player.getMatchmakingPlayer())) {
+        if (statusList.findRemote(player.getMatchmakingPlayer(), entry)) {
+            const auto &challenger = player.isMatchmakingInitiator() ? player.getUsername() : player.getMatchmakingPlayer();
+            const auto &challenged = player.isMatchmakingInitiator() ? player.getMatchmakingPlayer() : player.getUsername();
+            forwardToPeer(peers, entry.owner, ForwardedChallenge(PEER_CHALLENGE_CANCEL, challenger, challenged));
+        }
+        cancelMatchmakingStatus(player, statusList);
+        return;
+    }
+
     /*
      * The reset for the player whose object is passed directly must be done as the last step.
      * Indeed, cancelMatchmakingStatus() clears the field matchmakingPlayer,
@@ -32,17 +54,14 @@ void MatchmakingClientHandler::cancelMatchmaking(Player &player, PlayerList &pla
     cancelMatchmakingStatus(player, statusList);
 }
 
-void MatchmakingClientHandler::setPlayingStatus(Player &player, PlayerStatusList &statusList) {
-    player.setStatus(Player::Status::PLAYING);
-    statusList[player.getUsername()] = Player::Status::PLAYING;
-}
-
 void MatchmakingClientHandler::handleGoodbye(Player &player,
                                              PlayerList &playerList,
                                              PlayerStatusList &statusList,
+                                             const PeerList &peers,
+                                             QuickMatchQueue &queue,
                                              PlayerRemovalList &removalList) {
     std::cout << "Received a GOODBYE message. Disconnecting the client" << std::endl;
-    cancelMatchmaking(player, playerList, statusList);
+    cancelMatchmaking(player, playerList, statusList, peers, queue);
     removalList.insert(player.getUsername());
     return;
 }
@@ -79,7 +98,8 @@ bool MatchmakingClientHandler::sendPlayerMessageToChallenger(const TcpSocket &ch
                                                              Player &challengedPlayer,
                                                              PlayerStatusList &statusList,
                                                              PlayerRemovalList &removalList) {
-    std::cout << "Sending a PLAYER message to the challenger '" << challengerPlayer.getUsername() << "'" << std::endl;
+    std::cout << "Sending a " << convertMessageType(message.isRelayed() ? RELAYED_PLAYER : PLAYER);
+    std::cout << " message to the challenger '" << challengerPlayer.getUsername() << "'" << std::endl;
 
     try {
         challengerSocket.send(encryptAndAuthenticate(&message, challengerPlayer));
@@ -98,11 +118,53 @@ bool MatchmakingClientHandler::sendPlayerMessageToChallenger(const TcpSocket &ch
     }
 }
 
+void MatchmakingClientHandler::handleRemoteChallengeResponse(const TcpSocket &challengedSocket,
+                                                             const uint8_t challengeResponseType,
+                                                             Player &challengedPlayer,
+                                                             PlayerStatusList &statusList,
+                                                             const PeerList &peers) {
+    PresenceTable::Entry entry;
+    if (!statusList.findRemote(challengedPlayer.getMatchmakingPlayer(), entry)) {
+        throw std::runtime_error("Player not found");
+    }
+
+    std::cout << "Forwarding the message to the peer " << entry.owner << ", serving the challenger '";
+    std::cout << challengedPlayer.getMatchmakingPlayer() << '\'' << std::endl;
+
+    // The turn is drawn here, so that the two processes agree on it without a further round trip.
+    auto challengerFirstToPlay = CSPRNG::nextBool();
+    ForwardedChallenge response(PEER_CHALLENGE_RESPONSE,
+                                challengedPlayer.getMatchmakingPlayer(),
+                                challengedPlayer.getUsername(),
+                                challengeResponseType,
+                                challengerFirstToPlay);
+
+    if (!forwardToPeer(peers, entry.owner, response) || challengeResponseType == CHALLENGE_REFUSED) {
+        cancelMatchmakingStatus(challengedPlayer, statusList);
+        return;
+    }
+
+    std::string challengerPublicKeyPath = SERVER_PLAYERS_FOLDER + challengedPlayer.getMatchmakingPlayer() + SERVER_PLAYER_KEY_SUFFIX;
+    PlayerMessage toChallenged(entry.address,
+                               DigitalSignature::serializePublicKey(challengerPublicKeyPath),
+                               !challengerFirstToPlay);
+
+    std::cout << "Sending a PLAYER message to the challenged '" << challengedPlayer.getUsername() << "'" << std::endl;
+    challengedSocket.send(encryptAndAuthenticate(&toChallenged, challengedPlayer));
+
+    cancelMatchmakingStatus(challengedPlayer, statusList);
+    setPlayingStatus(challengedPlayer, statusList);
+}
+
 void MatchmakingClientHandler::handleChallengeResponse(const TcpSocket &challengedSocket,
                                                        const uint8_t challengeResponseType,
                                                        Player &challengedPlayer,
                                                        PlayerList &playerList,
                                                        PlayerStatusList &statusList,
+                                                       bool relay,
+                                                       MatchTable &matchTable,
+                                                       RelayedMatchList &matchList,
+                                                       const PeerList &peers,
                                                        PlayerRemovalList &removalList) {
     /*
      * The exceptions caused by the challenged player are not caught in this method,
@@ -112,6 +174,11 @@ void MatchmakingClientHandler::handleChallengeResponse(const TcpSocket &challeng
      * to avoid disconnecting the challenged for errors not linked to her connection.
      */
     std::cout << "Received a " << convertMessageType(challengeResponseType) << " message\n";
+    if (!statusList.contains(challengedPlayer.getMatchmakingPlayer())) {
+        handleRemoteChallengeResponse(challengedSocket, challengeResponseType, challengedPlayer, statusList, peers);
+        return;
+    }
+
     auto &iterator = findPlayerByUsername(playerList, challengedPlayer.getMatchmakingPlayer());
 
     if (!forwardChallengeResponse(iterator.first, challengeResponseType, iterator.second, challengedPlayer, statusList, removalList)) {
@@ -124,24 +191,37 @@ void MatchmakingClientHandler::handleChallengeResponse(const TcpSocket &challeng
         return;
     }
 
-    std::string challengerPublicKeyPath = SERVER_PLAYERS_FOLDER + iterator.second.getUsername() + SERVER_PLAYER_KEY_SUFFIX;
-    std::string challengedPublicKeyPath = SERVER_PLAYERS_FOLDER + challengedPlayer.getUsername() + SERVER_PLAYER_KEY_SUFFIX;
     auto challengerFirstToPlay = CSPRNG::nextBool();
+    PlayerMessage toChallenger(challengerFirstToPlay);
+    PlayerMessage toChallenged(!challengerFirstToPlay);
 
-    PlayerMessage toChallenger(challengedSocket.getDestinationAddress(),
-                               DigitalSignature::serializePublicKey(challengedPublicKeyPath),
-                               challengerFirstToPlay);
-    PlayerMessage toChallenged(iterator.first.getDestinationAddress(),
-                               DigitalSignature::serializePublicKey(challengerPublicKeyPath),
-                               !challengerFirstToPlay);
+    if (!relay) {
+        std::string challengerPublicKeyPath = SERVER_PLAYERS_FOLDER + iterator.second.getUsername() + SERVER_PLAYER_KEY_SUFFIX;
+        std::string challengedPublicKeyPath = SERVER_PLAYERS_FOLDER + challengedPlayer.getUsername() + SERVER_PLAYER_KEY_SUFFIX;
 
-    std::cout << "Sending a PLAYER message to the challenged '" << challengedPlayer.getUsername() << "'" << std::endl;
+        toChallenger = PlayerMessage(challengedSocket.getDestinationAddress(),
+                                     DigitalSignature::serializePublicKey(challengedPublicKeyPath),
+                                     challengerFirstToPlay);
+        toChallenged = PlayerMessage(iterator.first.getDestinationAddress(),
+                                     DigitalSignature::serializePublicKey(challengerPublicKeyPath),
+                                     !challengerFirstToPlay);
+    }
+
+    std::cout << "Sending a " << convertMessageType(toChallenged.isRelayed() ? RELAYED_PLAYER : PLAYER);
+    std::cout << " message to the challenged '" << challengedPlayer.getUsername() << "'" << std::endl;
     challengedSocket.send(encryptAndAuthenticate(&toChallenged, challengedPlayer));
 
     if (!sendPlayerMessageToChallenger(iterator.first, toChallenger, iterator.second, challengedPlayer, statusList, removalList)) {
         return;
     }
 
+    if (relay) {
+        auto match = matchTable.create(iterator.first.getDescriptor(), challengedSocket.getDescriptor(), challengerFirstToPlay,
+                                       currentTimeMillis());
+        matchList[iterator.second.getUsername()] = match;
+        matchList[challengedPlayer.getUsername()] = match;
+    }
+
     cancelMatchmakingStatus(challengedPlayer, statusList);
     cancelMatchmakingStatus(iterator.second, statusList);
     setPlayingStatus(challengedPlayer, statusList);
@@ -152,6 +232,11 @@ void MatchmakingClientHandler::handle(const TcpSocket &socket,
                                       Player &player,
                                       PlayerList &playerList,
                                       PlayerStatusList &statusList,
+                                      bool relay,
+                                      MatchTable &matchTable,
+                                      RelayedMatchList &matchList,
+                                      const PeerList &peers,
+                                      QuickMatchQueue &queue,
                                       PlayerRemovalList &removalList) {
     try {
         auto encryptedMessage = socket.receive();
@@ -160,12 +245,12 @@ void MatchmakingClientHandler::handle(const TcpSocket &socket,
         cleanse(message);
 
         if (type == GOODBYE) {
-            handleGoodbye(player, playerList, statusList, removalList);
+            handleGoodbye(player, playerList, statusList, peers, queue, removalList);
             cleanse(type);
             return;
         }
 
-        if (type == REQ_PLAYER_LIST || type == CHALLENGE) {
+        if (type == REQ_PLAYER_LIST || type == CHALLENGE || type == REQ_TICKET || type == QUICK_MATCH) {
             std::cout << "Ignoring a " << convertMessageType(type) << " message. The client has a pending CHALLENGE";
             std::cout << std::endl;
             cleanse(type);
@@ -173,7 +258,7 @@ void MatchmakingClientHandler::handle(const TcpSocket &socket,
         }
 
         if (isValidChallengeResponse(player, type)) {
-            handleChallengeResponse(socket, type, player, playerList, statusList, removalList);
+            handleChallengeResponse(socket, type, player, playerList, statusList, relay, matchTable, matchList, peers, removalList);
             cleanse(type);
             return;
         }
@@ -181,27 +266,27 @@ void MatchmakingClientHandler::handle(const TcpSocket &socket,
         std::cerr << "Protocol violation: received " << convertMessageType(type) << std::endl;
         cleanse(type);
 
-        cancelMatchmaking(player, playerList, statusList);
+        cancelMatchmaking(player, playerList, statusList, peers, queue);
         InfoMessage protocolViolation(PROTOCOL_VIOLATION);
         socket.send(encryptAndAuthenticate(&protocolViolation, player));
     } catch (const SocketException &exception) {
         std::cerr << "Error while handling the message. " << exception.what() << std::endl;
-        cancelMatchmaking(player, playerList, statusList);
+        cancelMatchmaking(player, playerList, statusList, peers, queue);
         removalList.insert(player.getUsername());
 
     } catch (const SerializationException &exception) {
         std::cerr << "Error while handling the message. " << exception.what() << std::endl;
-        cancelMatchmaking(player, playerList, statusList);
+        cancelMatchmaking(player, playerList, statusList, peers, queue);
         failSafeSendErrorInCiphertext(socket, player, InfoMessage(MALFORMED_MESSAGE), removalList);
 
     } catch (const CryptoException &exception) {
         std::cerr << "Error while handling the message. " << exception.what() << std::endl;
-        cancelMatchmaking(player, playerList, statusList);
+        cancelMatchmaking(player, playerList, statusList, peers, queue);
         failSafeSendErrorInCiphertext(socket, player, InfoMessage(MALFORMED_MESSAGE), removalList);
 
     } catch (const std::exception &exception) {
         std::cerr << "Error while handling the message. " << exception.what() << std::endl;
-        cancelMatchmaking(player, playerList, statusList);
+        cancelMatchmaking(player, playerList, statusList, peers, queue);
         failSafeSendErrorInCiphertext(socket, player, InfoMessage(INTERNAL_ERROR), removalList);
         removalList.insert(player.getUsername());
     }
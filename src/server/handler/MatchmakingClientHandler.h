@@ -3,6 +3,7 @@
 
 #include "Handler.h"
 #include <PlayerMessage.h>
+#include <QuickMatchQueue.h>
 
 namespace fourinarow {
 
@@ -28,30 +29,35 @@ class MatchmakingClientHandler : public Handler {
          * uses <code>findPlayerByUsername()</code>. If the two player objects
          * are directly available, use <code>cancelMatchmakingStatus()</code> on both.
          * If a failure occurs when finding the opponent in the list, the method
-         * changes only the status of the given player.
+         * changes only the status of the given player. If the opponent is connected
+         * to another process or node of the server, the process is asked to cancel its status.
+         * A player waiting in the quick match queue, who has no opponent yet, is removed from the queue.
          * @param player      the challenger or the challenged player.
          * @param playerList  the player list.
          * @param statusList  the status list.
+         * @param peers       the links to the other processes or nodes of the server.
+         * @param queue       the quick match queue.
          */
-        static void cancelMatchmaking(Player &player, PlayerList &playerList, PlayerStatusList &statusList);
-
-        /**
-         * Sets the player status to <code>PLAYING</code>
-         * @param player      the player.
-         * @param statusList  the player status list.
-         */
-        static void setPlayingStatus(Player &player, PlayerStatusList &statusList);
+        static void cancelMatchmaking(Player &player,
+                                      PlayerList &playerList,
+                                      PlayerStatusList &statusList,
+                                      const PeerList &peers,
+                                      QuickMatchQueue &queue);
 
         /**
          * Handles the reception of a <code>GOODBYE</code> message.
          * @param player      the player.
          * @param playerList  the player list.
          * @param statusList  the player status list.
+         * @param peers       the links to the other processes or nodes of the server.
+         * @param queue       the quick match queue.
          * @param removalList the player removal list.
          */
         static void handleGoodbye(Player &player,
                                   PlayerList &playerList,
                                   PlayerStatusList &statusList,
+                                  const PeerList &peers,
+                                  QuickMatchQueue &queue,
                                   PlayerRemovalList &removalList);
 
         /**
@@ -76,11 +82,11 @@ class MatchmakingClientHandler : public Handler {
                                              PlayerRemovalList &removalList);
 
         /**
-         * Sends a <code>PLAYER</code> message to the challenger player.
+         * Sends a <code>PLAYER</code> or <code>RELAYED_PLAYER</code> message to the challenger player.
          * If an error occurs while sending the message, the matchmaking
          * is automatically cancelled and no exceptions are thrown.
          * @param challengerSocket       the socket used to communicate with the challenger.
-         * @param message                the <code>PLAYER</code> message.
+         * @param message                the <code>PLAYER</code> or <code>RELAYED_PLAYER</code> message.
          * @param challengerPlayer       the challenger player.
          * @param challengedPlayer       the challenged player. Used only to cancel the matchmaking status
          *                               if an error occurs.
@@ -95,6 +101,27 @@ class MatchmakingClientHandler : public Handler {
                                                   PlayerStatusList &statusList,
                                                   PlayerRemovalList &removalList);
 
+        /**
+         * Handles the reception of either a <code>CHALLENGE_ACCEPTED</code> or a <code>CHALLENGE_REFUSED</code>
+         * message, when the challenger is connected to another process or node of the server. The response is forwarded
+         * to that process, which notifies the challenger. The matches between players of different processes
+         * are always P2P.
+         * @param challengedSocket       the socket used to communicate with the challenged.
+         * @param challengeResponseType  the challenge response type.
+         * @param challengedPlayer       the challenged player.
+         * @param statusList             the player status list.
+         * @param peers                  the links to the other processes or nodes of the server.
+         * @throws runtime_error     if the challenger is no longer connected.
+         * @throws SocketException   if an error occurs while sending the <code>PLAYER</code> message.
+         * @throws CryptoException   if an error occurs while encrypting the <code>PLAYER</code> message,
+         *                           or the maximum sequence number has been reached.
+         */
+        static void handleRemoteChallengeResponse(const TcpSocket &challengedSocket,
+                                                  const uint8_t challengeResponseType,
+                                                  Player &challengedPlayer,
+                                                  PlayerStatusList &statusList,
+                                                  const PeerList &peers);
+
         /**
          * Handles the reception of either a <code>CHALLENGE_ACCEPTED</code>
          * or a <code>CHALLENGE_REFUSED</code> message.
@@ -103,6 +130,10 @@ class MatchmakingClientHandler : public Handler {
          * @param challengedPlayer       the challenged player.
          * @param playerList             the player list.
          * @param statusList             the player status list.
+         * @param relay                  true if the server relays the matches, false if they are P2P.
+         * @param matchTable             the relayed match table.
+         * @param matchList              the relayed match list.
+         * @param peers                  the links to the other processes or nodes of the server.
          * @param removalList            the player removal list.
          */
         static void handleChallengeResponse(const TcpSocket &challengedSocket,
@@ -110,6 +141,10 @@ class MatchmakingClientHandler : public Handler {
                                             Player &challengedPlayer,
                                             PlayerList &playerList,
                                             PlayerStatusList &statusList,
+                                            bool relay,
+                                            MatchTable &matchTable,
+                                            RelayedMatchList &matchList,
+                                            const PeerList &peers,
                                             PlayerRemovalList &removalList);
 
     public:
@@ -122,16 +157,28 @@ class MatchmakingClientHandler : public Handler {
 
         /**
          * Handles a message sent by a player in the <code>MATCHMAKING</code> status.
+         * If the server relays the matches, an accepted challenge creates a match in the match table,
+         * which is added to the relayed match list under the usernames of both players.
          * @param socket       the socket used to communicate.
          * @param player       the player.
          * @param playerList   the player list.
          * @param statusList   the player status list.
+         * @param relay        true if the server relays the matches, false if they are P2P.
+         * @param matchTable   the relayed match table.
+         * @param matchList    the relayed match list.
+         * @param peers        the links to the other processes or nodes of the server.
+         * @param queue        the quick match queue.
          * @param removalList  the player removal list.
          */
         static void handle(const TcpSocket &socket,
                            Player &player,
                            PlayerList &playerList,
                            PlayerStatusList &statusList,
+                           bool relay,
+                           MatchTable &matchTable,
+                           RelayedMatchList &matchList,
+                           const PeerList &peers,
+                           QuickMatchQueue &queue,
                            PlayerRemovalList &removalList);
 
 };
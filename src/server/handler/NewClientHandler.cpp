@@ -3,7 +3,10 @@
 
 namespace fourinarow {
 
-void NewClientHandler::handle(TcpSocket &helloSocket, InputMultiplexer &multiplexer, PlayerList &playerList) {
+void NewClientHandler::handle(TcpSocket &helloSocket,
+                              InputMultiplexer &multiplexer,
+                              PlayerList &playerList,
+                              PlayerDescriptorList &descriptorList) {
     std::cout << "Hello socket: new connection request" << std::endl;
     auto newDescriptor = -1; // Used for rollback.
 
@@ -16,11 +19,18 @@ void NewClientHandler::handle(TcpSocket &helloSocket, InputMultiplexer &multiple
         newPlayer.setStatus(Player::Status::CONNECTED);
 
         multiplexer.addDescriptor(newClientSocket.getDescriptor());
-        playerList[std::move(newClientSocket)] = std::move(newPlayer);
+        auto entry = playerList.emplace(std::move(newClientSocket), std::move(newPlayer));
+        descriptorList[newDescriptor] = &(*entry.first);
     } catch (const std::exception &exception) {
         std::cerr << "Impossible to accept the connection. " << exception.what() << std::endl;
         if (newDescriptor >= 0) {
-            multiplexer.removeDescriptor(newDescriptor); // Rollback in case the insertion in playerList fails.
+            // Rollback in case the insertion in playerList or descriptorList fails.
+            multiplexer.removeDescriptor(newDescriptor);
+            auto entry = descriptorList.find(newDescriptor);
+            if (entry != descriptorList.end()) {
+                playerList.erase(entry->second->first);
+                descriptorList.erase(entry);
+            }
         }
     }
 }
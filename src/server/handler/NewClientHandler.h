@@ -20,11 +20,15 @@ class NewClientHandler : public Handler {
 
         /**
          * Handles a new connection on the hello socket.
-         * @param helloSocket  the hello socket.
-         * @param multiplexer  the input multiplexer managing the server sockets.
-         * @param playerList   the player list.
+         * @param helloSocket     the hello socket.
+         * @param multiplexer     the input multiplexer managing the server sockets.
+         * @param playerList      the player list.
+         * @param descriptorList  the index of the player list by socket descriptor.
          */
-        static void handle(TcpSocket &helloSocket, InputMultiplexer &multiplexer, PlayerList &playerList);
+        static void handle(TcpSocket &helloSocket,
+                           InputMultiplexer &multiplexer,
+                           PlayerList &playerList,
+                           PlayerDescriptorList &descriptorList);
 };
 
 }
@@ -0,0 +1,180 @@
+#include <iostream>
+#include <Utils.h>
+#include <SerializationException.h>
+#include <CryptoException.h>
+#include <CertificateStore.h>
+#include <DiffieHellman.h>
+#include <Player1Hello.h>
+#include <Player2Hello.h>
+#include <EndHandshake.h>
+#include "NodeHandler.h"
+
+namespace fourinarow {
+
+void NodeHandler::verifyFreshnessProof(const std::vector<unsigned char> &freshnessProof,
+                                       const std::vector<unsigned char> &signature,
+                                       const std::vector<unsigned char> &certificate) {
+    auto serverCertificate = CertificateStore::deserializeCertificate(certificate);
+
+    if (!DigitalSignature::verify(freshnessProof, signature, serverCertificate.getPublicKey())) {
+        throw CryptoException("Invalid signature of the freshness proof");
+    }
+}
+
+void NodeHandler::sendPlayer1Hello(PendingNodeLink &link) {
+    link.session.generateClientNonce();
+    link.socket.send(Player1Hello(link.session.getClientNonce(), KEY_EXCHANGE_GROUPS).serialize());
+
+    link.stage = PendingNodeLink::Stage::WAITING_PLAYER2_HELLO;
+    link.deadline = std::chrono::steady_clock::now() + std::chrono::seconds(NODE_PROTOCOL_TIMEOUT);
+}
+
+void NodeHandler::handlePlayer1Hello(PendingNodeLink &link,
+                                     const std::vector<unsigned char> &message,
+                                     const DigitalSignature &digitalSignature) {
+    auto type = getMessageType<SerializationException>(message);
+    if (type != PLAYER1_HELLO) {
+        throw SerializationException(convertMessageType(type));
+    }
+
+    Player1Hello player1Hello;
+    player1Hello.deserialize(message);
+
+    auto &session = link.session;
+    session.generateServerNonce();
+    session.generateServerKeys(DiffieHellman::negotiateGroup(player1Hello.getKeyExchangeGroups()));
+    session.setClientNonce(player1Hello.getNonce());
+    session.generateServerFreshnessProof();
+    link.socket.send(Player2Hello(session.getServerNonce(),
+                                  session.getServerPublicKey(),
+                                  digitalSignature.sign(session.getServerFreshnessProof())).serialize());
+
+    link.stage = PendingNodeLink::Stage::WAITING_END_HANDSHAKE;
+    link.deadline = std::chrono::steady_clock::now() + std::chrono::seconds(NODE_PROTOCOL_TIMEOUT);
+}
+
+void NodeHandler::handlePlayer2Hello(PendingNodeLink &link,
+                                     const std::vector<unsigned char> &message,
+                                     const DigitalSignature &digitalSignature,
+                                     const std::vector<unsigned char> &certificate) {
+    auto type = getMessageType<SerializationException>(message);
+    if (type != PLAYER2_HELLO) {
+        throw SerializationException(convertMessageType(type));
+    }
+
+    Player2Hello player2Hello;
+    player2Hello.deserialize(message);
+
+    auto &session = link.session;
+    session.setServerNonce(player2Hello.getNonce());
+    session.setServerPublicKey(player2Hello.getPublicKey());
+    session.generateServerFreshnessProof();
+    verifyFreshnessProof(session.getServerFreshnessProof(), player2Hello.getDigitalSignature(), certificate);
+
+    session.generateClientKeys();
+    session.generateClientFreshnessProof();
+    link.socket.send(EndHandshake(session.getClientPublicKey(),
+                                  digitalSignature.sign(session.getClientFreshnessProof())).serialize());
+    session.initCipher();
+}
+
+void NodeHandler::handleEndHandshake(PendingNodeLink &link,
+                                     const std::vector<unsigned char> &message,
+                                     const std::vector<unsigned char> &certificate) {
+    auto type = getMessageType<SerializationException>(message);
+    if (type != END_HANDSHAKE) {
+        throw SerializationException(convertMessageType(type));
+    }
+
+    EndHandshake endHandshake;
+    endHandshake.deserialize(message);
+
+    auto &session = link.session;
+    session.setClientPublicKey(endHandshake.getPublicKey());
+    session.generateClientFreshnessProof();
+    verifyFreshnessProof(session.getClientFreshnessProof(), endHandshake.getDigitalSignature(), certificate);
+    session.initCipher();
+}
+
+std::unique_ptr<PendingNodeLink> NodeHandler::connectToNode(const std::string &localAddress,
+                                                            const std::string &nodeAddress,
+                                                            unsigned int node,
+                                                            InputMultiplexer &multiplexer) {
+    std::cout << "Connecting to the node " << nodeAddress << ':' << NODE_PORT << std::endl;
+
+    try {
+        std::unique_ptr<PendingNodeLink> link(new PendingNodeLink{TcpSocket(), Player(), node,
+                                                                  PendingNodeLink::Stage::CONNECTING, {},
+                                                                  std::chrono::steady_clock::now() +
+                                                                  std::chrono::seconds(NODE_PROTOCOL_TIMEOUT)});
+
+        // The source address identifies this node to the other one.
+        link->socket.bind(localAddress, 0);
+        if (link->socket.startConnect(nodeAddress, NODE_PORT)) {
+            sendPlayer1Hello(*link);
+            multiplexer.addDescriptor(link->socket.getDescriptor());
+        } else {
+            multiplexer.addConnectingDescriptor(link->socket.getDescriptor());
+        }
+        return link;
+    } catch (const std::exception &exception) {
+        std::cerr << "Impossible to link the node " << nodeAddress << ". " << exception.what() << std::endl;
+        throw std::runtime_error("Connection to the node failed");
+    }
+}
+
+std::unique_ptr<PendingNodeLink> NodeHandler::acceptNode(TcpSocket socket, unsigned int node, InputMultiplexer &multiplexer) {
+    std::cout << "Accepting a link from the node " << socket.getDestinationAddress() << std::endl;
+
+    std::unique_ptr<PendingNodeLink> link(new PendingNodeLink{std::move(socket), Player(), node,
+                                                              PendingNodeLink::Stage::WAITING_PLAYER1_HELLO, {},
+                                                              std::chrono::steady_clock::now() +
+                                                              std::chrono::seconds(NODE_PROTOCOL_TIMEOUT)});
+    multiplexer.addDescriptor(link->socket.getDescriptor());
+    return link;
+}
+
+std::unique_ptr<PeerLink> NodeHandler::handle(PendingNodeLink &link,
+                                              InputMultiplexer &multiplexer,
+                                              const DigitalSignature &digitalSignature,
+                                              const std::vector<unsigned char> &certificate) {
+    const auto nodeAddress = link.socket.getDestinationAddress();
+
+    try {
+        if (link.stage == PendingNodeLink::Stage::CONNECTING) {
+            link.socket.finishConnect();
+
+            // Once connected, the socket is monitored only for the messages of the other node.
+            multiplexer.removeDescriptor(link.socket.getDescriptor());
+            multiplexer.addDescriptor(link.socket.getDescriptor());
+            sendPlayer1Hello(link);
+            return nullptr;
+        }
+
+        // The messages following the handshake are left in the socket, to be received by the established link.
+        std::vector<unsigned char> message;
+        if (!link.socket.receiveMessageAvailable(link.buffer, message)) {
+            return nullptr;
+        }
+
+        if (link.stage == PendingNodeLink::Stage::WAITING_PLAYER1_HELLO) {
+            handlePlayer1Hello(link, message, digitalSignature);
+            return nullptr;
+        }
+
+        if (link.stage == PendingNodeLink::Stage::WAITING_PLAYER2_HELLO) {
+            handlePlayer2Hello(link, message, digitalSignature, certificate);
+            std::cout << "Link to the node " << nodeAddress << " established" << std::endl;
+        } else {
+            handleEndHandshake(link, message, certificate);
+            std::cout << "Link from the node " << nodeAddress << " established" << std::endl;
+        }
+
+        return std::unique_ptr<PeerLink>(new PeerLink(std::move(link.socket), std::move(link.session)));
+    } catch (const std::exception &exception) {
+        std::cerr << "Impossible to link the node " << nodeAddress << ". " << exception.what() << std::endl;
+        throw std::runtime_error("Handshake with the node failed");
+    }
+}
+
+}
@@ -0,0 +1,153 @@
+#ifndef INC_4INAROW_NODEHANDLER_H
+#define INC_4INAROW_NODEHANDLER_H
+
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <DigitalSignature.h>
+#include <InputMultiplexer.h>
+#include "Handler.h"
+
+namespace fourinarow {
+
+/**
+ * Structure representing a link to a node of the cluster whose handshake is in progress.
+ * The handshake is driven by the service loop, which takes a step each time the socket is ready:
+ * the link is dropped if the awaited step does not happen before the deadline.
+ */
+struct PendingNodeLink {
+    enum class Stage {
+        CONNECTING,             // The initiator waits for the connection to be established.
+        WAITING_PLAYER1_HELLO,  // The acceptor waits for the PLAYER1_HELLO message.
+        WAITING_PLAYER2_HELLO,  // The initiator waits for the PLAYER2_HELLO message.
+        WAITING_END_HANDSHAKE   // The acceptor waits for the END_HANDSHAKE message.
+    };
+
+    TcpSocket socket;
+    Player session;
+    unsigned int node;                                // The index of the other node in the cluster.
+    Stage stage;
+    std::vector<unsigned char> buffer;                // The bytes of the awaited message received so far.
+    std::chrono::steady_clock::time_point deadline;
+};
+
+/**
+ * Class representing a handler for the links between the nodes of a cluster.
+ * A link is established by the same handshake of the P2P matches, in which both nodes sign
+ * their freshness proof with the key of the server certificate. The node with the higher index
+ * connects to the one with the lower index, binding its socket to its own address: the acceptor
+ * identifies the node by the source address, and authenticates it by the signature.
+ * Neither the connection nor the handshake blocks the service loop: each message of the handshake
+ * is handled when its socket is ready, and is awaited for at most <code>NODE_PROTOCOL_TIMEOUT</code> seconds.
+ */
+class NodeHandler : public Handler {
+    private:
+        /**
+         * Verifies the signature of a freshness proof, issued with the key of the server certificate.
+         * @param freshnessProof  the freshness proof.
+         * @param signature       the signature.
+         * @param certificate     the certificate of the server in binary format.
+         * @throws CryptoException  if the signature is not valid.
+         */
+        static void verifyFreshnessProof(const std::vector<unsigned char> &freshnessProof,
+                                         const std::vector<unsigned char> &signature,
+                                         const std::vector<unsigned char> &certificate);
+
+        /**
+         * Sends the <code>PLAYER1_HELLO</code> message on a connected link, which then waits for the answer.
+         * @param link  the link, acting as the initiator of the handshake.
+         * @throws SocketException         if an error occurs while sending the message.
+         * @throws SerializationException  if an error occurs while serializing the message.
+         */
+        static void sendPlayer1Hello(PendingNodeLink &link);
+
+        /**
+         * Handles the <code>PLAYER1_HELLO</code> message, answering with the <code>PLAYER2_HELLO</code> one.
+         * @param link              the link, acting as the acceptor of the handshake.
+         * @param message           the received message.
+         * @param digitalSignature  the digital signature tool of the certificate.
+         * @throws runtime_error  if the message is not valid or the answer cannot be sent.
+         */
+        static void handlePlayer1Hello(PendingNodeLink &link,
+                                       const std::vector<unsigned char> &message,
+                                       const DigitalSignature &digitalSignature);
+
+        /**
+         * Handles the <code>PLAYER2_HELLO</code> message, answering with the <code>END_HANDSHAKE</code> one.
+         * @param link              the link, acting as the initiator of the handshake.
+         * @param message           the received message.
+         * @param digitalSignature  the digital signature tool of the certificate.
+         * @param certificate       the certificate of the server in binary format.
+         * @throws runtime_error  if the message or its signature are not valid, or the answer cannot be sent.
+         */
+        static void handlePlayer2Hello(PendingNodeLink &link,
+                                       const std::vector<unsigned char> &message,
+                                       const DigitalSignature &digitalSignature,
+                                       const std::vector<unsigned char> &certificate);
+
+        /**
+         * Handles the <code>END_HANDSHAKE</code> message, which completes the handshake.
+         * @param link         the link, acting as the acceptor of the handshake.
+         * @param message      the received message.
+         * @param certificate  the certificate of the server in binary format.
+         * @throws runtime_error  if the message or its signature are not valid.
+         */
+        static void handleEndHandshake(PendingNodeLink &link,
+                                       const std::vector<unsigned char> &message,
+                                       const std::vector<unsigned char> &certificate);
+    public:
+        NodeHandler() = delete;
+        ~NodeHandler() = delete;
+        NodeHandler(const NodeHandler&) = delete;
+        NodeHandler(NodeHandler&&) = delete;
+        NodeHandler &operator=(const NodeHandler&) = delete;
+        NodeHandler &operator=(NodeHandler&&) = delete;
+
+        /**
+         * Starts connecting to a node of the cluster, acting as the initiator of the handshake,
+         * and adds the socket to the multiplexer.
+         * @param localAddress  the address of this node.
+         * @param nodeAddress   the address of the other node.
+         * @param node          the index of the other node in the cluster.
+         * @param multiplexer   the multiplexer of sockets.
+         * @return              the link to the node, whose handshake is in progress.
+         * @throws runtime_error  if the connection fails.
+         */
+        static std::unique_ptr<PendingNodeLink> connectToNode(const std::string &localAddress,
+                                                              const std::string &nodeAddress,
+                                                              unsigned int node,
+                                                              InputMultiplexer &multiplexer);
+
+        /**
+         * Starts the handshake on a connection accepted from a node of the cluster, acting as the acceptor,
+         * and adds the socket to the multiplexer.
+         * @param socket       the accepted socket.
+         * @param node         the index of the other node in the cluster.
+         * @param multiplexer  the multiplexer of sockets.
+         * @return             the link to the node, whose handshake is in progress.
+         * @throws SocketException  if the socket cannot be added to the multiplexer.
+         */
+        static std::unique_ptr<PendingNodeLink> acceptNode(TcpSocket socket,
+                                                           unsigned int node,
+                                                           InputMultiplexer &multiplexer);
+
+        /**
+         * Takes the next step of the handshake of a link whose socket is ready: it completes the connection,
+         * or handles the awaited message if it has been entirely received.
+         * @param link              the link whose handshake is in progress.
+         * @param multiplexer       the multiplexer of sockets.
+         * @param digitalSignature  the digital signature tool of the certificate.
+         * @param certificate       the certificate of the server in binary format.
+         * @return                  the established link, which takes the socket of the pending one,
+         *                          or null if the handshake is still in progress.
+         * @throws runtime_error  if the connection or the handshake fail.
+         */
+        static std::unique_ptr<PeerLink> handle(PendingNodeLink &link,
+                                                InputMultiplexer &multiplexer,
+                                                const DigitalSignature &digitalSignature,
+                                                const std::vector<unsigned char> &certificate);
+};
+
+}
+
+#endif //INC_4INAROW_NODEHANDLER_H
@@ -0,0 +1,278 @@
+#include <algorithm>
+#include <iostream>
+#include <utility>
+#include <Utils.h>
+#include <SocketException.h>
+#include <CryptoException.h>
+#include <SerializationException.h>
+#include <Challenge.h>
+#include <PlayerMessage.h>
+#include <DigitalSignature.h>
+#include "PeerHandler.h"
+
+namespace fourinarow {
+
+void PeerHandler::handleChallenge(const ForwardedChallenge &message,
+                                  unsigned int peer,
+                                  PlayerList &playerList,
+                                  PlayerStatusList &statusList,
+                                  const PeerList &peers,
+                                  PlayerRemovalList &removalList) {
+    const auto &challenged = message.getChallenged();
+    ForwardedChallenge notAvailable(PEER_CHALLENGE_RESPONSE, message.getChallenger(), challenged, PLAYER_NOT_AVAILABLE);
+
+    if (!statusList.contains(challenged) || statusList.get(challenged) != Player::Status::AVAILABLE) {
+        std::cout << "The player '" << challenged << "' is not available" << std::endl;
+        forwardToPeer(peers, peer, notAvailable);
+        return;
+    }
+
+    auto &iterator = findPlayerByUsername(playerList, challenged);
+
+    try {
+        Challenge challengePropagationMessage(message.getChallenger());
+        iterator.first.send(encryptAndAuthenticate(&challengePropagationMessage, iterator.second));
+        setMatchmakingStatus(iterator.second, statusList, message.getChallenger(), false);
+        std::cout << "CHALLENGE message forwarded to '" << challenged << '\'' << std::endl;
+    } catch (const std::exception &exception) {
+        std::cerr << "Error while forwarding the message. " << exception.what() << std::endl;
+        removalList.insert(challenged);
+        forwardToPeer(peers, peer, notAvailable);
+    }
+}
+
+void PeerHandler::handleChallengeResponse(const ForwardedChallenge &message,
+                                          PlayerList &playerList,
+                                          PlayerStatusList &statusList,
+                                          PlayerRemovalList &removalList) {
+    const auto &challenger = message.getChallenger();
+
+    if (!statusList.contains(challenger) || statusList.get(challenger) != Player::Status::MATCHMAKING) {
+        std::cout << "Ignoring the response: '" << challenger << "' is no longer waiting for it" << std::endl;
+        return;
+    }
+
+    auto &iterator = findPlayerByUsername(playerList, challenger);
+    auto &challengerPlayer = iterator.second;
+
+    if (!challengerPlayer.isMatchmakingInitiator() || challengerPlayer.getMatchmakingPlayer() != message.getChallenged()) {
+        std::cout << "Ignoring the response: '" << challenger << "' is no longer waiting for it" << std::endl;
+        return;
+    }
+
+    try {
+        // The challenged player may have disconnected after sending the response.
+        PresenceTable::Entry entry;
+        auto response = message.getResponse();
+        if (response == CHALLENGE_ACCEPTED && !statusList.findRemote(message.getChallenged(), entry)) {
+            response = PLAYER_NOT_AVAILABLE;
+        }
+
+        std::cout << "Forwarding the message to the challenger '" << challenger << "'" << std::endl;
+        InfoMessage challengeResponse(response);
+        iterator.first.send(encryptAndAuthenticate(&challengeResponse, challengerPlayer));
+
+        if (response != CHALLENGE_ACCEPTED) {
+            cancelMatchmakingStatus(challengerPlayer, statusList);
+            return;
+        }
+
+        std::string challengedPublicKeyPath = SERVER_PLAYERS_FOLDER + message.getChallenged() + SERVER_PLAYER_KEY_SUFFIX;
+        PlayerMessage toChallenger(entry.address,
+                                   DigitalSignature::serializePublicKey(challengedPublicKeyPath),
+                                   message.isChallengerFirstToPlay());
+
+        std::cout << "Sending a PLAYER message to the challenger '" << challenger << "'" << std::endl;
+        iterator.first.send(encryptAndAuthenticate(&toChallenger, challengerPlayer));
+
+        cancelMatchmakingStatus(challengerPlayer, statusList);
+        setPlayingStatus(challengerPlayer, statusList);
+    } catch (const std::exception &exception) {
+        std::cerr << "Error while forwarding the message. " << exception.what() << std::endl;
+        cancelMatchmakingStatus(challengerPlayer, statusList);
+        removalList.insert(challenger);
+    }
+}
+
+void PeerHandler::handleChallengeCancel(const ForwardedChallenge &message,
+                                        PlayerList &playerList,
+                                        PlayerStatusList &statusList) {
+    // The message is sent by the process of either party, so only one of the two is local.
+    const std::string *local = &message.getChallenged();
+    const std::string *remote = &message.getChallenger();
+    if (statusList.contains(message.getChallenger())) {
+        std::swap(local, remote);
+    }
+
+    if (!statusList.contains(*local) || statusList.get(*local) != Player::Status::MATCHMAKING) {
+        return;
+    }
+
+    auto &player = findPlayerByUsername(playerList, *local).second;
+    if (player.getMatchmakingPlayer() == *remote) {
+        std::cout << "Cancelling the matchmaking of '" << *local << "' with '" << *remote << "'" << std::endl;
+        cancelMatchmakingStatus(player, statusList);
+    }
+}
+
+void PeerHandler::handlePresenceUpdate(const PresenceUpdate &message, unsigned int peer, PlayerStatusList &statusList) {
+    for (const auto &entry : message.getEntries()) {
+        if (entry.status == static_cast<uint8_t>(Player::Status::OFFLINE)) {
+            statusList.eraseRemote(entry.username, peer);
+            continue;
+        }
+
+        if (entry.status > static_cast<uint8_t>(Player::Status::PLAYING)) {
+            std::cerr << "Ignoring the presence of '" << entry.username << "': invalid status" << std::endl;
+            continue;
+        }
+
+        if (!statusList.addRemote(entry.username, entry.address, peer, static_cast<Player::Status>(entry.status))) {
+            std::cerr << "Ignoring the presence of '" << entry.username << "': ";
+            std::cerr << "the player is connected to another node" << std::endl;
+        }
+    }
+}
+
+PresenceUpdate::Entry PeerHandler::createPresenceEntry(const std::string &username, const PlayerStatusList &statusList) {
+    PresenceUpdate::Entry entry{username, "", static_cast<uint8_t>(Player::Status::OFFLINE)};
+    PresenceTable::Entry tableEntry;
+
+    if (statusList.contains(username) && statusList.find(username, tableEntry)) {
+        entry.address = tableEntry.address;
+        entry.status = static_cast<uint8_t>(statusList.get(username));
+    }
+
+    return entry;
+}
+
+void PeerHandler::sendPresence(const PeerLink &link, const std::vector<PresenceUpdate::Entry> &entries) {
+    for (size_t first = 0; first < entries.size(); first += MAX_PRESENCE_UPDATE_ENTRIES) {
+        auto last = std::min(entries.size(), first + MAX_PRESENCE_UPDATE_ENTRIES);
+        PresenceUpdate message(std::vector<PresenceUpdate::Entry>(entries.begin() + first, entries.begin() + last));
+        sendToPeer(link, &message);
+    }
+}
+
+bool PeerHandler::handle(const PeerLink &link,
+                         unsigned int peer,
+                         PlayerList &playerList,
+                         PlayerStatusList &statusList,
+                         const PeerList &peers,
+                         PlayerRemovalList &removalList) {
+    try {
+        auto serializedMessage = receiveFromPeer(link);
+        auto type = getMessageType<SerializationException>(serializedMessage);
+
+        if (type == PEER_PRESENCE) {
+            PresenceUpdate message;
+            message.deserialize(serializedMessage);
+            std::cout << "Received a PEER_PRESENCE message from the peer " << peer << " with ";
+            std::cout << message.getEntries().size() << " entries" << std::endl;
+            handlePresenceUpdate(message, peer, statusList);
+            return true;
+        }
+
+        ForwardedChallenge message;
+        message.deserialize(serializedMessage);
+        std::cout << "Received a " << convertMessageType(message.getType()) << " message from the peer " << peer;
+        std::cout << std::endl;
+
+        if (message.getType() == PEER_CHALLENGE) {
+            handleChallenge(message, peer, playerList, statusList, peers, removalList);
+        } else if (message.getType() == PEER_CHALLENGE_RESPONSE) {
+            handleChallengeResponse(message, playerList, statusList, removalList);
+        } else {
+            handleChallengeCancel(message, playerList, statusList);
+        }
+    } catch (const SocketException &exception) {
+        std::cerr << "The link to the peer " << peer << " has been closed. " << exception.what() << std::endl;
+        return false;
+    } catch (const CryptoException &exception) {
+        // The sequence numbers of the session cannot be realigned, so the link is unusable.
+        std::cerr << "The link to the peer " << peer << " is broken. " << exception.what() << std::endl;
+        return false;
+    } catch (const std::exception &exception) {
+        std::cerr << "Error while handling the message of the peer " << peer << ". " << exception.what() << std::endl;
+    }
+
+    return true;
+}
+
+void PeerHandler::handleLostPeer(unsigned int peer,
+                                 PlayerList &playerList,
+                                 PlayerStatusList &statusList,
+                                 PlayerRemovalList &removalList) {
+    auto removed = statusList.eraseRemoteOwner(peer);
+    std::cerr << "Lost the link to the peer " << peer << ". Players removed: " << removed << std::endl;
+
+    for (auto &iterator : playerList) {
+        auto &player = iterator.second;
+        // The players waiting in the quick match queue have no opponent yet.
+        if (player.getStatus() != Player::Status::MATCHMAKING || player.getMatchmakingPlayer().empty() ||
+            statusList.isConnected(player.getMatchmakingPlayer())) {
+            continue;
+        }
+
+        std::cout << "Cancelling the matchmaking of '" << player.getUsername() << "' with '";
+        std::cout << player.getMatchmakingPlayer() << "'" << std::endl;
+
+        if (player.isMatchmakingInitiator()) {
+            try {
+                InfoMessage notAvailable(PLAYER_NOT_AVAILABLE);
+                iterator.first.send(encryptAndAuthenticate(&notAvailable, player));
+            } catch (const std::exception &exception) {
+                std::cerr << "Error while notifying the challenger. " << exception.what() << std::endl;
+                removalList.insert(player.getUsername());
+            }
+        }
+
+        cancelMatchmakingStatus(player, statusList);
+    }
+}
+
+bool PeerHandler::announceAllPresence(const PlayerStatusList &statusList, const PeerLink &link) {
+    std::vector<PresenceUpdate::Entry> entries;
+    for (const auto &iterator : statusList) {
+        auto entry = createPresenceEntry(iterator.first, statusList);
+        if (entry.status != static_cast<uint8_t>(Player::Status::OFFLINE)) {
+            entries.push_back(std::move(entry));
+        }
+    }
+
+    try {
+        sendPresence(link, entries);
+        return true;
+    } catch (const std::exception &exception) {
+        std::cerr << "Impossible to send the presence of the players. " << exception.what() << std::endl;
+        return false;
+    }
+}
+
+void PeerHandler::announcePresence(PlayerStatusList &statusList, const PeerList &peers) {
+    auto changes = statusList.takeChanges();
+    if (changes.empty()) {
+        return;
+    }
+
+    std::vector<PresenceUpdate::Entry> entries;
+    entries.reserve(changes.size());
+    for (const auto &username : changes) {
+        entries.push_back(createPresenceEntry(username, statusList));
+    }
+
+    for (unsigned int i = 0; i < peers.size(); i++) {
+        if (peers[i] == nullptr) {
+            continue;
+        }
+
+        try {
+            sendPresence(*peers[i], entries);
+        } catch (const std::exception &exception) {
+            std::cerr << "Impossible to send the presence of the players to the peer " << i << ". ";
+            std::cerr << exception.what() << std::endl;
+        }
+    }
+}
+
+}
@@ -0,0 +1,150 @@
+#ifndef INC_4INAROW_PEERHANDLER_H
+#define INC_4INAROW_PEERHANDLER_H
+
+#include <PresenceUpdate.h>
+#include "Handler.h"
+
+namespace fourinarow {
+
+/**
+ * Class representing a handler for messages sent by another process or node of the server.
+ * The processes exchange these messages to carry out a challenge between two players
+ * connected to different processes: the process of the challenger forwards the challenge,
+ * and the process of the challenged forwards the response or the cancellation of the matchmaking.
+ * The matches between players of different processes are always P2P.
+ * The nodes of a cluster exchange also the presence of their players, so that each node
+ * can list and challenge the players connected to the others. The presence is eventually consistent:
+ * every node sends a snapshot of its players when a link is established, and then the changes.
+ */
+class PeerHandler : public Handler {
+    private:
+        /**
+         * Handles a <code>PEER_CHALLENGE</code> message, forwarding the challenge to the challenged player.
+         * If the challenged player is not available, the process of the challenger receives
+         * a <code>PEER_CHALLENGE_RESPONSE</code> message carrying <code>PLAYER_NOT_AVAILABLE</code>.
+         * @param message      the message.
+         * @param peer         the index of the process or node which sent the message.
+         * @param playerList   the player list.
+         * @param statusList   the player status list.
+         * @param peers        the links to the other processes or nodes of the server.
+         * @param removalList  the player removal list.
+         */
+        static void handleChallenge(const ForwardedChallenge &message,
+                                    unsigned int peer,
+                                    PlayerList &playerList,
+                                    PlayerStatusList &statusList,
+                                    const PeerList &peers,
+                                    PlayerRemovalList &removalList);
+
+        /**
+         * Handles a <code>PEER_CHALLENGE_RESPONSE</code> message, forwarding the response to the challenger.
+         * If the challenge has been accepted, the challenger receives also the <code>PLAYER</code> message.
+         * The message is ignored if the challenger is no longer waiting for the response.
+         * @param message      the message.
+         * @param playerList   the player list.
+         * @param statusList   the player status list.
+         * @param removalList  the player removal list.
+         */
+        static void handleChallengeResponse(const ForwardedChallenge &message,
+                                            PlayerList &playerList,
+                                            PlayerStatusList &statusList,
+                                            PlayerRemovalList &removalList);
+
+        /**
+         * Handles a <code>PEER_CHALLENGE_CANCEL</code> message, cancelling the matchmaking of the local player,
+         * if it is still matched with the other one.
+         * @param message      the message.
+         * @param playerList   the player list.
+         * @param statusList   the player status list.
+         */
+        static void handleChallengeCancel(const ForwardedChallenge &message,
+                                          PlayerList &playerList,
+                                          PlayerStatusList &statusList);
+
+        /**
+         * Handles a <code>PEER_PRESENCE</code> message, updating the players connected to the node which sent it.
+         * The entries conflicting with the players connected to this node or to another one are ignored.
+         * @param message     the message.
+         * @param peer        the index of the node which sent the message.
+         * @param statusList  the player status list.
+         */
+        static void handlePresenceUpdate(const PresenceUpdate &message, unsigned int peer, PlayerStatusList &statusList);
+
+        /**
+         * Creates the entry of a <code>PEER_PRESENCE</code> message describing a local player.
+         * @param username    the username of the player.
+         * @param statusList  the player status list.
+         * @return            the entry, carrying no address if the player is no longer connected.
+         */
+        static PresenceUpdate::Entry createPresenceEntry(const std::string &username, const PlayerStatusList &statusList);
+
+        /**
+         * Sends the given entries to a node, split in <code>PEER_PRESENCE</code> messages
+         * of at most <code>MAX_PRESENCE_UPDATE_ENTRIES</code> entries.
+         * @param link     the link to the node.
+         * @param entries  the entries.
+         * @throws SocketException  if an error occurs while sending the messages.
+         * @throws CryptoException  if an error occurs while encrypting the messages,
+         *                          or the maximum sequence number has been reached.
+         */
+        static void sendPresence(const PeerLink &link, const std::vector<PresenceUpdate::Entry> &entries);
+    public:
+        PeerHandler() = delete;
+        ~PeerHandler() = delete;
+        PeerHandler(const PeerHandler&) = delete;
+        PeerHandler(PeerHandler&&) = delete;
+        PeerHandler &operator=(const PeerHandler&) = delete;
+        PeerHandler &operator=(PeerHandler&&) = delete;
+
+        /**
+         * Handles a message sent by another process or node of the server.
+         * @param link         the link to the process or node.
+         * @param peer         the index of the process or node.
+         * @param playerList   the player list.
+         * @param statusList   the player status list.
+         * @param peers        the links to the other processes or nodes of the server.
+         * @param removalList  the player removal list.
+         * @return             false if the link has been closed, true otherwise.
+         */
+        static bool handle(const PeerLink &link,
+                           unsigned int peer,
+                           PlayerList &playerList,
+                           PlayerStatusList &statusList,
+                           const PeerList &peers,
+                           PlayerRemovalList &removalList);
+
+        /**
+         * Removes the players connected to a process or node whose link has been lost, and cancels
+         * the matchmaking of the local players challenging them or challenged by them.
+         * A challenger still waiting for the response receives a <code>PLAYER_NOT_AVAILABLE</code> message.
+         * @param peer         the index of the process or node.
+         * @param playerList   the player list.
+         * @param statusList   the player status list.
+         * @param removalList  the player removal list.
+         */
+        static void handleLostPeer(unsigned int peer,
+                                   PlayerList &playerList,
+                                   PlayerStatusList &statusList,
+                                   PlayerRemovalList &removalList);
+
+        /**
+         * Sends to a node the presence of all the players connected to this node.
+         * It is called when the link to the node is established.
+         * @param statusList  the player status list.
+         * @param link        the link to the node.
+         * @return            true if the presence has been sent, false otherwise.
+         */
+        static bool announceAllPresence(const PlayerStatusList &statusList, const PeerLink &link);
+
+        /**
+         * Sends to every linked node the changes of the local players since the last call, if any.
+         * A failure is only logged: the link is reset when its closure is detected while receiving.
+         * @param statusList  the player status list.
+         * @param peers       the links to the other nodes of the cluster.
+         */
+        static void announcePresence(PlayerStatusList &statusList, const PeerList &peers);
+};
+
+}
+
+#endif //INC_4INAROW_PEERHANDLER_H
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <Utils.h>
+#include <Move.h>
 #include <SerializationException.h>
 #include <SocketException.h>
 #include <CryptoException.h>
@@ -9,26 +10,150 @@ namespace fourinarow {
 
 void PlayingClientHandler::setAvailableStatus(Player &player, PlayerStatusList &statusList) {
     player.setStatus(Player::Status::AVAILABLE);
-    statusList[player.getUsername()] = Player::Status::AVAILABLE;
+    statusList.set(player.getUsername(), Player::Status::AVAILABLE);
+}
+
+bool PlayingClientHandler::failSafeSendToParticipant(const MatchTable::Handle &match,
+                                                     unsigned int participant,
+                                                     const Message &message,
+                                                     const MatchTable &matchTable,
+                                                     const PlayerDescriptorList &descriptorList,
+                                                     PlayerRemovalList &removalList) {
+    if (matchTable.hasLeft(match, participant)) {
+        return false;
+    }
+
+    auto entry = descriptorList.find(matchTable.getParticipant(match, participant));
+    if (entry == descriptorList.end()) {
+        return false;
+    }
+
+    auto &socket = entry->second->first;
+    auto &player = entry->second->second;
+
+    try {
+        socket.send(encryptAndAuthenticate(&message, player));
+        return true;
+    } catch (const std::exception &exception) {
+        std::cerr << "Error while sending a message to '" << player.getUsername() << "'. ";
+        std::cerr << exception.what() << std::endl;
+        removalList.insert(player.getUsername());
+        return false;
+    }
+}
+
+void PlayingClientHandler::recordMatch(const MatchTable::Handle &match,
+                                       GameRecord::Result result,
+                                       const MatchTable &matchTable,
+                                       const PlayerDescriptorList &descriptorList,
+                                       GameJournal *journal) {
+    if (journal == nullptr) {
+        return;
+    }
+
+    // The first player of a record is the one who made the first move.
+    auto starter = matchTable.getStartingParticipant(match);
+    std::string usernames[2];
+    for (unsigned int i = 0; i < 2; i++) {
+        auto entry = descriptorList.find(matchTable.getParticipant(match, starter ^ i));
+        if (entry != descriptorList.end()) {
+            usernames[i] = entry->second->second.getUsername();
+        }
+    }
+
+    GameRecord game{usernames[0], usernames[1], matchTable.getStartTime(match), currentTimeMillis(), result, {}};
+    matchTable.getMoves(match, game.moves);
+
+    try {
+        if (!journal->append(game)) {
+            std::cerr << "The game journal is full: the match has not been recorded" << std::endl;
+        }
+    } catch (const std::exception &exception) {
+        std::cerr << "Error while recording the match. " << exception.what() << std::endl;
+    }
+}
+
+void PlayingClientHandler::updateRatings(const MatchTable::Handle &match,
+                                         unsigned int mover,
+                                         MatchResult result,
+                                         const MatchTable &matchTable,
+                                         const PlayerDescriptorList &descriptorList,
+                                         RatingTable &ratingTable) {
+    if (matchTable.hasLeft(match, mover) || matchTable.hasLeft(match, 1 - mover)) {
+        return;
+    }
+
+    auto moverEntry = descriptorList.find(matchTable.getParticipant(match, mover));
+    auto opponentEntry = descriptorList.find(matchTable.getParticipant(match, 1 - mover));
+    if (moverEntry == descriptorList.end() || opponentEntry == descriptorList.end()) {
+        return;
+    }
+
+    const auto &moverUsername = moverEntry->second->second.getUsername();
+    const auto &opponentUsername = opponentEntry->second->second.getUsername();
+    ratingTable.update(moverUsername, opponentUsername, result);
+    std::cout << "Ratings updated: '" << moverUsername << "' " << ratingTable.get(moverUsername) << ", '";
+    std::cout << opponentUsername << "' " << ratingTable.get(opponentUsername) << std::endl;
+}
+
+void PlayingClientHandler::interruptRelayedMatch(const MatchTable::Handle &match,
+                                                 unsigned int participant,
+                                                 MatchTable &matchTable,
+                                                 const PlayerDescriptorList &descriptorList,
+                                                 PlayerRemovalList &removalList,
+                                                 GameJournal *journal) {
+    if (matchTable.isFinished(match)) {
+        return;
+    }
+
+    recordMatch(match, GameRecord::Result::INTERRUPTED, matchTable, descriptorList, journal);
+    matchTable.finish(match);
+    failSafeSendToParticipant(match, 1 - participant, InfoMessage(GOODBYE), matchTable, descriptorList, removalList);
 }
 
 void PlayingClientHandler::handle(const TcpSocket &socket,
                                   Player &player,
                                   PlayerStatusList &statusList,
-                                  PlayerRemovalList &removalList) {
+                                  MatchTable &matchTable,
+                                  RelayedMatchList &matchList,
+                                  const PlayerDescriptorList &descriptorList,
+                                  PlayerRemovalList &removalList,
+                                  GameJournal *journal) {
     try {
         auto encryptedMessage = socket.receive();
         auto message = authenticateAndDecrypt(encryptedMessage, player);
         auto type = getMessageType<SerializationException>(message);
-        cleanse(message);
 
         if (type == END_GAME) {
             std::cout << "Received an END_GAME message. Making the client available again for playing" << std::endl;
+            cleanse(message);
+            leaveRelayedMatch(socket, player, matchTable, matchList, descriptorList, removalList, journal);
             setAvailableStatus(player, statusList);
             cleanse(type);
             return;
         }
 
+        auto match = matchList.find(player.getUsername());
+        if (match != matchList.end() && type == MOVE) {
+            Move move;
+            move.deserialize(message);
+            cleanse(message);
+            auto participant = matchTable.findParticipant(match->second, socket.getDescriptor());
+            matchTable.submitMove(match->second, participant, move.getColumn());
+            cleanse(type);
+            return;
+        }
+
+        if (match != matchList.end() && type == GOODBYE) {
+            std::cout << "Received a GOODBYE message. Ending the match" << std::endl;
+            cleanse(message);
+            auto participant = matchTable.findParticipant(match->second, socket.getDescriptor());
+            interruptRelayedMatch(match->second, participant, matchTable, descriptorList, removalList, journal);
+            cleanse(type);
+            return;
+        }
+
+        cleanse(message);
         std::cerr << "Protocol violation: received " << convertMessageType(type) << std::endl;
         cleanse(type);
         InfoMessage protocolViolation(PROTOCOL_VIOLATION);
@@ -52,4 +177,69 @@ void PlayingClientHandler::handle(const TcpSocket &socket,
     }
 }
 
+void PlayingClientHandler::forwardMoves(MatchTable &matchTable,
+                                        const PlayerDescriptorList &descriptorList,
+                                        PlayerRemovalList &removalList,
+                                        RatingTable &ratingTable,
+                                        GameJournal *journal) {
+    if (matchTable.getPendingMoveCount() == 0) {
+        return;
+    }
+
+    std::vector<MatchTable::MoveResult> results;
+    matchTable.processMoves(results);
+
+    for (const auto &result : results) {
+        if (result.outcome == MatchTable::Outcome::IGNORED) {
+            continue;
+        }
+
+        if (result.outcome == MatchTable::Outcome::REJECTED) {
+            std::cerr << "Protocol violation: invalid move. Ending the match" << std::endl;
+            recordMatch(result.match, GameRecord::Result::INTERRUPTED, matchTable, descriptorList, journal);
+            failSafeSendToParticipant(result.match, 1 - result.participant, InfoMessage(GOODBYE),
+                                      matchTable, descriptorList, removalList);
+            failSafeSendToParticipant(result.match, result.participant, InfoMessage(PROTOCOL_VIOLATION),
+                                      matchTable, descriptorList, removalList);
+            continue;
+        }
+
+        if (result.outcome == MatchTable::Outcome::WIN) {
+            auto moverStarted = result.participant == matchTable.getStartingParticipant(result.match);
+            auto winner = moverStarted ? GameRecord::Result::FIRST_PLAYER_WINS : GameRecord::Result::SECOND_PLAYER_WINS;
+            recordMatch(result.match, winner, matchTable, descriptorList, journal);
+            updateRatings(result.match, result.participant, MatchResult::WIN, matchTable, descriptorList, ratingTable);
+        } else if (result.outcome == MatchTable::Outcome::DRAW) {
+            recordMatch(result.match, GameRecord::Result::DRAW, matchTable, descriptorList, journal);
+            updateRatings(result.match, result.participant, MatchResult::DRAW, matchTable, descriptorList, ratingTable);
+        }
+
+        if (!failSafeSendToParticipant(result.match, 1 - result.participant, Move(result.column),
+                                       matchTable, descriptorList, removalList)) {
+            interruptRelayedMatch(result.match, 1 - result.participant, matchTable, descriptorList, removalList, journal);
+        }
+    }
+}
+
+void PlayingClientHandler::leaveRelayedMatch(const TcpSocket &socket,
+                                             const Player &player,
+                                             MatchTable &matchTable,
+                                             RelayedMatchList &matchList,
+                                             const PlayerDescriptorList &descriptorList,
+                                             PlayerRemovalList &removalList,
+                                             GameJournal *journal) {
+    auto match = matchList.find(player.getUsername());
+    if (match == matchList.end()) {
+        return;
+    }
+
+    if (matchTable.contains(match->second)) {
+        auto participant = matchTable.findParticipant(match->second, socket.getDescriptor());
+        interruptRelayedMatch(match->second, participant, matchTable, descriptorList, removalList, journal);
+        matchTable.leave(match->second, participant);
+    }
+
+    matchList.erase(match);
+}
+
 }
@@ -1,12 +1,18 @@
 #ifndef INC_4INAROW_PLAYINGCLIENTHANDLER_H
 #define INC_4INAROW_PLAYINGCLIENTHANDLER_H
 
+#include <GameJournal.h>
+#include <RatingTable.h>
 #include "Handler.h"
 
 namespace fourinarow {
 
 /**
  * Class representing a handler for messages sent by a player in the <code>PLAYING</code> status.
+ * If the match is relayed by the server, the moves of the player are submitted to the match table,
+ * and are validated and forwarded to the opponent at the end of the service loop iteration.
+ * If a game journal is given, each relayed match is appended to it when it finishes.
+ * The relayed matches won or drawn on the board update the ratings of the players.
  */
 class PlayingClientHandler : public Handler {
     private:
@@ -17,6 +23,74 @@ class PlayingClientHandler : public Handler {
          */
         static void setAvailableStatus(Player &player, PlayerStatusList &statusList);
 
+        /**
+         * Sends a message to a participant of a relayed match, without throwing an exception
+         * if a failure occurs. Nothing is sent if the participant has already left the match.
+         * If the message cannot be sent, the participant is put in the removal list.
+         * @param match           the handle of the match.
+         * @param participant     the index of the participant.
+         * @param message         the message.
+         * @param matchTable      the relayed match table.
+         * @param descriptorList  the index of the player list by socket descriptor.
+         * @param removalList     the player removal list.
+         * @return                true if the message is sent correctly, false otherwise.
+         */
+        static bool failSafeSendToParticipant(const MatchTable::Handle &match,
+                                              unsigned int participant,
+                                              const Message &message,
+                                              const MatchTable &matchTable,
+                                              const PlayerDescriptorList &descriptorList,
+                                              PlayerRemovalList &removalList);
+
+        /**
+         * Appends a finished relayed match to the game journal, without throwing an exception
+         * if a failure occurs. Nothing is done if the journal is null.
+         * @param match           the handle of the match.
+         * @param result          the result of the match.
+         * @param matchTable      the relayed match table.
+         * @param descriptorList  the index of the player list by socket descriptor.
+         * @param journal         the game journal. It can be null.
+         */
+        static void recordMatch(const MatchTable::Handle &match,
+                                GameRecord::Result result,
+                                const MatchTable &matchTable,
+                                const PlayerDescriptorList &descriptorList,
+                                GameJournal *journal);
+
+        /**
+         * Updates the ratings of the participants of a relayed match won or drawn on the board.
+         * Nothing is done if a participant is no longer connected.
+         * @param match           the handle of the match.
+         * @param mover           the index of the participant who made the last move.
+         * @param result          the result of the match, from the point of view of the mover.
+         * @param matchTable      the relayed match table.
+         * @param descriptorList  the index of the player list by socket descriptor.
+         * @param ratingTable     the rating table.
+         */
+        static void updateRatings(const MatchTable::Handle &match,
+                                  unsigned int mover,
+                                  MatchResult result,
+                                  const MatchTable &matchTable,
+                                  const PlayerDescriptorList &descriptorList,
+                                  RatingTable &ratingTable);
+
+        /**
+         * Finishes a relayed match, sending a <code>GOODBYE</code> message to the opponent
+         * of the given participant and recording the match as interrupted.
+         * Nothing is done if the match is already finished.
+         * @param match           the handle of the match.
+         * @param participant     the index of the participant ending the match.
+         * @param matchTable      the relayed match table.
+         * @param descriptorList  the index of the player list by socket descriptor.
+         * @param removalList     the player removal list.
+         * @param journal         the game journal. It can be null.
+         */
+        static void interruptRelayedMatch(const MatchTable::Handle &match,
+                                          unsigned int participant,
+                                          MatchTable &matchTable,
+                                          const PlayerDescriptorList &descriptorList,
+                                          PlayerRemovalList &removalList,
+                                          GameJournal *journal);
     public:
         PlayingClientHandler() = delete;
         ~PlayingClientHandler() = delete;
@@ -27,16 +101,60 @@ class PlayingClientHandler : public Handler {
 
         /**
          * Handles a message sent by a player in the <code>PLAYING</code> status.
-         * @param socket       the socket used to communicate.
-         * @param player       the player.
-         * @param statusList   the player status list.
-         * @param removalList  the player removal list.
+         * @param socket          the socket used to communicate.
+         * @param player          the player.
+         * @param statusList      the player status list.
+         * @param matchTable      the relayed match table.
+         * @param matchList       the relayed match list.
+         * @param descriptorList  the index of the player list by socket descriptor.
+         * @param removalList     the player removal list.
+         * @param journal         the game journal. It can be null.
          */
         static void handle(const TcpSocket &socket,
                            Player &player,
                            PlayerStatusList &statusList,
-                           PlayerRemovalList &removalList);
+                           MatchTable &matchTable,
+                           RelayedMatchList &matchList,
+                           const PlayerDescriptorList &descriptorList,
+                           PlayerRemovalList &removalList,
+                           GameJournal *journal);
+
+        /**
+         * Validates the moves submitted to the match table during the current iteration of the service loop.
+         * A valid move is forwarded to the opponent, while an invalid one ends the match:
+         * the player receives a <code>PROTOCOL_VIOLATION</code> message and the opponent a <code>GOODBYE</code> one.
+         * The moves received after the end of the match are ignored.
+         * @param matchTable      the relayed match table.
+         * @param descriptorList  the index of the player list by socket descriptor.
+         * @param removalList     the player removal list.
+         * @param ratingTable     the rating table.
+         * @param journal         the game journal. It can be null.
+         */
+        static void forwardMoves(MatchTable &matchTable,
+                                 const PlayerDescriptorList &descriptorList,
+                                 PlayerRemovalList &removalList,
+                                 RatingTable &ratingTable,
+                                 GameJournal *journal);
 
+        /**
+         * Removes a player from the relayed match the player is taking part in, if any.
+         * If the match is not finished, it is finished and the opponent receives a <code>GOODBYE</code> message.
+         * It must be called also when a player is disconnected, before removing the player from the player list.
+         * @param socket          the socket used to communicate with the player.
+         * @param player          the player.
+         * @param matchTable      the relayed match table.
+         * @param matchList       the relayed match list.
+         * @param descriptorList  the index of the player list by socket descriptor.
+         * @param removalList     the player removal list.
+         * @param journal         the game journal. It can be null.
+         */
+        static void leaveRelayedMatch(const TcpSocket &socket,
+                                      const Player &player,
+                                      MatchTable &matchTable,
+                                      RelayedMatchList &matchList,
+                                      const PlayerDescriptorList &descriptorList,
+                                      PlayerRemovalList &removalList,
+                                      GameJournal *journal);
 };
 
 }
@@ -0,0 +1,156 @@
+#include <iostream>
+#include <Utils.h>
+#include <CSPRNG.h>
+#include <Challenge.h>
+#include <InfoMessage.h>
+#include <DigitalSignature.h>
+#include "QuickMatchHandler.h"
+
+namespace fourinarow {
+
+QuickMatchHandler::PlayerList::value_type* QuickMatchHandler::findQueuedPlayer(const QuickMatchQueue::Entry &entry,
+                                                            const PlayerDescriptorList &descriptorList,
+                                                            const PlayerRemovalList &removalList) {
+    auto iterator = descriptorList.find(entry.handle);
+    if (iterator == descriptorList.end() || removalList.count(entry.username) != 0) {
+        return nullptr;
+    }
+
+    auto &player = iterator->second->second;
+    if (player.getUsername() != entry.username || player.getStatus() != Player::Status::MATCHMAKING ||
+        !player.getMatchmakingPlayer().empty()) {
+        return nullptr;
+    }
+
+    return iterator->second;
+}
+
+bool QuickMatchHandler::sendMatchFound(PlayerList::value_type &player,
+                                       const std::string &opponent,
+                                       const PlayerMessage &message,
+                                       PlayerRemovalList &removalList) {
+    std::cout << "Sending a QUICK_MATCH_FOUND message to '" << player.second.getUsername() << "', ";
+    std::cout << "matched with '" << opponent << "'" << std::endl;
+
+    try {
+        Challenge matchFound(opponent, QUICK_MATCH_FOUND);
+        player.first.send(encryptAndAuthenticate(&matchFound, player.second));
+        player.first.send(encryptAndAuthenticate(&message, player.second));
+        return true;
+    } catch (const std::exception &exception) {
+        std::cerr << "Error while sending the message. " << exception.what() << std::endl;
+        removalList.insert(player.second.getUsername());
+        return false;
+    }
+}
+
+void QuickMatchHandler::sendAbort(PlayerList::value_type &player, uint8_t type, PlayerRemovalList &removalList) {
+    std::cout << "Sending a " << convertMessageType(type) << " message to '" << player.second.getUsername() << "'";
+    std::cout << std::endl;
+
+    try {
+        InfoMessage abort(type);
+        player.first.send(encryptAndAuthenticate(&abort, player.second));
+    } catch (const std::exception &exception) {
+        std::cerr << "Error while sending the message. " << exception.what() << std::endl;
+        removalList.insert(player.second.getUsername());
+    }
+}
+
+void QuickMatchHandler::startMatch(PlayerList::value_type &first,
+                                   PlayerList::value_type &second,
+                                   bool relay,
+                                   QuickMatchQueue &queue,
+                                   const QuickMatchQueue::Pairing &pairing,
+                                   PlayerStatusList &statusList,
+                                   MatchTable &matchTable,
+                                   RelayedMatchList &matchList,
+                                   PlayerRemovalList &removalList) {
+    auto firstToPlay = CSPRNG::nextBool();
+    PlayerMessage toFirst(firstToPlay);
+    PlayerMessage toSecond(!firstToPlay);
+
+    if (!relay) {
+        std::string firstPublicKeyPath = SERVER_PLAYERS_FOLDER + first.second.getUsername() + SERVER_PLAYER_KEY_SUFFIX;
+        std::string secondPublicKeyPath = SERVER_PLAYERS_FOLDER + second.second.getUsername() + SERVER_PLAYER_KEY_SUFFIX;
+
+        toFirst = PlayerMessage(second.first.getDestinationAddress(),
+                                DigitalSignature::serializePublicKey(secondPublicKeyPath),
+                                firstToPlay);
+        toSecond = PlayerMessage(first.first.getDestinationAddress(),
+                                 DigitalSignature::serializePublicKey(firstPublicKeyPath),
+                                 !firstToPlay);
+    }
+
+    if (!sendMatchFound(first, second.second.getUsername(), toFirst, removalList)) {
+        queue.push(pairing.second);
+        return;
+    }
+
+    if (!sendMatchFound(second, first.second.getUsername(), toSecond, removalList)) {
+        /*
+         * The first player believes the match has started: it is put in the PLAYING state,
+         * where its END_GAME is accepted, and told that the opponent has left.
+         */
+        cancelMatchmakingStatus(first.second, statusList);
+        setPlayingStatus(first.second, statusList);
+        sendAbort(first, GOODBYE, removalList);
+        return;
+    }
+
+    if (relay) {
+        auto match = matchTable.create(first.first.getDescriptor(), second.first.getDescriptor(), firstToPlay,
+                                       currentTimeMillis());
+        matchList[first.second.getUsername()] = match;
+        matchList[second.second.getUsername()] = match;
+    }
+
+    cancelMatchmakingStatus(first.second, statusList);
+    cancelMatchmakingStatus(second.second, statusList);
+    setPlayingStatus(first.second, statusList);
+    setPlayingStatus(second.second, statusList);
+}
+
+void QuickMatchHandler::matchQueuedPlayers(QuickMatchQueue &queue,
+                                           const PlayerDescriptorList &descriptorList,
+                                           PlayerStatusList &statusList,
+                                           bool relay,
+                                           MatchTable &matchTable,
+                                           RelayedMatchList &matchList,
+                                           PlayerRemovalList &removalList) {
+    if (queue.size() < 2) {
+        return;
+    }
+
+    std::vector<QuickMatchQueue::Pairing> pairings;
+    queue.match(currentTimeMillis(), pairings);
+
+    for (const auto &pairing : pairings) {
+        auto first = findQueuedPlayer(pairing.first, descriptorList, removalList);
+        auto second = findQueuedPlayer(pairing.second, descriptorList, removalList);
+
+        if (first == nullptr || second == nullptr) {
+            // The players are removed from the queue when they leave it, so this should happen only on a removal.
+            if (first != nullptr) {
+                queue.push(pairing.first);
+            }
+            if (second != nullptr) {
+                queue.push(pairing.second);
+            }
+            continue;
+        }
+
+        try {
+            startMatch(*first, *second, relay, queue, pairing, statusList, matchTable, matchList, removalList);
+        } catch (const std::exception &exception) {
+            // Only the public keys of the players can cause an error here, and none of them has been notified.
+            std::cerr << "Error while starting the quick match. " << exception.what() << std::endl;
+            cancelMatchmakingStatus(first->second, statusList);
+            cancelMatchmakingStatus(second->second, statusList);
+            sendAbort(*first, PLAYER_NOT_AVAILABLE, removalList);
+            sendAbort(*second, PLAYER_NOT_AVAILABLE, removalList);
+        }
+    }
+}
+
+}
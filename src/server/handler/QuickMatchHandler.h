@@ -0,0 +1,113 @@
+#ifndef INC_4INAROW_QUICKMATCHHANDLER_H
+#define INC_4INAROW_QUICKMATCHHANDLER_H
+
+#include <PlayerMessage.h>
+#include <QuickMatchQueue.h>
+#include "Handler.h"
+
+namespace fourinarow {
+
+/**
+ * Class representing a handler for the players waiting in the quick match queue.
+ * At the end of each iteration of the service loop, the queue pairs its players, and each of them
+ * receives a <code>QUICK_MATCH_FOUND</code> message carrying the username of the opponent,
+ * immediately followed by the <code>PLAYER</code> or <code>RELAYED_PLAYER</code> message,
+ * without the challenge exchange. The player waiting for the longest time is served first.
+ */
+class QuickMatchHandler : public Handler {
+    private:
+        /**
+         * Finds a player of a pairing in the player list, checking that it is still waiting in the queue.
+         * @param entry           the entry of the player in the queue.
+         * @param descriptorList  the index of the player list by socket descriptor.
+         * @param removalList     the player removal list.
+         * @return                the entry of the player list, or null if the player left the queue.
+         */
+        static PlayerList::value_type* findQueuedPlayer(const QuickMatchQueue::Entry &entry,
+                                                        const PlayerDescriptorList &descriptorList,
+                                                        const PlayerRemovalList &removalList);
+
+        /**
+         * Sends the <code>QUICK_MATCH_FOUND</code> and the <code>PLAYER</code> messages to a paired player.
+         * If an error occurs while sending the messages, the player is put in the removal list
+         * and no exceptions are thrown.
+         * @param player       the entry of the player list of the player.
+         * @param opponent     the username of the opponent.
+         * @param message      the <code>PLAYER</code> or <code>RELAYED_PLAYER</code> message.
+         * @param removalList  the player removal list.
+         * @return             true if the messages are sent correctly, false otherwise.
+         */
+        static bool sendMatchFound(PlayerList::value_type &player,
+                                   const std::string &opponent,
+                                   const PlayerMessage &message,
+                                   PlayerRemovalList &removalList);
+
+        /**
+         * Sends a message ending the quick match of a player, either before or after the opponent has been notified.
+         * If an error occurs while sending the message, the player is put in the removal list
+         * and no exceptions are thrown.
+         * @param player       the entry of the player list of the player.
+         * @param type         the type of the message: <code>PLAYER_NOT_AVAILABLE</code> if the player is still
+         *                     waiting for an opponent, <code>GOODBYE</code> if the match has already been notified.
+         * @param removalList  the player removal list.
+         */
+        static void sendAbort(PlayerList::value_type &player, uint8_t type, PlayerRemovalList &removalList);
+
+        /**
+         * Starts the match between two paired players. If the first player cannot be notified,
+         * the second one is put back in the queue. If the second player cannot be notified,
+         * the first one, which already received the opponent, is put in the playing state
+         * and receives a <code>GOODBYE</code>, as if the opponent had left the match.
+         * @param first        the entry of the player list of the player waiting for the longest time.
+         * @param second       the entry of the player list of the other player.
+         * @param relay        true if the server relays the matches, false if they are P2P.
+         * @param queue        the quick match queue.
+         * @param pairing      the pairing of the two players.
+         * @param statusList   the player status list.
+         * @param matchTable   the relayed match table.
+         * @param matchList    the relayed match list.
+         * @param removalList  the player removal list.
+         */
+        static void startMatch(PlayerList::value_type &first,
+                               PlayerList::value_type &second,
+                               bool relay,
+                               QuickMatchQueue &queue,
+                               const QuickMatchQueue::Pairing &pairing,
+                               PlayerStatusList &statusList,
+                               MatchTable &matchTable,
+                               RelayedMatchList &matchList,
+                               PlayerRemovalList &removalList);
+    public:
+        QuickMatchHandler() = delete;
+        ~QuickMatchHandler() = delete;
+        QuickMatchHandler(const QuickMatchHandler&) = delete;
+        QuickMatchHandler(QuickMatchHandler&&) = delete;
+        QuickMatchHandler &operator=(const QuickMatchHandler&) = delete;
+        QuickMatchHandler &operator=(QuickMatchHandler&&) = delete;
+
+        /**
+         * Pairs the players waiting in the quick match queue and starts their matches.
+         * A player whose opponent left the queue in the meantime is put back in the queue,
+         * keeping its original arrival time. If the match cannot be created, both players
+         * receive a <code>PLAYER_NOT_AVAILABLE</code> message. If the server relays the matches, each match
+         * is created in the match table and added to the relayed match list.
+         * @param queue           the quick match queue.
+         * @param descriptorList  the index of the player list by socket descriptor.
+         * @param statusList      the player status list.
+         * @param relay           true if the server relays the matches, false if they are P2P.
+         * @param matchTable      the relayed match table.
+         * @param matchList       the relayed match list.
+         * @param removalList     the player removal list.
+         */
+        static void matchQueuedPlayers(QuickMatchQueue &queue,
+                                       const PlayerDescriptorList &descriptorList,
+                                       PlayerStatusList &statusList,
+                                       bool relay,
+                                       MatchTable &matchTable,
+                                       RelayedMatchList &matchList,
+                                       PlayerRemovalList &removalList);
+};
+
+}
+
+#endif //INC_4INAROW_QUICKMATCHHANDLER_H
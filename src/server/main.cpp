@@ -1,10 +1,17 @@
+#include <chrono>
 #include <iostream>
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 #include <string>
 #include <vector>
+#include <errno.h>
+#include <signal.h>
 #include <string.h>
+#include <unistd.h>
 #include <arpa/inet.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
 #include <Constants.h>
 #include <Utils.h>
 #include <TcpSocket.h>
@@ -12,27 +19,56 @@
 #include <Player.h>
 #include <CertificateStore.h>
 #include <DigitalSignature.h>
+#include <SessionTicketKey.h>
+#include <DelegatedKey.h>
 #include <InputMultiplexer.h>
+#include <SocketException.h>
+#include <MatchTable.h>
+#include <GameJournal.h>
+#include <PresenceTable.h>
+#include <PlayerStatusList.h>
+#include <PeerLink.h>
+#include <QuickMatchQueue.h>
+#include <RatingTable.h>
 #include "handler/NewClientHandler.h"
 #include "handler/ConnectedClientHandler.h"
 #include "handler/HandshakeClientHandler.h"
 #include "handler/AvailableClientHandler.h"
 #include "handler/MatchmakingClientHandler.h"
 #include "handler/PlayingClientHandler.h"
+#include "handler/QuickMatchHandler.h"
+#include "handler/PeerHandler.h"
+#include "handler/NodeHandler.h"
 
 using PlayerList = std::unordered_map<fourinarow::TcpSocket, fourinarow::Player, fourinarow::TcpSocketHasher>;
-using PlayerStatusList = std::unordered_map<std::string, fourinarow::Player::Status>;
 using PlayerRemovalList = std::unordered_set<std::string>;
+using PlayerDescriptorList = std::unordered_map<unsigned int, PlayerList::value_type*>;
+using RelayedMatchList = std::unordered_map<std::string, fourinarow::MatchTable::Handle>;
+using PeerDescriptorList = std::unordered_map<unsigned int, unsigned int>;
+using PeerList = std::vector<std::unique_ptr<fourinarow::PeerLink>>; // By process or node index. Null for this process or node.
+using PendingNodeLinkList = std::unordered_map<unsigned int, std::unique_ptr<fourinarow::PendingNodeLink>>; // By socket descriptor.
 
 /**
  * Prints a help message describing how to invoke the program from the command line.
  */
 void printHelp() {
-    std::string helpMessage("Usage: server [-h] -a ADDRESS \n"
+    std::string helpMessage("Usage: server [-h] -a ADDRESS [-r] [-j JOURNAL] [-p PROCESSES] [-c NODES] \n"
                             "\n"
                             "Options:\n"
                             " -h, --help              Show this help message and exit\n"
-                            " -a, --address ADDRESS   The IPv4 address of the server");
+                            " -a, --address ADDRESS   The IPv4 address of the server\n"
+                            " -r, --relay             Relay and validate the moves of the matches,\n"
+                            "                         instead of letting the players connect P2P\n"
+                            " -j, --journal JOURNAL   The path of the journal file recording the relayed\n"
+                            "                         matches. It requires the relay mode\n"
+                            " -p, --processes PROCESSES\n"
+                            "                         The number of processes serving the clients,\n"
+                            "                         from 1 (default) to " + std::to_string(fourinarow::SERVER_MAX_PROCESSES) + ". It is not\n"
+                            "                         supported in relay mode\n"
+                            " -c, --cluster NODES     The comma-separated IPv4 addresses of the nodes of\n"
+                            "                         a cluster sharing the players, including ADDRESS,\n"
+                            "                         from 2 to " + std::to_string(fourinarow::SERVER_MAX_NODES) + " nodes. It requires a single\n"
+                            "                         process and is not supported in relay mode");
     std::cout << helpMessage << std::endl;
 }
 
@@ -45,23 +81,87 @@ void printHelp() {
  * @param argc           the number of arguments passed via command line.
  * @param argv           the arguments passed via command line.
  * @param serverAddress  a reference to the variable that will store the server address.
+ * @param relay          a reference to the variable that will store true if the matches
+ *                       must be relayed by the server, false otherwise.
+ * @param journalPath    a reference to the variable that will store the path of the game journal,
+ *                       or an empty string if the matches are not recorded.
+ * @param processes      a reference to the variable that will store the number of processes serving the clients.
+ * @param cluster        a reference to the variable that will store the addresses of the nodes of the cluster,
+ *                       or an empty vector if the server is not part of a cluster.
  * @return               true if all and only the required arguments are supplied via
  *                       command line, false otherwise.
  */
-bool parseArguments(int argc, char *argv[], std::string &serverAddress) {
-    if (argc != 3) {
+bool parseArguments(int argc,
+                    char *argv[],
+                    std::string &serverAddress,
+                    bool &relay,
+                    std::string &journalPath,
+                    unsigned int &processes,
+                    std::vector<std::string> &cluster) {
+    auto addressFound = false;
+    auto journalFound = false;
+    auto processesFound = false;
+    auto clusterFound = false;
+    relay = false;
+    journalPath.clear();
+    processes = 1;
+    cluster.clear();
+
+    for (auto i = 1; i < argc; i++) {
+        std::string arg(argv[i]);
+
+        if ((arg == "-a" || arg == "--address") && i + 1 < argc && !addressFound) {
+            serverAddress = argv[i + 1];
+            addressFound = true;
+            i++;
+        } else if ((arg == "-r" || arg == "--relay") && !relay) {
+            relay = true;
+        } else if ((arg == "-j" || arg == "--journal") && i + 1 < argc && !journalFound) {
+            journalPath = argv[i + 1];
+            journalFound = true;
+            i++;
+        } else if ((arg == "-p" || arg == "--processes") && i + 1 < argc && !processesFound) {
+            try {
+                processes = std::stoul(argv[i + 1]);
+            } catch (const std::exception &exception) {
+                processes = 0;
+            }
+            processesFound = true;
+            i++;
+        } else if ((arg == "-c" || arg == "--cluster") && i + 1 < argc && !clusterFound) {
+            std::string nodes(argv[i + 1]);
+            size_t start = 0;
+            size_t end;
+            while ((end = nodes.find(',', start)) != std::string::npos) {
+                cluster.push_back(nodes.substr(start, end - start));
+                start = end + 1;
+            }
+            cluster.push_back(nodes.substr(start));
+            clusterFound = true;
+            i++;
+        } else {
+            printHelp();
+            return false;
+        }
+    }
+
+    if (!addressFound || (journalFound && (!relay || journalPath.empty())) ||
+        processes == 0 || processes > fourinarow::SERVER_MAX_PROCESSES || (processes > 1 && relay)) {
         printHelp();
         return false;
     }
 
-    std::string arg(argv[1]);
-    if (arg == "-a" || arg == "--address") {
-        serverAddress = argv[2];
-        return true;
+    // Every node must appear once in the cluster, which must include this node.
+    if (clusterFound) {
+        std::unordered_set<std::string> nodes(cluster.begin(), cluster.end());
+        if (cluster.size() < 2 || cluster.size() > fourinarow::SERVER_MAX_NODES || nodes.size() != cluster.size() ||
+            nodes.count(serverAddress) == 0 || nodes.count("") != 0 || processes > 1 || relay) {
+            printHelp();
+            return false;
+        }
     }
 
-    printHelp();
-    return false;
+    return true;
 }
 
 /**
@@ -100,18 +200,70 @@ fourinarow::DigitalSignature createDigitalSignature(const std::string &path) {
     }
 }
 
+/**
+ * Generates a delegated key for each scheme in <code>DELEGATED_SIGNATURE_SCHEMES</code>,
+ * issuing its credential with the key of the certificate.
+ * @param digitalSignature  the digital signature tool of the certificate.
+ * @return                  the delegated keys, in the order of preference of the server.
+ * @throws runtime_error  if an error occurs while generating the keys.
+ */
+std::vector<fourinarow::DelegatedKey> createDelegatedKeys(const fourinarow::DigitalSignature &digitalSignature) {
+    std::cout << "Generating the delegated keys" << std::endl;
+
+    try {
+        std::vector<fourinarow::DelegatedKey> delegatedKeys;
+        for (auto scheme : fourinarow::DELEGATED_SIGNATURE_SCHEMES) {
+            delegatedKeys.emplace_back(digitalSignature, scheme, fourinarow::SERVER_DELEGATED_CREDENTIAL_LIFETIME);
+        }
+        return delegatedKeys;
+    } catch (const std::exception &exception) {
+        std::cerr << "Impossible to generate the delegated keys. " << exception.what() << std::endl;
+        throw std::runtime_error("Cannot generate the delegated keys");
+    }
+}
+
+/**
+ * Replaces the delegated keys having less than half of their lifetime left with fresh ones,
+ * so that the clients never receive a credential about to expire. If a key cannot be renewed,
+ * the old one is kept until the next attempt.
+ * @param delegatedKeys     the delegated keys.
+ * @param digitalSignature  the digital signature tool of the certificate.
+ */
+void renewDelegatedKeys(std::vector<fourinarow::DelegatedKey> &delegatedKeys,
+                        const fourinarow::DigitalSignature &digitalSignature) {
+    for (auto &delegatedKey : delegatedKeys) {
+        if (!delegatedKey.needsRenewal()) {
+            continue;
+        }
+
+        try {
+            delegatedKey = fourinarow::DelegatedKey(digitalSignature, delegatedKey.getScheme(),
+                                                    fourinarow::SERVER_DELEGATED_CREDENTIAL_LIFETIME);
+            std::cout << "Renewed the delegated key ";
+            std::cout << fourinarow::convertSignatureScheme(delegatedKey.getScheme()) << std::endl;
+        } catch (const std::exception &exception) {
+            std::cerr << "Impossible to renew a delegated key. " << exception.what() << std::endl;
+        }
+    }
+}
+
 /**
  * Creates a TCP hello socket, binds it to the given address and
  * sets it in a listening state.
  * @param serverAddress  the address to which the socket will bind.
+ * @param reusePort      true if the port is shared with the other processes of the server,
+ *                       which receive the incoming connections in turn, false otherwise.
  * @return               the TCP hello socket.
  * @throws runtime_error  if an error occurs while creating the socket.
  */
-fourinarow::TcpSocket createHelloSocket(const std::string &serverAddress) {
+fourinarow::TcpSocket createHelloSocket(const std::string &serverAddress, bool reusePort) {
     std::cout << "Starting the hello socket on " << serverAddress << ':' << fourinarow::SERVER_PORT << std::endl;
 
     try {
         fourinarow::TcpSocket helloSocket;
+        if (reusePort) {
+            helloSocket.enablePortReuse();
+        }
         helloSocket.bind(serverAddress, fourinarow::SERVER_PORT);
         helloSocket.listen(fourinarow::BACKLOG_SIZE);
         return helloSocket;
@@ -121,6 +273,46 @@ fourinarow::TcpSocket createHelloSocket(const std::string &serverAddress) {
     }
 }
 
+/**
+ * Creates a TCP socket accepting the links from the other nodes of the cluster,
+ * binds it to the given address and sets it in a listening state.
+ * @param serverAddress  the address to which the socket will bind.
+ * @return               the TCP node socket.
+ * @throws runtime_error  if an error occurs while creating the socket.
+ */
+fourinarow::TcpSocket createNodeSocket(const std::string &serverAddress) {
+    std::cout << "Starting the node socket on " << serverAddress << ':' << fourinarow::NODE_PORT << std::endl;
+
+    try {
+        fourinarow::TcpSocket nodeSocket;
+        nodeSocket.bind(serverAddress, fourinarow::NODE_PORT);
+        nodeSocket.listen(fourinarow::SERVER_MAX_NODES);
+        return nodeSocket;
+    } catch (const std::exception &exception) {
+        std::cerr << "Impossible to start the socket. " << exception.what() << std::endl;
+        throw std::runtime_error("Cannot start the node socket");
+    }
+}
+
+/**
+ * Opens the game journal recording the relayed matches, creating the file if it does not exist.
+ * @param path  the path of the journal file.
+ * @return      the game journal.
+ * @throws runtime_error  if an error occurs while opening the journal.
+ */
+std::unique_ptr<fourinarow::GameJournal> openGameJournal(const std::string &path) {
+    std::cout << "Opening the game journal " << path << std::endl;
+
+    try {
+        return std::unique_ptr<fourinarow::GameJournal>(
+                new fourinarow::GameJournal(path, fourinarow::SERVER_JOURNAL_CAPACITY,
+                                            std::chrono::milliseconds(fourinarow::SERVER_JOURNAL_SYNC_PERIOD)));
+    } catch (const std::exception &exception) {
+        std::cerr << "Impossible to open the game journal. " << exception.what() << std::endl;
+        throw std::runtime_error("Cannot open the game journal");
+    }
+}
+
 /**
  * Prints information about the client that is being handled.
  * @param socket  the socket used to communicate with the client.
@@ -142,21 +334,42 @@ void printHandlingInfo(const fourinarow::TcpSocket &socket, const fourinarow::Pl
  * @param player            the player associated to the socket.
  * @param playerList        the player list.
  * @param statusList        the player status list.
+ * @param relay             true if the server relays the matches, false otherwise.
+ * @param matchTable        the relayed match table.
+ * @param matchList         the relayed match list.
+ * @param descriptorList    the index of the player list by socket descriptor.
+ * @param peers             the links to the other processes or nodes of the server.
+ * @param queue             the quick match queue.
+ * @param ratingTable       the rating table.
  * @param removalList       the player removal list.
+ * @param journal           the game journal. It can be null.
  * @param certificate       the certificate of the server.
  * @param digitalSignature  the digital signature tool.
+ * @param delegatedKeys     the delegated keys, by preference.
+ * @param ticketKey         the key used to issue and redeem the session tickets.
  */
 void handleMessage(const fourinarow::TcpSocket &socket,
                    fourinarow::Player &player,
                    PlayerList &playerList,
-                   PlayerStatusList &statusList,
+                   fourinarow::PlayerStatusList &statusList,
+                   bool relay,
+                   fourinarow::MatchTable &matchTable,
+                   RelayedMatchList &matchList,
+                   const PlayerDescriptorList &descriptorList,
+                   const PeerList &peers,
+                   fourinarow::QuickMatchQueue &queue,
+                   const fourinarow::RatingTable &ratingTable,
                    PlayerRemovalList &removalList,
+                   fourinarow::GameJournal *journal,
                    const std::vector<unsigned char> &certificate,
-                   const fourinarow::DigitalSignature &digitalSignature) {
+                   const fourinarow::DigitalSignature &digitalSignature,
+                   const std::vector<fourinarow::DelegatedKey> &delegatedKeys,
+                   const fourinarow::SessionTicketKey &ticketKey) {
     printHandlingInfo(socket, player);
 
     if (player.getStatus() == fourinarow::Player::Status::CONNECTED) {
-        fourinarow::ConnectedClientHandler::handle(socket, player, statusList, removalList, certificate, digitalSignature);
+        fourinarow::ConnectedClientHandler::handle(socket, player, statusList, removalList, certificate, digitalSignature,
+                                                   delegatedKeys, ticketKey);
         return;
     }
 
@@ -166,25 +379,29 @@ void handleMessage(const fourinarow::TcpSocket &socket,
     }
 
     if (player.getStatus() == fourinarow::Player::Status::AVAILABLE) {
-        fourinarow::AvailableClientHandler::handle(socket, player, playerList, statusList, removalList);
+        fourinarow::AvailableClientHandler::handle(socket, player, playerList, statusList, peers, removalList, ticketKey, queue,
+                                                   ratingTable);
         return;
     }
 
     if (player.getStatus() == fourinarow::Player::Status::MATCHMAKING) {
-        fourinarow::MatchmakingClientHandler::handle(socket, player, playerList, statusList, removalList);
+        fourinarow::MatchmakingClientHandler::handle(socket, player, playerList, statusList, relay, matchTable, matchList, peers,
+                                                     queue, removalList);
         return;
     }
 
     if (player.getStatus() == fourinarow::Player::Status::MATCHMAKING_INTERRUPTED) {
         player.setStatus(fourinarow::Player::Status::AVAILABLE);
-        statusList[player.getUsername()] = fourinarow::Player::Status::AVAILABLE;
+        statusList.set(player.getUsername(), fourinarow::Player::Status::AVAILABLE);
         std::cout << "Client unblocked: now it is AVAILABLE" << std::endl;
-        fourinarow::AvailableClientHandler::handle(socket, player, playerList, statusList, removalList);
+        fourinarow::AvailableClientHandler::handle(socket, player, playerList, statusList, peers, removalList, ticketKey, queue,
+                                                   ratingTable);
         return;
     }
 
     if (player.getStatus() == fourinarow::Player::Status::PLAYING) {
-        fourinarow::PlayingClientHandler::handle(socket, player, statusList, removalList);
+        fourinarow::PlayingClientHandler::handle(socket, player, statusList, matchTable, matchList, descriptorList, removalList,
+                                                 journal);
         return;
     }
 
@@ -203,24 +420,40 @@ bool isInsideRemovalList(const PlayerRemovalList &removalList, const fourinarow:
 }
 
 /**
- * Disconnects the client, removing the corresponding entries in
- * the player list, the player status list and the player removal list.
+ * Disconnects the client, removing the corresponding entries in the player list,
+ * the descriptor list, the player status list and the player removal list.
+ * If the client is taking part in a relayed match, the match is ended.
+ * If the client is waiting in the quick match queue, it is removed from the queue.
  * Moreover, the corresponding socket is removed from the multiplexer.
  * The iterator passed to the function is automatically updated to point
  * to the next entry in the player list.
- * @param iterator     the iterator of the player list referring to the client.
- * @param playerList   the player list.
- * @param statusList   the player status list.
- * @param removalList  the player removal list.
- * @param multiplexer  the multiplexer of sockets.
+ * @param iterator        the iterator of the player list referring to the client.
+ * @param playerList      the player list.
+ * @param descriptorList  the index of the player list by socket descriptor.
+ * @param statusList      the player status list.
+ * @param matchTable      the relayed match table.
+ * @param matchList       the relayed match list.
+ * @param queue           the quick match queue.
+ * @param removalList     the player removal list.
+ * @param journal         the game journal. It can be null.
+ * @param multiplexer     the multiplexer of sockets.
  */
 void disconnectClient(PlayerList::iterator &iterator,
                       PlayerList &playerList,
-                      PlayerStatusList &statusList,
+                      PlayerDescriptorList &descriptorList,
+                      fourinarow::PlayerStatusList &statusList,
+                      fourinarow::MatchTable &matchTable,
+                      RelayedMatchList &matchList,
+                      fourinarow::QuickMatchQueue &queue,
                       PlayerRemovalList &removalList,
+                      fourinarow::GameJournal *journal,
                       fourinarow::InputMultiplexer &multiplexer) {
+    fourinarow::PlayingClientHandler::leaveRelayedMatch(iterator->first, iterator->second, matchTable, matchList,
+                                                        descriptorList, removalList, journal);
+    queue.erase(iterator->second.getUsername());
     removalList.erase(iterator->second.getUsername());
     statusList.erase(iterator->second.getUsername());
+    descriptorList.erase(iterator->first.getDescriptor());
     multiplexer.removeDescriptor(iterator->first.getDescriptor());
     iterator = playerList.erase(iterator);
 }
@@ -230,6 +463,11 @@ void disconnectClient(PlayerList::iterator &iterator,
  * @param playerList  the player list.
  */
 void printPlayerList(const PlayerList &playerList) {
+    if (playerList.size() > fourinarow::SERVER_MAX_LOGGED_PLAYERS) {
+        std::cout << "Player list: " << playerList.size() << " players" << std::endl;
+        return;
+    }
+
     std::string formattedList = "Player list: {";
 
     if (playerList.empty()) {
@@ -252,7 +490,12 @@ void printPlayerList(const PlayerList &playerList) {
  * Prints the current status list.
  * @param statusList  the status list.
  */
-void printStatusList(const PlayerStatusList &statusList) {
+void printStatusList(const fourinarow::PlayerStatusList &statusList) {
+    if (statusList.size() > fourinarow::SERVER_MAX_LOGGED_PLAYERS) {
+        std::cout << "Status list: " << statusList.size() << " players" << std::endl;
+        return;
+    }
+
     std::string formattedList = "Status list: {";
 
     if (statusList.empty()) {
@@ -272,86 +515,599 @@ void printStatusList(const PlayerStatusList &statusList) {
 }
 
 /**
- * Starts the main service loop of the server.
+ * Registers a link to another process or node of the server, so that its messages are handled by the service loop.
+ * @param link             the link.
+ * @param peer             the index of the process or node.
+ * @param peers            the links to the other processes or nodes of the server.
+ * @param peerDescriptors  the index of the links by socket descriptor.
+ * @param multiplexer      the multiplexer of sockets.
+ */
+void registerPeerLink(std::unique_ptr<fourinarow::PeerLink> link,
+                      unsigned int peer,
+                      PeerList &peers,
+                      PeerDescriptorList &peerDescriptors,
+                      fourinarow::InputMultiplexer &multiplexer) {
+    peerDescriptors[link->getSocket().getDescriptor()] = peer;
+    multiplexer.addDescriptor(link->getSocket().getDescriptor());
+    peers[peer] = std::move(link);
+}
+
+/**
+ * Closes a link to another process or node of the server, and removes the players connected to it.
+ * @param peer             the index of the process or node.
+ * @param peers            the links to the other processes or nodes of the server.
+ * @param peerDescriptors  the index of the links by socket descriptor.
+ * @param multiplexer      the multiplexer of sockets.
+ * @param playerList       the player list.
+ * @param statusList       the player status list.
+ * @param removalList      the player removal list.
+ */
+void closePeerLink(unsigned int peer,
+                   PeerList &peers,
+                   PeerDescriptorList &peerDescriptors,
+                   fourinarow::InputMultiplexer &multiplexer,
+                   PlayerList &playerList,
+                   fourinarow::PlayerStatusList &statusList,
+                   PlayerRemovalList &removalList) {
+    auto descriptor = peers[peer]->getSocket().getDescriptor();
+    multiplexer.removeDescriptor(descriptor);
+    peerDescriptors.erase(descriptor);
+    peers[peer].reset();
+    fourinarow::PeerHandler::handleLostPeer(peer, playerList, statusList, removalList);
+}
+
+/**
+ * Checks if the handshake of a link to a node of the cluster is in progress.
+ * @param pendingLinks  the links to the nodes of the cluster whose handshake is in progress.
+ * @param node          the index of the node.
+ * @return              true if the handshake of a link to the node is in progress, false otherwise.
+ */
+bool isNodeLinkPending(const PendingNodeLinkList &pendingLinks, unsigned int node) {
+    for (const auto &link : pendingLinks) {
+        if (link.second->node == node) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Starts linking this node to the nodes of the cluster having a lower index, if not linked yet
+ * and not being linked. The nodes having a higher index link themselves to this one.
+ * @param cluster       the addresses of the nodes of the cluster.
+ * @param statusList    the player status list.
+ * @param peers         the links to the other nodes of the cluster.
+ * @param pendingLinks  the links to the nodes of the cluster whose handshake is in progress.
+ * @param multiplexer   the multiplexer of sockets.
+ * @return              true if some links are still missing, false otherwise.
+ */
+bool connectToNodes(const std::vector<std::string> &cluster,
+                    const fourinarow::PlayerStatusList &statusList,
+                    const PeerList &peers,
+                    PendingNodeLinkList &pendingLinks,
+                    fourinarow::InputMultiplexer &multiplexer) {
+    const auto node = statusList.getOwner();
+    auto linksMissing = false;
+
+    for (unsigned int i = 0; i < node; i++) {
+        if (peers[i] != nullptr) {
+            continue;
+        }
+
+        linksMissing = true;
+        if (isNodeLinkPending(pendingLinks, i)) {
+            continue;
+        }
+
+        try {
+            auto link = fourinarow::NodeHandler::connectToNode(cluster[node], cluster[i], i, multiplexer);
+            auto descriptor = link->socket.getDescriptor();
+            pendingLinks[descriptor] = std::move(link);
+        } catch (const std::exception &exception) {
+            std::cerr << "The node " << i << " will be linked later. " << exception.what() << std::endl;
+        }
+    }
+
+    return linksMissing;
+}
+
+/**
+ * Accepts a connection from a node of the cluster having a higher index, and starts the handshake of its link.
+ * The connection is refused if its source address does not belong to such a node.
+ * @param nodeSocket    the node socket.
+ * @param cluster       the addresses of the nodes of the cluster.
+ * @param statusList    the player status list.
+ * @param pendingLinks  the links to the nodes of the cluster whose handshake is in progress.
+ * @param multiplexer   the multiplexer of sockets.
+ */
+void acceptNodeLink(fourinarow::TcpSocket &nodeSocket,
+                    const std::vector<std::string> &cluster,
+                    const fourinarow::PlayerStatusList &statusList,
+                    PendingNodeLinkList &pendingLinks,
+                    fourinarow::InputMultiplexer &multiplexer) {
+    try {
+        auto socket = nodeSocket.accept();
+        auto node = statusList.getOwner() + 1;
+        while (node < cluster.size() && cluster[node] != socket.getDestinationAddress()) {
+            node++;
+        }
+
+        if (node == cluster.size()) {
+            std::cerr << "Refusing a link from " << socket.getFullDestinationAddress() << ": not a node" << std::endl;
+            return;
+        }
+
+        auto link = fourinarow::NodeHandler::acceptNode(std::move(socket), node, multiplexer);
+        auto descriptor = link->socket.getDescriptor();
+        pendingLinks[descriptor] = std::move(link);
+    } catch (const std::exception &exception) {
+        std::cerr << "Error while accepting a link from a node. " << exception.what() << std::endl;
+    }
+}
+
+/**
+ * Takes the next step of the handshake of a link to a node of the cluster, whose socket is ready.
+ * When the handshake completes, the link is registered, replacing the old link to the same node, if any,
+ * since the node could not have reconnected without closing it. If the handshake fails, the link is dropped.
+ * @param descriptor        the socket descriptor of the link.
+ * @param pendingLinks      the links to the nodes of the cluster whose handshake is in progress.
+ * @param playerList        the player list.
+ * @param statusList        the player status list.
+ * @param peers             the links to the other nodes of the cluster.
+ * @param peerDescriptors   the index of the links by socket descriptor.
+ * @param multiplexer       the multiplexer of sockets.
+ * @param removalList       the player removal list.
+ * @param certificate       the certificate of the server.
+ * @param digitalSignature  the digital signature tool.
+ */
+void handlePendingNodeLink(unsigned int descriptor,
+                           PendingNodeLinkList &pendingLinks,
+                           PlayerList &playerList,
+                           fourinarow::PlayerStatusList &statusList,
+                           PeerList &peers,
+                           PeerDescriptorList &peerDescriptors,
+                           fourinarow::InputMultiplexer &multiplexer,
+                           PlayerRemovalList &removalList,
+                           const std::vector<unsigned char> &certificate,
+                           const fourinarow::DigitalSignature &digitalSignature) {
+    auto &pendingLink = *pendingLinks[descriptor];
+    const auto node = pendingLink.node;
+
+    std::unique_ptr<fourinarow::PeerLink> link;
+    try {
+        link = fourinarow::NodeHandler::handle(pendingLink, multiplexer, digitalSignature, certificate);
+    } catch (const std::exception&) {
+        // The failure has already been reported.
+        multiplexer.removeDescriptor(descriptor);
+        pendingLinks.erase(descriptor);
+        return;
+    }
+
+    if (link == nullptr) {
+        return;
+    }
+    pendingLinks.erase(descriptor);
+
+    if (peers[node] != nullptr) {
+        closePeerLink(node, peers, peerDescriptors, multiplexer, playerList, statusList, removalList);
+    }
+
+    if (fourinarow::PeerHandler::announceAllPresence(statusList, *link)) {
+        registerPeerLink(std::move(link), node, peers, peerDescriptors, multiplexer);
+    } else {
+        multiplexer.removeDescriptor(descriptor);
+    }
+}
+
+/**
+ * Drops the links to the nodes of the cluster whose handshake has not taken its awaited step before the deadline.
+ * @param pendingLinks  the links to the nodes of the cluster whose handshake is in progress.
+ * @param multiplexer   the multiplexer of sockets.
+ */
+void dropExpiredNodeLinks(PendingNodeLinkList &pendingLinks, fourinarow::InputMultiplexer &multiplexer) {
+    const auto now = std::chrono::steady_clock::now();
+
+    for (auto iterator = pendingLinks.begin(); iterator != pendingLinks.end();) {
+        if (iterator->second->deadline > now) {
+            iterator++;
+            continue;
+        }
+
+        std::cerr << "Impossible to link the node " << iterator->second->socket.getDestinationAddress();
+        std::cerr << ". Timeout expired" << std::endl;
+        multiplexer.removeDescriptor(iterator->first);
+        iterator = pendingLinks.erase(iterator);
+    }
+}
+
+/**
+ * Starts the main service loop of the server. Only the sockets reported as ready by the multiplexer
+ * are visited, so that the cost of an iteration does not grow with the number of idle clients.
  * @param helloSocket       the hello socket.
  * @param multiplexer       the multiplexer of sockets.
  * @param playerList        the player list.
+ * @param descriptorList    the index of the player list by socket descriptor.
  * @param statusList        the player status list.
+ * @param relay             true if the server relays the matches, false otherwise.
+ * @param matchTable        the relayed match table.
+ * @param matchList         the relayed match list.
+ * @param peers             the links to the other processes or nodes of the server. A link is reset when closed.
+ * @param nodeSocket        the node socket. It is null if the server is not part of a cluster.
+ * @param cluster           the addresses of the nodes of the cluster. It is empty if the server is not part of a cluster.
+ * @param queue             the quick match queue.
+ * @param ratingTable       the rating table.
  * @param removalList       the player removal list.
+ * @param journal           the game journal. It can be null.
  * @param certificate       the certificate of the server.
  * @param digitalSignature  the digital signature tool.
+ * @param delegatedKeys     the delegated keys, by preference.
+ * @param ticketKey         the key used to issue and redeem the session tickets.
  */
 void startService(fourinarow::TcpSocket &helloSocket,
                   fourinarow::InputMultiplexer &multiplexer,
                   PlayerList &playerList,
-                  PlayerStatusList &statusList,
+                  PlayerDescriptorList &descriptorList,
+                  fourinarow::PlayerStatusList &statusList,
+                  bool relay,
+                  fourinarow::MatchTable &matchTable,
+                  RelayedMatchList &matchList,
+                  PeerList &peers,
+                  fourinarow::TcpSocket *nodeSocket,
+                  const std::vector<std::string> &cluster,
+                  fourinarow::QuickMatchQueue &queue,
+                  fourinarow::RatingTable &ratingTable,
                   PlayerRemovalList &removalList,
+                  fourinarow::GameJournal *journal,
                   const std::vector<unsigned char> &certificate,
-                  const fourinarow::DigitalSignature &digitalSignature) {
-    std::cout << "Initialization performed correctly. Starting the service" << std::endl;
+                  const fourinarow::DigitalSignature &digitalSignature,
+                  std::vector<fourinarow::DelegatedKey> &delegatedKeys,
+                  const fourinarow::SessionTicketKey &ticketKey) {
+    std::cout << "Initialization performed correctly. Starting the service";
+    std::cout << (relay ? " in relay mode" : "") << std::endl;
+    const auto helloDescriptor = static_cast<unsigned int>(helloSocket.getDescriptor());
+
+    PeerDescriptorList peerDescriptors; // Fast lookup of the process or node linked to a socket.
+    for (unsigned int i = 0; i < peers.size(); i++) {
+        if (peers[i] != nullptr) {
+            peerDescriptors[peers[i]->getSocket().getDescriptor()] = i;
+            multiplexer.addDescriptor(peers[i]->getSocket().getDescriptor());
+        }
+    }
+
+    PendingNodeLinkList pendingLinks;   // The links to the nodes whose handshake is in progress.
+    auto nodeLinksMissing = !cluster.empty();
+    auto nextNodeLinkAttempt = std::chrono::steady_clock::now();
 
     while (true) {
+        dropExpiredNodeLinks(pendingLinks, multiplexer);
+        if (nodeLinksMissing && std::chrono::steady_clock::now() >= nextNodeLinkAttempt) {
+            nodeLinksMissing = connectToNodes(cluster, statusList, peers, pendingLinks, multiplexer);
+            nextNodeLinkAttempt = std::chrono::steady_clock::now() + std::chrono::seconds(fourinarow::NODE_RECONNECT_PERIOD);
+        }
+
+        /*
+         * Wake up to retry the missing links, to drop the stalled node handshakes, or to widen the search
+         * of the queued players, even if no request arrives.
+         */
+        auto timeout = nodeLinksMissing ? fourinarow::NODE_RECONNECT_PERIOD : 0;
+        if (!pendingLinks.empty() && (timeout == 0 || fourinarow::NODE_PROTOCOL_TIMEOUT < timeout)) {
+            timeout = fourinarow::NODE_PROTOCOL_TIMEOUT;
+        }
+        if (queue.size() > 1 && (timeout == 0 || fourinarow::QUICK_MATCH_WIDENING_PERIOD < timeout)) {
+            timeout = fourinarow::QUICK_MATCH_WIDENING_PERIOD;
+        }
+
         std::cout << "Waiting for requests..." << std::endl;
-        multiplexer.select();
+        if (timeout == 0) {
+            multiplexer.select();
+        } else {
+            try {
+                multiplexer.selectWithTimeout(timeout);
+            } catch (const fourinarow::SocketException &exception) {
+                // No descriptor is ready, but the queued players may now accept a farther opponent.
+                if (queue.size() < 2) {
+                    continue;
+                }
+            }
+        }
+        renewDelegatedKeys(delegatedKeys, digitalSignature);
 
-        // Handle messages from connected clients.
-        for (auto iterator = playerList.begin(); iterator != playerList.end();) {
-            if (isInsideRemovalList(removalList, iterator->second)) {
-                disconnectClient(iterator, playerList, statusList, removalList, multiplexer);
+        // Handle messages from connected clients, and from the other processes or nodes.
+        for (auto descriptor : multiplexer.getReadyDescriptors()) {
+            auto entry = descriptorList.find(descriptor);
+            if (descriptor == helloDescriptor || entry == descriptorList.end()) {
+                auto peer = peerDescriptors.find(descriptor);
+                if (peer != peerDescriptors.end() &&
+                    !fourinarow::PeerHandler::handle(*peers[peer->second], peer->second, playerList, statusList, peers,
+                                                     removalList)) {
+                    closePeerLink(peer->second, peers, peerDescriptors, multiplexer, playerList, statusList, removalList);
+                    nodeLinksMissing = !cluster.empty();
+                } else if (nodeSocket != nullptr && descriptor == static_cast<unsigned int>(nodeSocket->getDescriptor())) {
+                    acceptNodeLink(*nodeSocket, cluster, statusList, pendingLinks, multiplexer);
+                } else if (pendingLinks.count(descriptor) != 0) {
+                    handlePendingNodeLink(descriptor, pendingLinks, playerList, statusList, peers, peerDescriptors,
+                                          multiplexer, removalList, certificate, digitalSignature);
+                }
                 continue;
             }
-            if (multiplexer.isReady(iterator->first.getDescriptor())) {
-                handleMessage(iterator->first, iterator->second, playerList, statusList, removalList, certificate, digitalSignature);
+
+            auto &client = *entry->second;
+            if (!isInsideRemovalList(removalList, client.second)) {
+                handleMessage(client.first, client.second, playerList, statusList, relay, matchTable, matchList,
+                              descriptorList, peers, queue, ratingTable, removalList, journal, certificate,
+                              digitalSignature, delegatedKeys, ticketKey);
+            }
+        }
+
+        // Validate and forward the moves of the relayed matches received in this iteration, if any.
+        fourinarow::PlayingClientHandler::forwardMoves(matchTable, descriptorList, removalList, ratingTable, journal);
+
+        // Pair the players waiting for a quick match, if any.
+        fourinarow::QuickMatchHandler::matchQueuedPlayers(queue, descriptorList, statusList, relay, matchTable, matchList,
+                                                          removalList);
+
+        /*
+         * Remove the clients put in the removal list while handling the messages, if any.
+         * Disconnecting a client can put its opponent in the removal list, so the list
+         * is scanned again until no more clients are removed.
+         */
+        auto removed = true;
+        while (removed && !removalList.empty()) {
+            removed = false;
+            for (auto iterator = playerList.begin(); iterator != playerList.end();) {
                 if (isInsideRemovalList(removalList, iterator->second)) {
-                    disconnectClient(iterator, playerList, statusList, removalList, multiplexer);
+                    disconnectClient(iterator, playerList, descriptorList, statusList, matchTable, matchList, queue,
+                                     removalList, journal, multiplexer);
+                    removed = true;
                     continue;
                 }
+                iterator++;
             }
-            iterator++;
         }
 
-        // Remove clients that were not removed in the previous loop, if any.
-        for (auto iterator = playerList.begin(); iterator != playerList.end();) {
-            if (removalList.empty()) {
-                break;
+        // Handle new connections on the hello socket.
+        if (multiplexer.isReady(helloDescriptor)) {
+            fourinarow::NewClientHandler::handle(helloSocket, multiplexer, playerList, descriptorList);
+        }
+
+        // Send the presence changes of the local players to the other nodes, if any.
+        fourinarow::PeerHandler::announcePresence(statusList, peers);
+
+        printPlayerList(playerList);
+        printStatusList(statusList);
+
+        if (relay) {
+            std::cout << "Relayed matches: " << matchTable.getMatchCount() << std::endl;
+        }
+
+        if (!queue.empty()) {
+            std::cout << "Players waiting for a quick match: " << queue.size() << std::endl;
+        }
+
+        if (journal != nullptr && journal->getDroppedGames() != 0) {
+            std::cout << "Matches not recorded, journal full: " << journal->getDroppedGames() << std::endl;
+        }
+    }
+}
+
+/**
+ * Creates the state of a server process and starts its service loop.
+ * @param serverAddress     the IPv4 address of the server.
+ * @param reusePort         true if the port is shared with the other processes of the server, false otherwise.
+ * @param statusList        the player status list.
+ * @param peers             the links to the other processes or nodes of the server. It is empty for a single process.
+ * @param cluster           the addresses of the nodes of the cluster. It is empty if the server is not part of a cluster.
+ * @param relay             true if the server relays the matches, false otherwise.
+ * @param journalPath       the path of the game journal, or an empty string if the matches are not recorded.
+ * @param certificate       the certificate of the server.
+ * @param digitalSignature  the digital signature tool.
+ * @param delegatedKeys     the delegated keys, by preference.
+ * @param ticketKey         the key used to issue and redeem the session tickets.
+ * @throws runtime_error  if an error occurs while starting the service.
+ */
+void runService(const std::string &serverAddress,
+                bool reusePort,
+                fourinarow::PlayerStatusList &statusList,
+                PeerList &peers,
+                const std::vector<std::string> &cluster,
+                bool relay,
+                const std::string &journalPath,
+                const std::vector<unsigned char> &certificate,
+                const fourinarow::DigitalSignature &digitalSignature,
+                std::vector<fourinarow::DelegatedKey> &delegatedKeys,
+                const fourinarow::SessionTicketKey &ticketKey) {
+    PlayerList playerList;
+    PlayerDescriptorList descriptorList; // Fast lookup of the player owning a ready socket.
+    fourinarow::MatchTable matchTable;
+    RelayedMatchList matchList; // Fast lookup of the relayed match of a player.
+    fourinarow::QuickMatchQueue queue(fourinarow::QUICK_MATCH_BUCKET_WIDTH, fourinarow::QUICK_MATCH_WIDENING_PERIOD*1000);
+    fourinarow::RatingTable ratingTable;
+    PlayerRemovalList removalList;
+
+    std::unique_ptr<fourinarow::GameJournal> journal;
+    if (!journalPath.empty()) {
+        journal = openGameJournal(journalPath);
+    }
+
+    auto helloSocket = createHelloSocket(serverAddress, reusePort);
+    fourinarow::InputMultiplexer multiplexer;
+    multiplexer.addDescriptor(helloSocket.getDescriptor());
+
+    std::unique_ptr<fourinarow::TcpSocket> nodeSocket;
+    if (!cluster.empty()) {
+        nodeSocket.reset(new fourinarow::TcpSocket(createNodeSocket(serverAddress)));
+        multiplexer.addDescriptor(nodeSocket->getDescriptor());
+    }
+
+    startService(helloSocket, multiplexer, playerList, descriptorList, statusList, relay, matchTable, matchList, peers,
+                 nodeSocket.get(), cluster, queue, ratingTable, removalList, journal.get(), certificate, digitalSignature,
+                 delegatedKeys, ticketKey);
+}
+
+/**
+ * Links every pair of processes of the server with a pair of connected local sockets.
+ * @param processes  the number of processes.
+ * @return           the links of each process, by process index.
+ * @throws SocketException  if the sockets cannot be created.
+ */
+std::vector<PeerList> createPeerLinks(unsigned int processes) {
+    std::vector<PeerList> links(processes);
+    for (auto &peers : links) {
+        peers.resize(processes);
+    }
+
+    for (unsigned int i = 0; i < processes; i++) {
+        for (unsigned int j = i + 1; j < processes; j++) {
+            auto pair = fourinarow::TcpSocket::createPair();
+            links[i][j].reset(new fourinarow::PeerLink(std::move(pair.first)));
+            links[j][i].reset(new fourinarow::PeerLink(std::move(pair.second)));
+        }
+    }
+
+    return links;
+}
+
+/**
+ * Forks the given number of processes serving the clients, and waits for their termination.
+ * The processes accept the connections on the same port, and share the presence table
+ * storing the players connected to each of them, so that a player can challenge any other.
+ * When a process terminates, its players are removed from the table. The processes
+ * are not restarted, and receive a <code>SIGTERM</code> signal if the parent terminates.
+ * The certificate, the keys and the ticket key are loaded before forking, so that
+ * a session ticket issued by a process can be redeemed by any other.
+ * @param processes         the number of processes.
+ * @param serverAddress     the IPv4 address of the server.
+ * @param certificate       the certificate of the server.
+ * @param digitalSignature  the digital signature tool.
+ * @param delegatedKeys     the delegated keys, by preference.
+ * @param ticketKey         the key used to issue and redeem the session tickets.
+ * @throws runtime_error  if an error occurs while creating the processes.
+ */
+void runProcessGroup(unsigned int processes,
+                     const std::string &serverAddress,
+                     const std::vector<unsigned char> &certificate,
+                     const fourinarow::DigitalSignature &digitalSignature,
+                     std::vector<fourinarow::DelegatedKey> &delegatedKeys,
+                     const fourinarow::SessionTicketKey &ticketKey) {
+    fourinarow::PresenceTable presenceTable(fourinarow::SERVER_PRESENCE_TABLE_CAPACITY);
+    auto links = createPeerLinks(processes);
+    std::unordered_map<pid_t, unsigned int> children; // Process index by process id.
+    const auto parent = getpid();
+
+    for (unsigned int i = 0; i < processes; i++) {
+        auto child = fork();
+        if (child == -1) {
+            std::cerr << "Impossible to create the process " << i << ". " << strerror(errno) << std::endl;
+            throw std::runtime_error("Cannot create the server processes");
+        }
+
+        if (child == 0) {
+            // The check on the parent covers its termination before prctl().
+            if (prctl(PR_SET_PDEATHSIG, SIGTERM) == -1 || getppid() != parent) {
+                return;
             }
-            if (isInsideRemovalList(removalList, iterator->second)) {
-                disconnectClient(iterator, playerList, statusList, removalList, multiplexer);
+
+            auto peers = std::move(links[i]);
+            links.clear();
+            fourinarow::PlayerStatusList statusList(presenceTable, i);
+            std::cout << "Process " << i << " started" << std::endl;
+            runService(serverAddress, true, statusList, peers, {}, false, "", certificate, digitalSignature, delegatedKeys,
+                       ticketKey);
+            return;
+        }
+
+        children[child] = i;
+    }
+
+    links.clear();
+    std::cout << "Started " << processes << " processes" << std::endl;
+
+    while (!children.empty()) {
+        int status;
+        auto child = waitpid(-1, &status, 0);
+        if (child == -1) {
+            if (errno == EINTR) {
                 continue;
             }
-            iterator++;
+            throw std::runtime_error("Cannot wait for the server processes");
         }
 
-        // Handle new connections on the hello socket.
-        if (multiplexer.isReady(helloSocket.getDescriptor())) {
-            fourinarow::NewClientHandler::handle(helloSocket, multiplexer, playerList);
+        auto entry = children.find(child);
+        if (entry == children.end()) {
+            continue;
         }
 
-        printPlayerList(playerList);
-        printStatusList(statusList);
+        auto removed = presenceTable.eraseOwner(entry->second);
+        std::cerr << "The process " << entry->second << " terminated";
+        std::cerr << (WIFSIGNALED(status) ? " by a signal" : "") << ". Players removed: " << removed << std::endl;
+        children.erase(entry);
+    }
+}
+
+/**
+ * Runs a node of a cluster of servers. Each node serves its own clients, and keeps in a private presence table
+ * the players connected to the other nodes, as received through the links to them, so that a player can challenge
+ * any other. The presence is eventually consistent, and the session tickets can be redeemed only by the issuing node.
+ * @param cluster           the addresses of the nodes of the cluster.
+ * @param serverAddress     the IPv4 address of this node.
+ * @param certificate       the certificate of the server.
+ * @param digitalSignature  the digital signature tool.
+ * @param delegatedKeys     the delegated keys, by preference.
+ * @param ticketKey         the key used to issue and redeem the session tickets.
+ * @throws runtime_error  if an error occurs while starting the service.
+ */
+void runClusterNode(const std::vector<std::string> &cluster,
+                    const std::string &serverAddress,
+                    const std::vector<unsigned char> &certificate,
+                    const fourinarow::DigitalSignature &digitalSignature,
+                    std::vector<fourinarow::DelegatedKey> &delegatedKeys,
+                    const fourinarow::SessionTicketKey &ticketKey) {
+    unsigned int node = 0;
+    while (cluster[node] != serverAddress) {
+        node++;
     }
+
+    fourinarow::PresenceTable presenceTable(fourinarow::SERVER_PRESENCE_TABLE_CAPACITY);
+    fourinarow::PlayerStatusList statusList(presenceTable, node, true);
+    PeerList peers(cluster.size());
+    std::cout << "Node " << node << " of a cluster of " << cluster.size() << " nodes" << std::endl;
+
+    runService(serverAddress, false, statusList, peers, cluster, false, "", certificate, digitalSignature, delegatedKeys,
+               ticketKey);
 }
 
 int main(int argc, char *argv[]) {
     try {
         std::string serverAddress;
+        auto relay = false;
+        std::string journalPath;
+        unsigned int processes;
+        std::vector<std::string> cluster;
 
-        if (!parseArguments(argc, argv, serverAddress)) {
+        if (!parseArguments(argc, argv, serverAddress, relay, journalPath, processes, cluster)) {
             return 1;
         }
 
-        PlayerList playerList;
-        PlayerStatusList statusList; // Fast lookup of player's status.
-        PlayerRemovalList removalList;
-
         auto certificate = loadCertificate(fourinarow::SERVER_CERTIFICATE_FOLDER + "4InARow_cert.pem");
         auto digitalSignature = createDigitalSignature(fourinarow::SERVER_CERTIFICATE_FOLDER + "4InARow_privkey.pem");
+        auto delegatedKeys = createDelegatedKeys(digitalSignature);
+        fourinarow::SessionTicketKey ticketKey; // Tickets are valid until the server is restarted.
+
+        if (processes > 1) {
+            runProcessGroup(processes, serverAddress, certificate, digitalSignature, delegatedKeys, ticketKey);
+            return 1;
+        }
 
-        auto helloSocket = createHelloSocket(serverAddress);
-        fourinarow::InputMultiplexer multiplexer;
-        multiplexer.addDescriptor(helloSocket.getDescriptor());
+        if (!cluster.empty()) {
+            runClusterNode(cluster, serverAddress, certificate, digitalSignature, delegatedKeys, ticketKey);
+            return 1;
+        }
 
-        startService(helloSocket, multiplexer, playerList, statusList, removalList, certificate, digitalSignature);
+        fourinarow::PlayerStatusList statusList; // Fast lookup of player's status.
+        PeerList peers;
+        runService(serverAddress, false, statusList, peers, {}, relay, journalPath, certificate, digitalSignature,
+                   delegatedKeys, ticketKey);
     } catch (const std::exception &exception) {
         std::cerr << "Fatal error. " << exception.what() << std::endl;
         return 1;
@@ -0,0 +1,689 @@
+#include <stdexcept>
+#include <string.h>
+#include <arpa/inet.h>
+#include <Constants.h>
+#include <Utils.h>
+#include <SerializationException.h>
+#include <CryptoException.h>
+#include <DelegatedCredential.h>
+#include <ClientHello.h>
+#include <ServerHello.h>
+#include <EndHandshake.h>
+#include <ResumeHello.h>
+#include <ResumeAccepted.h>
+#include <SessionTicket.h>
+#include <InfoMessage.h>
+#include <Challenge.h>
+#include <PlayerListMessage.h>
+#include <Move.h>
+#include "SessionLoop.h"
+#include "ClientSession.h"
+
+namespace fourinarow {
+
+ClientSession::ClientSession(std::string username,
+                             const DigitalSignature &digitalSignature,
+                             const CertificateStore &certificateStore,
+                             SessionListener &listener)
+                             : username(std::move(username)),
+                               digitalSignature(digitalSignature),
+                               certificateStore(certificateStore),
+                               listener(listener),
+                               loop(nullptr),
+                               state(State::CLOSED),
+                               resuming(false),
+                               helloReceived(false),
+                               playerListPending(false),
+                               ticketPending(false),
+                               myTurn(false),
+                               deadlineSet(false) {
+    checkUsernameValidity<std::runtime_error>(this->username);
+}
+
+ClientSession::~ClientSession() {
+    close();
+}
+
+const std::string& ClientSession::getUsername() const {
+    return username;
+}
+
+ClientSession::State ClientSession::getState() const {
+    return state;
+}
+
+const std::string& ClientSession::getOpponent() const {
+    return opponent;
+}
+
+const FourInARow& ClientSession::getBoard() const {
+    if (!board) {
+        throw std::runtime_error("No relayed match has been played since the last match started");
+    }
+
+    return *board;
+}
+
+bool ClientSession::isMyTurn() const {
+    return state == State::PLAYING && board && myTurn;
+}
+
+void ClientSession::setDeadline(unsigned long seconds) {
+    deadlineSet = true;
+    deadline = Clock::now() + std::chrono::seconds(seconds);
+}
+
+void ClientSession::clearDeadline() {
+    deadlineSet = false;
+}
+
+std::vector<unsigned char> ClientSession::encrypt(const Message &message) {
+    // Same encryption of the client handlers: the sequence number is the additional authenticated data.
+    uint32_t sequenceNumber = htonl(myselfForServer.getSequenceNumberWrites());
+    std::vector<unsigned char> aad(sizeof(sequenceNumber));
+    memcpy(aad.data(), &sequenceNumber, sizeof(sequenceNumber));
+
+    auto plaintext = message.serialize();
+    auto authenticatedCiphertext = myselfForServer.getCipher().encrypt(plaintext, aad);
+    cleanse(plaintext);
+
+    myselfForServer.incrementSequenceNumberWrites();
+    return authenticatedCiphertext;
+}
+
+bool ClientSession::send(const Message &message) {
+    try {
+        socket->send(encrypt(message));
+        return true;
+    } catch (const std::exception &exception) {
+        terminate(std::string("Cannot send a message to the server. ") + exception.what());
+        return false;
+    }
+}
+
+std::vector<unsigned char> ClientSession::decrypt(std::vector<unsigned char> &message) {
+    uint32_t sequenceNumber = htonl(myselfForServer.getSequenceNumberReads());
+    std::vector<unsigned char> aad(sizeof(sequenceNumber));
+    memcpy(aad.data(), &sequenceNumber, sizeof(sequenceNumber));
+
+    auto plaintext = myselfForServer.getCipher().decrypt(message, aad);
+    myselfForServer.incrementSequenceNumberReads();
+    return plaintext;
+}
+
+void ClientSession::terminate(const std::string &reason) {
+    if (state == State::CLOSED) {
+        return;
+    }
+
+    if (loop) {
+        loop->remove(*this);
+    }
+
+    socket.reset();
+    receiveBuffer.clear();
+    board.reset();
+    clearDeadline();
+    state = State::CLOSED;
+
+    if (!reason.empty()) {
+        listener.onClosed(*this, reason);
+    }
+}
+
+void ClientSession::checkState(State expected, const std::string &command) const {
+    if (state != expected) {
+        throw std::runtime_error("The command " + command + " is not allowed in the current state of the session");
+    }
+}
+
+void ClientSession::checkNoPendingRequest() const {
+    if (playerListPending || ticketPending) {
+        throw std::runtime_error("A request to the server is already pending");
+    }
+}
+
+bool ClientSession::hasSessionTicket() const {
+    return !ticket.empty();
+}
+
+void ClientSession::connect(const std::string &serverAddress, const std::string &clientAddress) {
+    if (state != State::CLOSED || socket) {
+        throw std::runtime_error("The session is already connected");
+    }
+
+    auto newSocket = std::make_unique<TcpSocket>();
+    if (!clientAddress.empty()) {
+        newSocket->bind(clientAddress, SERVER_PORT);
+    }
+    newSocket->connect(serverAddress, SERVER_PORT);
+    connect(std::move(newSocket));
+}
+
+void ClientSession::connect(std::unique_ptr<TcpSocket> connectedSocket) {
+    if (state != State::CLOSED || socket) {
+        throw std::runtime_error("The session is already connected");
+    }
+
+    myselfForServer = Player();
+    myselfForServer.setUsername(username);
+    myselfForServer.generateClientNonce();
+    resuming = !ticket.empty();
+
+    if (resuming) {
+        connectedSocket->send(ResumeHello(username, myselfForServer.getClientNonce(), ticket).serialize());
+        ticket.clear();
+    } else {
+        connectedSocket->send(ClientHello(username, myselfForServer.getClientNonce(), DELEGATED_SIGNATURE_SCHEMES,
+                                          KEY_EXCHANGE_GROUPS, AuthenticatedEncryption::getPreferredCipherSuites(),
+                                          certificateCache.getFingerprint()).serialize());
+    }
+
+    socket = std::move(connectedSocket);
+    state = State::HANDSHAKE;
+    helloReceived = false;
+    playerListPending = false;
+    ticketPending = false;
+    setDeadline(CLIENT_PROTOCOL_TIMEOUT);
+}
+
+void ClientSession::handleServerHello(const std::vector<unsigned char> &message) {
+    auto type = getMessageType<SerializationException>(message);
+    if (message.size() == sizeof(type)) {
+        throw std::runtime_error("Handshake refused by the server: " + convertMessageType(type));
+    }
+
+    if (type != SERVER_HELLO) {
+        throw SerializationException(convertMessageType(type));
+    }
+
+    ServerHello serverHello;
+    serverHello.deserialize(message);
+
+    // The server omits the certificate only if the session announced the cached one.
+    const Certificate *serverCertificate;
+    if (serverHello.getCertificate().empty()) {
+        if (certificateCache.getFingerprint().empty()) {
+            throw SerializationException("Missing server certificate");
+        }
+        serverCertificate = &certificateCache.get(certificateStore);
+    } else {
+        auto certificate = CertificateStore::deserializeCertificate(serverHello.getCertificate());
+
+        if (!certificateStore.verifyCertificate(certificate)
+            || certificate.getDistinguishedName() != SERVER_DISTINGUISHED_NAME) {
+            certificateCache.clear();
+            throw CryptoException("Invalid server certificate");
+        }
+        serverCertificate = &certificateCache.put(serverHello.getCertificate(), std::move(certificate), certificateStore);
+    }
+
+    myselfForServer.setServerNonce(serverHello.getNonce());
+    myselfForServer.setServerPublicKey(serverHello.getPublicKey());
+    myselfForServer.setCipherSuite(serverHello.getCipherSuite());
+    myselfForServer.generateServerFreshnessProof();
+
+    if (!DelegatedCredential::verifySignature(myselfForServer.getServerFreshnessProof(),
+                                              serverHello.getDigitalSignature(),
+                                              serverHello.getDelegatedCredential(),
+                                              serverCertificate->getPublicKey())) {
+        throw CryptoException("Invalid signature of the freshness proof");
+    }
+
+    myselfForServer.generateClientKeys();
+    myselfForServer.generateClientFreshnessProof();
+    auto signature = digitalSignature.sign(myselfForServer.getClientFreshnessProof());
+    socket->send(EndHandshake(myselfForServer.getClientPublicKey(), signature).serialize());
+    helloReceived = true;
+}
+
+void ClientSession::handleResumeAccepted(const std::vector<unsigned char> &message) {
+    // A rejected ticket is reported in cleartext, and the server closes the connection.
+    auto type = getMessageType<SerializationException>(message);
+    if (type != RESUME_ACCEPTED) {
+        throw std::runtime_error("Resumption refused by the server: " + convertMessageType(type));
+    }
+
+    ResumeAccepted resumeAccepted;
+    resumeAccepted.deserialize(message);
+
+    myselfForServer.setServerNonce(resumeAccepted.getNonce());
+    myselfForServer.setCipherSuite(resumeAccepted.getCipherSuite());
+    myselfForServer.resumeCipher(resumptionSecret);
+    cleanse(resumptionSecret);
+    resumptionSecret.clear();
+
+    socket->send(encrypt(InfoMessage(END_RESUME)));
+    helloReceived = true;
+}
+
+void ClientSession::handleFirstPlayerList(std::vector<unsigned char> &message) {
+    /*
+     * The errors of the handshake are sent in cleartext, and consist of the type only:
+     * the size tells them apart from the encrypted list, whose first byte can take any value.
+     */
+    auto type = getMessageType<SerializationException>(message);
+    if (message.size() == sizeof(type)) {
+        throw std::runtime_error("Handshake refused by the server: " + convertMessageType(type));
+    }
+
+    // A resumed session already has its cipher.
+    if (!resuming) {
+        myselfForServer.initCipher();
+    }
+
+    auto plaintext = decrypt(message);
+    type = getMessageType<SerializationException>(plaintext);
+    if (type != PLAYER_LIST) {
+        throw SerializationException(convertMessageType(type));
+    }
+
+    state = State::AVAILABLE;
+    clearDeadline();
+    listener.onConnected(*this);
+
+    if (state != State::CLOSED) {
+        notifyPlayerList(plaintext);
+    }
+}
+
+void ClientSession::notifyPlayerList(const std::vector<unsigned char> &message) {
+    PlayerListMessage playerListMessage;
+    playerListMessage.deserialize(message);
+    const auto &list = playerListMessage.getPlayerList();
+
+    std::vector<std::string> players;
+    size_t begin = 0;
+    for (auto end = list.find(';'); end != std::string::npos; begin = end + 1, end = list.find(';', begin)) {
+        players.push_back(list.substr(begin, end - begin));
+    }
+
+    listener.onPlayerList(*this, players);
+}
+
+void ClientSession::handleSessionTicket(const std::vector<unsigned char> &message) {
+    SessionTicket sessionTicket;
+    sessionTicket.deserialize(message);
+
+    ticket = sessionTicket.getTicket();
+    resumptionSecret = myselfForServer.getResumptionSecret();
+    listener.onSessionTicket(*this);
+}
+
+void ClientSession::failMatchmaking(MatchmakingFailure failure, bool abort) {
+    /*
+     * If the timeout has expired, the other player is not responding. Then, the matchmaking
+     * is aborted by sending an END_GAME message to the server: since this type of message
+     * is not expected at this point of the matchmaking, the server will manage it as an error
+     * in the protocol and cancel the matchmaking itself, forcing both clients in the
+     * MATCHMAKING_INTERRUPTED state.
+     *
+     * Note that sending END_GAME, instead of another message like PLAYER_NOT_AVAILABLE,
+     * is useful to avoid that this session gets trapped into the PLAYING state due to a
+     * response from the opponent sent near the expiration of the timeout.
+     * Indeed, consider this critical race:
+     * 1) this session is waiting for a CHALLENGE_ACCEPTED/REFUSED;
+     * 2) the opponent sends CHALLENGE_ACCEPTED near the expiration of this session's timeout.
+     *    The server receives CHALLENGE_ACCEPTED from the opponent, and immediately after it receives
+     *    the abort message sent by this session, triggered by the expiration of the timeout;
+     * 3) the server processes the CHALLENGE_ACCEPTED, puts both players in PLAYING state and
+     *    sends the PLAYER messages. This session, when PLAYER is received, believes the matchmaking
+     *    has been aborted and to be in the AVAILABLE state, and discards the message.
+     *    The opponent receives PLAYER correctly, tries to establish a P2P connection
+     *    with this client and fails, returning to the AVAILABLE state as expected by the protocol;
+     * 4) now, the server processes the abort message previously sent by this session.
+     *    This session is still in the PLAYING state for the server, so any message different
+     *    from END_GAME would result in a protocol violation (see PlayingClientHandler.cpp)
+     *    and the PLAYING state being preserved. An available session never sends END_GAME,
+     *    so it would never recover from the PLAYING state.
+     *    This is why sending END_GAME to abort the matchmaking is required.
+     */
+    if (abort && !send(InfoMessage(END_GAME))) {
+        return;
+    }
+
+    state = State::AVAILABLE;
+    clearDeadline();
+    listener.onMatchmakingFailed(*this, failure);
+}
+
+void ClientSession::endMatch(MatchEnd end) {
+    auto relayed = static_cast<bool>(board);
+    clearDeadline();
+
+    if (!send(InfoMessage(END_GAME))) {
+        return;
+    }
+
+    state = State::AVAILABLE;
+    if (relayed) {
+        listener.onMatchEnded(*this, end);
+    }
+}
+
+void ClientSession::handleChallenge(const std::vector<unsigned char> &message) {
+    Challenge challenge;
+    challenge.deserialize(message);
+
+    // The pending requests are ignored by the server, which has put the session in matchmaking.
+    auto preempted = state == State::CHALLENGING || state == State::QUEUED;
+    playerListPending = false;
+    ticketPending = false;
+    opponent = challenge.getUsername();
+    state = State::CHALLENGED;
+    clearDeadline();
+
+    if (preempted) {
+        listener.onMatchmakingFailed(*this, MatchmakingFailure::PREEMPTED);
+    }
+
+    if (state == State::CHALLENGED) {
+        listener.onChallenge(*this, opponent);
+    }
+}
+
+void ClientSession::handleChallengeResponse(uint8_t type) {
+    if (type == CHALLENGE_ACCEPTED) {
+        state = State::MATCHMAKING;
+        setDeadline(CLIENT_MATCHMAKING_TIMEOUT);
+        listener.onChallengeAccepted(*this);
+        return;
+    }
+
+    failMatchmaking(type == CHALLENGE_REFUSED ? MatchmakingFailure::REFUSED : MatchmakingFailure::NOT_AVAILABLE, false);
+}
+
+void ClientSession::handleMatchFound(const std::vector<unsigned char> &message) {
+    Challenge matchFound;
+    matchFound.deserialize(message);
+
+    // The profile of the opponent follows, as after an accepted challenge.
+    opponent = matchFound.getUsername();
+    state = State::MATCHMAKING;
+    setDeadline(CLIENT_MATCHMAKING_TIMEOUT);
+    listener.onOpponentFound(*this);
+}
+
+void ClientSession::handlePlayerMessage(const std::vector<unsigned char> &message) {
+    PlayerMessage playerMessage;
+    playerMessage.deserialize(message);
+
+    state = State::PLAYING;
+    clearDeadline();
+    board.reset();
+
+    if (playerMessage.isRelayed()) {
+        board = std::make_unique<FourInARow>(opponent);
+        myTurn = playerMessage.isFirstToPlay();
+        if (!myTurn) {
+            setDeadline(MAX_TURN_DURATION);
+        }
+    }
+
+    listener.onMatchStarted(*this, opponent, playerMessage);
+}
+
+void ClientSession::handleOpponentMove(const std::vector<unsigned char> &message) {
+    Move move;
+    move.deserialize(message);
+
+    if (myTurn || !board->registerMove(move.getColumn(), true)) {
+        endMatch(MatchEnd::OPPONENT_CHEATED);
+        return;
+    }
+
+    // A finishing move is notified only by the end of the match: the board keeps it.
+    if (board->isMatchFinished()) {
+        endMatch(board->getResult() == MatchResult::WIN ? MatchEnd::WIN
+                 : board->getResult() == MatchResult::DRAW ? MatchEnd::DRAW : MatchEnd::LOSS);
+        return;
+    }
+
+    myTurn = true;
+    clearDeadline();
+    listener.onOpponentMove(*this, move.getColumn());
+}
+
+void ClientSession::handleMessage(std::vector<unsigned char> &message) {
+    auto plaintext = decrypt(message);
+    auto type = getMessageType<SerializationException>(plaintext);
+
+    if (type == MALFORMED_MESSAGE || type == INTERNAL_ERROR) {
+        throw std::runtime_error("Error reported by the server: " + convertMessageType(type));
+    }
+
+    if (type == CHALLENGE && (state == State::AVAILABLE || state == State::CHALLENGING || state == State::QUEUED)) {
+        handleChallenge(plaintext);
+        return;
+    }
+
+    // A challenge or a quick match requested after the request does not prevent the response from being sent.
+    auto requesting = state == State::AVAILABLE || state == State::CHALLENGING || state == State::QUEUED;
+    if (requesting && type == PLAYER_LIST && playerListPending) {
+        playerListPending = false;
+        if (state == State::AVAILABLE) {
+            clearDeadline();
+        }
+        notifyPlayerList(plaintext);
+        return;
+    }
+
+    if (requesting && type == SESSION_TICKET && ticketPending) {
+        ticketPending = false;
+        if (state == State::AVAILABLE) {
+            clearDeadline();
+        }
+        handleSessionTicket(plaintext);
+        return;
+    }
+
+    if (state == State::CHALLENGING
+        && (type == CHALLENGE_ACCEPTED || type == CHALLENGE_REFUSED || type == PLAYER_NOT_AVAILABLE)) {
+        handleChallengeResponse(type);
+        return;
+    }
+
+    if (state == State::QUEUED && type == QUICK_MATCH_FOUND) {
+        handleMatchFound(plaintext);
+        return;
+    }
+
+    // The server cancels the quick match if the opponent found cannot be reached.
+    if (state == State::QUEUED && type == PLAYER_NOT_AVAILABLE) {
+        failMatchmaking(MatchmakingFailure::NOT_AVAILABLE, false);
+        return;
+    }
+
+    if (state == State::MATCHMAKING && (type == PLAYER || type == RELAYED_PLAYER)) {
+        handlePlayerMessage(plaintext);
+        return;
+    }
+
+    // The server cancels the matchmaking if the challenger aborted it, rejecting the acceptance.
+    if (state == State::MATCHMAKING && type == PROTOCOL_VIOLATION) {
+        failMatchmaking(MatchmakingFailure::NOT_AVAILABLE, false);
+        return;
+    }
+
+    if (state == State::PLAYING && board && type == MOVE) {
+        handleOpponentMove(plaintext);
+        return;
+    }
+
+    if (state == State::PLAYING && board && type == GOODBYE) {
+        endMatch(MatchEnd::OPPONENT_LEFT);
+        return;
+    }
+
+    /*
+     * The other messages are late responses to an aborted matchmaking or a left match,
+     * e.g. the PLAYER message or the PROTOCOL_VIOLATION following an abort, and are discarded,
+     * as the messages received while leaving.
+     */
+}
+
+void ClientSession::handleReadable() {
+    try {
+        socket->receiveAvailable(receiveBuffer);
+
+        std::vector<unsigned char> message;
+        while (state != State::CLOSED && TcpSocket::extractMessage(receiveBuffer, message)) {
+            if (state != State::HANDSHAKE) {
+                handleMessage(message);
+            } else if (helloReceived) {
+                handleFirstPlayerList(message);
+            } else if (resuming) {
+                handleResumeAccepted(message);
+            } else {
+                handleServerHello(message);
+            }
+        }
+    } catch (const std::exception &exception) {
+        if (state != State::LEAVING) {
+            terminate(exception.what());
+            return;
+        }
+
+        // The server closes the connection once it has handled the GOODBYE.
+        terminate("");
+        listener.onLeft(*this);
+    }
+}
+
+void ClientSession::checkTimeout(Clock::time_point now) {
+    if (!deadlineSet || now < deadline) {
+        return;
+    }
+
+    clearDeadline();
+
+    if (state == State::CHALLENGING || state == State::QUEUED || state == State::MATCHMAKING) {
+        failMatchmaking(MatchmakingFailure::TIMEOUT, true);
+    } else if (state == State::PLAYING) {
+        endMatch(MatchEnd::TIMEOUT);
+    } else {
+        terminate("The server is not responding");
+    }
+}
+
+void ClientSession::requestPlayerList() {
+    checkState(State::AVAILABLE, "REQ_PLAYER_LIST");
+    checkNoPendingRequest();
+
+    if (send(InfoMessage(REQ_PLAYER_LIST))) {
+        playerListPending = true;
+        setDeadline(CLIENT_PROTOCOL_TIMEOUT);
+    }
+}
+
+void ClientSession::requestSessionTicket() {
+    checkState(State::AVAILABLE, "REQ_TICKET");
+    checkNoPendingRequest();
+
+    if (send(InfoMessage(REQ_TICKET))) {
+        ticketPending = true;
+        setDeadline(CLIENT_PROTOCOL_TIMEOUT);
+    }
+}
+
+void ClientSession::challenge(const std::string &username) {
+    checkState(State::AVAILABLE, "CHALLENGE");
+    checkUsernameValidity<std::runtime_error>(username);
+
+    if (send(Challenge(username))) {
+        opponent = username;
+        state = State::CHALLENGING;
+        setDeadline(CLIENT_MATCHMAKING_TIMEOUT);
+    }
+}
+
+void ClientSession::quickMatch() {
+    checkState(State::AVAILABLE, "QUICK_MATCH");
+
+    if (send(InfoMessage(QUICK_MATCH))) {
+        opponent.clear();
+        state = State::QUEUED;
+        setDeadline(CLIENT_MATCHMAKING_TIMEOUT);
+    }
+}
+
+void ClientSession::acceptChallenge() {
+    checkState(State::CHALLENGED, "CHALLENGE_ACCEPTED");
+
+    if (send(InfoMessage(CHALLENGE_ACCEPTED))) {
+        state = State::MATCHMAKING;
+        setDeadline(CLIENT_MATCHMAKING_TIMEOUT);
+    }
+}
+
+void ClientSession::refuseChallenge() {
+    checkState(State::CHALLENGED, "CHALLENGE_REFUSED");
+
+    if (send(InfoMessage(CHALLENGE_REFUSED))) {
+        state = State::AVAILABLE;
+    }
+}
+
+bool ClientSession::makeMove(uint8_t column) {
+    checkState(State::PLAYING, "MOVE");
+    if (!board || !myTurn) {
+        throw std::runtime_error("It is not the turn of the session in a relayed match");
+    }
+
+    if (column >= COLUMNS || !board->registerMove(column, false)) {
+        return false;
+    }
+
+    if (!send(Move(column))) {
+        return true;
+    }
+
+    if (board->isMatchFinished()) {
+        endMatch(board->getResult() == MatchResult::WIN ? MatchEnd::WIN
+                 : board->getResult() == MatchResult::DRAW ? MatchEnd::DRAW : MatchEnd::LOSS);
+        return true;
+    }
+
+    myTurn = false;
+    setDeadline(MAX_TURN_DURATION);
+    return true;
+}
+
+void ClientSession::leaveMatch() {
+    checkState(State::PLAYING, "END_GAME");
+
+    if (board && !send(InfoMessage(GOODBYE))) {
+        return;
+    }
+
+    endMatch(MatchEnd::LEFT);
+}
+
+void ClientSession::leave() {
+    checkState(State::AVAILABLE, "GOODBYE");
+
+    if (send(InfoMessage(GOODBYE))) {
+        state = State::LEAVING;
+        playerListPending = false;
+        ticketPending = false;
+        setDeadline(CLIENT_PROTOCOL_TIMEOUT);
+    }
+}
+
+void ClientSession::close() {
+    if (state == State::CLOSED) {
+        return;
+    }
+
+    if (state != State::HANDSHAKE && state != State::LEAVING) {
+        try {
+            socket->send(encrypt(InfoMessage(GOODBYE)));
+        } catch (const std::exception &exception) {
+            // The session is closed anyway.
+        }
+    }
+
+    terminate("");
+}
+
+}
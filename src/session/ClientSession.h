@@ -0,0 +1,293 @@
+#ifndef INC_4INAROW_CLIENTSESSION_H
+#define INC_4INAROW_CLIENTSESSION_H
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <TcpSocket.h>
+#include <Player.h>
+#include <Message.h>
+#include <FourInARow.h>
+#include <CertificateCache.h>
+#include <CertificateStore.h>
+#include <DigitalSignature.h>
+#include "SessionListener.h"
+
+namespace fourinarow {
+
+class SessionLoop;
+
+/**
+ * Class representing the session of a client with the server, driven by commands and emitting events.
+ * The session never blocks waiting for the server: after the connection, it is attached to a
+ * <code>SessionLoop</code>, which handles the messages of many sessions as they arrive and enforces the
+ * timeouts of the protocol, notifying a <code>SessionListener</code>. The commands are valid only in
+ * some states, and throw a <code>runtime_error</code> otherwise: the sends are performed immediately,
+ * and a failure closes the session, notified by <code>onClosed()</code>.
+ * The relayed matches are played through the session, which keeps the board and checks the moves.
+ */
+class ClientSession {
+    public:
+        enum class State {
+                HANDSHAKE,    // Connected, waiting for the end of the handshake.
+                AVAILABLE,    // Available for a match.
+                CHALLENGING,  // A challenge has been sent, and waits for a response.
+                CHALLENGED,   // A challenge has been received, and waits for <code>acceptChallenge()</code> or <code>refuseChallenge()</code>.
+                QUEUED,       // A quick match has been requested, and waits for the server to find an opponent.
+                MATCHMAKING,  // A challenge has been accepted, and the profile of the opponent is expected.
+                PLAYING,      // A match is being played, either relayed or P2P.
+                LEAVING,      // A GOODBYE has been sent, and the server is expected to close the connection.
+                CLOSED
+        };
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        std::string username;
+        const DigitalSignature &digitalSignature;
+        const CertificateStore &certificateStore;
+        CertificateCache certificateCache;  // The certificate of the server, reused when reconnecting.
+        SessionListener &listener;
+        std::unique_ptr<TcpSocket> socket;
+        Player myselfForServer;
+        std::vector<unsigned char> receiveBuffer;
+        SessionLoop *loop;
+        State state;
+        bool resuming;                      // True if the handshake resumes a previous session.
+        bool helloReceived;                 // True once the SERVER_HELLO or the RESUME_ACCEPTED has been handled.
+        bool playerListPending;
+        bool ticketPending;
+        std::vector<unsigned char> ticket;  // The ticket resuming the last session. Used once.
+        std::vector<unsigned char> resumptionSecret;
+        std::string opponent;
+        std::unique_ptr<FourInARow> board;  // The board of the current or last match, if relayed.
+        bool myTurn;
+        bool deadlineSet;
+        Clock::time_point deadline;         // The deadline of the response awaited, if set.
+
+        friend class SessionLoop;
+
+        void setDeadline(unsigned long seconds);
+        void clearDeadline();
+
+        /**
+         * Performs the authenticated encryption of the given message,
+         * returning the ciphertext concatenated with the tag.
+         * @param message  the message to encrypt and authenticate.
+         * @return         the ciphertext concatenated with the tag.
+         * @throws CryptoException  if an error occurs while encrypting the message,
+         *                          or the maximum sequence number has been reached.
+         */
+        std::vector<unsigned char> encrypt(const Message &message);
+
+        /**
+         * Performs the authenticated encryption of the given message and sends it to the server.
+         * A failure closes the session.
+         * @param message  the message to send.
+         * @return         true if the message has been sent, false if the session has been closed.
+         */
+        bool send(const Message &message);
+
+        /**
+         * Performs the authenticated decryption of a message received from the server.
+         * @param message  the encrypted message.
+         * @return         the decrypted message.
+         * @throws CryptoException  if the message cannot be decrypted, or the tag is not valid.
+         */
+        std::vector<unsigned char> decrypt(std::vector<unsigned char> &message);
+
+        /**
+         * Closes the connection and detaches the session from its loop.
+         * @param reason  the reason of the closure, notified to the listener if not empty.
+         */
+        void terminate(const std::string &reason);
+
+        /**
+         * Checks that no player list or session ticket is awaited.
+         * @throws runtime_error  if a request is pending.
+         */
+        void checkNoPendingRequest() const;
+
+        void handleServerHello(const std::vector<unsigned char> &message);
+        void handleResumeAccepted(const std::vector<unsigned char> &message);
+        void handleFirstPlayerList(std::vector<unsigned char> &message);
+        void handleSessionTicket(const std::vector<unsigned char> &message);
+        void handleMatchFound(const std::vector<unsigned char> &message);
+        void handleMessage(std::vector<unsigned char> &message);
+        void handleChallenge(const std::vector<unsigned char> &message);
+        void handleChallengeResponse(uint8_t type);
+        void handlePlayerMessage(const std::vector<unsigned char> &message);
+        void handleOpponentMove(const std::vector<unsigned char> &message);
+        void notifyPlayerList(const std::vector<unsigned char> &message);
+
+        /**
+         * Fails the pending matchmaking, making the session available again.
+         * @param failure  the reason of the failure.
+         * @param abort    true if the server must be told to cancel the matchmaking, false otherwise.
+         */
+        void failMatchmaking(MatchmakingFailure failure, bool abort);
+
+        /**
+         * Ends the current match, notifying its end to the server, and makes the session available again.
+         * @param end  the reason of the end, notified to the listener for relayed matches.
+         */
+        void endMatch(MatchEnd end);
+
+        /**
+         * Checks that the session is in the given state.
+         * @throws runtime_error  if the session is in another state.
+         */
+        void checkState(State expected, const std::string &command) const;
+
+        /**
+         * Handles the bytes received from the server, processing all the complete messages.
+         * Called by the loop when the socket is ready.
+         */
+        void handleReadable();
+
+        /**
+         * Enforces the timeout of the response awaited, if any. Called periodically by the loop.
+         * @param now  the current time.
+         */
+        void checkTimeout(Clock::time_point now);
+    public:
+        /**
+         * Creates a disconnected session.
+         * @param username          the username of the client.
+         * @param digitalSignature  the digital signature tool holding the private key of the client.
+         *                          It can be shared by many sessions.
+         * @param certificateStore  the store verifying the certificate of the server. It can be shared by many sessions.
+         * @param listener          the listener of the events of the session. It can be shared by many sessions.
+         */
+        ClientSession(std::string username,
+                      const DigitalSignature &digitalSignature,
+                      const CertificateStore &certificateStore,
+                      SessionListener &listener);
+
+        /**
+         * Closes the session, if still open.
+         */
+        ~ClientSession();
+
+        ClientSession(const ClientSession&) = delete;
+        ClientSession& operator=(const ClientSession&) = delete;
+        ClientSession(ClientSession&&) = delete;
+        ClientSession& operator=(ClientSession&&) = delete;
+
+        const std::string& getUsername() const;
+        State getState() const;
+
+        /**
+         * Returns the opponent of the current or last match, or the player involved in the current challenge.
+         * While a quick match waits for an opponent, the string is empty.
+         */
+        const std::string& getOpponent() const;
+
+        /**
+         * Returns the board of the current relayed match or, once it has ended, its final position.
+         * @throws runtime_error  if the current or last match is not relayed.
+         */
+        const FourInARow& getBoard() const;
+
+        /**
+         * Checks if the session has to move in the current relayed match.
+         */
+        bool isMyTurn() const;
+
+        /**
+         * Checks if the session holds a session ticket, which resumes the session at the next connection.
+         */
+        bool hasSessionTicket() const;
+
+        /**
+         * Connects to the server and starts the handshake. The session must then be added to a loop.
+         * The handshake resumes the previous session if a session ticket is held, and is a full one otherwise.
+         * @param serverAddress  the IPv4 address of the server.
+         * @param clientAddress  the IPv4 address to which the socket binds, as the client application does
+         *                       to be reachable for P2P matches. If empty, the socket is not bound.
+         * @throws runtime_error  if the session has already been connected.
+         * @throws SocketException  if an error occurs while connecting or sending the first message.
+         */
+        void connect(const std::string &serverAddress, const std::string &clientAddress = "");
+
+        /**
+         * Starts the handshake over a socket already connected to the server, as <code>connect()</code> does.
+         * @param connectedSocket  the connected socket, owned by the session from now on.
+         * @throws runtime_error  if the session has already been connected.
+         * @throws SocketException  if an error occurs while sending the first message.
+         */
+        void connect(std::unique_ptr<TcpSocket> connectedSocket);
+
+        /**
+         * Asks the server for the list of the available players, notified by <code>onPlayerList()</code>.
+         * A pending request is dropped by the server if a challenge arrives first.
+         * @throws runtime_error  if the session is not available, or a request is pending.
+         */
+        void requestPlayerList();
+
+        /**
+         * Asks the server for a session ticket, notified by <code>onSessionTicket()</code> and kept by the session
+         * to resume the session at the next connection. A pending request is dropped by the server
+         * if a challenge arrives first.
+         * @throws runtime_error  if the session is not available, or a request is pending.
+         */
+        void requestSessionTicket();
+
+        /**
+         * Challenges a player. The outcome is notified by <code>onMatchStarted()</code> or <code>onMatchmakingFailed()</code>.
+         * @param username  the username of the challenged player.
+         * @throws runtime_error  if the session is not available.
+         */
+        void challenge(const std::string &username);
+
+        /**
+         * Asks the server for a quick match against a player of similar rating. The outcome is notified
+         * by <code>onMatchStarted()</code> or <code>onMatchmakingFailed()</code>.
+         * @throws runtime_error  if the session is not available.
+         */
+        void quickMatch();
+
+        /**
+         * Accepts the challenge received. The start of the match is notified by <code>onMatchStarted()</code>.
+         * @throws runtime_error  if no challenge is waiting for a response.
+         */
+        void acceptChallenge();
+
+        /**
+         * Refuses the challenge received, making the session available again.
+         * @throws runtime_error  if no challenge is waiting for a response.
+         */
+        void refuseChallenge();
+
+        /**
+         * Makes a move in the current relayed match. If the move ends the match, the end is notified
+         * by <code>onMatchEnded()</code> before the method returns.
+         * @param column  the column of the move.
+         * @return        true if the move has been made, false if it is not valid.
+         * @throws runtime_error  if no relayed match is being played, or it is not the turn of the session.
+         */
+        bool makeMove(uint8_t column);
+
+        /**
+         * Leaves the current match. The opponent of a relayed match is notified;
+         * for a P2P match, the server is told that the match has ended.
+         * @throws runtime_error  if no match is being played.
+         */
+        void leaveMatch();
+
+        /**
+         * Leaves the server, waiting for it to close the connection: the closure is notified by <code>onLeft()</code>.
+         * Unlike <code>close()</code>, the username can be used by a new connection as soon as the event is emitted.
+         * @throws runtime_error  if the session is not available.
+         */
+        void leave();
+
+        /**
+         * Leaves the server and closes the connection immediately. The listener is not notified.
+         */
+        void close();
+};
+
+}
+
+#endif //INC_4INAROW_CLIENTSESSION_H
@@ -0,0 +1,123 @@
+#ifndef INC_4INAROW_SESSIONLISTENER_H
+#define INC_4INAROW_SESSIONLISTENER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <PlayerMessage.h>
+
+namespace fourinarow {
+
+class ClientSession;
+
+/**
+ * Reason of a failed matchmaking.
+ */
+enum class MatchmakingFailure {
+        REFUSED,        // The challenged player refused the challenge.
+        NOT_AVAILABLE,  // The challenged player is not available, or the server cancelled the matchmaking.
+        PREEMPTED,      // A challenge from another player arrived first: the server ignores the sent request.
+        TIMEOUT         // No response or opponent arrived in time: the matchmaking has been aborted.
+};
+
+/**
+ * Reason of the end of a match, from the point of view of the session.
+ */
+enum class MatchEnd {
+        WIN,
+        DRAW,
+        LOSS,
+        LEFT,              // The session left the match.
+        OPPONENT_LEFT,
+        OPPONENT_CHEATED,  // The opponent sent an invalid move.
+        TIMEOUT            // The opponent did not move in time.
+};
+
+/**
+ * Class receiving the events of client sessions. The default implementation of each event does nothing,
+ * so that a listener overrides only the events it is interested in.
+ * The events are emitted after the state of the session has been updated: a listener can issue
+ * commands to the session from inside an event, but it must not destroy the session.
+ */
+class SessionListener {
+    public:
+        SessionListener() = default;
+        virtual ~SessionListener() = default;
+
+        SessionListener(const SessionListener&) = default;
+        SessionListener& operator=(const SessionListener&) = default;
+        SessionListener(SessionListener&&) = default;
+        SessionListener& operator=(SessionListener&&) = default;
+
+        /**
+         * The handshake with the server succeeded. It is followed by the first player list.
+         */
+        virtual void onConnected(ClientSession&) {}
+
+        /**
+         * A player list has been received, either the first one or the response to a request.
+         * The list holds the players available for a match.
+         */
+        virtual void onPlayerList(ClientSession&, const std::vector<std::string>&) {}
+
+        /**
+         * A session ticket has been received, and will resume the session at the next connection.
+         */
+        virtual void onSessionTicket(ClientSession&) {}
+
+        /**
+         * A player has sent a challenge, to be answered with <code>acceptChallenge()</code>
+         * or <code>refuseChallenge()</code>.
+         */
+        virtual void onChallenge(ClientSession&, const std::string&) {}
+
+        /**
+         * The challenged player has accepted the challenge sent. The profile of the opponent is expected.
+         */
+        virtual void onChallengeAccepted(ClientSession&) {}
+
+        /**
+         * A quick match has found an opponent, returned by <code>getOpponent()</code>.
+         * The profile of the opponent is expected.
+         */
+        virtual void onOpponentFound(ClientSession&) {}
+
+        /**
+         * A challenge, either sent or accepted, did not lead to a match.
+         */
+        virtual void onMatchmakingFailed(ClientSession&, MatchmakingFailure) {}
+
+        /**
+         * A match has started against the given opponent. If the match is relayed, it is played through
+         * the session; otherwise the message carries the address and the public key of the opponent,
+         * the match is played P2P by the owner of the session, which then calls <code>leaveMatch()</code>.
+         */
+        virtual void onMatchStarted(ClientSession&, const std::string&, const PlayerMessage&) {}
+
+        /**
+         * The opponent of a relayed match has made a valid move, and the session has to move.
+         * A move ending the match is notified only by <code>onMatchEnded()</code>.
+         */
+        virtual void onOpponentMove(ClientSession&, uint8_t) {}
+
+        /**
+         * A relayed match has ended. The session is available again, and <code>getBoard()</code>
+         * returns the final position.
+         */
+        virtual void onMatchEnded(ClientSession&, MatchEnd) {}
+
+        /**
+         * The server has closed the connection after <code>leave()</code>.
+         */
+        virtual void onLeft(ClientSession&) {}
+
+        /**
+         * The session has been closed because of an error or a timeout, with the given reason.
+         * It is not emitted when the owner closes the session.
+         */
+        virtual void onClosed(ClientSession&, const std::string&) {}
+};
+
+}
+
+#endif //INC_4INAROW_SESSIONLISTENER_H
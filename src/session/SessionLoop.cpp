@@ -0,0 +1,87 @@
+#include <stdexcept>
+#include <SocketException.h>
+#include "SessionLoop.h"
+
+namespace fourinarow {
+
+SessionLoop::~SessionLoop() {
+    for (auto &session : sessions) {
+        session.second->loop = nullptr;
+    }
+}
+
+void SessionLoop::add(ClientSession &session) {
+    if (session.loop) {
+        throw std::runtime_error("The session is already attached to a loop");
+    }
+
+    if (!session.socket) {
+        throw std::runtime_error("The session is not connected");
+    }
+
+    auto descriptor = session.socket->getDescriptor();
+    multiplexer.addDescriptor(descriptor);
+    sessions[descriptor] = &session;
+    session.loop = this;
+}
+
+void SessionLoop::remove(ClientSession &session) {
+    auto descriptor = session.socket->getDescriptor();
+    multiplexer.removeDescriptor(descriptor);
+    sessions.erase(descriptor);
+    session.loop = nullptr;
+}
+
+void SessionLoop::watch(unsigned int descriptor) {
+    multiplexer.addDescriptor(descriptor);
+}
+
+void SessionLoop::unwatch(unsigned int descriptor) {
+    multiplexer.removeDescriptor(descriptor);
+}
+
+bool SessionLoop::isReady(unsigned int descriptor) const {
+    return multiplexer.isReady(descriptor);
+}
+
+size_t SessionLoop::getSessionCount() const {
+    return sessions.size();
+}
+
+void SessionLoop::runOnce(unsigned long seconds) {
+    try {
+        multiplexer.selectWithTimeout(seconds);
+
+        // The sessions closed while handling the messages are removed from the map, and skipped.
+        auto readyDescriptors = multiplexer.getReadyDescriptors();
+        for (auto descriptor : readyDescriptors) {
+            auto session = sessions.find(descriptor);
+            if (session != sessions.end()) {
+                session->second->handleReadable();
+            }
+        }
+    } catch (const SocketException &exception) {
+        // No session has received data before the timeout.
+    }
+
+    // The sessions may be closed by the checks, so they are iterated on a copy.
+    snapshot.clear();
+    for (auto &session : sessions) {
+        snapshot.push_back(session.second);
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    for (auto session : snapshot) {
+        if (session->loop == this) {
+            session->checkTimeout(now);
+        }
+    }
+}
+
+void SessionLoop::run() {
+    while (!sessions.empty()) {
+        runOnce(1);
+    }
+}
+
+}
@@ -0,0 +1,91 @@
+#ifndef INC_4INAROW_SESSIONLOOP_H
+#define INC_4INAROW_SESSIONLOOP_H
+
+#include <unordered_map>
+#include <vector>
+#include <InputMultiplexer.h>
+#include "ClientSession.h"
+
+namespace fourinarow {
+
+/**
+ * Class representing an event loop shared by many client sessions. It waits for the messages
+ * of all the sessions on a single input multiplexer, handing each session the messages it received,
+ * and enforces the timeouts of the pending responses. A closed session is removed automatically.
+ * The loop is single-threaded: the sessions and their listeners are used only by the thread running it.
+ * Other descriptors, like the standard input of an interactive client, can be watched by the same wait.
+ */
+class SessionLoop {
+    private:
+        InputMultiplexer multiplexer;
+        std::unordered_map<int, ClientSession*> sessions;
+        std::vector<ClientSession*> snapshot;
+
+        friend class ClientSession;
+
+        /**
+         * Detaches a session from the loop. Called by a session when it is closed.
+         * @param session  the session.
+         */
+        void remove(ClientSession &session);
+    public:
+        SessionLoop() = default;
+
+        /**
+         * Detaches the sessions still attached, which stay open.
+         */
+        ~SessionLoop();
+
+        SessionLoop(const SessionLoop&) = delete;
+        SessionLoop& operator=(const SessionLoop&) = delete;
+        SessionLoop(SessionLoop&&) = delete;
+        SessionLoop& operator=(SessionLoop&&) = delete;
+
+        /**
+         * Attaches a connected session to the loop. The session is detached when it is closed,
+         * and must not be destroyed while the loop is running.
+         * @param session  the session.
+         * @throws runtime_error  if the session is not connected, or is attached to a loop.
+         */
+        void add(ClientSession &session);
+
+        /**
+         * Adds a descriptor not belonging to a session to the ones waited for by <code>runOnce()</code>.
+         * @param descriptor  the descriptor.
+         */
+        void watch(unsigned int descriptor);
+
+        /**
+         * Removes a descriptor added by <code>watch()</code>.
+         * @param descriptor  the descriptor.
+         */
+        void unwatch(unsigned int descriptor);
+
+        /**
+         * Checks if a watched descriptor became readable during the last call to <code>runOnce()</code>.
+         * @param descriptor  the descriptor.
+         * @return            true if the descriptor is readable, false otherwise.
+         */
+        bool isReady(unsigned int descriptor) const;
+
+        /**
+         * Returns the number of sessions attached to the loop.
+         */
+        size_t getSessionCount() const;
+
+        /**
+         * Waits until at least one session receives data or the timeout expires,
+         * then handles the received messages and the expired timeouts.
+         * @param seconds  the maximum waiting time, in seconds.
+         */
+        void runOnce(unsigned long seconds);
+
+        /**
+         * Runs the loop until no session is attached. The watched descriptors are not read.
+         */
+        void run();
+};
+
+}
+
+#endif //INC_4INAROW_SESSIONLOOP_H
@@ -1,86 +1,168 @@
+#include <algorithm>
+#include <climits>
 #include <errno.h>
 #include <string.h>
+#include <unistd.h>
 #include <SocketException.h>
 #include "InputMultiplexer.h"
 
 namespace fourinarow {
 
-InputMultiplexer::InputMultiplexer() {
-    FD_ZERO(&masterSet);
-    FD_ZERO(&readSet);
-    maxDescriptor = 0u;
-    numberOfDescriptors = 0u;
+const int InputMultiplexer::MAX_EVENTS_PER_WAIT;
+
+InputMultiplexer::InputMultiplexer() : epollDescriptor(epoll_create1(EPOLL_CLOEXEC)), numberOfDescriptors(0u) {
+    if (epollDescriptor == -1) {
+        throw SocketException(parseError());
+    }
 }
 
-void InputMultiplexer::addDescriptor(unsigned int descriptor) {
-    if (descriptor >= FD_SETSIZE) {
+InputMultiplexer::~InputMultiplexer() {
+    if (epollDescriptor != -1) {
+        close(epollDescriptor);
+    }
+}
+
+InputMultiplexer::InputMultiplexer(InputMultiplexer &&that) noexcept
+    : epollDescriptor(that.epollDescriptor),
+      numberOfDescriptors(that.numberOfDescriptors),
+      events(std::move(that.events)),
+      readyDescriptors(std::move(that.readyDescriptors)),
+      readyFlags(std::move(that.readyFlags)),
+      alwaysReadyDescriptors(std::move(that.alwaysReadyDescriptors)) {
+    that.epollDescriptor = -1;
+    that.numberOfDescriptors = 0u;
+}
+
+InputMultiplexer& InputMultiplexer::operator=(InputMultiplexer &&that) noexcept {
+    std::swap(epollDescriptor, that.epollDescriptor);
+    std::swap(numberOfDescriptors, that.numberOfDescriptors);
+    std::swap(events, that.events);
+    std::swap(readyDescriptors, that.readyDescriptors);
+    std::swap(readyFlags, that.readyFlags);
+    std::swap(alwaysReadyDescriptors, that.alwaysReadyDescriptors);
+    return *this;
+}
+
+void InputMultiplexer::monitorDescriptor(unsigned int descriptor, uint32_t events) {
+    if (descriptor > INT_MAX) {
         throw SocketException("Invalid descriptor");
     }
 
-    if (numberOfDescriptors == FD_SETSIZE) {
-        throw SocketException("Cannot monitor more than " + std::to_string(FD_SETSIZE) + " sockets at a time");
+    epoll_event event{};
+    event.events = events;
+    event.data.fd = descriptor;
+
+    if (epoll_ctl(epollDescriptor, EPOLL_CTL_ADD, descriptor, &event) == -1) {
+        if (errno == EEXIST) {
+            return;
+        }
+
+        // Regular files cannot be monitored, but a read on them never blocks.
+        if (errno == EPERM) {
+            if (std::find(alwaysReadyDescriptors.begin(), alwaysReadyDescriptors.end(), descriptor)
+                == alwaysReadyDescriptors.end()) {
+                alwaysReadyDescriptors.push_back(descriptor);
+                numberOfDescriptors++;
+            }
+            return;
+        }
+
+        throw SocketException(parseError());
     }
 
-    FD_SET(descriptor, &masterSet);
     numberOfDescriptors++;
+}
+
+void InputMultiplexer::addDescriptor(unsigned int descriptor) {
+    monitorDescriptor(descriptor, EPOLLIN);
+}
 
-    if (descriptor > maxDescriptor)
-        maxDescriptor = descriptor;
+void InputMultiplexer::addConnectingDescriptor(unsigned int descriptor) {
+    // A connection in progress makes the socket writable, not readable, when it is established.
+    monitorDescriptor(descriptor, EPOLLIN | EPOLLOUT);
 }
 
 void InputMultiplexer::removeDescriptor(unsigned int descriptor) {
-    if (descriptor >= FD_SETSIZE) {
-        throw SocketException("Invalid descriptor");
+    if (descriptor < readyFlags.size()) {
+        readyFlags[descriptor] = false;
+    }
+
+    auto alwaysReady = std::find(alwaysReadyDescriptors.begin(), alwaysReadyDescriptors.end(), descriptor);
+    if (alwaysReady != alwaysReadyDescriptors.end()) {
+        alwaysReadyDescriptors.erase(alwaysReady);
+        numberOfDescriptors--;
+        return;
     }
 
-    if (FD_ISSET(descriptor, &masterSet)) {
-        FD_CLR(descriptor, &masterSet);
+    if (descriptor <= INT_MAX && epoll_ctl(epollDescriptor, EPOLL_CTL_DEL, descriptor, nullptr) == 0) {
         numberOfDescriptors--;
     }
 }
 
 bool InputMultiplexer::isReady(const unsigned int &descriptor) const {
-    if (descriptor >= FD_SETSIZE) {
-        throw SocketException("Invalid descriptor");
-    }
+    return descriptor < readyFlags.size() && readyFlags[descriptor];
+}
 
-    return FD_ISSET(descriptor, &readSet);
+const std::vector<unsigned int>& InputMultiplexer::getReadyDescriptors() const {
+    return readyDescriptors;
 }
 
 char* InputMultiplexer::parseError() const {
     return strerror(errno);
 }
 
-void InputMultiplexer::select() {
-    if (numberOfDescriptors == 0) {
-        return;
+size_t InputMultiplexer::wait(int milliseconds) {
+    for (auto descriptor : readyDescriptors) {
+        if (descriptor < readyFlags.size()) {
+            readyFlags[descriptor] = false;
+        }
     }
+    readyDescriptors.clear();
 
-    readSet = masterSet;
-    auto success = ::select(maxDescriptor + 1, &readSet, nullptr, nullptr, nullptr);
+    // The descriptors that are always ready must not make the wait block.
+    if (!alwaysReadyDescriptors.empty()) {
+        milliseconds = 0;
+    }
+
+    events.resize(std::min<size_t>(std::max(numberOfDescriptors, 1u), MAX_EVENTS_PER_WAIT));
+    auto readyCount = epoll_wait(epollDescriptor, events.data(), events.size(), milliseconds);
 
-    if (success == -1) {
+    if (readyCount == -1) {
         throw SocketException(parseError());
     }
+
+    readyDescriptors.reserve(readyCount + alwaysReadyDescriptors.size());
+    for (auto i = 0; i < readyCount; i++) {
+        readyDescriptors.push_back(events[i].data.fd);
+    }
+    readyDescriptors.insert(readyDescriptors.end(), alwaysReadyDescriptors.begin(), alwaysReadyDescriptors.end());
+
+    for (auto descriptor : readyDescriptors) {
+        if (descriptor >= readyFlags.size()) {
+            readyFlags.resize(descriptor + 1, false);
+        }
+        readyFlags[descriptor] = true;
+    }
+
+    return readyDescriptors.size();
 }
 
-void InputMultiplexer::selectWithTimeout(unsigned long seconds) {
+void InputMultiplexer::select() {
     if (numberOfDescriptors == 0) {
         return;
     }
 
-    timeval timeout;
-    timeout.tv_sec = seconds;
-    timeout.tv_usec = 0;
-
-    readSet = masterSet;
-    auto success = ::select(maxDescriptor + 1, &readSet, nullptr, nullptr, &timeout);
+    wait(-1);
+}
 
-    if (success == -1) {
-        throw SocketException(parseError());
+void InputMultiplexer::selectWithTimeout(unsigned long seconds) {
+    if (numberOfDescriptors == 0) {
+        return;
     }
 
-    if (success == 0) {
+    auto milliseconds = static_cast<int>(std::min<unsigned long>(seconds, INT_MAX/1000)*1000);
+
+    if (wait(milliseconds) == 0) {
         throw SocketException("Timeout expired");
     }
 }
@@ -2,61 +2,99 @@
 #define INC_4INAROW_INPUTMULTIPLEXER_H
 
 #include <sys/types.h>
+#include <sys/epoll.h>
 #include <ostream>
+#include <vector>
 
 namespace fourinarow {
 
 /**
  * Class representing an input multiplexer for sockets.
  * The multiplexer is able to monitor a set of sockets and detect when at least one of them
- * is ready for a read operation. The maximum number of sockets that can be monitored
- * at the same time is equal to <code>FD_SETSIZE</code>. A socket descriptor is considered valid
- * if and only if its value is in the interval <code>[0, FD_SETSIZE)</code>.
- * Since the class uses <code>select()</code> internally, a multiplexer can be used
- * to monitor generic file descriptors like <code>stdin</code>.
+ * is ready for a read operation. The class uses <code>epoll</code> internally, so the number
+ * of sockets that can be monitored at the same time is limited only by the descriptors available
+ * to the process, and the cost of a wait depends on the number of ready sockets, not on the monitored ones.
+ * A multiplexer can be used to monitor generic file descriptors like <code>stdin</code>:
+ * descriptors that cannot be monitored by <code>epoll</code>, like regular files, are always ready.
  */
 class InputMultiplexer {
     private:
-        fd_set masterSet;
-        fd_set readSet;
-        unsigned int maxDescriptor;
+        static const int MAX_EVENTS_PER_WAIT = 1024;
+
+        int epollDescriptor;
         unsigned int numberOfDescriptors;
+        std::vector<epoll_event> events;
+        std::vector<unsigned int> readyDescriptors;
+        std::vector<bool> readyFlags;         // Indexed by descriptor.
+        std::vector<unsigned int> alwaysReadyDescriptors;
 
         /**
          * Returns a string containing a human readable description of the error
-         * that occurred while using <code>select()</code>.
+         * that occurred while using <code>epoll</code>.
          * @return  the string containing the error.
          */
         char* parseError() const;
+
+        /**
+         * Waits until at least one of the descriptors is ready, or the timeout expires,
+         * updating the ready descriptors.
+         * @param milliseconds  the timeout, <code>-1</code> to wait indefinitely.
+         * @return              the number of ready descriptors.
+         * @throws SocketException  if an error occurs while monitoring the sockets.
+         */
+        size_t wait(int milliseconds);
+
+        /**
+         * Adds a descriptor to the set of monitored ones, for the given <code>epoll</code> events.
+         * If the descriptor is already in the set, the method has no effect.
+         * @param descriptor  the descriptor.
+         * @param events      the <code>epoll</code> events.
+         * @throws SocketException  if the descriptor is invalid.
+         */
+        void monitorDescriptor(unsigned int descriptor, uint32_t events);
     public:
+        /**
+         * Creates an empty multiplexer.
+         * @throws SocketException  if the <code>epoll</code> instance cannot be created.
+         */
         InputMultiplexer();
 
         /**
          * Destroys the object, without closing the sockets added to the set of monitored ones.
          * It is up to the caller to close them individually, if needed.
          */
-        ~InputMultiplexer() = default;
+        ~InputMultiplexer();
 
-        InputMultiplexer(const InputMultiplexer&) = default;
-        InputMultiplexer(InputMultiplexer&&) = default;
-        InputMultiplexer& operator=(const InputMultiplexer&) = default;
-        InputMultiplexer& operator=(InputMultiplexer&&) = default;
+        InputMultiplexer(const InputMultiplexer&) = delete;
+        InputMultiplexer& operator=(const InputMultiplexer&) = delete;
+        InputMultiplexer(InputMultiplexer &&that) noexcept;
+        InputMultiplexer& operator=(InputMultiplexer &&that) noexcept;
 
         /**
          * Adds a socket descriptor to the set of monitored ones. If the descriptor
          * is already in the set, the method has no effect.
          * @param descriptor  the socket descriptor.
-         * @throws SocketException  if the descriptor is invalid, or the maximum number of sockets
-         *                          that can be monitored at the same time has been reached.
+         * @throws SocketException  if the descriptor is invalid.
          */
         void addDescriptor(unsigned int descriptor);
 
         /**
-         * Removes a socket descriptor from the set of monitored ones. If the descriptor
-         * is not in the set, the method has no effect.
+         * Adds the descriptor of a socket whose connection is in progress to the set of monitored ones.
+         * The socket is reported as ready when the connection is established or fails, and then at every wait:
+         * once the connection is established, the descriptor must be removed and added again
+         * with <code>addDescriptor()</code>, to be monitored only for reads.
          * @param descriptor  the socket descriptor.
          * @throws SocketException  if the descriptor is invalid.
          */
+        void addConnectingDescriptor(unsigned int descriptor);
+
+        /**
+         * Removes a socket descriptor from the set of monitored ones. If the descriptor
+         * is not in the set, the method has no effect. The descriptor is no longer
+         * reported as ready, but it is not removed from the list returned by <code>getReadyDescriptors()</code>.
+         * It must be called before closing the socket.
+         * @param descriptor  the socket descriptor.
+         */
         void removeDescriptor(unsigned int descriptor);
 
         /**
@@ -68,10 +106,17 @@ class InputMultiplexer {
          * 4) the socket is a listening one and there are pending connections.
          * @param descriptor  the socket descriptor.
          * @return            true if the socket is ready, false otherwise.
-         * @throws SocketException  if the descriptor is invalid.
          */
         bool isReady(const unsigned int &descriptor) const;
 
+        /**
+         * Returns the descriptors found ready by the last call to <code>select()</code>
+         * or <code>selectWithTimeout()</code>. If many descriptors are ready at the same time,
+         * a call can return only a part of them: the others are returned by the following calls.
+         * @return  the ready descriptors.
+         */
+        const std::vector<unsigned int>& getReadyDescriptors() const;
+
         /**
          * Waits until at least one of the sockets being monitored is ready.
          * The method is blocking, unless the set of sockets is empty.
@@ -2,6 +2,7 @@
 #include <sys/socket.h>
 #include <unistd.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <string.h>
 #include <iostream>
 #include <SocketException.h>
@@ -129,6 +130,14 @@ void TcpSocket::bind(std::string address, unsigned short port) {
     }
 }
 
+void TcpSocket::enablePortReuse() {
+    int enabled = 1;
+    auto success = setsockopt(descriptor, SOL_SOCKET, SO_REUSEPORT, &enabled, sizeof(enabled));
+    if (success == -1) {
+        throw SocketException(parseError());
+    }
+}
+
 void TcpSocket::listen(size_t backlog) {
     auto success = ::listen(descriptor, backlog);
     if (success == -1) {
@@ -148,7 +157,20 @@ TcpSocket TcpSocket::accept() {
     return TcpSocket(newSocketDescriptor, clientAddress);
 }
 
-void TcpSocket::connect(std::string address, unsigned short port) {
+std::pair<TcpSocket, TcpSocket> TcpSocket::createPair() {
+    int descriptors[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, descriptors) == -1) {
+        throw SocketException(strerror(errno));
+    }
+
+    sockaddr_in unspecifiedAddress;
+    memset(&unspecifiedAddress, 0, sizeof(unspecifiedAddress));
+    unspecifiedAddress.sin_family = AF_INET;
+
+    return std::make_pair(TcpSocket(descriptors[0], unspecifiedAddress), TcpSocket(descriptors[1], unspecifiedAddress));
+}
+
+void TcpSocket::setDestination(std::string address, unsigned short port) {
     destinationAddress = std::move(address);
     destinationPort = port;
 
@@ -160,11 +182,57 @@ void TcpSocket::connect(std::string address, unsigned short port) {
     if (success == 0) {
         throw SocketException("Invalid network address");
     }
+}
+
+void TcpSocket::setNonBlocking(bool nonBlocking) {
+    auto flags = fcntl(descriptor, F_GETFL);
+    if (flags == -1) {
+        throw SocketException(parseError());
+    }
 
-    success = ::connect(descriptor, (sockaddr*) &rawDestinationAddress, sizeof(rawDestinationAddress));
+    flags = nonBlocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+    if (fcntl(descriptor, F_SETFL, flags) == -1) {
+        throw SocketException(parseError());
+    }
+}
+
+void TcpSocket::connect(std::string address, unsigned short port) {
+    setDestination(std::move(address), port);
+
+    auto success = ::connect(descriptor, (sockaddr*) &rawDestinationAddress, sizeof(rawDestinationAddress));
+    if (success == -1) {
+        throw SocketException(parseError());
+    }
+}
+
+bool TcpSocket::startConnect(std::string address, unsigned short port) {
+    setDestination(std::move(address), port);
+    setNonBlocking(true);
+
+    auto success = ::connect(descriptor, (sockaddr*) &rawDestinationAddress, sizeof(rawDestinationAddress));
     if (success == -1) {
+        if (errno == EINPROGRESS) {
+            return false;
+        }
         throw SocketException(parseError());
     }
+
+    setNonBlocking(false);
+    return true;
+}
+
+void TcpSocket::finishConnect() {
+    int error = 0;
+    socklen_t errorLength = sizeof(error);
+    if (getsockopt(descriptor, SOL_SOCKET, SO_ERROR, &error, &errorLength) == -1) {
+        throw SocketException(parseError());
+    }
+
+    if (error != 0) {
+        throw SocketException(strerror(error));
+    }
+
+    setNonBlocking(false);
 }
 
 void TcpSocket::sendAllBytes(const unsigned char *buffer, size_t bufferLength) const {
@@ -262,6 +330,95 @@ std::vector<unsigned char> TcpSocket::receiveWithTimeout(unsigned long seconds)
     }
 }
 
+size_t TcpSocket::receiveAvailable(std::vector<unsigned char> &buffer) const {
+    unsigned char chunk[4096];
+    size_t totalBytesReceived = 0;
+
+    while (true) {
+        auto bytesReceived = ::recv(descriptor, chunk, sizeof(chunk), MSG_DONTWAIT);
+
+        if (bytesReceived == -1) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return totalBytesReceived;
+            }
+            throw SocketException(parseError());
+        }
+
+        if (bytesReceived == 0) {
+            // The bytes received before the closure are returned first: the next call will throw.
+            if (totalBytesReceived > 0) {
+                return totalBytesReceived;
+            }
+            throw SocketException("Remote socket has been closed");
+        }
+
+        buffer.insert(buffer.end(), chunk, chunk + bytesReceived);
+        totalBytesReceived += bytesReceived;
+    }
+}
+
+bool TcpSocket::extractMessage(std::vector<unsigned char> &buffer, std::vector<unsigned char> &message) {
+    uint16_t msgLength;
+    if (buffer.size() < sizeof(msgLength)) {
+        return false;
+    }
+
+    memcpy(&msgLength, buffer.data(), sizeof(msgLength));
+    size_t msgSize = ntohs(msgLength);
+    if (msgSize == 0) {
+        throw SocketException("Empty message");
+    }
+
+    if (buffer.size() < sizeof(msgLength) + msgSize) {
+        return false;
+    }
+
+    message.assign(buffer.begin() + sizeof(msgLength), buffer.begin() + sizeof(msgLength) + msgSize);
+    buffer.erase(buffer.begin(), buffer.begin() + sizeof(msgLength) + msgSize);
+    return true;
+}
+
+bool TcpSocket::receiveMessageAvailable(std::vector<unsigned char> &buffer, std::vector<unsigned char> &message) const {
+    uint16_t msgLength;
+
+    while (true) {
+        // Only the length is requested until it is known, then only the rest of the message.
+        auto messageEnd = sizeof(msgLength);
+        if (buffer.size() >= sizeof(msgLength)) {
+            memcpy(&msgLength, buffer.data(), sizeof(msgLength));
+            if (msgLength == 0) {
+                throw SocketException("Empty message");
+            }
+            messageEnd += ntohs(msgLength);
+        }
+
+        if (buffer.size() == messageEnd) {
+            message.assign(buffer.begin() + sizeof(msgLength), buffer.end());
+            buffer.clear();
+            return true;
+        }
+
+        auto receivedSize = buffer.size();
+        buffer.resize(messageEnd);
+        auto bytesReceived = ::recv(descriptor, buffer.data() + receivedSize, messageEnd - receivedSize, MSG_DONTWAIT);
+
+        if (bytesReceived == -1) {
+            auto wouldBlock = errno == EAGAIN || errno == EWOULDBLOCK;
+            auto error = std::string(parseError());
+            buffer.resize(receivedSize);
+            if (wouldBlock) {
+                return false;
+            }
+            throw SocketException(error);
+        }
+
+        buffer.resize(receivedSize + bytesReceived);
+        if (bytesReceived == 0) {
+            throw SocketException("Remote socket has been closed");
+        }
+    }
+}
+
 bool TcpSocket::operator==(const TcpSocket &rhs) const {
     return sourceAddress == rhs.sourceAddress
            && sourcePort == rhs.sourcePort
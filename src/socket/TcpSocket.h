@@ -4,6 +4,7 @@
 #include <arpa/inet.h>
 #include <ostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace fourinarow {
@@ -40,6 +41,21 @@ class TcpSocket {
          */
         char* parseError() const;
 
+        /**
+         * Sets the remote address to which the socket will be connected.
+         * @param address  the IPv4 address.
+         * @param port     the port.
+         * @throws SocketException  if the given address is invalid.
+         */
+        void setDestination(std::string address, unsigned short port);
+
+        /**
+         * Switches the socket between the blocking and the non-blocking mode.
+         * @param nonBlocking  true to make the socket non-blocking, false to make it blocking.
+         * @throws SocketException  if the mode cannot be changed.
+         */
+        void setNonBlocking(bool nonBlocking);
+
         /**
          * Sends all the bytes of a message through a connected socket.
          * @param buffer        the buffer containing the message.
@@ -118,6 +134,14 @@ class TcpSocket {
          */
         void bind(std::string address, unsigned short port);
 
+        /**
+         * Allows other sockets to bind to the same address and port, as long as they enable
+         * the reuse too. The kernel then spreads the incoming connections among the listening sockets.
+         * It must be called before <code>bind()</code>.
+         * @throws SocketException  if the option cannot be set.
+         */
+        void enablePortReuse();
+
         /**
          * Marks the socket as passive, i.e. able to receive incoming connection requests.
          * @param backlog  the dimension of the backlog queue for requests.
@@ -133,6 +157,14 @@ class TcpSocket {
          */
         TcpSocket accept();
 
+        /**
+         * Creates a pair of sockets connected to each other inside the same process, without any network
+         * setup. The sockets exchange messages as TCP sockets do, but have no address.
+         * @return  the pair of connected sockets.
+         * @throws SocketException  if the sockets cannot be created.
+         */
+        static std::pair<TcpSocket, TcpSocket> createPair();
+
         /**
          * Connects the socket to the specified remote address. The method is blocking:
          * the socket waits until the connection request is accepted.
@@ -143,6 +175,26 @@ class TcpSocket {
          */
         void connect(std::string address, unsigned short port);
 
+        /**
+         * Starts connecting the socket to the specified remote address. The method is non-blocking:
+         * if the connection cannot be established immediately, it returns and the socket becomes
+         * writable when the connection is established or fails. In that case,
+         * <code>finishConnect()</code> must be called before using the socket.
+         * @param address  the IPv4 address.
+         * @param port     the port.
+         * @return         true if the connection has been established, false if it is in progress.
+         * @throws SocketException  if the given address is invalid,
+         *                          or the connection to the remote address fails.
+         */
+        bool startConnect(std::string address, unsigned short port);
+
+        /**
+         * Completes a connection started by <code>startConnect()</code>, making the socket blocking again.
+         * It must be called when the socket becomes writable.
+         * @throws SocketException  if the connection to the remote address has failed.
+         */
+        void finishConnect();
+
         /**
          * Sends a binary message through a connected socket. The method is blocking:
          * the socket waits until the entire message has been sent. A message can be
@@ -179,6 +231,40 @@ class TcpSocket {
          */
         std::vector<unsigned char> receiveWithTimeout(unsigned long seconds) const;
 
+        /**
+         * Appends to a buffer the bytes already received by a connected socket. The method is non-blocking:
+         * it returns as soon as no more bytes are available, without waiting for a message to be complete.
+         * The messages are then taken from the buffer with <code>extractMessage()</code>.
+         * @param buffer  the buffer storing the bytes received and not yet extracted.
+         * @return        the number of bytes appended, possibly zero.
+         * @throws SocketException  if an error occurs while performing the receive,
+         *                          or the remote socket has been closed and no bytes have been appended.
+         */
+        size_t receiveAvailable(std::vector<unsigned char> &buffer) const;
+
+        /**
+         * Receives the bytes of the next message already received by a connected socket. The method is non-blocking,
+         * like <code>receiveAvailable()</code>, but it never reads past the end of the message: the following
+         * messages can then be received by <code>receive()</code>.
+         * @param buffer   the buffer storing the bytes of the message received so far, length included.
+         *                 It is cleared when the message is complete.
+         * @param message  the vector that will store the message. Its previous content is discarded.
+         * @return         true if the message is complete, false otherwise.
+         * @throws SocketException  if the message is empty,
+         *                          or an error occurs while performing the receive,
+         *                          or the remote socket has been closed.
+         */
+        bool receiveMessageAvailable(std::vector<unsigned char> &buffer, std::vector<unsigned char> &message) const;
+
+        /**
+         * Removes the first message from a buffer filled by <code>receiveAvailable()</code>, if it is complete.
+         * @param buffer   the buffer storing the bytes received and not yet extracted.
+         * @param message  the vector that will store the message. Its previous content is discarded.
+         * @return         true if a complete message has been extracted, false otherwise.
+         * @throws SocketException  if the message is empty.
+         */
+        static bool extractMessage(std::vector<unsigned char> &buffer, std::vector<unsigned char> &message);
+
         bool operator==(const TcpSocket &rhs) const;
         bool operator!=(const TcpSocket &rhs) const;
 };
@@ -4,11 +4,28 @@ namespace fourinarow {
 
 const unsigned short SERVER_PORT               = 5000;
 const unsigned short PLAYER_PORT               = 5001;
+const unsigned short NODE_PORT                 = 5002;                     // Links between the nodes of a cluster.
 const size_t BACKLOG_SIZE                      = 100;
 const unsigned long CLIENT_PROTOCOL_TIMEOUT    = 10;                       // In seconds.
 const unsigned long CLIENT_MATCHMAKING_TIMEOUT = 30;                       // In seconds.
 const unsigned int P2P_MAX_CONNECTION_RETRIES  = 3;                        // Each retry is interleaved by 1 second of sleep.
 const unsigned int MAX_TURN_DURATION           = 90;                       // In seconds.
+const size_t SERVER_MAX_LOGGED_PLAYERS         = 32;                       // Larger lists are logged only as a number of players.
+const unsigned long SERVER_TICKET_LIFETIME     = 3600;                     // In seconds.
+const unsigned long SERVER_DELEGATED_CREDENTIAL_LIFETIME = 7*24*3600;      // In seconds. Renewed at half of it.
+const unsigned int SERVER_MAX_PROCESSES        = 64;
+const size_t SERVER_PRESENCE_TABLE_CAPACITY    = 64*1024;                  // Players connected to all the server processes or nodes.
+const unsigned int SERVER_MAX_NODES            = 16;
+const unsigned long NODE_PROTOCOL_TIMEOUT      = 2;                        // In seconds. For each message of a node handshake.
+const unsigned long NODE_RECONNECT_PERIOD      = 5;                        // In seconds.
+
+const size_t SERVER_JOURNAL_CAPACITY           = 256*1024*1024;            // In bytes, about 4 million games.
+const unsigned long SERVER_JOURNAL_SYNC_PERIOD = 1000;                     // In milliseconds.
+
+const unsigned int INITIAL_RATING              = 1500;
+const unsigned int RATING_K_FACTOR             = 32;                       // Maximum rating change after a match.
+const unsigned int QUICK_MATCH_BUCKET_WIDTH    = 100;                      // In rating points.
+const unsigned long QUICK_MATCH_WIDENING_PERIOD = 5;                      // In seconds. Waiting longer widens the search by one bucket.
 
 const std::string SERVER_CERTIFICATE_FOLDER    = "./certificate/";
 const std::string SERVER_PLAYERS_FOLDER        = "./players/";
@@ -39,30 +56,81 @@ const uint8_t PLAYER_NOT_REGISTERED            = 17;
 const uint8_t PROTOCOL_VIOLATION               = 18;
 const uint8_t MALFORMED_MESSAGE                = 19;
 const uint8_t INTERNAL_ERROR                   = 20;
+const uint8_t RELAYED_PLAYER                   = 21;
+const uint8_t RESUME_HELLO                     = 22;
+const uint8_t RESUME_ACCEPTED                  = 23;
+const uint8_t END_RESUME                       = 24;
+const uint8_t TICKET_REJECTED                  = 25;
+const uint8_t REQ_TICKET                       = 26;
+const uint8_t SESSION_TICKET                   = 27;
+const uint8_t PEER_CHALLENGE                   = 28;                       // Exchanged only between server processes or nodes.
+const uint8_t PEER_CHALLENGE_RESPONSE          = 29;
+const uint8_t PEER_CHALLENGE_CANCEL            = 30;
+const uint8_t PEER_PRESENCE                    = 31;                       // Exchanged only between cluster nodes.
+const uint8_t QUICK_MATCH                      = 32;
+const uint8_t QUICK_MATCH_FOUND                = 33;
+
+const uint8_t SIGNATURE_RSA_PKCS1_SHA256       = 1;
+const uint8_t SIGNATURE_ECDSA_P256_SHA256      = 2;
+const uint8_t SIGNATURE_ED25519                = 3;
+const std::vector<uint8_t> DELEGATED_SIGNATURE_SCHEMES = {                 // By preference of the server.
+        SIGNATURE_ED25519,
+        SIGNATURE_ECDSA_P256_SHA256
+};
+
+const uint8_t KEY_EXCHANGE_ECDH_P256           = 1;                        // Supported by every party.
+const uint8_t KEY_EXCHANGE_X25519              = 2;
+const std::vector<uint8_t> KEY_EXCHANGE_GROUPS = {                         // By preference of the responder.
+        KEY_EXCHANGE_X25519,
+        KEY_EXCHANGE_ECDH_P256
+};
+
+const uint8_t CIPHER_AES_128_GCM               = 1;                        // Supported by every party.
+const uint8_t CIPHER_CHACHA20_POLY1305         = 2;                        // Preferred without hardware support for AES.
 
 const uint16_t MAX_MSG_SIZE                    = 65535;
 const uint8_t MAX_IPV4_ADDRESS_SIZE            = 15;
 const uint8_t NONCE_SIZE                       = 4;
 const uint8_t MAX_USERNAME_SIZE                = 255;
-const uint8_t ECDH_PUBLIC_KEY_SIZE             = 91;                       // ECDH with prime256v1 curve, DER format.
-const uint16_t RSA_PUBLIC_KEY_SIZE             = 294;                      // RSA-2048, DER format.
-const uint16_t DIGITAL_SIGNATURE_SIZE          = 256;                      // RSA-2048 digital signatures.
-const uint8_t KEY_SIZE                         = 16;                       // AES-128 GCM.
-const uint8_t IV_SIZE                          = 12;                       // AES-128 GCM.
-const uint8_t TAG_SIZE                         = 16;                       // AES-128 GCM.
+const uint8_t ECDH_P256_PUBLIC_KEY_SIZE        = 91;                       // ECDH with prime256v1 curve, DER format.
+const uint8_t X25519_PUBLIC_KEY_SIZE           = 32;                       // ECDH with Curve25519, raw format.
+const uint8_t MAX_ECDH_PUBLIC_KEY_SIZE         = ECDH_P256_PUBLIC_KEY_SIZE;
+const uint16_t MAX_SIGNATURE_PUBLIC_KEY_SIZE   = 294;                      // RSA-2048, DER format, the largest key supported.
+const uint16_t MAX_DIGITAL_SIGNATURE_SIZE      = 256;                      // RSA-2048, the largest signature supported.
+const uint8_t AES_128_GCM_KEY_SIZE             = 16;
+const uint8_t CHACHA20_POLY1305_KEY_SIZE       = 32;
+const uint8_t IV_SIZE                          = 12;                       // AES-128 GCM and ChaCha20-Poly1305.
+const uint8_t TAG_SIZE                         = 16;                       // AES-128 GCM and ChaCha20-Poly1305.
+const uint8_t RESUMPTION_SECRET_SIZE           = 16;
+const uint8_t SESSION_TICKET_SIZE              = IV_SIZE +                 // A ticket is the authenticated encryption of
+                                                 sizeof(uint64_t) +        // the expiration time, the cipher suite
+                                                 sizeof(uint8_t) +         // and the resumption secret.
+                                                 RESUMPTION_SECRET_SIZE +
+                                                 TAG_SIZE;
+const uint8_t CERTIFICATE_FINGERPRINT_SIZE     = 32;                       // SHA-256 of the certificate in DER format.
+const size_t CSPRNG_BLOCK_SIZE                 = 4096;                     // Random bytes drawn at once by each thread.
+
+const uint16_t MAX_DELEGATED_CREDENTIAL_SIZE   = sizeof(uint8_t) +         // Scheme, expiration time, public key and signature,
+                                                 sizeof(uint64_t) +        // the last two preceded by their length.
+                                                 sizeof(uint16_t) +
+                                                 MAX_SIGNATURE_PUBLIC_KEY_SIZE +
+                                                 sizeof(uint16_t) +
+                                                 MAX_DIGITAL_SIGNATURE_SIZE;
 
 const uint16_t MAX_CERTIFICATE_SIZE            = MAX_MSG_SIZE -            // Size derived from the composition of SERVER_HELLO.
-                                                 sizeof(uint8_t) -         // sizeof(uint8_t) refers to the "type" field size,
-                                                 NONCE_SIZE -              // while sizeof(uint16_t) refers to the certificate
-                                                 ECDH_PUBLIC_KEY_SIZE -    // length sent in the serialized message.
-                                                 DIGITAL_SIGNATURE_SIZE -
-                                                 sizeof(uint16_t);
+                                                 3*sizeof(uint8_t) -       // 3*sizeof(uint8_t) refers to the "type" field size,
+                                                 NONCE_SIZE -              // to the length of the ECDH public key and to the cipher suite, while
+                                                 MAX_ECDH_PUBLIC_KEY_SIZE - // each sizeof(uint16_t) refers to the length of
+                                                 MAX_DELEGATED_CREDENTIAL_SIZE - // another variable-size field.
+                                                 MAX_DIGITAL_SIGNATURE_SIZE -
+                                                 3*sizeof(uint16_t);
 
 const uint16_t MAX_PLAYER_LIST_SIZE            = MAX_MSG_SIZE -            // Size derived from the composition of PLAYER_LIST.
                                                  sizeof(uint8_t) -         // sizeof(uint8_t) refers to the "type" field size, while sizeof(uint16_t)
                                                  sizeof(uint16_t);         // refers to the list length sent in the serialized message.
 
-const uint8_t ROWS                             = 6;
-const uint8_t COLUMNS                          = 7;
+const uint8_t MAX_PRESENCE_UPDATE_ENTRIES      = 128;                      // About 35 KB with the longest usernames.
+
+const size_t DEFAULT_TRANSPOSITION_TABLE_SIZE  = 64*1024*1024;             // 64 MiB, i.e. 8M entries of 8 bytes.
 
-}
+}
\ No newline at end of file
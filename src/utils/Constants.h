@@ -3,17 +3,37 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 namespace fourinarow {
 
 // Networking quantities.
 extern const unsigned short SERVER_PORT;
 extern const unsigned short PLAYER_PORT;
+extern const unsigned short NODE_PORT;
 extern const size_t BACKLOG_SIZE;
 extern const unsigned long CLIENT_PROTOCOL_TIMEOUT;
 extern const unsigned long CLIENT_MATCHMAKING_TIMEOUT;
 extern const unsigned int P2P_MAX_CONNECTION_RETRIES;
 extern const unsigned int MAX_TURN_DURATION;
+extern const size_t SERVER_MAX_LOGGED_PLAYERS;
+extern const unsigned long SERVER_TICKET_LIFETIME;
+extern const unsigned long SERVER_DELEGATED_CREDENTIAL_LIFETIME;
+extern const unsigned int SERVER_MAX_PROCESSES;
+extern const size_t SERVER_PRESENCE_TABLE_CAPACITY;
+extern const unsigned int SERVER_MAX_NODES;
+extern const unsigned long NODE_PROTOCOL_TIMEOUT;
+extern const unsigned long NODE_RECONNECT_PERIOD;
+
+// Game journal quantities.
+extern const size_t SERVER_JOURNAL_CAPACITY;
+extern const unsigned long SERVER_JOURNAL_SYNC_PERIOD;
+
+// Rating and quick match quantities.
+extern const unsigned int INITIAL_RATING;
+extern const unsigned int RATING_K_FACTOR;
+extern const unsigned int QUICK_MATCH_BUCKET_WIDTH;
+extern const unsigned long QUICK_MATCH_WIDENING_PERIOD;
 
 // File paths.
 extern const std::string SERVER_CERTIFICATE_FOLDER;
@@ -47,24 +67,65 @@ extern const uint8_t PLAYER_NOT_REGISTERED;
 extern const uint8_t PROTOCOL_VIOLATION;
 extern const uint8_t MALFORMED_MESSAGE;
 extern const uint8_t INTERNAL_ERROR;
+extern const uint8_t RELAYED_PLAYER;
+extern const uint8_t RESUME_HELLO;
+extern const uint8_t RESUME_ACCEPTED;
+extern const uint8_t END_RESUME;
+extern const uint8_t TICKET_REJECTED;
+extern const uint8_t REQ_TICKET;
+extern const uint8_t SESSION_TICKET;
+extern const uint8_t PEER_CHALLENGE;
+extern const uint8_t PEER_CHALLENGE_RESPONSE;
+extern const uint8_t PEER_CHALLENGE_CANCEL;
+extern const uint8_t PEER_PRESENCE;
+extern const uint8_t QUICK_MATCH;
+extern const uint8_t QUICK_MATCH_FOUND;
+
+// Signature schemes.
+extern const uint8_t SIGNATURE_RSA_PKCS1_SHA256;
+extern const uint8_t SIGNATURE_ECDSA_P256_SHA256;
+extern const uint8_t SIGNATURE_ED25519;
+extern const std::vector<uint8_t> DELEGATED_SIGNATURE_SCHEMES;
+
+// Key exchange groups.
+extern const uint8_t KEY_EXCHANGE_ECDH_P256;
+extern const uint8_t KEY_EXCHANGE_X25519;
+extern const std::vector<uint8_t> KEY_EXCHANGE_GROUPS;
+
+// Cipher suites.
+extern const uint8_t CIPHER_AES_128_GCM;
+extern const uint8_t CIPHER_CHACHA20_POLY1305;
 
 // Size of message fields and cryptographic quantities, expressed in number of bytes.
 extern const uint16_t MAX_MSG_SIZE;
 extern const uint8_t MAX_IPV4_ADDRESS_SIZE;
 extern const uint8_t NONCE_SIZE;
 extern const uint8_t MAX_USERNAME_SIZE;
-extern const uint8_t ECDH_PUBLIC_KEY_SIZE;
-extern const uint16_t RSA_PUBLIC_KEY_SIZE;
-extern const uint16_t DIGITAL_SIGNATURE_SIZE;
+extern const uint8_t ECDH_P256_PUBLIC_KEY_SIZE;
+extern const uint8_t X25519_PUBLIC_KEY_SIZE;
+extern const uint8_t MAX_ECDH_PUBLIC_KEY_SIZE;
+extern const uint16_t MAX_SIGNATURE_PUBLIC_KEY_SIZE;
+extern const uint16_t MAX_DIGITAL_SIGNATURE_SIZE;
+extern const uint16_t MAX_DELEGATED_CREDENTIAL_SIZE;
 extern const uint16_t MAX_CERTIFICATE_SIZE;
 extern const uint16_t MAX_PLAYER_LIST_SIZE;
-extern const uint8_t KEY_SIZE;
+extern const uint8_t MAX_PRESENCE_UPDATE_ENTRIES;
+extern const uint8_t AES_128_GCM_KEY_SIZE;
+extern const uint8_t CHACHA20_POLY1305_KEY_SIZE;
 extern const uint8_t IV_SIZE;
 extern const uint8_t TAG_SIZE;
+extern const uint8_t RESUMPTION_SECRET_SIZE;
+extern const uint8_t SESSION_TICKET_SIZE;
+extern const uint8_t CERTIFICATE_FINGERPRINT_SIZE;
+extern const size_t CSPRNG_BLOCK_SIZE;
+
+// Search quantities.
+extern const size_t DEFAULT_TRANSPOSITION_TABLE_SIZE;
 
-// Game quantities.
-extern const uint8_t ROWS;
-extern const uint8_t COLUMNS;
+// Game quantities. They are defined here, so that they can be used as template arguments.
+constexpr uint8_t ROWS           = 6;
+constexpr uint8_t COLUMNS        = 7;
+constexpr uint8_t CONNECT_LENGTH = 4;
 
 }
 
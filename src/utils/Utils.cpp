@@ -49,11 +49,15 @@ void cleanse(unsigned int &integer) {
     OPENSSL_cleanse(&integer, sizeof(integer));
 }
 
+void cleanse(uint64_t &integer) {
+    OPENSSL_cleanse(&integer, sizeof(integer));
+}
+
 void cleanse(bool &boolean) {
     OPENSSL_cleanse(&boolean, sizeof(boolean));
 }
 
-void cleanse(FourInARow::Result &result) {
+void cleanse(MatchResult &result) {
     OPENSSL_cleanse(&result, sizeof(result));
 }
 
@@ -78,9 +82,41 @@ std::string convertMessageType(const uint8_t &messageType) {
     if (messageType == PROTOCOL_VIOLATION)       return "PROTOCOL_VIOLATION";
     if (messageType == MALFORMED_MESSAGE)        return "MALFORMED_MESSAGE";
     if (messageType == INTERNAL_ERROR)           return "INTERNAL_ERROR";
+    if (messageType == RELAYED_PLAYER)           return "RELAYED_PLAYER";
+    if (messageType == RESUME_HELLO)             return "RESUME_HELLO";
+    if (messageType == RESUME_ACCEPTED)          return "RESUME_ACCEPTED";
+    if (messageType == END_RESUME)               return "END_RESUME";
+    if (messageType == TICKET_REJECTED)          return "TICKET_REJECTED";
+    if (messageType == REQ_TICKET)               return "REQ_TICKET";
+    if (messageType == SESSION_TICKET)           return "SESSION_TICKET";
+    if (messageType == PEER_CHALLENGE)           return "PEER_CHALLENGE";
+    if (messageType == PEER_CHALLENGE_RESPONSE)  return "PEER_CHALLENGE_RESPONSE";
+    if (messageType == PEER_CHALLENGE_CANCEL)    return "PEER_CHALLENGE_CANCEL";
+    if (messageType == PEER_PRESENCE)            return "PEER_PRESENCE";
+    if (messageType == QUICK_MATCH)              return "QUICK_MATCH";
+    if (messageType == QUICK_MATCH_FOUND)        return "QUICK_MATCH_FOUND";
     else                                         return "CURRENTLY_NOT_SUPPORTED_TYPE";
 }
 
+std::string convertSignatureScheme(const uint8_t &scheme) {
+    if (scheme == SIGNATURE_RSA_PKCS1_SHA256)  return "RSA_PKCS1_SHA256";
+    if (scheme == SIGNATURE_ECDSA_P256_SHA256) return "ECDSA_P256_SHA256";
+    if (scheme == SIGNATURE_ED25519)           return "ED25519";
+    else                                       return "CURRENTLY_NOT_SUPPORTED_SCHEME";
+}
+
+std::string convertKeyExchangeGroup(const uint8_t &group) {
+    if (group == KEY_EXCHANGE_ECDH_P256) return "ECDH_P256";
+    if (group == KEY_EXCHANGE_X25519)    return "X25519";
+    else                                 return "CURRENTLY_NOT_SUPPORTED_GROUP";
+}
+
+std::string convertCipherSuite(const uint8_t &cipherSuite) {
+    if (cipherSuite == CIPHER_AES_128_GCM)       return "AES_128_GCM";
+    if (cipherSuite == CIPHER_CHACHA20_POLY1305) return "CHACHA20_POLY1305";
+    else                                         return "CURRENTLY_NOT_SUPPORTED_CIPHER_SUITE";
+}
+
 std::string convertClientStatus(const Player::Status &status) {
     if (status == Player::Status::OFFLINE)                 return "OFFLINE";
     if (status == Player::Status::CONNECTED)               return "CONNECTED";
@@ -1,12 +1,14 @@
 #ifndef INC_4INAROW_UTILS_H
 #define INC_4INAROW_UTILS_H
 
+#include <array>
 #include <string>
 #include <vector>
 #include <regex>
+#include <openssl/crypto.h>
 #include "Constants.h"
 #include "Player.h"
-#include "FourInARow.h"
+#include "MatchResult.h"
 
 namespace fourinarow {
 
@@ -65,6 +67,14 @@ void cleanse(uint8_t &integer);
  */
 void cleanse(unsigned int &integer);
 
+/**
+ * Fills the given 64-bit unsigned integer with zeros destroying its content,
+ * so that the compiler does not remove the operations when optimizing.
+ * It relies on <code>OPENSSL_cleanse()</code>.
+ * @param integer  the 64-bit unsigned integer whose content must be destroyed.
+ */
+void cleanse(uint64_t &integer);
+
 /**
  * Fills the given boolean with zeros destroying its content,
  * so that the compiler does not remove the operations when optimizing.
@@ -79,7 +89,20 @@ void cleanse(bool &boolean);
  * It relies on <code>OPENSSL_cleanse()</code>.
  * @param result  the enumerator whose content must be destroyed.
  */
-void cleanse(FourInARow::Result &result);
+void cleanse(MatchResult &result);
+
+/**
+ * Fills the given fixed-size array with zeros destroying its content,
+ * so that the compiler does not remove the operations when optimizing.
+ * It relies on <code>OPENSSL_cleanse()</code>.
+ * @tparam T      the type of the array's elements.
+ * @tparam N      the number of elements of the array.
+ * @param array   the array whose content must be destroyed.
+ */
+template<typename T, size_t N>
+void cleanse(std::array<T, N> &array) {
+    OPENSSL_cleanse(array.data(), sizeof(T)*N);
+}
 
 /**
  * Translates a message type into a human readable string.
@@ -88,6 +111,27 @@ void cleanse(FourInARow::Result &result);
  */
 std::string convertMessageType(const uint8_t &messageType);
 
+/**
+ * Translates a signature scheme into a human readable string.
+ * @param scheme  the signature scheme.
+ * @return  the string containing the human readable scheme.
+ */
+std::string convertSignatureScheme(const uint8_t &scheme);
+
+/**
+ * Translates a key exchange group into a human readable string.
+ * @param group  the key exchange group.
+ * @return  the string containing the human readable group.
+ */
+std::string convertKeyExchangeGroup(const uint8_t &group);
+
+/**
+ * Translates a cipher suite into a human readable string.
+ * @param cipherSuite  the cipher suite.
+ * @return  the string containing the human readable cipher suite.
+ */
+std::string convertCipherSuite(const uint8_t &cipherSuite);
+
 /**
  * Translates a player status into a human readable string.
  * @param status  the player status.
@@ -117,17 +161,18 @@ uint8_t getMessageType(const std::vector<unsigned char> &message) {
 }
 
 /**
- * Checks if the given key is correctly sized.
+ * Checks if the given key of a symmetric cipher is correctly sized.
  * If the check fails, the function throws a user specified exception.
  * @tparam Exception  the exception type.
  * @param key         the key.
+ * @param keySize     the key size required by the cipher.
  * @throws Exception  if the key is wrongly sized.
  */
 template<typename Exception>
-void checkKeySize(const std::vector<unsigned char> &key) {
-    if (key.size() != KEY_SIZE) {
+void checkKeySize(const std::vector<unsigned char> &key, size_t keySize) {
+    if (key.size() != keySize) {
         throw Exception("The key size must be exactly " +
-                        std::to_string(KEY_SIZE) +
+                        std::to_string(keySize) +
                         " bytes. Key size: " +
                         std::to_string(key.size()) +
                         " bytes");
@@ -172,18 +217,20 @@ void checkNonceSize(const std::vector<unsigned char> &nonce) {
 }
 
 /**
- * Checks if the given Elliptic-curve Diffie-Hellman public key
- * is correctly sized. If the check fails, the function throws
- * a user specified exception.
+ * Checks if the given Elliptic-curve Diffie-Hellman public key is correctly sized,
+ * namely if it has the size of a key of one of the supported groups.
+ * If the check fails, the function throws a user specified exception.
  * @tparam Exception  the exception type.
  * @param publicKey   the public key.
  * @throws Exception  if the public key is wrongly sized.
  */
 template<typename Exception>
 void checkEcdhPublicKeySize(const std::vector<unsigned char> &publicKey) {
-    if (publicKey.size() != ECDH_PUBLIC_KEY_SIZE) {
-        throw Exception("The ECDH public key size must be exactly " +
-                        std::to_string(ECDH_PUBLIC_KEY_SIZE) +
+    if (publicKey.size() != ECDH_P256_PUBLIC_KEY_SIZE && publicKey.size() != X25519_PUBLIC_KEY_SIZE) {
+        throw Exception("The ECDH public key size must be either " +
+                        std::to_string(ECDH_P256_PUBLIC_KEY_SIZE) +
+                        " or " +
+                        std::to_string(X25519_PUBLIC_KEY_SIZE) +
                         " bytes. Public key size: " +
                         std::to_string(publicKey.size()) +
                         " bytes");
@@ -191,17 +238,17 @@ void checkEcdhPublicKeySize(const std::vector<unsigned char> &publicKey) {
 }
 
 /**
- * Checks if the given RSA public key is correctly sized.
+ * Checks if the given public key, used to verify digital signatures, is correctly sized.
  * If the check fails, the function throws a user specified exception.
  * @tparam Exception  the exception type.
  * @param publicKey   the public key.
- * @throws Exception  if the public key is wrongly sized.
+ * @throws Exception  if the public key is empty or too big.
  */
 template<typename Exception>
-void checkRsaPublicKeySize(const std::vector<unsigned char> &publicKey) {
-    if (publicKey.size() != RSA_PUBLIC_KEY_SIZE) {
-        throw Exception("The RSA public key size must be exactly " +
-                        std::to_string(RSA_PUBLIC_KEY_SIZE) +
+void checkSignaturePublicKeySize(const std::vector<unsigned char> &publicKey) {
+    if (publicKey.empty() || publicKey.size() > MAX_SIGNATURE_PUBLIC_KEY_SIZE) {
+        throw Exception("The public key size must be between 1 and " +
+                        std::to_string(MAX_SIGNATURE_PUBLIC_KEY_SIZE) +
                         " bytes. Public key size: " +
                         std::to_string(publicKey.size()) +
                         " bytes");
@@ -213,19 +260,37 @@ void checkRsaPublicKeySize(const std::vector<unsigned char> &publicKey) {
  * If the check fails, the function throws a user specified exception.
  * @tparam Exception        the exception type.
  * @param digitalSignature  the digital signature.
- * @throws Exception  if the digital signature is wrongly sized.
+ * @throws Exception  if the digital signature is empty or too big.
  */
 template<typename Exception>
 void checkDigitalSignatureSize(const std::vector<unsigned char> &digitalSignature) {
-    if (digitalSignature.size() != DIGITAL_SIGNATURE_SIZE) {
-        throw Exception("The digital signature size must be exactly " +
-                        std::to_string(DIGITAL_SIGNATURE_SIZE) +
+    if (digitalSignature.empty() || digitalSignature.size() > MAX_DIGITAL_SIGNATURE_SIZE) {
+        throw Exception("The digital signature size must be between 1 and " +
+                        std::to_string(MAX_DIGITAL_SIGNATURE_SIZE) +
                         " bytes. Digital signature size: " +
                         std::to_string(digitalSignature.size()) +
                         " bytes");
     }
 }
 
+/**
+ * Checks if the given delegated credential is correctly sized. An empty credential is valid.
+ * If the check fails, the function throws a user specified exception.
+ * @tparam Exception   the exception type.
+ * @param credential  the serialized delegated credential.
+ * @throws Exception  if the delegated credential is too big.
+ */
+template<typename Exception>
+void checkDelegatedCredentialSize(const std::vector<unsigned char> &credential) {
+    if (credential.size() > MAX_DELEGATED_CREDENTIAL_SIZE) {
+        throw Exception("The delegated credential size must be at most " +
+                        std::to_string(MAX_DELEGATED_CREDENTIAL_SIZE) +
+                        " bytes. Delegated credential size: " +
+                        std::to_string(credential.size()) +
+                        " bytes");
+    }
+}
+
 /**
  * Checks if the given column index is valid.
  * If the check fails, the function throws a user specified exception.
@@ -279,6 +344,24 @@ void checkCertificateSize(const std::vector<unsigned char> &certificate) {
     }
 }
 
+/**
+ * Checks if the given session ticket is correctly sized.
+ * If the check fails, the function throws a user specified exception.
+ * @tparam Exception  the exception type.
+ * @param ticket      the session ticket.
+ * @throws Exception  if the session ticket is wrongly sized.
+ */
+template<typename Exception>
+void checkSessionTicketSize(const std::vector<unsigned char> &ticket) {
+    if (ticket.size() != SESSION_TICKET_SIZE) {
+        throw Exception("The session ticket size must be exactly " +
+                        std::to_string(SESSION_TICKET_SIZE) +
+                        " bytes. Session ticket size: " +
+                        std::to_string(ticket.size()) +
+                        " bytes");
+    }
+}
+
 /**
  * Concatenates two vectors. The concatenation is obtained by copying the
  * elements of the source vector into the destination one.